@@ -21,10 +21,14 @@ public class GitSourceControl : ModuleRules
 				"UnrealEd",
 				"SourceControl",
 				"SourceControlWindows",
-				"Projects"
+				"Projects",
+				"Json"
 			}
 		);
 
+		// Inflates the loose objects read by the native backend
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
 		if (Target.Version.MajorVersion == 5)
 		{
 			PrivateDependencyModuleNames.Add("ToolMenus");
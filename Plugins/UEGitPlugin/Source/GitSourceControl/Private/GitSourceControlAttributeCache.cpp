@@ -0,0 +1,385 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlAttributeCache.h"
+
+#include "GitSourceControlReadBackend.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace GitAttributeCacheConstants
+{
+/** Minimum delay between two checks of the timestamps of the attributes files */
+const double CheckIntervalSeconds = 1.0;
+} // namespace GitAttributeCacheConstants
+
+static bool HasWildcard(const FString& InPattern)
+{
+	int32 Index;
+	return InPattern.FindChar(TEXT('*'), Index) || InPattern.FindChar(TEXT('?'), Index) || InPattern.FindChar(TEXT('['), Index);
+}
+
+/**
+ * Match a path against a pattern with '/', as git does: '*' and '?' do not match a '/', "**" then a '/' match
+ * any number of directories, none included, and a trailing "**" anything. Ignores the case, as the extensions.
+ */
+static bool MatchesPathPattern(const TCHAR* InPattern, const TCHAR* InPath)
+{
+	while (*InPattern)
+	{
+		if (InPattern[0] == TEXT('*') && InPattern[1] == TEXT('*') && (InPattern[2] == TEXT('/') || InPattern[2] == 0))
+		{
+			if (InPattern[2] == 0)
+			{
+				return true;
+			}
+			for (const TCHAR* Start = InPath; ; )
+			{
+				if (MatchesPathPattern(InPattern + 3, Start))
+				{
+					return true;
+				}
+				const TCHAR* Slash = FCString::Strchr(Start, TEXT('/'));
+				if (!Slash)
+				{
+					return false;
+				}
+				Start = Slash + 1;
+			}
+		}
+		if (*InPattern == TEXT('*'))
+		{
+			for (const TCHAR* End = InPath; ; End++)
+			{
+				if (MatchesPathPattern(InPattern + 1, End))
+				{
+					return true;
+				}
+				if (*End == 0 || *End == TEXT('/'))
+				{
+					return false;
+				}
+			}
+		}
+		if (*InPath == 0 || (*InPattern == TEXT('?') ? *InPath == TEXT('/') : FChar::ToLower(*InPattern) != FChar::ToLower(*InPath)))
+		{
+			return false;
+		}
+		InPattern++;
+		InPath++;
+	}
+	return *InPath == 0;
+}
+
+FGitAttributeCache& FGitAttributeCache::Get()
+{
+	static FGitAttributeCache AttributeCache;
+	return AttributeCache;
+}
+
+bool FGitAttributeCache::Load(const FString& InPathToGitBinary, const FString& InRepositoryRoot)
+{
+	const FString RepositoryDir = InRepositoryRoot.EndsWith(TEXT("/")) ? InRepositoryRoot : InRepositoryRoot + TEXT("/");
+
+	// From the lowest to the highest precedence: the root file, the files of the subdirectories from the shallowest, then info/attributes
+	TArray<FAttributesFile> NewFiles;
+	NewFiles.Add({RepositoryDir + TEXT(".gitattributes"), FString(), FDateTime::MinValue()});
+
+	TArray<FString> IndexFiles;
+	GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend) { return Backend.ListFiles(InRepositoryRoot, InRepositoryRoot, IndexFiles); });
+	TArray<FString> NestedFiles = IndexFiles.FilterByPredicate([](const FString& File)
+	{
+		return File.EndsWith(TEXT("/.gitattributes"));
+	});
+	auto Depth = [](const FString& InFile)
+	{
+		int32 NumSlashes = 0;
+		for (const TCHAR Char : InFile)
+		{
+			NumSlashes += Char == TEXT('/') ? 1 : 0;
+		}
+		return NumSlashes;
+	};
+	NestedFiles.Sort([&Depth](const FString& A, const FString& B)
+	{
+		const int32 DepthA = Depth(A);
+		const int32 DepthB = Depth(B);
+		return DepthA != DepthB ? DepthA < DepthB : A < B;
+	});
+	for (const FString& NestedFile : NestedFiles)
+	{
+		NewFiles.Add({RepositoryDir + NestedFile, FPaths::GetPath(NestedFile), FDateTime::MinValue()});
+	}
+
+	FString CommonDir;
+	if (FGitNativeReadBackend::GetCommonDir(InRepositoryRoot, CommonDir))
+	{
+		NewFiles.Add({CommonDir / TEXT("info/attributes"), FString(), FDateTime::MinValue()});
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	RepositoryRoot = RepositoryDir;
+	Files = MoveTemp(NewFiles);
+	LoadFiles();
+	return Files.ContainsByPredicate([](const FAttributesFile& File) { return File.TimeStamp != FDateTime::MinValue(); });
+}
+
+void FGitAttributeCache::LoadFiles()
+{
+	Root = MakeUnique<FNode>();
+	int32 Precedence = 0;
+	int32 NumLoaded = 0;
+	for (FAttributesFile& File : Files)
+	{
+		File.TimeStamp = IFileManager::Get().GetTimeStamp(*File.Filename);
+		FString Content;
+		if (FFileHelper::LoadFileToString(Content, *File.Filename, FFileHelper::EHashOptions::None, FILEREAD_Silent))
+		{
+			AddFile(File.Directory, Content, Precedence);
+			NumLoaded++;
+		}
+	}
+	LastCheckTime = FPlatformTime::Seconds();
+	UE_LOG(LogSourceControl, Log, TEXT("Read %d attributes file(s): %d lockable rule(s)"), NumLoaded, Precedence);
+}
+
+FGitAttributeCache::FNode& FGitAttributeCache::FindOrAddNode(const FString& InDirectory)
+{
+	FNode* Node = Root.Get();
+	TArray<FString> Segments;
+	InDirectory.ParseIntoArray(Segments, TEXT("/"), true);
+	for (const FString& Segment : Segments)
+	{
+		TUniquePtr<FNode>& Child = Node->Children.FindOrAdd(Segment);
+		if (!Child.IsValid())
+		{
+			Child = MakeUnique<FNode>();
+		}
+		Node = Child.Get();
+	}
+	return *Node;
+}
+
+void FGitAttributeCache::AddFile(const FString& InDirectory, const FString& InContent, int32& InOutPrecedence)
+{
+	TArray<FString> Lines;
+	InContent.ParseIntoArrayLines(Lines);
+	for (const FString& RawLine : Lines)
+	{
+		const FString Line = RawLine.TrimStartAndEnd();
+		if (Line.IsEmpty() || Line[0] == TEXT('#') || Line.StartsWith(TEXT("[attr]")))
+		{
+			continue;
+		}
+		TArray<FString> Tokens;
+		Line.ParseIntoArrayWS(Tokens);
+
+		// Only the lines about the lockable attribute matter: the last one of them decides
+		bool bHasLockable = false;
+		bool bLockable = false;
+		for (int32 TokenIndex = 1; TokenIndex < Tokens.Num(); TokenIndex++)
+		{
+			const FString& Token = Tokens[TokenIndex];
+			if (Token == TEXT("lockable") || Token == TEXT("-lockable") || Token == TEXT("!lockable") || Token.StartsWith(TEXT("lockable=")))
+			{
+				bHasLockable = true;
+				bLockable = Token == TEXT("lockable");
+			}
+		}
+		FString Pattern = Tokens[0];
+		if (!bHasLockable || Pattern.StartsWith(TEXT("\"")) || Pattern.StartsWith(TEXT("!")) || Pattern.EndsWith(TEXT("/")))
+		{
+			// Quoted patterns are not supported, negative ones are forbidden, and attributes don't apply to directories
+			continue;
+		}
+		const int32 Precedence = ++InOutPrecedence;
+
+		// A leading "**/" before a name matches in all directories, like a pattern without any '/'
+		FString NamePattern = Pattern;
+		while (NamePattern.RemoveFromStart(TEXT("**/")))
+		{
+		}
+		int32 NameSlashIndex;
+		if (!NamePattern.FindChar(TEXT('/'), NameSlashIndex))
+		{
+			Pattern = MoveTemp(NamePattern);
+		}
+		const bool bAnchored = Pattern.RemoveFromStart(TEXT("/"));
+		int32 SlashIndex;
+		if (!bAnchored && !Pattern.FindChar(TEXT('/'), SlashIndex))
+		{
+			const FString Suffix = Pattern.RightChop(1);
+			int32 DotIndex;
+			if (Pattern.StartsWith(TEXT("*.")) && !HasWildcard(Suffix) && Suffix.FindLastChar(TEXT('.'), DotIndex) && DotIndex == 0)
+			{
+				// The common "*.uasset": a hash lookup
+				FindOrAddNode(InDirectory).Extensions.Add(Suffix.ToLower(), {Precedence, bLockable});
+			}
+			else
+			{
+				FRule Rule;
+				Rule.Pattern = Pattern;
+				Rule.Precedence = Precedence;
+				Rule.bLockable = bLockable;
+				FindOrAddNode(InDirectory).Rules.Add(MoveTemp(Rule));
+			}
+			continue;
+		}
+
+		// A path relative to the directory: its leading directories without wildcard are nodes of the trie
+		TArray<FString> Segments;
+		Pattern.ParseIntoArray(Segments, TEXT("/"), true);
+		FString Directory = InDirectory;
+		int32 FirstSegment = 0;
+		while (FirstSegment < Segments.Num() - 1 && !HasWildcard(Segments[FirstSegment]))
+		{
+			Directory = Directory.IsEmpty() ? Segments[FirstSegment] : Directory / Segments[FirstSegment];
+			FirstSegment++;
+		}
+		FRule Rule;
+		Rule.bMatchName = false;
+		Rule.Pattern = FString::Join(TArrayView<const FString>(Segments).Slice(FirstSegment, Segments.Num() - FirstSegment), TEXT("/"));
+		Rule.NumSlashes = Segments.Num() - FirstSegment - 1;
+		Rule.bAnyDepth = Rule.Pattern.Contains(TEXT("**"));
+		Rule.Precedence = Precedence;
+		Rule.bLockable = bLockable;
+		FindOrAddNode(Directory).Rules.Add(MoveTemp(Rule));
+	}
+}
+
+bool FGitAttributeCache::IsLoaded() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Root.IsValid();
+}
+
+bool FGitAttributeCache::IsLockable(const FString& InPath) const
+{
+	FReadScopeLock ReadLock(Lock);
+	if (!Root.IsValid())
+	{
+		return false;
+	}
+
+	FString Path = InPath.Replace(TEXT("\\"), TEXT("/"));
+	if (Path.StartsWith(RepositoryRoot))
+	{
+		Path.RightChopInline(RepositoryRoot.Len());
+	}
+	else if (!FPaths::IsRelative(Path))
+	{
+		// Outside of the repository: only the patterns matching any file name apply
+		Path = FPaths::GetCleanFilename(Path);
+	}
+
+	// Start of each directory in the path, to match the patterns of a node against the rest of the path
+	TArray<int32, TInlineAllocator<16>> SegmentStarts;
+	SegmentStarts.Add(0);
+	for (int32 Index = 0; Index < Path.Len(); Index++)
+	{
+		if (Path[Index] == TEXT('/'))
+		{
+			SegmentStarts.Add(Index + 1);
+		}
+	}
+	const int32 NumSegments = SegmentStarts.Num();
+	const FString FileName = Path.RightChop(SegmentStarts.Last());
+	int32 DotIndex;
+	const FString Extension = FileName.FindLastChar(TEXT('.'), DotIndex) ? FileName.RightChop(DotIndex).ToLower() : FString();
+
+	int32 BestPrecedence = -1;
+	bool bLockable = false;
+	const FNode* Node = Root.Get();
+	for (int32 Depth = 0; Node != nullptr; Depth++)
+	{
+		if (const FExtensionRule* ExtensionRule = Node->Extensions.Find(Extension))
+		{
+			if (ExtensionRule->Precedence > BestPrecedence)
+			{
+				BestPrecedence = ExtensionRule->Precedence;
+				bLockable = ExtensionRule->bLockable;
+			}
+		}
+		for (const FRule& Rule : Node->Rules)
+		{
+			if (Rule.Precedence <= BestPrecedence)
+			{
+				continue;
+			}
+			bool bMatches;
+			if (Rule.bMatchName)
+			{
+				bMatches = FileName.MatchesWildcard(Rule.Pattern);
+			}
+			else
+			{
+				// A '*' of the pattern must not match a '/' of the path: compare the number of directories first
+				bMatches = (Rule.bAnyDepth || Rule.NumSlashes == NumSegments - 1 - Depth) && MatchesPathPattern(*Rule.Pattern, *Path + SegmentStarts[Depth]);
+			}
+			if (bMatches)
+			{
+				BestPrecedence = Rule.Precedence;
+				bLockable = Rule.bLockable;
+			}
+		}
+
+		if (Depth + 1 >= NumSegments)
+		{
+			break;
+		}
+		const TUniquePtr<FNode>* Child = Node->Children.Find(Path.Mid(SegmentStarts[Depth], SegmentStarts[Depth + 1] - SegmentStarts[Depth] - 1));
+		Node = Child ? Child->Get() : nullptr;
+	}
+	return bLockable;
+}
+
+TArray<FString> FGitAttributeCache::GetLockableExtensions() const
+{
+	FReadScopeLock ReadLock(Lock);
+	TArray<FString> Extensions;
+	if (Root.IsValid())
+	{
+		for (const auto& Pair : Root->Extensions)
+		{
+			if (Pair.Value.bLockable)
+			{
+				Extensions.Add(Pair.Key);
+			}
+		}
+	}
+	return Extensions;
+}
+
+void FGitAttributeCache::RefreshIfChanged()
+{
+	const double Now = FPlatformTime::Seconds();
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (!Root.IsValid() || Now - LastCheckTime < GitAttributeCacheConstants::CheckIntervalSeconds)
+		{
+			return;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	if (Now - LastCheckTime < GitAttributeCacheConstants::CheckIntervalSeconds)
+	{
+		// Another thread checked in between
+		return;
+	}
+	LastCheckTime = Now;
+	for (const FAttributesFile& File : Files)
+	{
+		if (IFileManager::Get().GetTimeStamp(*File.Filename) != File.TimeStamp)
+		{
+			LoadFiles();
+			return;
+		}
+	}
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/UniquePtr.h"
+
+/**
+ * The "lockable" attribute of the paths of a repository, evaluated from its .gitattributes files.
+ *
+ * The patterns are compiled once into a trie of directories: each node has a hash map of the extensions
+ * declared for its subtree ("*.uasset lockable"), and the few other patterns declared there. A lookup walks
+ * the directories of the path, with a hash lookup and these patterns at each level. The files are read again
+ * when one of them changes.
+ */
+class FGitAttributeCache
+{
+public:
+	static FGitAttributeCache& Get();
+
+	/** The attributes of another repository than the one of the editor, for the tests: the editor uses Get() */
+	FGitAttributeCache() = default;
+
+	/**
+	 * Read the attributes of a repository: its root .gitattributes, those of its subdirectories found in the index, and info/attributes
+	 * @returns false if none could be read
+	 */
+	bool Load(const FString& InPathToGitBinary, const FString& InRepositoryRoot);
+
+	bool IsLoaded() const;
+
+	/**
+	 * Whether a file has the lockable attribute
+	 * @param	InPath	Absolute, relative to the repository root, or a bare extension like ".uasset"
+	 */
+	bool IsLockable(const FString& InPath) const;
+
+	/** Extensions lockable in the whole repository, like ".uasset" */
+	TArray<FString> GetLockableExtensions() const;
+
+	/** Read the attributes again if one of their files changed since the last check, at most once per second */
+	void RefreshIfChanged();
+
+private:
+	/** A pattern that is not a plain "*.ext" */
+	struct FRule
+	{
+		FString Pattern;
+		/** No '/' in the pattern: it matches the name of the file, at any depth */
+		bool bMatchName = true;
+		/** Number of '/' in the pattern, that a path must have as well unless it contains "**" */
+		int32 NumSlashes = 0;
+		bool bAnyDepth = false;
+		int32 Precedence = 0;
+		bool bLockable = false;
+	};
+
+	/** Precedence and value of the last rule of an extension */
+	struct FExtensionRule
+	{
+		int32 Precedence = 0;
+		bool bLockable = false;
+	};
+
+	/** An attributes file, and the directory it applies to, relative to the repository root */
+	struct FAttributesFile
+	{
+		FString Filename;
+		FString Directory;
+		/** When it was read, MinValue if it did not exist */
+		FDateTime TimeStamp;
+	};
+
+	/** A directory with attributes */
+	struct FNode
+	{
+		TMap<FString, TUniquePtr<FNode>> Children;
+		/** Lower case extensions, with their dot */
+		TMap<FString, FExtensionRule> Extensions;
+		TArray<FRule> Rules;
+	};
+
+	/** Compile the lines of an attributes file of a directory ("" for the root), in increasing precedence */
+	void AddFile(const FString& InDirectory, const FString& InContent, int32& InOutPrecedence);
+
+	FNode& FindOrAddNode(const FString& InDirectory);
+
+	/** Compile all the files again, under the write lock */
+	void LoadFiles();
+
+	mutable FRWLock Lock;
+	FString RepositoryRoot;
+	/** The attributes files in increasing precedence */
+	TArray<FAttributesFile> Files;
+	TUniquePtr<FNode> Root;
+	double LastCheckTime = 0.0;
+};
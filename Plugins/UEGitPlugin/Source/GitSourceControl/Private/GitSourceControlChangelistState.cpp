@@ -66,6 +66,37 @@ int32 FGitSourceControlChangelistState::GetShelvedFilesStatesNum() const
 }
 #endif
 
+bool FGitSourceControlChangelistState::AddFile(const FSourceControlStateRef& InState)
+{
+	int32& Index = FileIndices.FindOrAdd(&InState.Get(), INDEX_NONE);
+	if (Index != INDEX_NONE)
+	{
+		return false;
+	}
+	Index = Files.Add(InState);
+	return true;
+}
+
+bool FGitSourceControlChangelistState::RemoveFile(const FSourceControlStateRef& InState)
+{
+	int32 Index = INDEX_NONE;
+	if (!FileIndices.RemoveAndCopyValue(&InState.Get(), Index))
+	{
+		return false;
+	}
+	// Move the last file in the hole left by this one
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4
+	Files.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+#else
+	Files.RemoveAtSwap(Index, 1, false);
+#endif
+	if (Index < Files.Num())
+	{
+		FileIndices[&Files[Index].Get()] = Index;
+	}
+	return true;
+}
+
 FSourceControlChangelistRef FGitSourceControlChangelistState::GetChangelist() const
 {
 	FGitSourceControlChangelistRef ChangelistCopy = MakeShareable( new FGitSourceControlChangelist(Changelist));
@@ -72,16 +72,37 @@ public:
 
 	virtual FSourceControlChangelistRef GetChangelist() const override;
 
+	/**
+	 * Add a file to the changelist, in constant time
+	 * @returns false if it was already in it
+	 */
+	bool AddFile(const FSourceControlStateRef& InState);
+
+	/**
+	 * Remove a file from the changelist, in constant time (the order of the other files may change)
+	 * @returns false if it was not in it
+	 */
+	bool RemoveFile(const FSourceControlStateRef& InState);
+
+	bool ContainsFile(const FSourceControlStateRef& InState) const
+	{
+		return FileIndices.Contains(&InState.Get());
+	}
+
 public:
 	FGitSourceControlChangelist Changelist;
 
 	FString Description;
-
-	TArray<FSourceControlStateRef> Files;
 	
 	TArray<FSourceControlStateRef> ShelvedFiles;
 
 	/** The timestamp of the last update */
 	FDateTime TimeStamp;
+
+private:
+	TArray<FSourceControlStateRef> Files;
+
+	/** Index of each state in Files, to keep the membership of large changelists up to date file by file */
+	TMap<const ISourceControlState*, int32> FileIndices;
 };
 #endif
@@ -7,7 +7,10 @@
 
 #include "Modules/ModuleManager.h"
 #include "GitSourceControlModule.h"
+#include "GitSourceControlScheduler.h"
 #include "GitSourceControlUtils.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
 
 FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>& InOperation, const TSharedRef<class IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const FSourceControlOperationComplete& InOperationCompleteDelegate)
 	: Operation(InOperation)
@@ -18,6 +21,11 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 	, bCommandSuccessful(false)
 	, bAutoDelete(true)
 	, Concurrency(EConcurrency::Synchronous)
+	, bCancelReturned(false)
+	, QueueWaitSeconds(0.0)
+	, CompletedEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	, ProgressPercent(-1)
+	, bProgressChanged(false)
 {
 	// cache the providers settings here
 	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
@@ -28,22 +36,77 @@ FGitSourceControlCommand::FGitSourceControlCommand(const TSharedRef<class ISourc
 	PathToGitRoot = Provider.GetPathToGitRoot();
 }
 
+FGitSourceControlCommand::~FGitSourceControlCommand()
+{
+	FPlatformProcess::ReturnSynchEventToPool(CompletedEvent);
+}
+
 void FGitSourceControlCommand::UpdateRepositoryRootIfSubmodule(TArray<FString>& AbsoluteFilePaths)
 {
 	PathToRepositoryRoot = GitSourceControlUtils::ChangeRepositoryRootIfSubmodule(AbsoluteFilePaths, PathToRepositoryRoot);
 }
 
+static thread_local FGitSourceControlCommand* CurrentCommand = nullptr;
+
+FGitSourceControlCommand* FGitSourceControlCommand::GetCurrent()
+{
+	return CurrentCommand;
+}
+
+FGitScopedCurrentCommand::FGitScopedCurrentCommand(FGitSourceControlCommand* InCommand)
+	: PreviousCommand(CurrentCommand)
+{
+	CurrentCommand = InCommand;
+}
+
+FGitScopedCurrentCommand::~FGitScopedCurrentCommand()
+{
+	CurrentCommand = PreviousCommand;
+}
+
 bool FGitSourceControlCommand::DoWork()
 {
-	bCommandSuccessful = Worker->Execute(*this);
+	{
+		FGitScopedCurrentCommand ScopedCurrentCommand(this);
+		bCommandSuccessful = Worker->Execute(*this);
+	}
+	CompleteCoalescedCommands(false);
 	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
+	CompletedEvent->Trigger();
 
 	return bCommandSuccessful;
 }
 
 void FGitSourceControlCommand::Abandon()
 {
+	CompleteCoalescedCommands(true);
 	FPlatformAtomics::InterlockedExchange(&bExecuteProcessed, 1);
+	CompletedEvent->Trigger();
+}
+
+void FGitSourceControlCommand::CompleteCoalescedCommands(bool bInAbandoned)
+{
+	// The callers of the merged commands did not cancel them: they run on their own, or are abandoned along with the scheduler
+	if ((bInAbandoned || (IsCanceled() && !bCommandSuccessful)) && Scheduler != nullptr)
+	{
+		for (FGitSourceControlCommand* Coalesced : CoalescedCommands)
+		{
+			Scheduler->Schedule(*Coalesced);
+		}
+		CoalescedCommands.Reset();
+		return;
+	}
+
+	// The states were updated by this command's worker: the merged commands only report the result to their own callers
+	for (FGitSourceControlCommand* Coalesced : CoalescedCommands)
+	{
+		Coalesced->bCommandSuccessful = bCommandSuccessful;
+		Coalesced->CommitId = CommitId;
+		Coalesced->CommitSummary = CommitSummary;
+		FPlatformAtomics::InterlockedExchange(&Coalesced->bExecuteProcessed, 1);
+		Coalesced->CompletedEvent->Trigger();
+	}
+	CoalescedCommands.Reset();
 }
 
 void FGitSourceControlCommand::DoThreadedWork()
@@ -54,7 +117,15 @@ void FGitSourceControlCommand::DoThreadedWork()
 
 void FGitSourceControlCommand::Cancel()
 {
-	FPlatformAtomics::InterlockedExchange(&bCancelled, 1);
+	if (CanCancel())
+	{
+		FPlatformAtomics::InterlockedExchange(&bCancelled, 1);
+	}
+}
+
+bool FGitSourceControlCommand::CanCancel() const
+{
+	return Worker->CanCancel();
 }
 
 bool FGitSourceControlCommand::IsCanceled() const
@@ -62,6 +133,35 @@ bool FGitSourceControlCommand::IsCanceled() const
 	return bCancelled != 0;
 }
 
+bool FGitSourceControlCommand::WaitForCompletion(uint32 InWaitTimeMs)
+{
+	return CompletedEvent->Wait(InWaitTimeMs);
+}
+
+void FGitSourceControlCommand::SetProgress(const FString& InPhase, int32 InPercent)
+{
+	FScopeLock ScopeLock(&ProgressCriticalSection);
+	if (ProgressPercent != InPercent || ProgressPhase != InPhase)
+	{
+		ProgressPhase = InPhase;
+		ProgressPercent = InPercent;
+		bProgressChanged = true;
+	}
+}
+
+bool FGitSourceControlCommand::ConsumeProgress(FString& OutPhase, int32& OutPercent)
+{
+	FScopeLock ScopeLock(&ProgressCriticalSection);
+	if (!bProgressChanged)
+	{
+		return false;
+	}
+	OutPhase = ProgressPhase;
+	OutPercent = ProgressPercent;
+	bProgressChanged = false;
+	return true;
+}
+
 ECommandResult::Type FGitSourceControlCommand::ReturnResults()
 {
 	// Save any messages that have accumulated
@@ -2,10 +2,17 @@
 
 #include "GitSourceControlConsole.h"
 
+#include "Async/Async.h"
 #include "HAL/IConsoleManager.h"
 #include "ISourceControlModule.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
 
 #include "GitSourceControlModule.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlRevisionCache.h"
+#include "GitSourceControlSparseCheckout.h"
+#include "GitSourceControlTracer.h"
 #include "GitSourceControlUtils.h"
 
 // Auto-registered console commands:
@@ -16,6 +23,21 @@ static FAutoConsoleCommand g_executeGitConsoleCommand(TEXT("git"),
 	TEXT("Type 'git help' to get a command list."),
 	FConsoleCommandWithArgsDelegate::CreateStatic(&GitSourceControlConsole::ExecuteGitConsoleCommand));
 
+static FAutoConsoleCommand g_executeGitHydrateCommand(TEXT("git.hydrate"),
+	TEXT("Check out directories of a sparse-checkout, eg. 'git.hydrate Content/Characters Content/Props'.\n")
+	TEXT("In a partial clone, their missing blobs are fetched in a single batch."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&GitSourceControlConsole::ExecuteGitHydrateCommand));
+
+static FAutoConsoleCommand g_executeGitStatsCommand(TEXT("git.stats"),
+	TEXT("Statistics of the git processes launched by the plugin, by command, of the force updates and of the revision cache.\n")
+	TEXT("'git.stats csv [file]' writes the last processes to a CSV file (Saved/GitSourceControl by default), 'git.stats reset' clears them."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&GitSourceControlConsole::ExecuteGitStatsCommand));
+
+static FAutoConsoleCommand g_executeGitOfflineCommand(TEXT("git.offline"),
+	TEXT("List the pushes and locks queued while the Git remote was unreachable, replayed in order by the background refresh once it is back.\n")
+	TEXT("'git.offline clear' forgets them: the commits stay local, and the files stay locked locally only."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&GitSourceControlConsole::ExecuteGitOfflineCommand));
+
 void GitSourceControlConsole::ExecuteGitConsoleCommand(const TArray<FString>& a_args)
 {
 	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
@@ -42,3 +64,79 @@ void GitSourceControlConsole::ExecuteGitConsoleCommand(const TArray<FString>& a_
 
 	UE_LOG(LogSourceControl, Log, TEXT("Output:\n%s"), *Results);
 }
+
+void GitSourceControlConsole::ExecuteGitHydrateCommand(const TArray<FString>& a_args)
+{
+	FGitSourceControlModule& GitSourceControl = FModuleManager::LoadModuleChecked<FGitSourceControlModule>("GitSourceControl");
+	const FString PathToGitBinary = GitSourceControl.AccessSettings().GetBinaryPath();
+	const FString RepositoryRoot = GitSourceControl.GetProvider().GetPathToRepositoryRoot();
+	if (a_args.Num() == 0)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("git.hydrate: no directory given"));
+		return;
+	}
+
+	// The checkout can take long for large directories: don't block the editor
+	const TArray<FString> Directories = a_args;
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [PathToGitBinary, RepositoryRoot, Directories]()
+	{
+		TArray<FString> ErrorMessages;
+		if (!FGitSparseCheckout::Get().Hydrate(PathToGitBinary, RepositoryRoot, Directories, ErrorMessages))
+		{
+			for (const FString& ErrorMessage : ErrorMessages)
+			{
+				UE_LOG(LogSourceControl, Error, TEXT("git.hydrate: %s"), *ErrorMessage);
+			}
+		}
+	});
+}
+
+void GitSourceControlConsole::ExecuteGitStatsCommand(const TArray<FString>& a_args)
+{
+	FGitCommandTracer& Tracer = FGitCommandTracer::Get();
+	if (a_args.Num() == 0)
+	{
+		Tracer.LogStats();
+		const FGitForceUpdateStats& ForceUpdateStats = FGitSourceControlModule::Get().GetProvider().GetForceUpdateStats();
+		UE_LOG(LogSourceControl, Log, TEXT("Force updates: %lld request(s) of %lld path(s), %lld path(s) skipped, merged into %lld status command(s)"),
+			ForceUpdateStats.NumRequests, ForceUpdateStats.NumPathsRequested, ForceUpdateStats.NumPathsSkipped, ForceUpdateStats.NumCommands);
+		const FGitRevisionCacheStats RevisionCacheStats = FGitRevisionCache::Get().GetStats();
+		UE_LOG(LogSourceControl, Log, TEXT("Revision cache: %lld hit(s), %lld miss(es), %lld bytes served, %lld bytes cached, %lld bytes evicted"),
+			RevisionCacheStats.Hits, RevisionCacheStats.Misses, RevisionCacheStats.BytesServed, RevisionCacheStats.BytesCached, RevisionCacheStats.BytesEvicted);
+	}
+	else if (a_args[0] == TEXT("csv"))
+	{
+		const FString Filename = a_args.Num() > 1 ? a_args[1] : FPaths::ProjectSavedDir() / TEXT("GitSourceControl") / FString::Printf(TEXT("GitCommands-%s.csv"), *FDateTime::Now().ToString());
+		Tracer.ExportCsv(Filename);
+	}
+	else if (a_args[0] == TEXT("reset"))
+	{
+		Tracer.Reset();
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("git.stats: unknown argument '%s'"), *a_args[0]);
+	}
+}
+
+void GitSourceControlConsole::ExecuteGitOfflineCommand(const TArray<FString>& a_args)
+{
+	FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	if (a_args.Num() == 0)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Remote %s, %d operation(s) queued"), OfflineQueue.IsRemoteReachable() ? TEXT("reachable") : TEXT("unreachable"), OfflineQueue.Num());
+		for (const FGitOfflineEntry& Entry : OfflineQueue.GetEntries())
+		{
+			const TCHAR* OperationName = Entry.Operation == EGitOfflineOperation::Push ? TEXT("push") : Entry.Operation == EGitOfflineOperation::Lock ? TEXT("lock") : TEXT("unlock");
+			UE_LOG(LogSourceControl, Log, TEXT("%s %-6s %s"), *Entry.Time.ToString(), OperationName, Entry.Operation == EGitOfflineOperation::Push ? *Entry.Ref : *FString::Join(Entry.Files, TEXT(" ")));
+		}
+	}
+	else if (a_args[0] == TEXT("clear"))
+	{
+		OfflineQueue.Clear();
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("git.offline: unknown argument '%s'"), *a_args[0]);
+	}
+}
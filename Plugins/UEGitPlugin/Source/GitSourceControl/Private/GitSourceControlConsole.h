@@ -15,4 +15,13 @@ class GitSourceControlConsole
 public:
 	// Git Command Line Interface: Run 'git' commands directly from the Unreal Editor Console.
 	static void ExecuteGitConsoleCommand(const TArray<FString>& a_args);
+
+	// Add directories to the sparse-checkout cones, fetching their blobs in a single batch in a partial clone.
+	static void ExecuteGitHydrateCommand(const TArray<FString>& a_args);
+
+	// Statistics of the git processes launched by the plugin: "git.stats", "git.stats csv [file]" or "git.stats reset".
+	static void ExecuteGitStatsCommand(const TArray<FString>& a_args);
+
+	// Operations queued while the remote was unreachable: "git.offline" or "git.offline clear".
+	static void ExecuteGitOfflineCommand(const TArray<FString>& a_args);
 };
\ No newline at end of file
@@ -0,0 +1,187 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlLockIndex.h"
+
+#include "GitSourceControlPersistentFile.h"
+#include "ISourceControlModule.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace GitLfsLockIndexConstants
+{
+/** Identifies a lock index file */
+const uint32 Magic = 0x4C4B4947; // "GIKL"
+/** To be bumped when the layout of the file changes */
+const int32 Version = 1;
+} // namespace GitLfsLockIndexConstants
+
+FString FGitLfsLockIndex::GetIndexFilename() const
+{
+	return GitPersistentFile::GetFilename(TEXT("LfsLocks.bin"));
+}
+
+bool FGitLfsLockIndex::Load(const FString& InRepositoryRoot)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	RepositoryRoot = InRepositoryRoot;
+	const FString Filename = GetIndexFilename();
+
+	TArray<FGitLfsLock> PersistedLocks;
+	if (!GitPersistentFile::Load(Filename, GitLfsLockIndexConstants::Magic, GitLfsLockIndexConstants::Version, [&InRepositoryRoot, &PersistedLocks](FArchive& Reader)
+	{
+		FString IndexRepositoryRoot;
+		Reader << IndexRepositoryRoot;
+		if (IndexRepositoryRoot != InRepositoryRoot)
+		{
+			return false;
+		}
+		Reader << PersistedLocks;
+		return true;
+	}))
+	{
+		return false;
+	}
+
+	Locks.Reset();
+	Locks.Reserve(PersistedLocks.Num());
+	for (FGitLfsLock& Lock : PersistedLocks)
+	{
+		FString Path = Lock.Path;
+		Locks.Add(MoveTemp(Path), MoveTemp(Lock));
+	}
+	bPopulated = true;
+	bDirty = false;
+
+	UE_LOG(LogSourceControl, Log, TEXT("Loaded %d LFS locks from '%s'"), Locks.Num(), *Filename);
+	return true;
+}
+
+bool FGitLfsLockIndex::Save()
+{
+	TArray<uint8> Buffer;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (!bDirty || RepositoryRoot.IsEmpty())
+		{
+			return true;
+		}
+
+		TArray<FGitLfsLock> PersistedLocks;
+		Locks.GenerateValueArray(PersistedLocks);
+
+		FMemoryWriter Writer(Buffer);
+		Writer << RepositoryRoot << PersistedLocks;
+		bDirty = false;
+	}
+
+	return GitPersistentFile::Save(GetIndexFilename(), GitLfsLockIndexConstants::Magic, GitLfsLockIndexConstants::Version, Buffer);
+}
+
+bool FGitLfsLockIndex::IsPopulated() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bPopulated;
+}
+
+bool FGitLfsLockIndex::FindLockOwner(const FString& InPath, FString& OutOwner) const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	if (const FGitLfsLock* Lock = Locks.Find(InPath))
+	{
+		OutOwner = Lock->Owner;
+		return true;
+	}
+	return false;
+}
+
+TMap<FString, FString> FGitLfsLockIndex::GetLockOwners() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	TMap<FString, FString> LockOwners;
+	LockOwners.Reserve(Locks.Num());
+	for (const auto& Lock : Locks)
+	{
+		LockOwners.Add(Lock.Key, Lock.Value.Owner);
+	}
+	return LockOwners;
+}
+
+void FGitLfsLockIndex::ApplyListing(const TArray<FGitLfsLock>& InLocks, FOnLockChanged OnLockChanged)
+{
+	// Collect the changes under the lock, and report them after, so the callback can query the index
+	TArray<FGitLfsLock> Released;
+	TArray<FGitLfsLock> Acquired;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+
+		TSet<FString> ListedPaths;
+		ListedPaths.Reserve(InLocks.Num());
+		for (const FGitLfsLock& Lock : InLocks)
+		{
+			ListedPaths.Add(Lock.Path);
+			FGitLfsLock* KnownLock = Locks.Find(Lock.Path);
+			if (KnownLock == nullptr)
+			{
+				Acquired.Add(Lock);
+				Locks.Add(Lock.Path, Lock);
+			}
+			else if (KnownLock->Owner != Lock.Owner || (!Lock.Id.IsEmpty() && KnownLock->Id != Lock.Id))
+			{
+				// The file was unlocked then locked again since the last listing
+				Released.Add(*KnownLock);
+				Acquired.Add(Lock);
+				*KnownLock = Lock;
+			}
+		}
+
+		for (auto It = Locks.CreateIterator(); It; ++It)
+		{
+			if (!ListedPaths.Contains(It.Key()))
+			{
+				Released.Add(MoveTemp(It.Value()));
+				It.RemoveCurrent();
+			}
+		}
+
+		bPopulated = true;
+		bDirty |= Released.Num() > 0 || Acquired.Num() > 0;
+	}
+
+	for (const FGitLfsLock& Lock : Released)
+	{
+		OnLockChanged(Lock.Path, Lock.Owner, false);
+	}
+	for (const FGitLfsLock& Lock : Acquired)
+	{
+		OnLockChanged(Lock.Path, Lock.Owner, true);
+	}
+}
+
+void FGitLfsLockIndex::AddLock(const FGitLfsLock& InLock, FOnLockChanged OnLockChanged)
+{
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		Locks.Add(InLock.Path, InLock);
+		bDirty = true;
+	}
+	// Always reported, since locking is what makes the file writable for its owner
+	OnLockChanged(InLock.Path, InLock.Owner, true);
+}
+
+void FGitLfsLockIndex::RemoveLock(const FString& InPath, FOnLockChanged OnLockChanged)
+{
+	FGitLfsLock Lock;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (!Locks.RemoveAndCopyValue(InPath, Lock))
+		{
+			return;
+		}
+		bDirty = true;
+	}
+	OnLockChanged(Lock.Path, Lock.Owner, false);
+}
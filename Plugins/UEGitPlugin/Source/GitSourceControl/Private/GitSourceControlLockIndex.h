@@ -0,0 +1,85 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+/** A Git LFS lock, as listed by "git-lfs locks" */
+struct FGitLfsLock
+{
+	/** Lock id on the LFS server (can be empty when listed from the local cache) */
+	FString Id;
+
+	/** Absolute path of the locked file */
+	FString Path;
+
+	/** Name of the user who owns the lock */
+	FString Owner;
+
+	friend FArchive& operator<<(FArchive& Ar, FGitLfsLock& Lock)
+	{
+		return Ar << Lock.Id << Lock.Path << Lock.Owner;
+	}
+};
+
+/**
+ * Local index of the Git LFS locks of the repository, with per-path lookup.
+ *
+ * A listing from the server is applied as a difference with the known locks, so only the locks
+ * that changed are reported. The index is persisted in the Saved directory and read back into
+ * memory at load, so the lock state is known at startup without querying the server.
+ * Changes only mark it dirty: Save() writes it once per batch of changes.
+ */
+class FGitLfsLockIndex
+{
+public:
+	/** Callback for each lock acquired (bLocked) or released (!bLocked) */
+	typedef TFunctionRef<void(const FString& /* Path */, const FString& /* Owner */, bool /* bLocked */)> FOnLockChanged;
+
+	/**
+	 * Load the index persisted for this repository, replacing the known locks.
+	 * @returns false if there is no index, or if it was written for another repository or by another version
+	 */
+	bool Load(const FString& InRepositoryRoot);
+
+	/** Write the index to disk, if it changed since it was last saved */
+	bool Save();
+
+	/** @returns true once the index has been loaded or filled from a server listing */
+	bool IsPopulated() const;
+
+	/** Per-path lookup, without copying the whole index */
+	bool FindLockOwner(const FString& InPath, FString& OutOwner) const;
+
+	/** @returns a copy of all the locks, as a map of path to owner */
+	TMap<FString, FString> GetLockOwners() const;
+
+	/** Replace the known locks by a full listing, reporting only the locks that changed */
+	void ApplyListing(const TArray<FGitLfsLock>& InLocks, FOnLockChanged OnLockChanged);
+
+	/** Add or update a single lock, and report it */
+	void AddLock(const FGitLfsLock& InLock, FOnLockChanged OnLockChanged);
+
+	/** Remove a single lock, reporting it if it was known */
+	void RemoveLock(const FString& InPath, FOnLockChanged OnLockChanged);
+
+private:
+	/** Path of the index file for the repository */
+	FString GetIndexFilename() const;
+
+	mutable FCriticalSection CriticalSection;
+
+	/** Locks indexed by absolute path */
+	TMap<FString, FGitLfsLock> Locks;
+
+	/** Repository root the index belongs to */
+	FString RepositoryRoot;
+
+	bool bPopulated = false;
+	bool bDirty = false;
+};
@@ -8,6 +8,7 @@
 #include "GitSourceControlModule.h"
 #include "GitSourceControlProvider.h"
 #include "GitSourceControlOperations.h"
+#include "GitSourceControlPackageReloader.h"
 #include "GitSourceControlUtils.h"
 
 #include "ISourceControlModule.h"
@@ -49,9 +50,15 @@ static const FName LevelEditorName(TEXT("LevelEditor"));
 #define LOCTEXT_NAMESPACE "GitSourceControl"
 
 TWeakPtr<SNotificationItem> FGitSourceControlMenu::OperationInProgressNotification;
+TWeakPtr<ISourceControlOperation, ESPMode::ThreadSafe> FGitSourceControlMenu::OperationInProgress;
+FText FGitSourceControlMenu::OperationInProgressText;
 
 void FGitSourceControlMenu::Register()
 {
+	FGitCommandProgress& CommandProgress = FGitSourceControlModule::Get().GetProvider().OnCommandProgress();
+	CommandProgress.Remove(CommandProgressHandle);
+	CommandProgressHandle = CommandProgress.AddStatic(&FGitSourceControlMenu::OnCommandProgress);
+
 #if ENGINE_MAJOR_VERSION >= 5
     FToolMenuOwnerScoped SourceControlMenuOwner( GitSourceControlMenuTabName );
 	if (UToolMenus* ToolMenus = UToolMenus::Get())
@@ -76,6 +83,13 @@ void FGitSourceControlMenu::Register()
 
 void FGitSourceControlMenu::Unregister()
 {
+	// Also called while the module shuts down
+	if (FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe())
+	{
+		GitSourceControl->GetProvider().OnCommandProgress().Remove(CommandProgressHandle);
+	}
+	CommandProgressHandle.Reset();
+
 #if ENGINE_MAJOR_VERSION >= 5
 	if (UToolMenus* ToolMenus = UToolMenus::Get())
 	{
@@ -217,7 +231,7 @@ void FGitSourceControlMenu::SyncClicked()
 			if (Result == ECommandResult::Succeeded)
 			{
 				// Display an ongoing notification during the whole operation (packages will be reloaded at the completion of the operation)
-				DisplayInProgressNotification(SyncOperation->GetInProgressString());
+				DisplayInProgressNotification(SyncOperation);
 			}
 			else
 			{
@@ -270,7 +284,7 @@ void FGitSourceControlMenu::PushClicked()
 		if (Result == ECommandResult::Succeeded)
 		{
 			// Display an ongoing notification during the whole operation
-			DisplayInProgressNotification(PushOperation->GetInProgressString());
+			DisplayInProgressNotification(PushOperation);
 		}
 		else
 		{
@@ -315,7 +329,9 @@ void FGitSourceControlMenu::RevertClicked()
 	SourceControlProvider.Execute(Operation, Filenames, EConcurrency::Asynchronous, FSourceControlOperationComplete::CreateStatic(&FGitSourceControlMenu::RevertAllCallback));
 #endif
 
-	FNotificationInfo Info(LOCTEXT("SourceControlMenuRevertAll", "Checking for assets to revert..."));
+	OperationInProgress = Operation;
+	OperationInProgressText = LOCTEXT("SourceControlMenuRevertAll", "Checking for assets to revert...");
+	FNotificationInfo Info(OperationInProgressText);
 	Info.bFireAndForget = false;
 	Info.ExpireDuration = 0.0f;
 	Info.FadeOutDuration = 1.0f;
@@ -345,32 +361,21 @@ void FGitSourceControlMenu::RevertAllCallback(const FSourceControlOperationRef&
 
 	// Get a list of all the checked out packages
 	TArray<FString> PackageNames;
-	TArray<UPackage*> LoadedPackages;
 	TMap<FString, FSourceControlStatePtr> PackageStates;
 	FEditorFileUtils::FindAllSubmittablePackageFiles(PackageStates, true);
+	PackageStates.GetKeys(PackageNames);
 
-	for (TMap<FString, FSourceControlStatePtr>::TConstIterator PackageIter(PackageStates); PackageIter; ++PackageIter)
-	{
-		const FString PackageName = *PackageIter.Key();
-		const FSourceControlStatePtr CurPackageSCCState = PackageIter.Value();
-
-		UPackage* Package = FindPackage(nullptr, *PackageName);
-		if (Package != nullptr)
-		{
-			LoadedPackages.Add(Package);
-
-			if (!Package->IsFullyLoaded())
-			{
-				FlushAsyncLoading();
-				Package->FullyLoad();
-			}
-			ResetLoaders(Package);
-		}
+	const auto FileNames = SourceControlHelpers::PackageFilenames(PackageNames);
 
-		PackageNames.Add(PackageName);
+	// Detach the loaded packages from their files, flushing the async loading only once
+	const double UnlinkStartTime = FPlatformTime::Seconds();
+	TArray<TWeakObjectPtr<UPackage>> LoadedPackages;
+	for (UPackage* Package : GitSourceControlUtils::UnlinkPackages(FileNames))
+	{
+		// The garbage collector can run during the revert
+		LoadedPackages.Emplace(Package);
 	}
-
-	const auto FileNames = SourceControlHelpers::PackageFilenames(PackageNames);
+	const double UnlinkSeconds = FPlatformTime::Seconds() - UnlinkStartTime;
 
 	// Launch a "Revert" Operation
 	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
@@ -392,7 +397,8 @@ void FGitSourceControlMenu::RevertAllCallback(const FSourceControlOperationRef&
 		DisplaySucessNotification(TEXT("Revert"));
 	}
 
-	GitSourceControlUtils::ReloadPackages(LoadedPackages);
+	// Reloaded over several frames, as after a pull
+	FGitPackageReloader::Start(LoadedPackages, UnlinkSeconds);
 #if ENGINE_MAJOR_VERSION >= 5
 	Provider.Execute(ISourceControlOperation::Create<FUpdateStatus>(), FSourceControlChangelistPtr(), FGitSourceControlModule::GetEmptyStringArray(), EConcurrency::Asynchronous);
 #else
@@ -419,7 +425,7 @@ void FGitSourceControlMenu::RefreshClicked()
 		if (Result == ECommandResult::Succeeded)
 		{
 			// Display an ongoing notification during the whole operation
-			DisplayInProgressNotification(RefreshOperation->GetInProgressString());
+			DisplayInProgressNotification(RefreshOperation);
 		}
 		else
 		{
@@ -436,11 +442,13 @@ void FGitSourceControlMenu::RefreshClicked()
 }
 
 // Display an ongoing notification during the whole operation
-void FGitSourceControlMenu::DisplayInProgressNotification(const FText& InOperationInProgressString)
+void FGitSourceControlMenu::DisplayInProgressNotification(const FSourceControlOperationRef& InOperation)
 {
 	if (!OperationInProgressNotification.IsValid())
 	{
-		FNotificationInfo Info(InOperationInProgressString);
+		OperationInProgress = InOperation;
+		OperationInProgressText = InOperation->GetInProgressString();
+		FNotificationInfo Info(OperationInProgressText);
 		Info.bFireAndForget = false;
 		Info.ExpireDuration = 0.0f;
 		Info.FadeOutDuration = 1.0f;
@@ -465,6 +473,15 @@ void FGitSourceControlMenu::RevertAllCancelled(FSourceControlOperationRef InOper
 	OperationInProgressNotification.Reset();
 }
 
+void FGitSourceControlMenu::OnCommandProgress(const FSourceControlOperationRef& InOperation, const FString& InPhase, int32 InPercent)
+{
+	const TSharedPtr<SNotificationItem> Notification = OperationInProgressNotification.Pin();
+	if (Notification.IsValid() && OperationInProgress.Pin().Get() == &InOperation.Get())
+	{
+		Notification->SetText(FText::Format(LOCTEXT("SourceControlMenu_Progress", "{0}\n{1}: {2}%"), OperationInProgressText, FText::FromString(InPhase), FText::AsNumber(InPercent)));
+	}
+}
+
 // Remove the ongoing notification at the end of the operation
 void FGitSourceControlMenu::RemoveInProgressNotification()
 {
@@ -19,6 +19,7 @@
 #include "ContentBrowserDelegates.h"
 
 #include "GitSourceControlOperations.h"
+#include "GitSourceControlRevisionCache.h"
 #include "GitSourceControlUtils.h"
 #include "ISourceControlModule.h"
 #include "SourceControlHelpers.h"
@@ -62,11 +63,15 @@ void FGitSourceControlModule::StartupModule()
 #if ENGINE_MAJOR_VERSION == 5
 	GitSourceControlProvider.RegisterWorker( "MoveToChangelist", FGetGitSourceControlWorker::CreateStatic( &CreateWorker<FGitMoveToChangelistWorker> ) );
 	GitSourceControlProvider.RegisterWorker( "UpdateChangelistsStatus", FGetGitSourceControlWorker::CreateStatic( &CreateWorker<FGitUpdateStagingWorker> ) );
+	GitSourceControlProvider.RegisterWorker( "StageSaved", FGetGitSourceControlWorker::CreateStatic( &CreateWorker<FGitStageSavedWorker> ) );
 #endif
 
 	// load our settings
 	GitSourceControlSettings.LoadSettings();
 
+	// load the revisions extracted by previous sessions
+	FGitRevisionCache::Get().Load();
+
 	// If configured, do a check if the current user has permissions to access a specified repository. Exit with a fatal error if that is the case.
 	FString RequiredRepositoryAccessURL, RequiredRepositoryAccessBranchName;
 	GConfig->GetString(TEXT("GitSourceControl"), TEXT("RequiredAccessRepositoryURL"), RequiredRepositoryAccessURL, GEditorIni);
@@ -127,6 +132,9 @@ void FGitSourceControlModule::ShutdownModule()
 {
 	// shut down the provider, as this module is going away
 	GitSourceControlProvider.Close();
+	GitSourceControlUtils::ShutdownGitProcessPool();
+
+	FGitRevisionCache::Get().Save();
 
 	// unbind provider from editor
     IModularFeatures::Get().UnregisterModularFeature( NAME_SourceControl, &GitSourceControlProvider );
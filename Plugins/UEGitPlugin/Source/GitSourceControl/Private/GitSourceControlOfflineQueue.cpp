@@ -0,0 +1,352 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlOfflineQueue.h"
+
+#include "Async/Async.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "GitSourceControlModule.h"
+#include "GitSourceControlPersistentFile.h"
+#include "GitSourceControlRevisionCache.h"
+#include "GitSourceControlUtils.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "GitSourceControl"
+
+namespace GitOfflineQueueConstants
+{
+/** Identifies a journal file */
+const uint32 Magic = 0x4A4F4947; // "GIOJ"
+/** To be bumped when the layout of the file changes */
+const int32 Version = 2;
+} // namespace GitOfflineQueueConstants
+
+FArchive& operator<<(FArchive& Ar, FGitOfflineEntry& Entry)
+{
+	Ar << Entry.Id << Entry.Operation << Entry.Files << Entry.Ref << Entry.Time;
+	return Ar;
+}
+
+FGitOfflineQueue& FGitOfflineQueue::Get()
+{
+	static FGitOfflineQueue OfflineQueue(GetJournalFilename());
+	return OfflineQueue;
+}
+
+FGitOfflineQueue::FGitOfflineQueue(const FString& InJournalFilename)
+	: JournalFilename(InJournalFilename)
+{
+}
+
+FString FGitOfflineQueue::GetJournalFilename()
+{
+	return GitPersistentFile::GetFilename(TEXT("OfflineJournal.bin"));
+}
+
+void FGitOfflineQueue::Load(const FString& InRepositoryRoot)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	RepositoryRoot = InRepositoryRoot;
+	Entries.Reset();
+	NextId = 1;
+
+	uint32 JournalNextId = 1;
+	TArray<FGitOfflineEntry> PersistedEntries;
+	if (!GitPersistentFile::Load(JournalFilename, GitOfflineQueueConstants::Magic, GitOfflineQueueConstants::Version, [&InRepositoryRoot, &JournalNextId, &PersistedEntries](FArchive& Reader)
+	{
+		FString JournalRepositoryRoot;
+		Reader << JournalRepositoryRoot;
+		if (JournalRepositoryRoot != InRepositoryRoot)
+		{
+			return false;
+		}
+		Reader << JournalNextId << PersistedEntries;
+		return true;
+	}))
+	{
+		return;
+	}
+	NextId = JournalNextId;
+	Entries = MoveTemp(PersistedEntries);
+	if (Entries.Num() > 0)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("%d operation(s) left by the last session are waiting for the remote"), Entries.Num());
+	}
+}
+
+void FGitOfflineQueue::Save() const
+{
+	FString JournalRepositoryRoot = RepositoryRoot;
+	uint32 JournalNextId = NextId;
+	TArray<FGitOfflineEntry> PersistedEntries = Entries;
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+	Writer << JournalRepositoryRoot << JournalNextId << PersistedEntries;
+	if (!GitPersistentFile::Save(JournalFilename, GitOfflineQueueConstants::Magic, GitOfflineQueueConstants::Version, Buffer))
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Operations waiting for the remote are not persisted: they will be lost if the editor closes before they are sent"));
+	}
+}
+
+bool FGitOfflineQueue::IsRemoteReachable() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bRemoteReachable;
+}
+
+void FGitOfflineQueue::SetRemoteReachable(bool bInReachable)
+{
+	int32 NumPending = 0;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (bRemoteReachable == bInReachable)
+		{
+			return;
+		}
+		bRemoteReachable = bInReachable;
+		NumPending = Entries.Num();
+	}
+	if (this != &Get())
+	{
+		return;
+	}
+
+	FText Message;
+	if (bInReachable)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Git remote reachable again, %d queued operation(s) to replay"), NumPending);
+		Message = LOCTEXT("Git_RemoteReachable", "Git remote reachable again");
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Git remote unreachable: working offline, pushes and locks are queued until it is back"));
+		Message = LOCTEXT("Git_RemoteUnreachable", "Git remote unreachable: working offline");
+	}
+	AsyncTask(ENamedThreads::GameThread, [Message, bInReachable]()
+	{
+		FNotificationInfo Info(Message);
+		Info.ExpireDuration = 5.0f;
+		TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+		if (Notification.IsValid())
+		{
+			Notification->SetCompletionState(bInReachable ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+		}
+	});
+}
+
+bool FGitOfflineQueue::ProbeRemote(const FString& InPathToGitBinary, const FString& InRepositoryRoot)
+{
+	// A single round trip that transfers no objects
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Parameters{TEXT("origin"), TEXT("HEAD")};
+	const bool bReachable = GitSourceControlUtils::RunCommand(TEXT("ls-remote"), InPathToGitBinary, InRepositoryRoot, Parameters,
+															  FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+	SetRemoteReachable(bReachable);
+	return bReachable;
+}
+
+void FGitOfflineQueue::Enqueue(EGitOfflineOperation InOperation, const TArray<FString>& InFiles, const FString& InRef)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+
+	TArray<FString> Files = InFiles;
+	if (InOperation == EGitOfflineOperation::Push)
+	{
+		// A push sends all the local commits of its branch: one is enough until another operation has to follow it
+		if (Entries.Num() > 0 && Entries.Last().Operation == EGitOfflineOperation::Push && Entries.Last().Ref == InRef && Entries.Last().Id != ReplayingId)
+		{
+			return;
+		}
+	}
+	else if (InOperation == EGitOfflineOperation::Unlock)
+	{
+		// A lock that never reached the remote does not need to be released there
+		const TSet<FString> UnlockedFiles(InFiles);
+		for (int32 Index = Entries.Num() - 1; Index >= 0; Index--)
+		{
+			FGitOfflineEntry& Entry = Entries[Index];
+			if (Entry.Operation != EGitOfflineOperation::Lock || Entry.Id == ReplayingId)
+			{
+				continue;
+			}
+			for (int32 FileIndex = Entry.Files.Num() - 1; FileIndex >= 0; FileIndex--)
+			{
+				if (UnlockedFiles.Contains(Entry.Files[FileIndex]))
+				{
+					Files.Remove(Entry.Files[FileIndex]);
+					Entry.Files.RemoveAt(FileIndex);
+				}
+			}
+			if (Entry.Files.Num() == 0)
+			{
+				Entries.RemoveAt(Index);
+			}
+		}
+		if (Files.Num() == 0)
+		{
+			Save();
+			return;
+		}
+	}
+
+	FGitOfflineEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Id = NextId++;
+	Entry.Operation = InOperation;
+	Entry.Files = MoveTemp(Files);
+	Entry.Ref = InRef;
+	Entry.Time = FDateTime::Now();
+	Save();
+}
+
+int32 FGitOfflineQueue::Num() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Entries.Num();
+}
+
+TArray<FGitOfflineEntry> FGitOfflineQueue::GetEntries() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Entries;
+}
+
+void FGitOfflineQueue::Clear()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Entries.Reset();
+	Save();
+}
+
+void FGitOfflineQueue::Complete(uint32 InId, const TArray<FString>& InRemainingFiles)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	ReplayingId = 0;
+	const int32 Index = Entries.IndexOfByPredicate([InId](const FGitOfflineEntry& Entry) { return Entry.Id == InId; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+	if (InRemainingFiles.Num() > 0)
+	{
+		Entries[Index].Files = InRemainingFiles;
+	}
+	else
+	{
+		Entries.RemoveAt(Index);
+	}
+	Save();
+}
+
+bool FGitOfflineQueue::Replay(const FString& InPathToGitBinary, const FString& InRepositoryRoot, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	// Entries may be queued while replaying: take them one at a time, from the front of the journal
+	while (IsRemoteReachable())
+	{
+		FGitOfflineEntry Entry;
+		{
+			FScopeLock ScopeLock(&CriticalSection);
+			if (Entries.Num() == 0)
+			{
+				return true;
+			}
+			Entry = Entries[0];
+			ReplayingId = Entry.Id;
+		}
+
+		TArray<FString> Results;
+		TArray<FString> ErrorMessages;
+		TArray<FString> RemainingFiles;
+		if (Entry.Operation == EGitOfflineOperation::Push)
+		{
+			// The branch committed to when offline, to the remote branch of the same name, whatever is checked out now
+			const TArray<FString> PushParameters{TEXT("-u"), TEXT("--progress"), TEXT("origin"), FString::Printf(TEXT("%s:%s"), *Entry.Ref, *Entry.Ref)};
+			const bool bPushed = GitSourceControlUtils::RunCommand(TEXT("push"), InPathToGitBinary, InRepositoryRoot, PushParameters,
+																   FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+			FGitRevisionCache::Get().InvalidateBranches();
+			if (!bPushed && IsNetworkError(ErrorMessages))
+			{
+				SetRemoteReachable(false);
+				break;
+			}
+			if (!bPushed)
+			{
+				// Most likely out of date: the commits stay local, and the next check in pulls before pushing them
+				OutErrorMessages.Add(FString::Printf(TEXT("The push queued on %s was rejected by the remote:"), *Entry.Time.ToString()));
+				OutErrorMessages.Append(ErrorMessages);
+			}
+		}
+		else
+		{
+			const bool bLock = Entry.Operation == EGitOfflineOperation::Lock;
+			TArray<FString> SucceededFiles;
+			GitSourceControlUtils::RunLFSLockCommand(bLock ? TEXT("lock") : TEXT("unlock"), InRepositoryRoot, InPathToGitBinary, Entry.Files, SucceededFiles, Results, ErrorMessages);
+			const TSet<FString> SucceededSet(SucceededFiles);
+			for (const FString& File : Entry.Files)
+			{
+				if (!SucceededSet.Contains(File))
+				{
+					RemainingFiles.Add(File);
+				}
+			}
+			if (RemainingFiles.Num() > 0 && IsNetworkError(ErrorMessages))
+			{
+				Complete(Entry.Id, RemainingFiles);
+				SetRemoteReachable(false);
+				break;
+			}
+			if (RemainingFiles.Num() > 0)
+			{
+				// Most likely locked by someone else in the meantime: the local lock was only an intent
+				OutErrorMessages.Add(FString::Printf(TEXT("%d file(s) queued on %s could not be %s:"), RemainingFiles.Num(), *Entry.Time.ToString(), bLock ? TEXT("locked") : TEXT("unlocked")));
+				OutErrorMessages.Append(ErrorMessages);
+				if (bLock)
+				{
+					for (const FString& File : RemainingFiles)
+					{
+						FGitLockedFilesCache::RemoveLockedFile(FPaths::Combine(InRepositoryRoot, File));
+					}
+					FGitLockedFilesCache::SaveIndex();
+				}
+				RemainingFiles.Reset();
+			}
+		}
+		OutResults.Append(MoveTemp(Results));
+		Complete(Entry.Id, RemainingFiles);
+	}
+
+	FScopeLock ScopeLock(&CriticalSection);
+	ReplayingId = 0;
+	return Entries.Num() == 0;
+}
+
+bool FGitOfflineQueue::IsNetworkError(const TArray<FString>& InErrorMessages)
+{
+	// From git over ssh, http and file remotes, and from git-lfs
+	static const TCHAR* NetworkMarkers[] = {
+		TEXT("Could not read from remote repository"), TEXT("does not appear to be a git repository"), TEXT("unable to access"),
+		TEXT("Could not resolve host"), TEXT("no such host"), TEXT("connection refused"), TEXT("timed out"), TEXT("network is unreachable"),
+		TEXT("remote end hung up unexpectedly"), TEXT("dial tcp")
+	};
+	for (const FString& ErrorMessage : InErrorMessages)
+	{
+		for (const TCHAR* Marker : NetworkMarkers)
+		{
+			if (ErrorMessage.Contains(Marker))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+#undef LOCTEXT_NAMESPACE
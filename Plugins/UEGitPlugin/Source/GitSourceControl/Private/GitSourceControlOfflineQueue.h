@@ -0,0 +1,101 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/** A remote operation done while the remote was unreachable */
+enum class EGitOfflineOperation : uint8
+{
+	/** Push the local commits of the branch checked out when it was queued */
+	Push,
+	Lock,
+	Unlock,
+};
+
+struct FGitOfflineEntry
+{
+	uint32 Id = 0;
+	EGitOfflineOperation Operation = EGitOfflineOperation::Push;
+	/** Files to lock or unlock, relative to the repository root */
+	TArray<FString> Files;
+	/** Branch to push, as "refs/heads/<name>": HEAD may be on another branch by the time the push is replayed */
+	FString Ref;
+	FDateTime Time;
+
+	friend FArchive& operator<<(FArchive& Ar, FGitOfflineEntry& Entry);
+};
+
+/**
+ * Journal of the remote operations done while offline, replayed in order once the remote is reachable again.
+ *
+ * Commits stay local and lock intents are applied to the local lock index, so that no operation waits on an
+ * unreachable remote. The journal is written to Saved/GitSourceControl at each change, to survive a restart,
+ * and the background refresh probes the remote with a single ls-remote before replaying it.
+ */
+class FGitOfflineQueue
+{
+public:
+	static FGitOfflineQueue& Get();
+
+	/** A queue with a journal file of its own, that does not notify the user: the editor uses Get() */
+	explicit FGitOfflineQueue(const FString& InJournalFilename);
+
+	/** Read the journal left by a previous session in the repository */
+	void Load(const FString& InRepositoryRoot);
+
+	bool IsRemoteReachable() const;
+
+	/** Switch to or from the offline mode, with a notification */
+	void SetRemoteReachable(bool bInReachable);
+
+	/**
+	 * Check whether the remote answers, and update the offline mode
+	 * @returns true if it is reachable
+	 */
+	bool ProbeRemote(const FString& InPathToGitBinary, const FString& InRepositoryRoot);
+
+	/** Record an operation at the end of the journal, merged with the previous ones where possible */
+	void Enqueue(EGitOfflineOperation InOperation, const TArray<FString>& InFiles, const FString& InRef = FString());
+
+	/** Number of operations waiting for the remote */
+	int32 Num() const;
+
+	TArray<FGitOfflineEntry> GetEntries() const;
+
+	/**
+	 * Replay the journal in order, until it is empty or the remote is unreachable again.
+	 * Operations rejected by the remote are reported and dropped: the commits stay local, and the files are no longer locked.
+	 * @returns true if the journal is empty
+	 */
+	bool Replay(const FString& InPathToGitBinary, const FString& InRepositoryRoot, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
+
+	/** Forget the pending operations, without undoing them locally */
+	void Clear();
+
+	/** Whether some git or git-lfs errors mean that the remote could not be reached */
+	static bool IsNetworkError(const TArray<FString>& InErrorMessages);
+
+private:
+	/** Path of the journal of the editor */
+	static FString GetJournalFilename();
+
+	/** Write the journal to a temporary file then move it in place, under the lock */
+	void Save() const;
+
+	/** Remove a replayed entry, or keep only the files that could not be sent */
+	void Complete(uint32 InId, const TArray<FString>& InRemainingFiles);
+
+	mutable FCriticalSection CriticalSection;
+	const FString JournalFilename;
+	FString RepositoryRoot;
+	TArray<FGitOfflineEntry> Entries;
+	uint32 NextId = 1;
+	/** The entry being sent to the remote, that a new operation cannot merge with */
+	uint32 ReplayingId = 0;
+	bool bRemoteReachable = true;
+};
@@ -11,10 +11,13 @@
 #include "ISourceControlModule.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlCommand.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlRevisionCache.h"
 #include "GitSourceControlUtils.h"
 #include "SourceControlHelpers.h"
 #include "Logging/MessageLog.h"
 #include "Misc/MessageDialog.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformProcess.h"
 #include "GenericPlatform/GenericPlatformFile.h"
 #if ENGINE_MAJOR_VERSION >= 5
@@ -27,6 +30,11 @@
 
 #define LOCTEXT_NAMESPACE "GitSourceControl"
 
+static TAutoConsoleVariable<bool> CVarGitBulkRevert(
+	TEXT("git.BulkRevert"),
+	true,
+	TEXT("Revert files with a single status and a single restore (Git 2.25), rather than with a command per category of files."));
+
 FName FGitConnectWorker::GetName() const
 {
 	return "Connect";
@@ -75,14 +83,20 @@ bool FGitConnectWorker::Execute(FGitSourceControlCommand& InCommand)
 	TArray<FString> InfoMessages;
 	TArray<FString> ErrorMessages;
 	InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("ls-remote"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, FGitSourceControlModule::GetEmptyStringArray(), FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (!InCommand.bCommandSuccessful)
+	if (!InCommand.bCommandSuccessful && FGitOfflineQueue::IsNetworkError(ErrorMessages))
+	{
+		// Work offline: pushes and locks are queued until the background refresh reaches the remote again
+		FGitOfflineQueue::Get().SetRemoteReachable(false);
+		InCommand.ResultInfo.InfoMessages.Append(ErrorMessages);
+		InCommand.bCommandSuccessful = true;
+	}
+	else if (!InCommand.bCommandSuccessful)
 	{
 		const FText& NotFound = LOCTEXT("GitRemoteFailed", "Failed Git remote connection. Ensure your repo is initialized, and check your connection to the Git host.");
 		InCommand.ResultInfo.ErrorMessages.Add(NotFound.ToString());
 		Operation->SetErrorText(NotFound);
 	}
 
-	// TODO: always return true, and enter an offline mode if could not connect to remote
 	return InCommand.bCommandSuccessful;
 }
 
@@ -123,19 +137,27 @@ bool FGitCheckOutWorker::Execute(FGitSourceControlCommand& InCommand)
 		return InCommand.bCommandSuccessful;
 	}
 
-	const bool bSuccess = GitSourceControlUtils::RunLFSCommand(TEXT("lock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary, FGitSourceControlModule::GetEmptyStringArray(), LockableRelativeFiles, InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+	TArray<FString> LockedRelativeFiles;
+	const bool bSuccess = GitSourceControlUtils::RunQueuedLFSLockCommand(TEXT("lock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary, LockableRelativeFiles, LockedRelativeFiles, InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
 	InCommand.bCommandSuccessful = bSuccess;
 	const FString& LockUser = FGitSourceControlModule::Get().GetProvider().GetLockUser();
-	if (bSuccess)
+	// Even if some files could not be locked, the others are: keep track of them
+	if (LockedRelativeFiles.Num() > 0)
 	{
+		const TSet<FString> FailedFiles = TSet<FString>(LockableRelativeFiles).Difference(TSet<FString>(LockedRelativeFiles));
 		TArray<FString> AbsoluteFiles;
 		for (const auto& RelativeFile : RelativeFiles)
 		{
+			if (FailedFiles.Contains(RelativeFile))
+			{
+				continue;
+			}
 			FString AbsoluteFile = FPaths::Combine(InCommand.PathToGitRoot, RelativeFile);
 			FGitLockedFilesCache::AddLockedFile(AbsoluteFile, LockUser);
 			FPaths::NormalizeFilename(AbsoluteFile);
 			AbsoluteFiles.Add(AbsoluteFile);
 		}
+		FGitLockedFilesCache::SaveIndex();
 
 		GitSourceControlUtils::CollectNewStates(AbsoluteFiles, States, EFileState::Unset, ETreeState::Unset, ELockState::Locked);
 		for (auto& State : States)
@@ -169,6 +191,21 @@ FName FGitCheckInWorker::GetName() const
 
 const FText EmptyCommitMsg;
 
+/** Record the push of the local commits of the current branch in the offline journal, the check in succeeding locally */
+static void QueuePush(FGitSourceControlCommand& InCommand)
+{
+	FString BranchName;
+	if (!GitSourceControlUtils::GetBranchName(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, BranchName) || BranchName.StartsWith(TEXT("HEAD detached")))
+	{
+		InCommand.ResultInfo.ErrorMessages.Add(TEXT("HEAD is not on a branch: the commit stays local and cannot be queued for push"));
+		InCommand.bCommandSuccessful = false;
+		return;
+	}
+	FGitOfflineQueue::Get().Enqueue(EGitOfflineOperation::Push, FGitSourceControlModule::GetEmptyStringArray(), TEXT("refs/heads/") + BranchName);
+	InCommand.ResultInfo.InfoMessages.Add(TEXT("Push queued until the remote is reachable"));
+	InCommand.bCommandSuccessful = true;
+}
+
 bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 {
 	check(InCommand.Operation->GetName() == GetName());
@@ -179,7 +216,7 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 	bool bDoCommit = InCommand.Files.Num() > 0;
 	const FText& CommitMsg = bDoCommit ? Operation->GetDescription() : EmptyCommitMsg;
 	FGitScopedTempFile CommitMsgFile(CommitMsg);
-	if (CommitMsgFile.GetFilename().Len() > 0)
+	if (CommitMsgFile.IsValid())
 	{
 		FGitSourceControlProvider& Provider = FGitSourceControlModule::Get().GetProvider();
 
@@ -252,14 +289,30 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 
 		TArray<FString> PulledFiles;
 
-		// If we have unpushed files, push
-		if (bUnpushedFiles)
+		// If we have unpushed files, push, unless the remote is unreachable: then the commit stays local until the offline journal is replayed
+		FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+		if (bUnpushedFiles && !OfflineQueue.IsRemoteReachable())
+		{
+			QueuePush(InCommand);
+		}
+		else if (bUnpushedFiles)
 		{
 			// TODO: configure remote
-			TArray<FString> PushParameters {TEXT("-u"), TEXT("origin"), TEXT("HEAD")};
+			TArray<FString> PushParameters {TEXT("-u"), TEXT("--progress"), TEXT("origin"), TEXT("HEAD")};
+			TArray<FString> PushErrorMessages;
 			InCommand.bCommandSuccessful = GitSourceControlUtils::RunCommand(TEXT("push"), InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot,
 																			 PushParameters, FGitSourceControlModule::GetEmptyStringArray(),
-																			 InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+																			 InCommand.ResultInfo.InfoMessages, PushErrorMessages);
+			// The remote branch moved
+			FGitRevisionCache::Get().InvalidateBranches();
+
+			if (!InCommand.bCommandSuccessful && FGitOfflineQueue::IsNetworkError(PushErrorMessages))
+			{
+				OfflineQueue.SetRemoteReachable(false);
+				InCommand.ResultInfo.InfoMessages.Append(MoveTemp(PushErrorMessages));
+				QueuePush(InCommand);
+			}
+			InCommand.ResultInfo.ErrorMessages.Append(MoveTemp(PushErrorMessages));
 
 			if (!InCommand.bCommandSuccessful)
 			{
@@ -338,16 +391,14 @@ bool FGitCheckInWorker::Execute(FGitSourceControlCommand& InCommand)
 					if (FilesToUnlock.Num() > 0)
 					{
 						// Not strictly necessary to succeed, so don't update command success
-						const bool bUnlockSuccess = GitSourceControlUtils::RunLFSCommand(TEXT("unlock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary,
-																						 FGitSourceControlModule::GetEmptyStringArray(), FilesToUnlock,
-																						 InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
-						if (bUnlockSuccess)
+						TArray<FString> UnlockedFiles;
+						GitSourceControlUtils::RunQueuedLFSLockCommand(TEXT("unlock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary, FilesToUnlock, UnlockedFiles,
+																	   InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+						for (const auto& File : GitSourceControlUtils::AbsoluteFilenames(UnlockedFiles, InCommand.PathToGitRoot))
 						{
-							for (const auto& File : LockedFiles)
-							{
-								FGitLockedFilesCache::RemoveLockedFile(File);
-							}
+							FGitLockedFilesCache::RemoveLockedFile(File);
 						}
+						FGitLockedFilesCache::SaveIndex();
 					}
 				}
 #if 0
@@ -518,14 +569,26 @@ bool FGitRevertWorker::Execute(FGitSourceControlCommand& InCommand)
 {
 	InCommand.bCommandSuccessful = true;
 
+	// Git 2.25 restores the files listed in a file: classify them from a single status rather than from their cached states
+	const bool bRevertAll = InCommand.Files.Num() < 1;
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	const bool bBulkRevert = !bRevertAll && CVarGitBulkRevert.GetValueOnAnyThread() && GitSourceControl && GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25);
+
 	// Filter files by status
 	TArray<FString> MissingFiles;
 	TArray<FString> AllExistingFiles;
 	TArray<FString> OtherThanAddedExistingFiles;
-	GetMissingVsExistingFiles(InCommand.Files, MissingFiles, AllExistingFiles, OtherThanAddedExistingFiles);
+	if (!bBulkRevert)
+	{
+		GetMissingVsExistingFiles(InCommand.Files, MissingFiles, AllExistingFiles, OtherThanAddedExistingFiles);
+	}
 
-	const bool bRevertAll = InCommand.Files.Num() < 1;
-	if (bRevertAll)
+	if (bBulkRevert)
+	{
+		InCommand.bCommandSuccessful = GitSourceControlUtils::RunBulkRevert(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.Files, OtherThanAddedExistingFiles,
+																			InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+	}
+	else if (bRevertAll)
 	{
 		TArray<FString> Parms;
 		Parms.Add(TEXT("--hard"));
@@ -579,15 +642,14 @@ bool FGitRevertWorker::Execute(FGitSourceControlCommand& InCommand)
 		if (LockedFiles.Num() > 0)
 		{
 			const TArray<FString>& RelativeFiles = GitSourceControlUtils::RelativeFilenames(LockedFiles, InCommand.PathToGitRoot);
-			InCommand.bCommandSuccessful &= GitSourceControlUtils::RunLFSCommand(TEXT("unlock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary, FGitSourceControlModule::GetEmptyStringArray(), RelativeFiles,
-																				 InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
-			if (InCommand.bCommandSuccessful)
+			TArray<FString> UnlockedFiles;
+			InCommand.bCommandSuccessful &= GitSourceControlUtils::RunQueuedLFSLockCommand(TEXT("unlock"), InCommand.PathToGitRoot, InCommand.PathToGitBinary, RelativeFiles, UnlockedFiles,
+																						   InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+			for (const auto& File : GitSourceControlUtils::AbsoluteFilenames(UnlockedFiles, InCommand.PathToGitRoot))
 			{
-				for (const auto& File : LockedFiles)
-				{
-					FGitLockedFilesCache::RemoveLockedFile(File);
-				}
+				FGitLockedFilesCache::RemoveLockedFile(File);
 			}
+			FGitLockedFilesCache::SaveIndex();
 		}
 	}
 
@@ -671,28 +733,70 @@ FName FGitFetchWorker::GetName() const
 
 bool FGitFetchWorker::Execute(FGitSourceControlCommand& InCommand)
 {
-	InCommand.bCommandSuccessful = GitSourceControlUtils::FetchRemote(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
-																	  InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+	check(InCommand.Operation->GetName() == GetName());
+	TSharedRef<FGitFetch, ESPMode::ThreadSafe> Operation = StaticCastSharedRef<FGitFetch>(InCommand.Operation);
+
+	FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	if (!OfflineQueue.IsRemoteReachable() || OfflineQueue.Num() > 0)
+	{
+		// A cheap probe rather than a fetch waiting on an unreachable remote, then send what was done offline, in order
+		if (OfflineQueue.ProbeRemote(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot))
+		{
+			OfflineQueue.Replay(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+		}
+	}
+
+	bool bRefsMoved = true;
+	if (!OfflineQueue.IsRemoteReachable())
+	{
+		// Offline: the background refresh only updates the local status, against the remote branches fetched last
+		bRefsMoved = false;
+		InCommand.bCommandSuccessful = Operation->bBackgroundRefresh;
+		if (!InCommand.bCommandSuccessful)
+		{
+			InCommand.ResultInfo.ErrorMessages.Add(LOCTEXT("GitFetch_Offline", "The Git remote is unreachable").ToString());
+		}
+	}
+	else if (Operation->bBackgroundRefresh)
+	{
+		InCommand.bCommandSuccessful = GitSourceControlUtils::FetchRemoteRefs(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
+																			  InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages, bRefsMoved);
+	}
+	else
+	{
+		InCommand.bCommandSuccessful = GitSourceControlUtils::FetchRemote(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
+																		  InCommand.ResultInfo.InfoMessages, InCommand.ResultInfo.ErrorMessages);
+	}
 	if (!InCommand.bCommandSuccessful)
 	{
+		if (FGitOfflineQueue::IsNetworkError(InCommand.ResultInfo.ErrorMessages))
+		{
+			OfflineQueue.SetRemoteReachable(false);
+		}
 		return false;
 	}
 
-	check(InCommand.Operation->GetName() == GetName());
-	TSharedRef<FGitFetch, ESPMode::ThreadSafe> Operation = StaticCastSharedRef<FGitFetch>(InCommand.Operation);
-
 	if (Operation->bUpdateStatus)
 	{
 		// Now update the status of all our files
 		const TArray<FString> ProjectDirs = GitSourceControlUtils::GetSourceControlledAssetPaths();
 
+		// Nothing moved since the last refresh: the remote states are still accurate, skip the comparison with the remote branches
 		TMap<FString, FGitSourceControlState> UpdatedStates;
 		InCommand.bCommandSuccessful = GitSourceControlUtils::RunUpdateStatus(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.bUsingGitLfsLocking,
-																			  ProjectDirs, InCommand.ResultInfo.ErrorMessages, UpdatedStates);
+																			  ProjectDirs, InCommand.ResultInfo.ErrorMessages, UpdatedStates, bRefsMoved);
 		GitSourceControlUtils::RemoveRedundantErrors(InCommand, TEXT("' is outside repository"));
 		if (InCommand.bCommandSuccessful)
 		{
 			GitSourceControlUtils::CollectNewStates(UpdatedStates, States);
+			if (!bRefsMoved)
+			{
+				// Keep the remote states found by the previous refresh
+				for (auto& State : States)
+				{
+					State.Value.RemoteState = ERemoteState::Unset;
+				}
+			}
 		}
 	}
 
@@ -892,6 +996,35 @@ bool FGitMoveToChangelistWorker::Execute(FGitSourceControlCommand& InCommand)
 	return bResult;
 }
 
+FName FGitStageSaved::GetName() const
+{
+	return "StageSaved";
+}
+
+FText FGitStageSaved::GetInProgressString() const
+{
+	return LOCTEXT("SourceControl_StageSaved", "Staging the saved files...");
+}
+
+FName FGitStageSavedWorker::GetName() const
+{
+	return "StageSaved";
+}
+
+bool FGitStageSavedWorker::Execute(FGitSourceControlCommand& InCommand)
+{
+	check(InCommand.Operation->GetName() == GetName());
+
+	InCommand.bCommandSuccessful = GitSourceControlUtils::RunStageFiles(InCommand.PathToGitBinary, InCommand.PathToRepositoryRoot, InCommand.Files, InCommand.ResultInfo.ErrorMessages);
+	return InCommand.bCommandSuccessful;
+}
+
+bool FGitStageSavedWorker::UpdateStates() const
+{
+	// The files stay in the "Staged" changelist
+	return false;
+}
+
 FName FGitUpdateStagingWorker::GetName() const
 {
 	return "UpdateChangelistsStatus";
@@ -23,8 +23,25 @@ public:
 	virtual FText GetInProgressString() const override;
 
 	bool bUpdateStatus = false;
+
+	/** Only fetch the branches the states depend on, and only compare with them again if they moved */
+	bool bBackgroundRefresh = false;
 };
 
+#if ENGINE_MAJOR_VERSION == 5
+/**
+ * Internal operation used to stage again the staged files saved in the editor
+ */
+class FGitStageSaved : public ISourceControlOperation
+{
+public:
+	// ISourceControlOperation interface
+	virtual FName GetName() const override;
+
+	virtual FText GetInProgressString() const override;
+};
+#endif
+
 /** Called when first activated on a project, and then at project load time.
  *  Look for the root directory of the git repository (where the ".git/" subdirectory is located). */
 class FGitConnectWorker : public IGitSourceControlWorker
@@ -35,6 +52,7 @@ public:
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
 	virtual bool UpdateStates() const override;
+	virtual bool CanCancel() const override { return true; }
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
@@ -133,6 +151,7 @@ public:
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
 	virtual bool UpdateStates() const override;
+	virtual bool CanCancel() const override { return true; }
 
 public:
 	/** Temporary states for results */
@@ -178,6 +197,7 @@ public:
 	virtual FName GetName() const override;
 	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
 	virtual bool UpdateStates() const override;
+	virtual bool CanCancel() const override { return true; }
 
 	/** Temporary states for results */
 	TMap<const FString, FGitState> States;
@@ -197,6 +217,17 @@ public:
 	TMap<const FString, FGitState> States;
 };
 
+/** git add of the staged files saved in the editor, so that their new content is staged too */
+class FGitStageSavedWorker : public IGitSourceControlWorker
+{
+public:
+	virtual ~FGitStageSavedWorker() {}
+	// IGitSourceControlWorker interface
+	virtual FName GetName() const override;
+	virtual bool Execute(class FGitSourceControlCommand& InCommand) override;
+	virtual bool UpdateStates() const override;
+};
+
 class FGitUpdateStagingWorker: public IGitSourceControlWorker
 {
 public:
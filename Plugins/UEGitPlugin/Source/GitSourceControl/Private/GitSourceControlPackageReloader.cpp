@@ -0,0 +1,220 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlPackageReloader.h"
+
+#include "Containers/Ticker.h"
+#include "Editor.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "PackageTools.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "UObject/Package.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#define LOCTEXT_NAMESPACE "GitSourceControl"
+
+namespace GitPackageReloaderConstants
+{
+/** Time the reload of a chunk of packages should take, to keep the editor responsive */
+const double FrameBudgetSeconds = 0.05;
+/** Size of the first chunk, before the reload time of a package is known */
+const int32 InitialPackagesPerChunk = 8;
+/** Upper bound of a chunk, since each reload ends with a garbage collection */
+const int32 MaxPackagesPerChunk = 256;
+} // namespace GitPackageReloaderConstants
+
+void FGitPackageReloader::Start(const TArray<TWeakObjectPtr<UPackage>>& InPackages, double InUnlinkSeconds)
+{
+	check(IsInGameThread());
+	if (InPackages.Num() == 0)
+	{
+		return;
+	}
+
+	// First tick right away, so that no save happens before the edited packages are reloaded,
+	// then owned by the ticker, until its last tick
+	TSharedRef<FGitPackageReloader> Reloader = MakeShared<FGitPackageReloader>(InPackages, InUnlinkSeconds);
+	if (!Reloader->Tick(0.0f))
+	{
+		return;
+	}
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Reloader](float InDeltaTime)
+	{
+		return Reloader->Tick(InDeltaTime);
+	}));
+}
+
+FGitPackageReloader::FGitPackageReloader(const TArray<TWeakObjectPtr<UPackage>>& InPackages, double InUnlinkSeconds)
+	: PackagesPerChunk(GitPackageReloaderConstants::InitialPackagesPerChunk)
+{
+	// The pull may have deleted some packages, so we need to unload those rather than reload them
+	Packages.Reserve(InPackages.Num());
+	for (const TWeakObjectPtr<UPackage>& WeakPackage : InPackages)
+	{
+		UPackage* Package = WeakPackage.Get();
+		if (!Package)
+		{
+			// Garbage collected since the unlink
+			continue;
+		}
+		const FString PackageExtension = Package->ContainsMap() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+		const FString PackageFilename = FPackageName::LongPackageNameToFilename(Package->GetName(), PackageExtension);
+		if (FPaths::FileExists(PackageFilename))
+		{
+			Packages.Emplace(Package);
+		}
+		else
+		{
+			PackagesToUnload.Emplace(Package);
+		}
+	}
+	// The unlink happened in the same frame, just before the pull started
+	Stats.TotalStallSeconds = InUnlinkSeconds;
+	Stats.MaxFrameStallSeconds = InUnlinkSeconds;
+
+	if (Packages.Num() > PackagesPerChunk)
+	{
+		FNotificationInfo Info(FText::Format(LOCTEXT("Git_ReloadingPackages", "Reloading {0} packages..."), Packages.Num()));
+		Info.bFireAndForget = false;
+		Info.ExpireDuration = 0.0f;
+		Info.FadeOutDuration = 1.0f;
+		Notification = FSlateNotificationManager::Get().AddNotification(Info);
+		if (Notification.IsValid())
+		{
+			Notification.Pin()->SetCompletionState(SNotificationItem::CS_Pending);
+		}
+	}
+}
+
+bool FGitPackageReloader::Tick(float InDeltaTime)
+{
+	const double FrameStartTime = FPlatformTime::Seconds();
+
+	const bool bUnloading = PackagesToUnload.Num() > 0;
+	if (bUnloading)
+	{
+		TArray<UPackage*> Unload;
+		for (const TWeakObjectPtr<UPackage>& Package : PackagesToUnload)
+		{
+			if (UPackage* LoadedPackage = Package.Get())
+			{
+				Unload.Add(LoadedPackage);
+			}
+		}
+		PackagesToUnload.Reset();
+		UPackageTools::UnloadPackages(Unload);
+		Stats.NumUnloaded = Unload.Num();
+	}
+	if (NextPackage < Packages.Num())
+	{
+		// Stale packages being edited are reloaded right away, before they can be saved over the pulled files;
+		// the other ones one chunk per frame, each reload collecting garbage, and not in the frame of the unload
+		const int32 NumEdited = MoveEditedPackagesFirst();
+		const int32 NumPackages = bUnloading ? NumEdited : FMath::Min(FMath::Max(PackagesPerChunk, NumEdited), Packages.Num() - NextPackage);
+		TArray<UPackage*> Chunk;
+		Chunk.Reserve(NumPackages);
+		for (int32 Index = NextPackage; Index < NextPackage + NumPackages; Index++)
+		{
+			if (UPackage* Package = Packages[Index].Get())
+			{
+				Chunk.Add(Package);
+			}
+		}
+		NextPackage += NumPackages;
+		if (Chunk.Num() > 0)
+		{
+			UPackageTools::ReloadPackages(Chunk);
+			Stats.NumReloaded += Chunk.Num();
+		}
+
+		if (NumPackages > 0 && !bUnloading)
+		{
+			const double ChunkSecondsPerPackage = (FPlatformTime::Seconds() - FrameStartTime) / NumPackages;
+			SecondsPerPackage = SecondsPerPackage > 0.0 ? 0.5 * (SecondsPerPackage + ChunkSecondsPerPackage) : ChunkSecondsPerPackage;
+			PackagesPerChunk = SecondsPerPackage > 0.0
+				? FMath::Clamp(FMath::FloorToInt32(GitPackageReloaderConstants::FrameBudgetSeconds / SecondsPerPackage), 1, GitPackageReloaderConstants::MaxPackagesPerChunk)
+				: GitPackageReloaderConstants::MaxPackagesPerChunk;
+		}
+
+		if (TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin())
+		{
+			NotificationItem->SetText(FText::Format(LOCTEXT("Git_ReloadingPackagesProgress", "Reloading packages ({0}/{1})..."), NextPackage, Packages.Num()));
+		}
+	}
+
+	const double FrameStallSeconds = FPlatformTime::Seconds() - FrameStartTime;
+	Stats.NumFrames++;
+	Stats.TotalStallSeconds += FrameStallSeconds;
+	if (Stats.NumFrames == 1)
+	{
+		Stats.MaxFrameStallSeconds += FrameStallSeconds;
+	}
+	else
+	{
+		Stats.MaxFrameStallSeconds = FMath::Max(Stats.MaxFrameStallSeconds, FrameStallSeconds);
+	}
+
+	if (PackagesToUnload.Num() == 0 && NextPackage >= Packages.Num())
+	{
+		Finish();
+		return false;
+	}
+	return true;
+}
+
+int32 FGitPackageReloader::MoveEditedPackagesFirst()
+{
+	// Packages open in an asset editor, or the level open in the editor
+	TSet<const UPackage*> EditedPackages;
+	if (GEditor)
+	{
+		if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+		{
+			for (const UObject* Asset : AssetEditorSubsystem->GetAllEditedAssets())
+			{
+				if (Asset)
+				{
+					EditedPackages.Add(Asset->GetOutermost());
+				}
+			}
+		}
+		if (const UWorld* EditorWorld = GEditor->GetEditorWorldContext().World())
+		{
+			EditedPackages.Add(EditorWorld->GetOutermost());
+		}
+	}
+
+	int32 NumEdited = 0;
+	for (int32 Index = NextPackage; Index < Packages.Num(); Index++)
+	{
+		const UPackage* Package = Packages[Index].Get();
+		if (Package && (Package->IsDirty() || EditedPackages.Contains(Package)))
+		{
+			Packages.Swap(NextPackage + NumEdited, Index);
+			NumEdited++;
+		}
+	}
+	return NumEdited;
+}
+
+void FGitPackageReloader::Finish()
+{
+	UE_LOG(LogSourceControl, Log, TEXT("Reloaded %d and unloaded %d package(s) over %d frame(s): %.3fs stall in total, %.1fms for the longest frame"),
+		Stats.NumReloaded, Stats.NumUnloaded, Stats.NumFrames, Stats.TotalStallSeconds, 1000.0 * Stats.MaxFrameStallSeconds);
+
+	if (TSharedPtr<SNotificationItem> NotificationItem = Notification.Pin())
+	{
+		NotificationItem->SetText(FText::Format(LOCTEXT("Git_ReloadedPackages", "Reloaded {0} packages"), Stats.NumReloaded));
+		NotificationItem->SetCompletionState(SNotificationItem::CS_Success);
+		NotificationItem->ExpireAndFadeout();
+	}
+	Notification.Reset();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,63 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class SNotificationItem;
+class UPackage;
+
+/** Editor stalls caused by a reload of packages */
+struct FGitPackageReloadStats
+{
+	int32 NumReloaded = 0;
+	int32 NumUnloaded = 0;
+	int32 NumFrames = 0;
+	/** Time the game thread spent unlinking and reloading, over all the frames */
+	double TotalStallSeconds = 0.0;
+	double MaxFrameStallSeconds = 0.0;
+};
+
+/**
+ * Reloads the packages updated by a pull in chunks spread across frames, instead of all of them in one blocking call.
+ *
+ * The size of the chunks adapts to the time measured per package to stay within a frame budget,
+ * and a notification shows the progress. Packages that are dirty or open in an editor are reloaded
+ * at the next frame whatever the budget, so that a stale package is not saved over its pulled file.
+ */
+class FGitPackageReloader
+{
+public:
+	/**
+	 * Start reloading packages unlinked before their files were updated, from the game thread
+	 * @param	InPackages			Weak pointers, taken at the unlink: the packages collected since then are skipped
+	 * @param	InUnlinkSeconds		Time spent unlinking them, counted as the stall of the first frame
+	 */
+	static void Start(const TArray<TWeakObjectPtr<UPackage>>& InPackages, double InUnlinkSeconds);
+
+	FGitPackageReloader(const TArray<TWeakObjectPtr<UPackage>>& InPackages, double InUnlinkSeconds);
+
+	/** Reload the next chunks within the frame budget: returns false once done, to be removed from the ticker */
+	bool Tick(float InDeltaTime);
+
+private:
+	/** Move the pending packages that are dirty or open in an editor to the front of the next chunk, returning their number */
+	int32 MoveEditedPackagesFirst();
+
+	void Finish();
+
+	/** Packages to reload, in their order */
+	TArray<TWeakObjectPtr<UPackage>> Packages;
+	int32 NextPackage = 0;
+	/** Packages whose files were deleted by the pull */
+	TArray<TWeakObjectPtr<UPackage>> PackagesToUnload;
+	int32 PackagesPerChunk = 0;
+	/** Average reload time of a package, measured on the previous chunks */
+	double SecondsPerPackage = 0.0;
+	FGitPackageReloadStats Stats;
+	TWeakPtr<SNotificationItem> Notification;
+};
@@ -0,0 +1,92 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlPathTable.h"
+
+#include "Misc/Paths.h"
+
+FGitPathTable& FGitPathTable::Get()
+{
+	static FGitPathTable PathTable;
+	return PathTable;
+}
+
+FGitPathTable::FGitPathTable()
+{
+	// Reserve the first id for the empty string, the default of the names of a file state
+	const int32 Index = Paths.AddElement(FString());
+	Ids.Add(&Paths[Index], (FGitPathId)Index);
+}
+
+FGitPathId FGitPathTable::Intern(const FString& InPath)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FGitPathId* Id = Ids.Find(&InPath))
+		{
+			return *Id;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	// Another thread may have interned it in between
+	if (const FGitPathId* Id = Ids.Find(&InPath))
+	{
+		return *Id;
+	}
+	const int32 Index = Paths.AddElement(InPath);
+	Ids.Add(&Paths[Index], (FGitPathId)Index);
+	return (FGitPathId)Index;
+}
+
+FGitPathId FGitPathTable::InternRelative(const FString& InRepositoryRoot, const FString& InRelativePath)
+{
+	if (!FPaths::IsRelative(InRelativePath) || InRelativePath.Contains(TEXT("..")) || InRelativePath.Contains(TEXT("\\")))
+	{
+		// Not a plain git path: let the engine normalize it
+		return Intern(FPaths::ConvertRelativePathToFull(InRepositoryRoot, InRelativePath));
+	}
+
+	FString Path;
+	Path.Reserve(InRepositoryRoot.Len() + 1 + InRelativePath.Len());
+	Path += InRepositoryRoot;
+	if (!Path.EndsWith(TEXT("/")))
+	{
+		Path += TEXT('/');
+	}
+	Path += InRelativePath;
+	return Intern(Path);
+}
+
+FGitPathId FGitPathTable::Find(const FString& InPath) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const FGitPathId* Id = Ids.Find(&InPath);
+	return Id ? *Id : EmptyId;
+}
+
+const FString& FGitPathTable::GetPath(FGitPathId InId) const
+{
+	FReadScopeLock ReadLock(Lock);
+	// Strings never move once added, so the reference outlives the lock
+	return Paths[(int32)InId];
+}
+
+int32 FGitPathTable::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Paths.Num();
+}
+
+SIZE_T FGitPathTable::GetAllocatedSize() const
+{
+	FReadScopeLock ReadLock(Lock);
+	SIZE_T Size = Paths.GetAllocatedSize() + Ids.GetAllocatedSize();
+	for (int32 Index = 0; Index < Paths.Num(); Index++)
+	{
+		Size += Paths[Index].GetAllocatedSize();
+	}
+	return Size;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlPersistentFile.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFile.h"
+#if ENGINE_MAJOR_VERSION >= 5
+#include "HAL/PlatformFileManager.h"
+#else
+#include "HAL/PlatformFilemanager.h"
+#endif
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryReader.h"
+
+namespace GitPersistentFile
+{
+FString GetFilename(const TCHAR* InName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("GitSourceControl") / InName;
+}
+
+static bool Read(const FString& InFilename, FArchive& InReader, uint32 InMagic, int32 InVersion, TFunctionRef<bool(FArchive& Reader)> InRead)
+{
+	uint32 Magic = 0;
+	int32 Version = 0;
+	InReader << Magic << Version;
+	if (Magic != InMagic || Version != InVersion)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Ignoring outdated '%s'"), *InFilename);
+		return false;
+	}
+	if (!InRead(InReader))
+	{
+		return false;
+	}
+	if (InReader.IsError())
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to read '%s'"), *InFilename);
+		return false;
+	}
+	return true;
+}
+
+bool Load(const FString& InFilename, uint32 InMagic, int32 InVersion, TFunctionRef<bool(FArchive& Reader)> InRead)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*InFilename))
+	{
+		return false;
+	}
+
+	// Read directly from the mapped pages, without copying the file to a buffer first
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*InFilename));
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (MappedRegion.IsValid())
+		{
+			FBufferReader Reader(const_cast<uint8*>(MappedRegion->GetMappedPtr()), MappedRegion->GetMappedSize(), false);
+			return Read(InFilename, Reader, InMagic, InVersion, InRead);
+		}
+	}
+
+	// Not all the platforms can map a file
+	TArray<uint8> Buffer;
+	if (!FFileHelper::LoadFileToArray(Buffer, *InFilename, FILEREAD_Silent))
+	{
+		return false;
+	}
+	FMemoryReader Reader(Buffer);
+	return Read(InFilename, Reader, InMagic, InVersion, InRead);
+}
+
+bool Save(const FString& InFilename, uint32 InMagic, int32 InVersion, const TArray<uint8>& InContent)
+{
+	const FString TempFilename = InFilename + TEXT(".tmp");
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(InFilename), true);
+	bool bWritten = false;
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename, FILEWRITE_Silent));
+		if (Writer)
+		{
+			uint32 Magic = InMagic;
+			int32 Version = InVersion;
+			*Writer << Magic << Version;
+			Writer->Serialize(const_cast<uint8*>(InContent.GetData()), InContent.Num());
+			bWritten = Writer->Close();
+		}
+	}
+	if (!bWritten || !IFileManager::Get().Move(*InFilename, *TempFilename, true, true))
+	{
+		IFileManager::Get().Delete(*TempFilename, false, true, true);
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to write '%s'"), *InFilename);
+		return false;
+	}
+	return true;
+}
+} // namespace GitPersistentFile
@@ -0,0 +1,33 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+ * The binary files kept in Saved/GitSourceControl across the editor sessions: a magic number and a version,
+ * then the content serialized by their owner. A file of another version is ignored, and is replaced by the next save.
+ */
+namespace GitPersistentFile
+{
+/** Full path of a file in Saved/GitSourceControl, like "LfsLocks.bin" */
+FString GetFilename(const TCHAR* InName);
+
+/**
+ * Read a file with the expected header, then its content from the mapped file
+ * @param	InRead		Reads the content after the header, returning false to ignore the file (of another repository for instance)
+ * @returns false if the file does not exist, is outdated, failed to read, or was ignored by InRead
+ */
+bool Load(const FString& InFilename, uint32 InMagic, int32 InVersion, TFunctionRef<bool(FArchive& Reader)> InRead);
+
+/**
+ * Write the header then the content of a file. It is written aside first, then moved over the previous one,
+ * so that a crash never leaves a truncated file behind.
+ * @param	InContent	The content serialized after the header
+ */
+bool Save(const FString& InFilename, uint32 InMagic, int32 InVersion, const TArray<uint8>& InContent);
+} // namespace GitPersistentFile
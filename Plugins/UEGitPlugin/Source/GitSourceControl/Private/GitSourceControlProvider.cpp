@@ -8,13 +8,17 @@
 #include "GitMessageLog.h"
 #include "GitSourceControlState.h"
 #include "Misc/Paths.h"
-#include "Misc/QueuedThreadPool.h"
 #include "GitSourceControlCommand.h"
 #include "ISourceControlModule.h"
 #include "GitSourceControlModule.h"
 #include "GitSourceControlUtils.h"
 #include "SGitSourceControlSettings.h"
 #include "GitSourceControlRunner.h"
+#include "GitSourceControlScheduler.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlReadBackend.h"
+#include "GitSourceControlStartupSnapshot.h"
+#include "GitSourceControlSparseCheckout.h"
 #include "GitSourceControlChangelistState.h"
 #include "Logging/MessageLog.h"
 #include "ScopedSourceControlProgress.h"
@@ -38,6 +42,12 @@
 
 #define LOCTEXT_NAMESPACE "GitSourceControl"
 
+namespace GitSourceControlConstants
+{
+/** The interval at which a synchronous command wakes up to tick its progress dialog */
+const uint32 ProgressTickMs = 50;
+} // namespace GitSourceControlConstants
+
 static FName ProviderName("Git LFS 2");
 
 void FGitSourceControlProvider::Init(bool bForceConnection)
@@ -122,7 +132,47 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 		return;
 	}
 
-	TUniqueFunction<void()> InitFunc = [this]()
+	// Operations queued while offline by the last session, replayed by the background refresh
+	FGitOfflineQueue::Get().Load(PathToRepositoryRoot);
+
+	StartupStats = FGitStartupStats();
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bLfsLockingSetting = bUsingGitLfsLocking;
+
+	// Fast path: reuse the configuration found by the last session, as long as HEAD is still on the same branch.
+	// The same queries run again below in the background, and replace it from the game thread.
+	FGitStartupSnapshot Snapshot;
+	FString HeadBranchName;
+	if (Snapshot.Load(PathToRepositoryRoot) && FGitNativeReadBackend().GetBranchName(PathToRepositoryRoot, HeadBranchName) && HeadBranchName == Snapshot.BranchName)
+	{
+		UserName = Snapshot.UserName;
+		UserEmail = Snapshot.UserEmail;
+		BranchName = Snapshot.BranchName;
+		RemoteBranchName = Snapshot.RemoteBranchName;
+		RemoteUrl = Snapshot.RemoteUrl;
+		GitSourceControlUtils::SetLockableTypes(Snapshot.LockableTypes);
+		bUsingGitLfsLocking = bUsingGitLfsLocking && Snapshot.bUsingGitLfsLocking;
+		if (bUsingGitLfsLocking)
+		{
+			FGitLockedFilesCache::LoadIndex(PathToRepositoryRoot);
+		}
+		StartupStats.bFromSnapshot = true;
+		SetRepositoryAvailable(StartTime);
+	}
+
+	// Configuration read in the background: the provider may already be available from the snapshot, and read by the game thread and the
+	// workers, so it is only assigned on the game thread once complete
+	struct FRepositoryConfig
+	{
+		FString UserName;
+		FString UserEmail;
+		FString BranchName;
+		FString RemoteBranchName;
+		FString RemoteUrl;
+		bool bUsingGitLfsLocking = false;
+	};
+
+	TUniqueFunction<void()> InitFunc = [this, StartTime, bLfsLockingSetting]()
 	{
 		if (!IsInGameThread())
 		{
@@ -138,19 +188,27 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 		}
 
 		// Get user name & email (of the repository, else from the global Git config)
-		GitSourceControlUtils::GetUserConfig(PathToGitBinary, PathToRepositoryRoot, UserName, UserEmail);
+		FRepositoryConfig Config;
+		GitSourceControlUtils::GetUserConfig(PathToGitBinary, PathToRepositoryRoot, Config.UserName, Config.UserEmail);
 		
+		// The sparse-checkout cones restrict the directories to query
+		FGitSparseCheckout::Get().Refresh(PathToGitBinary, PathToRepositoryRoot);
+
 		TMap<FString, FGitSourceControlState> States;
-		auto ConditionalRepoInit = [this, &States]()
+		const TArray<FString> ProjectDirs = GitSourceControlUtils::GetSourceControlledAssetPaths();
+		auto ConditionalRepoInit = [this, &Config, &States, &ProjectDirs, bLfsLockingSetting]()
 		{
-			if (!GitSourceControlUtils::GetBranchName(PathToGitBinary, PathToRepositoryRoot, BranchName))
+			// Query the branches again rather than getting the names cached from the snapshot
+			if (!GitReadBackend::Read(PathToGitBinary, [&](IGitReadBackend& Backend) { return Backend.GetBranchName(PathToRepositoryRoot, Config.BranchName); }))
 			{
 				return false;
 			}
-			GitSourceControlUtils::GetRemoteBranchName(PathToGitBinary, PathToRepositoryRoot, RemoteBranchName);
-			GitSourceControlUtils::GetRemoteUrl(PathToGitBinary, PathToRepositoryRoot, RemoteUrl);
+			GitReadBackend::Read(PathToGitBinary, [&](IGitReadBackend& Backend) { return Backend.GetRemoteBranchName(PathToRepositoryRoot, Config.RemoteBranchName); });
+			GitSourceControlUtils::GetRemoteUrl(PathToGitBinary, PathToRepositoryRoot, Config.RemoteUrl);
 			const TArray<FString> Files{TEXT("*.uasset"), TEXT("*.umap")};
 			TArray<FString> LockableErrorMessages;
+			// Start again from the settings, the .gitattributes may have changed since the snapshot
+			bool bLfsLocking = bLfsLockingSetting;
 			if (!GitSourceControlUtils::CheckLFSLockable(PathToGitBinary, PathToRepositoryRoot, Files, LockableErrorMessages))
 			{
 				for (const auto &ErrorMessage : LockableErrorMessages)
@@ -158,24 +216,30 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 					UE_LOG(LogSourceControl, Error, TEXT("%s"), *ErrorMessage);
 				}
 			}
-			else if (bUsingGitLfsLocking)
+			else if (bLfsLocking)
 			{
 				if (!GitSourceControlUtils::IsFileLFSLockable(".umap")
 					|| !GitSourceControlUtils::IsFileLFSLockable(".uasset"))
 				{
 					UE_LOG(LogSourceControl, Error, TEXT("Git LFS Locking is disabled. Files .uasset or .umap are not lockable. Make sure your .gitattributes is setting lockable attributes for .uasset or .umap at the root of the git repository."));
-					bUsingGitLfsLocking = false;
+					bLfsLocking = false;
 				}
 				else
 				{
 					UE_LOG(LogSourceControl, Log, TEXT("Git LFS Locking is enabled."));
 				}
 			}
+			Config.bUsingGitLfsLocking = bLfsLocking;
 
-			const TArray<FString> ProjectDirs = GitSourceControlUtils::GetSourceControlledAssetPaths();
+			if (bLfsLocking && !FGitLockedFilesCache::IsPopulated())
+			{
+				// Locks known from the last session, refreshed from the server by the background fetch
+				FGitLockedFilesCache::LoadIndex(PathToRepositoryRoot);
+			}
 
+			// Only the local status: the comparison with the remote branches follows once the provider is available
 			TArray<FString> StatusErrorMessages;
-			if (!GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, PathToRepositoryRoot, bUsingGitLfsLocking, ProjectDirs, StatusErrorMessages, States))
+			if (!GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, PathToRepositoryRoot, bLfsLocking, ProjectDirs, StatusErrorMessages, States, false))
 			{
 				return false;
 			}
@@ -183,15 +247,26 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 		};
 		if (ConditionalRepoInit())
 		{
-			TUniqueFunction<void()> SuccessFunc = [States, this]()
+			TUniqueFunction<void()> SuccessFunc = [States, Config, StartTime, this]()
 			{
+				UserName = Config.UserName;
+				UserEmail = Config.UserEmail;
+				BranchName = Config.BranchName;
+				RemoteBranchName = Config.RemoteBranchName;
+				RemoteUrl = Config.RemoteUrl;
+				bUsingGitLfsLocking = Config.bUsingGitLfsLocking;
+
 				TMap<const FString, FGitState> Results;
 				if (GitSourceControlUtils::CollectNewStates(States, Results))
 				{
 					GitSourceControlUtils::UpdateCachedStates(Results);
 				}
-				Runner = new FGitSourceControlRunner();
-				bGitRepositoryFound = true;
+				if (!bGitRepositoryFound)
+				{
+					SetRepositoryAvailable(StartTime);
+				}
+				StartupStats.TimeToStatus = FPlatformTime::Seconds() - StartTime;
+				SaveStartupSnapshot();
 			};
 			if (FApp::IsUnattended() || IsRunningCommandlet())
 			{
@@ -201,13 +276,55 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 			{
 				AsyncTask(ENamedThreads::GameThread, MoveTemp(SuccessFunc));
 			}
+
+			// Then compare the files with the remote branches, and only update the states of those that changed there
+			TArray<FString> RemoteErrorMessages;
+			GitSourceControlUtils::CheckRemote(PathToGitBinary, PathToRepositoryRoot, ProjectDirs, RemoteErrorMessages, States);
+			TMap<const FString, FGitState> RemoteResults;
+			for (const auto& State : States)
+			{
+				if (State.Value.State.RemoteState != ERemoteState::UpToDate)
+				{
+					FGitState& RemoteState = RemoteResults.Add(State.Key);
+					RemoteState.FileState = EFileState::Unset;
+					RemoteState.TreeState = ETreeState::Unset;
+					RemoteState.LockState = ELockState::Unset;
+					RemoteState.RemoteState = State.Value.State.RemoteState;
+					RemoteState.HeadBranch = State.Value.State.HeadBranch;
+				}
+			}
+			TUniqueFunction<void()> RemoteFunc = [RemoteResults, StartTime, this]()
+			{
+				if (RemoteResults.Num() > 0)
+				{
+					GitSourceControlUtils::UpdateCachedStates(RemoteResults);
+					OnSourceControlStateChanged.Broadcast();
+				}
+				StartupStats.TimeToRemoteStatus = FPlatformTime::Seconds() - StartTime;
+				UE_LOG(LogSourceControl, Log, TEXT("Git startup: available in %.3fs%s, status in %.3fs, remote status in %.3fs"), StartupStats.TimeToAvailable,
+					StartupStats.bFromSnapshot ? TEXT(" (from the startup snapshot)") : TEXT(""), StartupStats.TimeToStatus, StartupStats.TimeToRemoteStatus);
+			};
+			if (FApp::IsUnattended() || IsRunningCommandlet())
+			{
+				RemoteFunc();
+			}
+			else
+			{
+				AsyncTask(ENamedThreads::GameThread, MoveTemp(RemoteFunc));
+			}
 		}
 		else
 		{
-			TUniqueFunction<void()> ErrorFunc = [States, this]()
+			TUniqueFunction<void()> ErrorFunc = [Config, this]()
 			{
 				UE_LOG(LogSourceControl, Error, TEXT("Failed to update repo on initialization."));
-				bGitRepositoryFound = false;
+				// Available from the snapshot: HEAD was checked, so let the next status updates try again
+				if (!StartupStats.bFromSnapshot)
+				{
+					UserName = Config.UserName;
+					UserEmail = Config.UserEmail;
+					bGitRepositoryFound = false;
+				}
 			};
 			if (FApp::IsUnattended() || IsRunningCommandlet())
 			{
@@ -230,6 +347,30 @@ void FGitSourceControlProvider::CheckRepositoryStatus()
 	}
 }
 
+void FGitSourceControlProvider::SetRepositoryAvailable(double InStartTime)
+{
+	if (!Runner)
+	{
+		Runner = new FGitSourceControlRunner();
+	}
+	bGitRepositoryFound = true;
+	StartupStats.TimeToAvailable = FPlatformTime::Seconds() - InStartTime;
+}
+
+void FGitSourceControlProvider::SaveStartupSnapshot() const
+{
+	FGitStartupSnapshot Snapshot;
+	Snapshot.RepositoryRoot = PathToRepositoryRoot;
+	Snapshot.UserName = UserName;
+	Snapshot.UserEmail = UserEmail;
+	Snapshot.BranchName = BranchName;
+	Snapshot.RemoteBranchName = RemoteBranchName;
+	Snapshot.RemoteUrl = RemoteUrl;
+	Snapshot.LockableTypes = GitSourceControlUtils::GetLockableTypes();
+	Snapshot.bUsingGitLfsLocking = bUsingGitLfsLocking;
+	Snapshot.Save();
+}
+
 void FGitSourceControlProvider::SetLastErrors(const TArray<FText>& InErrors)
 {
 
@@ -252,8 +393,15 @@ int32 FGitSourceControlProvider::GetNumLastErrors() const
 
 void FGitSourceControlProvider::Close()
 {
+#if ENGINE_MAJOR_VERSION == 5
+	// Do not lose the packages saved during the last coalescing window
+	GitSourceControlUtils::FlushFileStagingOnSaved(true);
+#endif
 	// clear the cache
 	StateCache.Empty();
+	FileStateTable.Empty();
+	// The commands of the force updates in flight are canceled below: don't let the next connection wait on them
+	InFlightForceUpdates.Empty();
 	// Remove all extensions to the "Revision Control" menu in the Editor Toolbar
 	GitSourceControlMenu.Unregister();
 
@@ -266,11 +414,26 @@ void FGitSourceControlProvider::Close()
 		delete Runner;
 		Runner = nullptr;
 	}
+	if (Scheduler)
+	{
+		// Kill the running git queries rather than waiting for them, the commands are collected by Tick()
+		for (FGitSourceControlCommand* Command : CommandQueue)
+		{
+			Command->Cancel();
+		}
+		delete Scheduler;
+		Scheduler = nullptr;
+	}
 }
 
 TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(const FString& Filename)
 {
-	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = StateCache.Find(Filename);
+	return GetStateInternal(FGitPathTable::Get().Intern(Filename));
+}
+
+TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvider::GetStateInternal(FGitPathId InPathId)
+{
+	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>* State = StateCache.Find(InPathId);
 	if (State != NULL)
 	{
 		// found cached item
@@ -278,9 +441,9 @@ TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> FGitSourceControlProvide
 	}
 	else
 	{
-		// cache an unknown state for this item
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> NewState = MakeShareable( new FGitSourceControlState(Filename) );
-		StateCache.Add(Filename, NewState);
+		// cache an unknown state for this item, as a view over its row of the state table
+		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> NewState = MakeShareable( new FGitSourceControlState(InPathId, &FileStateTable) );
+		StateCache.Add(InPathId, NewState);
 		return NewState;
 	}
 }
@@ -328,7 +491,19 @@ FText FGitSourceControlProvider::GetStatusText() const
 
 	Args.Add(TEXT("ErrorText"), FormattedError);
 
-	return FText::Format( NSLOCTEXT("GitStatusText", "{ErrorText}Enabled: {IsAvailable}", "Local repository: {RepositoryName}\nRemote: {RemoteUrl}\nUser: {UserName}\nE-mail: {UserEmail}\n[{BranchName} {CommitId}] {CommitSummary}"), Args );
+	FText OfflineText;
+	const FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	if (!OfflineQueue.IsRemoteReachable())
+	{
+		OfflineText = FText::Format(LOCTEXT("GitOfflineStatusText", "\nOffline: {0} operation(s) waiting for the remote"), OfflineQueue.Num());
+	}
+	else if (OfflineQueue.Num() > 0)
+	{
+		OfflineText = FText::Format(LOCTEXT("GitReplayStatusText", "\n{0} offline operation(s) waiting to be replayed"), OfflineQueue.Num());
+	}
+	Args.Add(TEXT("OfflineText"), OfflineText);
+
+	return FText::Format( NSLOCTEXT("GitStatusText", "{ErrorText}Enabled: {IsAvailable}", "Local repository: {RepositoryName}\nRemote: {RemoteUrl}\nUser: {UserName}\nE-mail: {UserEmail}\n[{BranchName} {CommitId}] {CommitSummary}{OfflineText}"), Args );
 }
 
 /** Quick check if revision control is enabled */
@@ -355,26 +530,31 @@ ECommandResult::Type FGitSourceControlProvider::GetState( const TArray<FString>&
 		return ECommandResult::Failed;
 	}
 
+	const TArray<FString>& AbsoluteFiles = SourceControlHelpers::AbsoluteFilenames(InFiles);
+
 	if (InStateCacheUsage == EStateCacheUsage::ForceUpdate)
 	{
-		TArray<FString> ForceUpdate;
-		for (FString Path : InFiles)
+		ForceUpdateStats.NumRequests++;
+		ForceUpdateStats.NumPathsRequested += AbsoluteFiles.Num();
+		TArray<FString> Files;
+		for (const FString& Path : AbsoluteFiles)
 		{
 			// Remove the path from the cache, so it's not ignored the next time we force check.
-			// If the file isn't in the cache, force update it now.
-			if (!RemoveFileFromIgnoreForceCache(Path))
+			// If the file isn't in the cache, force update it, unless it is already being updated by another force update.
+			const bool bSkipped = RemoveFileFromIgnoreForceCache(Path) || FindInFlightForceUpdate(Path) != nullptr;
+			if (!bSkipped)
 			{
-				ForceUpdate.Add(Path);
+				Files.AddUnique(Path);
 			}
+			ForceUpdateStats.NumPathsSkipped += bSkipped ? 1 : 0;
 		}
-		if (ForceUpdate.Num() > 0)
+		if (Files.Num() > 0)
 		{
-			Execute(ISourceControlOperation::Create<FUpdateStatus>(), ForceUpdate);
+			IssueForceUpdate(Files);
 		}
+		WaitForForceUpdates(AbsoluteFiles);
 	}
 
-	const TArray<FString>& AbsoluteFiles = SourceControlHelpers::AbsoluteFilenames(InFiles);
-
 	for (TArray<FString>::TConstIterator It(AbsoluteFiles); It; It++)
 	{
 		OutState.Add(GetStateInternal(*It));
@@ -416,12 +596,97 @@ TArray<FSourceControlStateRef> FGitSourceControlProvider::GetCachedStateByPredic
 
 bool FGitSourceControlProvider::RemoveFileFromCache(const FString& Filename)
 {
-	return StateCache.Remove(Filename) > 0;
+	const FGitPathId PathId = FGitPathTable::Get().Find(Filename);
+	if (PathId == FGitPathTable::EmptyId)
+	{
+		return false;
+	}
+	FileStateTable.Reset(PathId);
+	return StateCache.Remove(PathId) > 0;
 }
 
 bool FGitSourceControlProvider::AddFileToIgnoreForceCache(const FString& Filename)
 {
-	return IgnoreForceCache.Add(Filename) > 0;
+	bool bAlreadyInCache = false;
+	IgnoreForceCache.Add(Filename, &bAlreadyInCache);
+	return !bAlreadyInCache;
+}
+
+void FGitSourceControlProvider::IssueForceUpdate(const TArray<FString>& InFiles)
+{
+	ForceUpdateStats.NumCommands++;
+
+	// Its completion updates the states of all the callers waiting on it at once, with a single OnSourceControlStateChanged
+	TSharedPtr<IGitSourceControlWorker, ESPMode::ThreadSafe> Worker = CreateWorker("UpdateStatus");
+	FGitSourceControlCommand* Command = new FGitSourceControlCommand(ISourceControlOperation::Create<FUpdateStatus>(), Worker.ToSharedRef());
+	TArray<FString> Files = InFiles;
+	Command->UpdateRepositoryRootIfSubmodule(Files);
+	Command->Files = MoveTemp(Files);
+	Command->bAutoDelete = true;
+	// The game thread blocks on it: don't let it wait behind a background fetch
+	Command->bInteractive = true;
+	IssueCommand(*Command);
+
+	// Queued (else already completed without a worker thread): the other force updates of these files wait on it rather than issuing their own.
+	// The scheduler also merges it with the interactive status updates already pending for the same files.
+	if (CommandQueue.Num() > 0 && CommandQueue.Last() == Command)
+	{
+		for (const FString& File : InFiles)
+		{
+			InFlightForceUpdates.Add(File, Command);
+		}
+	}
+	else
+	{
+		delete Command;
+	}
+}
+
+FGitSourceControlCommand* FGitSourceControlProvider::FindInFlightForceUpdate(const FString& InFile) const
+{
+	FGitSourceControlCommand* const* Command = InFlightForceUpdates.Find(InFile);
+	// A command processed but out of the queue is being completed by a Tick() up the stack (from a completion delegate): waiting on it would never end
+	if (Command == nullptr || ((*Command)->bExecuteProcessed && !CommandQueue.Contains(*Command)))
+	{
+		return nullptr;
+	}
+	return *Command;
+}
+
+void FGitSourceControlProvider::ForgetForceUpdate(const FGitSourceControlCommand& InCommand)
+{
+	for (auto It = InFlightForceUpdates.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == &InCommand)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FGitSourceControlProvider::WaitForForceUpdates(const TArray<FString>& InFiles)
+{
+	// Like a synchronous command, so that the caller gets the updated states, but without a progress dialog
+	while (true)
+	{
+		FGitSourceControlCommand* InFlightCommand = nullptr;
+		for (const FString& File : InFiles)
+		{
+			InFlightCommand = FindInFlightForceUpdate(File);
+			if (InFlightCommand != nullptr)
+			{
+				break;
+			}
+		}
+		if (InFlightCommand == nullptr)
+		{
+			break;
+		}
+
+		// Tick() forgets its files once it is processed
+		InFlightCommand->WaitForCompletion(GitSourceControlConstants::ProgressTickMs);
+		Tick();
+	}
 }
 
 bool FGitSourceControlProvider::RemoveFileFromIgnoreForceCache(const FString& Filename)
@@ -433,9 +698,10 @@ bool FGitSourceControlProvider::RemoveFileFromIgnoreForceCache(const FString& Fi
 TArray<FString> FGitSourceControlProvider::GetFilesInCache()
 {
 	TArray<FString> Files;
+	Files.Reserve(StateCache.Num());
 	for (const auto& State : StateCache)
 	{
-		Files.Add(State.Key);
+		Files.Add(FGitPathTable::Get().GetPath(State.Key));
 	}
 	return Files;
 }
@@ -481,6 +747,14 @@ ECommandResult::Type FGitSourceControlProvider::Execute( const FSourceControlOpe
 		return ECommandResult::Failed;
 	}
 
+#if ENGINE_MAJOR_VERSION == 5
+	// The files saved since the last flush are staged first, so that a command modifying the repository finds them in the index
+	if (!Worker->CanCancel() && InOperation->GetName() != "StageSaved")
+	{
+		GitSourceControlUtils::FlushFileStagingOnSaved(true);
+	}
+#endif
+
 	FGitSourceControlCommand* Command = new FGitSourceControlCommand(InOperation, Worker.ToSharedRef());
 	Command->UpdateRepositoryRootIfSubmodule(AbsoluteFiles);
 	Command->Files = AbsoluteFiles;
@@ -518,18 +792,15 @@ bool FGitSourceControlProvider::CanCancelOperation( const FSourceControlOperatio
 bool FGitSourceControlProvider::CanCancelOperation( const FSourceControlOperationRef& InOperation ) const
 #endif
 {
-	// TODO: maybe support cancellation again?
-#if 0
+	// A canceled command kills the git process it is running, if any, and skips the remaining ones
 	for (int32 CommandIndex = 0; CommandIndex < CommandQueue.Num(); ++CommandIndex)
 	{
 		const FGitSourceControlCommand& Command = *CommandQueue[CommandIndex];
 		if (Command.Operation == InOperation)
 		{
-			check(Command.bAutoDelete);
-			return true;
+			return Command.CanCancel() && !Command.bExecuteProcessed && !Command.IsCanceled();
 		}
 	}
-#endif
 
 	// operation was not in progress!
 	return false;
@@ -546,7 +817,6 @@ void FGitSourceControlProvider::CancelOperation( const FSourceControlOperationRe
 		FGitSourceControlCommand& Command = *CommandQueue[CommandIndex];
 		if (Command.Operation == InOperation)
 		{
-			check(Command.bAutoDelete);
 			Command.Cancel();
 			return;
 		}
@@ -674,52 +944,70 @@ void FGitSourceControlProvider::Tick()
 	}
 #endif
 
+	// Take all the finished commands first, since completion delegates can issue new commands
+	TArray<FGitSourceControlCommand*> FinishedCommands;
 	for (int32 CommandIndex = 0; CommandIndex < CommandQueue.Num(); ++CommandIndex)
 	{
 		FGitSourceControlCommand& Command = *CommandQueue[CommandIndex];
 
 		if (Command.bExecuteProcessed)
 		{
-			// Remove command from the queue
-			CommandQueue.RemoveAt(CommandIndex);
-
-			if (!Command.IsCanceled())
+			FinishedCommands.Add(&Command);
+			CommandQueue.RemoveAt(CommandIndex--);
+		}
+		else if (Command.bCancelled)
+		{
+			if (!Command.bCancelReturned)
 			{
-				// Update repository status on UpdateStatus operations
-				UpdateRepositoryStatus(Command);
-			}
-
-			// let command update the states of any files
-			bStatesUpdated |= Command.Worker->UpdateStates();
-
-			// dump any messages to output log
-			OutputCommandMessages(Command);
+				// If this was a synchronous command, set it free so that it will be deleted automatically
+				// when its (still running) thread finally finishes
+				Command.bAutoDelete = true;
+				Command.bCancelReturned = true;
 
-			// run the completion delegate callback if we have one bound
-			if (!Command.IsCanceled())
-			{
 				Command.ReturnResults();
 			}
-
-			// commands that are left in the array during a tick need to be deleted
-			if(Command.bAutoDelete)
+		}
+		else
+		{
+			FString Phase;
+			int32 Percent;
+			if (Command.ConsumeProgress(Phase, Percent))
 			{
-				// Only delete commands that are not running 'synchronously'
-				delete &Command;
+				CommandProgress.Broadcast(Command.Operation, Phase, Percent);
 			}
-
-			// only do one command per tick loop, as we dont want concurrent modification
-			// of the command queue (which can happen in the completion delegate)
-			break;
 		}
-		else if (Command.bCancelled)
+	}
+
+	for (FGitSourceControlCommand* FinishedCommand : FinishedCommands)
+	{
+		FGitSourceControlCommand& Command = *FinishedCommand;
+
+		if (!Command.IsCanceled())
 		{
-			// If this was a synchronous command, set it free so that it will be deleted automatically
-			// when its (still running) thread finally finishes
-			Command.bAutoDelete = true;
+			// Update repository status on UpdateStatus operations
+			UpdateRepositoryStatus(Command);
+		}
 
+		// let command update the states of any files
+		bStatesUpdated |= Command.Worker->UpdateStates();
+
+		// dump any messages to output log
+		OutputCommandMessages(Command);
+
+		// run the completion delegate callback if we have one bound
+		if (!Command.IsCanceled())
+		{
 			Command.ReturnResults();
-			break;
+		}
+
+		// The force updates of its files are done, even if it was canceled
+		ForgetForceUpdate(Command);
+
+		// commands that are left in the array during a tick need to be deleted
+		if(Command.bAutoDelete)
+		{
+			// Only delete commands that are not running 'synchronously'
+			delete &Command;
 		}
 	}
 
@@ -779,13 +1067,10 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 		TaskText = FText::GetEmpty();
 	}
 
-	int i = 0;
-
 	// Display the progress dialog if a string was provided
 	{
-		// TODO: support cancellation?
-		//FScopedSourceControlProgress Progress(TaskText, FSimpleDelegate::CreateStatic(&Local::CancelCommand, &InCommand));
-		FScopedSourceControlProgress Progress(TaskText);
+		// No cancel button for the commands modifying the repository
+		FScopedSourceControlProgress Progress(TaskText, InCommand.CanCancel() ? FSimpleDelegate::CreateStatic(&Local::CancelCommand, &InCommand) : FSimpleDelegate());
 
 		// Issue the command asynchronously...
 		IssueCommand( InCommand );
@@ -793,24 +1078,25 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 		// ... then wait for its completion (thus making it synchronous)
 		while (!InCommand.IsCanceled() && CommandQueue.Contains(&InCommand))
 		{
+			// Sleep until the command signals its completion, waking up regularly to keep the progress dialog (and its cancel button) responsive
+			InCommand.WaitForCompletion(GitSourceControlConstants::ProgressTickMs);
+
 			// Tick the command queue and update progress.
 			Tick();
-
-			if (i >= 20) {
-				Progress.Tick();
-				i = 0;
-			}
-			i++;
-
-			// Sleep for a bit so we don't busy-wait so much.
-			FPlatformProcess::Sleep(0.01f);
+			Progress.Tick();
 		}
 
 		if (InCommand.bCancelled)
 		{
 			Result = ECommandResult::Cancelled;
+			if (CommandQueue.Contains(&InCommand))
+			{
+				// The worker thread is still unwinding: the command will be deleted by Tick() once it is done
+				InCommand.bAutoDelete = true;
+				InCommand.bCancelReturned = true;
+			}
 		}
-		if (InCommand.bCommandSuccessful)
+		else if (InCommand.bCommandSuccessful)
 		{
 			Result = ECommandResult::Succeeded;
 		}
@@ -824,6 +1110,7 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 	// Delete the command now if not marked as auto-delete
 	if (!InCommand.bAutoDelete)
 	{
+		ForgetForceUpdate(InCommand);
 		delete &InCommand;
 	}
 
@@ -832,12 +1119,17 @@ ECommandResult::Type FGitSourceControlProvider::ExecuteSynchronousCommand(FGitSo
 
 ECommandResult::Type FGitSourceControlProvider::IssueCommand(FGitSourceControlCommand& InCommand, const bool bSynchronous)
 {
-	if (!bSynchronous && GThreadPool != nullptr)
+	if (!bSynchronous && FPlatformProcess::SupportsMultithreading())
 	{
+		if (Scheduler == nullptr)
+		{
+			Scheduler = new FGitCommandScheduler();
+		}
+
 		// Queue this to our worker thread(s) for resolving.
 		// When asynchronous, any callback gets called from Tick().
-		GThreadPool->AddQueuedWork(&InCommand);
 		CommandQueue.Add(&InCommand);
+		Scheduler->Schedule(InCommand);
 		return ECommandResult::Succeeded;
 	}
 	else
@@ -0,0 +1,1740 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlReadBackend.h"
+
+#include "GitSourceControlModule.h"
+#include "GitSourceControlSparseCheckout.h"
+#include "GitSourceControlUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace GitReadBackendConstants
+{
+/** Symbolic refs pointing to symbolic refs are followed up to this depth */
+const int32 MaxSymbolicRefDepth = 5;
+/** Objects are only inflated to read commits: anything bigger is left to git */
+const int32 MaxObjectSize = 16 * 1024 * 1024;
+/** Longest delta chain followed in a pack, as written by "git gc --aggressive" */
+const int32 MaxDeltaDepth = 250;
+/** Size of the reads of compressed data from a pack */
+const int32 PackReadSize = 64 * 1024;
+/** Size of a SHA-1 object id, the only one of the version 2 pack indexes read */
+const int32 ObjectIdSize = 20;
+/** Size of the SHA-1 trailing the index */
+const int32 IndexChecksumSize = 20;
+/** Types of the deltas in a pack, against an offset in the same pack or against an object id */
+const uint8 PackOfsDelta = 6;
+const uint8 PackRefDelta = 7;
+/** Enough inflated bytes for the header of a loose object, or for the sizes at the start of a delta */
+const int32 ObjectHeaderSize = 64;
+/** Revisions of a history, as the "--max-count" of the git command line */
+const int32 MaxHistoryCount = 250;
+} // namespace GitReadBackendConstants
+
+FGitCliReadBackend::FGitCliReadBackend(const FString& InPathToGitBinary)
+	: PathToGitBinary(InPathToGitBinary)
+{
+}
+
+bool FGitCliReadBackend::GetBranchName(const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	bool bResults;
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("--short"));
+	Parameters.Add(TEXT("--quiet")); // no error message while in detached HEAD
+	Parameters.Add(TEXT("HEAD"));
+	bResults = GitSourceControlUtils::RunCommand(TEXT("symbolic-ref"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		OutBranchName = InfoMessages[0];
+	}
+	else
+	{
+		Parameters.Reset(2);
+		Parameters.Add(TEXT("-1"));
+		Parameters.Add(TEXT("--format=\"%h\"")); // no error message while in detached HEAD
+		bResults = GitSourceControlUtils::RunCommand(TEXT("log"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+		if (bResults && InfoMessages.Num() > 0)
+		{
+			OutBranchName = "HEAD detached at ";
+			OutBranchName += InfoMessages[0];
+		}
+		else
+		{
+			bResults = false;
+		}
+	}
+
+	return bResults;
+}
+
+bool FGitCliReadBackend::GetRemoteBranchName(const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("--abbrev-ref"));
+	Parameters.Add(TEXT("--symbolic-full-name"));
+	Parameters.Add(TEXT("@{u}"));
+	const bool bResults = GitSourceControlUtils::RunCommand(TEXT("rev-parse"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(),
+															InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		OutBranchName = InfoMessages[0];
+	}
+	return bResults;
+}
+
+bool FGitCliReadBackend::GetCommitInfo(const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary)
+{
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("-1"));
+	Parameters.Add(TEXT("--format=\"%H %s\""));
+	const bool bResults = GitSourceControlUtils::RunCommand(TEXT("log"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		// The whole commit id, of 40 or 64 hexadecimal digits, then the subject
+		if (!InfoMessages[0].Split(TEXT(" "), &OutCommitId, &OutCommitSummary))
+		{
+			OutCommitId = InfoMessages[0];
+			OutCommitSummary.Empty();
+		}
+	}
+
+	return bResults;
+}
+
+bool FGitCliReadBackend::GetRemoteUrl(const FString& InRepositoryRoot, FString& OutRemoteUrl)
+{
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("get-url"));
+	Parameters.Add(TEXT("origin"));
+	const bool bResults = GitSourceControlUtils::RunCommand(TEXT("remote"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		OutRemoteUrl = InfoMessages[0];
+	}
+
+	return bResults;
+}
+
+bool FGitCliReadBackend::GetUserConfig(const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail)
+{
+	bool bResults;
+	TArray<FString> InfoMessages;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("user.name"));
+	bResults = GitSourceControlUtils::RunCommand(TEXT("config"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		OutUserName = InfoMessages[0];
+	}
+	else
+	{
+		OutUserName = TEXT("");
+	}
+
+	Parameters.Reset(1);
+	Parameters.Add(TEXT("user.email"));
+	InfoMessages.Reset();
+	bResults &= GitSourceControlUtils::RunCommand(TEXT("config"), PathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
+	if (bResults && InfoMessages.Num() > 0)
+	{
+		OutUserEmail = InfoMessages[0];
+	}
+	else
+	{
+		OutUserEmail = TEXT("");
+	}
+
+	return bResults;
+}
+
+bool FGitCliReadBackend::ListFiles(const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles)
+{
+	TArray<FString> ErrorMessages;
+	TArray<FString> Directory;
+	Directory.Add(InDirectory);
+	return GitSourceControlUtils::RunCommand(TEXT("ls-files"), PathToGitBinary, InRepositoryRoot, FGitSourceControlModule::GetEmptyStringArray(), Directory, OutFiles, ErrorMessages);
+}
+
+bool FGitCliReadBackend::CheckLockable(const FString& InRepositoryRoot, const TArray<FString>& InWildcards, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	TArray<FString> Parameters;
+	Parameters.Add(TEXT("lockable"));
+	return GitSourceControlUtils::RunCommand(TEXT("check-attr"), PathToGitBinary, InRepositoryRoot, Parameters, InWildcards, OutResults, OutErrorMessages);
+}
+
+bool FGitCliReadBackend::GetHistory(const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TGitSourceControlHistory& OutHistory, TArray<FString>& OutErrorMessages)
+{
+	return GitSourceControlUtils::RunLogHistory(PathToGitBinary, InRepositoryRoot, InFile, bMergeConflict, OutErrorMessages, OutHistory);
+}
+
+bool FGitNativeReadBackend::GetCommonDir(const FString& InRepositoryRoot, FString& OutCommonDir)
+{
+	FGitDirs Dirs;
+	if (!FindGitDirs(InRepositoryRoot, Dirs))
+	{
+		return false;
+	}
+	OutCommonDir = MoveTemp(Dirs.CommonDir);
+	return true;
+}
+
+bool FGitNativeReadBackend::FindGitDirs(const FString& InRepositoryRoot, FGitDirs& OutDirs)
+{
+	const FString DotGit = InRepositoryRoot / TEXT(".git");
+	if (IFileManager::Get().DirectoryExists(*DotGit))
+	{
+		OutDirs.GitDir = DotGit;
+	}
+	else
+	{
+		// Linked worktree or submodule: ".git" is a file pointing to the actual git directory
+		FString Content;
+		if (!FFileHelper::LoadFileToString(Content, *DotGit, FFileHelper::EHashOptions::None, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Content.TrimStartAndEndInline();
+		if (!Content.StartsWith(TEXT("gitdir:")))
+		{
+			return false;
+		}
+		OutDirs.GitDir = Content.RightChop(7).TrimStartAndEnd();
+		if (FPaths::IsRelative(OutDirs.GitDir))
+		{
+			OutDirs.GitDir = InRepositoryRoot / OutDirs.GitDir;
+		}
+		FPaths::CollapseRelativeDirectories(OutDirs.GitDir);
+	}
+
+	// A linked worktree shares the refs, objects and config of the main repository
+	FString CommonDir;
+	if (FFileHelper::LoadFileToString(CommonDir, *(OutDirs.GitDir / TEXT("commondir")), FFileHelper::EHashOptions::None, FILEREAD_Silent))
+	{
+		CommonDir.TrimStartAndEndInline();
+		OutDirs.CommonDir = FPaths::IsRelative(CommonDir) ? OutDirs.GitDir / CommonDir : CommonDir;
+		FPaths::CollapseRelativeDirectories(OutDirs.CommonDir);
+	}
+	else
+	{
+		OutDirs.CommonDir = OutDirs.GitDir;
+	}
+	return true;
+}
+
+bool FGitNativeReadBackend::ReadConfig(const FString& InFilename, FGitConfig& OutConfig)
+{
+	FString Content;
+	if (!FFileHelper::LoadFileToString(Content, *InFilename, FFileHelper::EHashOptions::None, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	TArray<FString> Lines;
+	Content.ParseIntoArrayLines(Lines);
+	FString Section;
+	for (const FString& RawLine : Lines)
+	{
+		const FString Line = RawLine.TrimStartAndEnd();
+		if (Line.IsEmpty() || Line[0] == TEXT('#') || Line[0] == TEXT(';'))
+		{
+			continue;
+		}
+		if (Line.EndsWith(TEXT("\\")))
+		{
+			// Continuation lines
+			OutConfig.bIsSupported = false;
+			continue;
+		}
+
+		FString Rest = Line;
+		if (Rest[0] == TEXT('['))
+		{
+			int32 EndIndex;
+			if (!Rest.FindChar(TEXT(']'), EndIndex))
+			{
+				OutConfig.bIsSupported = false;
+				continue;
+			}
+			const FString Header = Rest.Mid(1, EndIndex - 1).TrimStartAndEnd();
+			int32 QuoteIndex;
+			if (Header.FindChar(TEXT('"'), QuoteIndex))
+			{
+				// [section "subsection"]: the subsection is case sensitive
+				FString Subsection = Header.Mid(QuoteIndex + 1);
+				Subsection.RemoveFromEnd(TEXT("\""));
+				Subsection.ReplaceInline(TEXT("\\\""), TEXT("\""));
+				Subsection.ReplaceInline(TEXT("\\\\"), TEXT("\\"));
+				Section = Header.Left(QuoteIndex).TrimEnd().ToLower() + TEXT(".") + Subsection;
+			}
+			else
+			{
+				// [section] or the deprecated [section.subsection]
+				Section = Header.ToLower();
+			}
+			if (Section == TEXT("include") || Section.StartsWith(TEXT("includeif.")))
+			{
+				OutConfig.bIsSupported = false;
+			}
+			Rest = Rest.Mid(EndIndex + 1).TrimStart();
+			if (Rest.IsEmpty() || Rest[0] == TEXT('#') || Rest[0] == TEXT(';'))
+			{
+				continue;
+			}
+		}
+
+		// name = value, or a lone name for a boolean true
+		FString Name;
+		FString Value;
+		if (!Rest.Split(TEXT("="), &Name, &Value))
+		{
+			Name = Rest;
+			Value = TEXT("true");
+		}
+		else
+		{
+			FString Unquoted;
+			bool bInQuotes = false;
+			Value.TrimStartInline();
+			for (int32 Index = 0; Index < Value.Len(); Index++)
+			{
+				const TCHAR Char = Value[Index];
+				if (Char == TEXT('"'))
+				{
+					bInQuotes = !bInQuotes;
+				}
+				else if (Char == TEXT('\\') && Index + 1 < Value.Len())
+				{
+					const TCHAR Escaped = Value[++Index];
+					Unquoted += Escaped == TEXT('n') ? TEXT('\n') : Escaped == TEXT('t') ? TEXT('\t') : Escaped;
+				}
+				else if (!bInQuotes && (Char == TEXT('#') || Char == TEXT(';')))
+				{
+					break;
+				}
+				else
+				{
+					Unquoted += Char;
+				}
+			}
+			Value = Unquoted.TrimEnd();
+		}
+		const FString Key = Section + TEXT(".") + Name.TrimStartAndEnd().ToLower();
+		// The last value wins, as with "git config <name>"
+		OutConfig.Values.Add(Key, Value);
+	}
+	return true;
+}
+
+FString FGitNativeReadBackend::GetHomeDir()
+{
+	FString Home = FPlatformMisc::GetEnvironmentVariable(TEXT("HOME"));
+	if (Home.IsEmpty())
+	{
+		Home = FPlatformMisc::GetEnvironmentVariable(TEXT("USERPROFILE"));
+	}
+	return Home;
+}
+
+FString FGitNativeReadBackend::GetXdgConfigHome()
+{
+	FString XdgConfigHome = FPlatformMisc::GetEnvironmentVariable(TEXT("XDG_CONFIG_HOME"));
+	if (XdgConfigHome.IsEmpty())
+	{
+		const FString Home = GetHomeDir();
+		if (!Home.IsEmpty())
+		{
+			XdgConfigHome = Home / TEXT(".config");
+		}
+	}
+	return XdgConfigHome;
+}
+
+bool FGitNativeReadBackend::ReadGlobalConfig(FGitConfig& OutConfig)
+{
+	// An explicit global config file, or none at all, is left to git
+	if (!FPlatformMisc::GetEnvironmentVariable(TEXT("GIT_CONFIG_GLOBAL")).IsEmpty())
+	{
+		return false;
+	}
+	const FString Home = GetHomeDir();
+	const FString XdgConfigHome = GetXdgConfigHome();
+
+	// Either file may not exist
+	if (!XdgConfigHome.IsEmpty())
+	{
+		ReadConfig(XdgConfigHome / TEXT("git/config"), OutConfig);
+	}
+	if (!Home.IsEmpty())
+	{
+		ReadConfig(Home / TEXT(".gitconfig"), OutConfig);
+	}
+	return OutConfig.bIsSupported;
+}
+
+bool FGitNativeReadBackend::ReadSymbolicHead(const FGitDirs& InDirs, FString& OutRef)
+{
+	FString Head;
+	if (!FFileHelper::LoadFileToString(Head, *(InDirs.GitDir / TEXT("HEAD")), FFileHelper::EHashOptions::None, FILEREAD_Silent))
+	{
+		return false;
+	}
+	Head.TrimStartAndEndInline();
+	if (!Head.StartsWith(TEXT("ref:")))
+	{
+		// Detached HEAD
+		return false;
+	}
+	OutRef = Head.RightChop(4).TrimStart();
+	return true;
+}
+
+bool FGitNativeReadBackend::ResolveRef(const FGitDirs& InDirs, const FString& InRef, FString& OutSha)
+{
+	FString Ref = InRef;
+	for (int32 Depth = 0; Depth < GitReadBackendConstants::MaxSymbolicRefDepth; Depth++)
+	{
+		// HEAD is per worktree, the branches are shared
+		const FString& RefDir = Ref == TEXT("HEAD") ? InDirs.GitDir : InDirs.CommonDir;
+		FString Content;
+		if (FFileHelper::LoadFileToString(Content, *(RefDir / Ref), FFileHelper::EHashOptions::None, FILEREAD_Silent))
+		{
+			Content.TrimStartAndEndInline();
+			if (Content.StartsWith(TEXT("ref:")))
+			{
+				Ref = Content.RightChop(4).TrimStart();
+				continue;
+			}
+			if (GitSourceControlUtils::IsObjectId(Content))
+			{
+				OutSha = MoveTemp(Content);
+				return true;
+			}
+			return false;
+		}
+
+		// Not a loose ref: look into the packed refs, "<sha> <ref>" lines possibly followed by "^<peeled sha>" ones
+		FString PackedRefs;
+		if (!FFileHelper::LoadFileToString(PackedRefs, *(InDirs.CommonDir / TEXT("packed-refs")), FFileHelper::EHashOptions::None, FILEREAD_Silent))
+		{
+			return false;
+		}
+		TArray<FString> Lines;
+		PackedRefs.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			if (Line.IsEmpty() || Line[0] == TEXT('#') || Line[0] == TEXT('^'))
+			{
+				continue;
+			}
+			FString Sha;
+			FString Name;
+			if (Line.Split(TEXT(" "), &Sha, &Name) && Name == Ref && GitSourceControlUtils::IsObjectId(Sha))
+			{
+				OutSha = MoveTemp(Sha);
+				return true;
+			}
+		}
+		return false;
+	}
+	return false;
+}
+
+bool FGitNativeReadBackend::ReadLooseObject(const FGitDirs& InDirs, const FString& InSha, FString& OutType, TArray<uint8>& OutContent)
+{
+	const FString ObjectFilename = InDirs.CommonDir / TEXT("objects") / InSha.Left(2) / InSha.RightChop(2);
+	TArray<uint8> Compressed;
+	if (!FFileHelper::LoadFileToArray(Compressed, *ObjectFilename, FILEREAD_Silent))
+	{
+		// Most likely in a pack
+		return false;
+	}
+
+	z_stream Stream;
+	FMemory::Memzero(Stream);
+	Stream.next_in = Compressed.GetData();
+	Stream.avail_in = Compressed.Num();
+	if (inflateInit(&Stream) != Z_OK)
+	{
+		return false;
+	}
+	TArray<uint8> Inflated;
+	int32 InflatedSize = 0;
+	int Result = Z_OK;
+	while (Result == Z_OK && InflatedSize < GitReadBackendConstants::MaxObjectSize)
+	{
+		const int32 ChunkSize = FMath::Max(Compressed.Num() * 2, 4096);
+		Inflated.SetNumUninitialized(InflatedSize + ChunkSize);
+		Stream.next_out = Inflated.GetData() + InflatedSize;
+		Stream.avail_out = ChunkSize;
+		Result = inflate(&Stream, Z_NO_FLUSH);
+		InflatedSize += ChunkSize - Stream.avail_out;
+	}
+	inflateEnd(&Stream);
+	if (Result != Z_STREAM_END)
+	{
+		return false;
+	}
+
+	// "<type> <size>\0<content>"
+	int32 HeaderEnd = INDEX_NONE;
+	for (int32 Index = 0; Index < InflatedSize; Index++)
+	{
+		if (Inflated[Index] == 0)
+		{
+			HeaderEnd = Index;
+			break;
+		}
+	}
+	if (HeaderEnd == INDEX_NONE)
+	{
+		return false;
+	}
+	const FString Header(HeaderEnd, (const ANSICHAR*)Inflated.GetData());
+	if (!Header.Split(TEXT(" "), &OutType, nullptr))
+	{
+		return false;
+	}
+	OutContent = TArray<uint8>(Inflated.GetData() + HeaderEnd + 1, InflatedSize - HeaderEnd - 1);
+	return true;
+}
+
+static uint32 ReadBigEndian32(const uint8* InData)
+{
+	return ((uint32)InData[0] << 24) | ((uint32)InData[1] << 16) | ((uint32)InData[2] << 8) | (uint32)InData[3];
+}
+
+static uint16 ReadBigEndian16(const uint8* InData)
+{
+	return (uint16)(((uint32)InData[0] << 8) | (uint32)InData[1]);
+}
+
+static uint64 ReadBigEndian64(const uint8* InData)
+{
+	return ((uint64)ReadBigEndian32(InData) << 32) | (uint64)ReadBigEndian32(InData + 4);
+}
+
+/** Inflate a zlib stream of a known size, read from an archive up to its end */
+static bool InflateFromArchive(FArchive& InReader, int32 InSize, TArray<uint8>& OutData)
+{
+	z_stream Stream;
+	FMemory::Memzero(Stream);
+	if (inflateInit(&Stream) != Z_OK)
+	{
+		return false;
+	}
+	// One more byte than expected, so that the end of the stream can be read even for an empty object
+	OutData.SetNumUninitialized(InSize + 1);
+	Stream.next_out = OutData.GetData();
+	Stream.avail_out = OutData.Num();
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(GitReadBackendConstants::PackReadSize);
+	int Result = Z_OK;
+	while (Result == Z_OK)
+	{
+		if (Stream.avail_in == 0)
+		{
+			const int64 Remaining = InReader.TotalSize() - InReader.Tell();
+			if (Remaining <= 0)
+			{
+				break;
+			}
+			const int32 ReadSize = (int32)FMath::Min<int64>(Remaining, Compressed.Num());
+			InReader.Serialize(Compressed.GetData(), ReadSize);
+			Stream.next_in = Compressed.GetData();
+			Stream.avail_in = ReadSize;
+		}
+		Result = inflate(&Stream, Z_NO_FLUSH);
+	}
+	const bool bComplete = Result == Z_STREAM_END && Stream.total_out == (uLong)InSize;
+	inflateEnd(&Stream);
+	OutData.SetNum(InSize);
+	return bComplete && !InReader.IsError();
+}
+
+/** Inflate the start of a zlib stream read from an archive, up to a number of bytes */
+static bool InflatePrefix(FArchive& InReader, int32 InMaxSize, TArray<uint8>& OutData)
+{
+	z_stream Stream;
+	FMemory::Memzero(Stream);
+	if (inflateInit(&Stream) != Z_OK)
+	{
+		return false;
+	}
+	OutData.SetNumUninitialized(InMaxSize);
+	Stream.next_out = OutData.GetData();
+	Stream.avail_out = InMaxSize;
+	uint8 Compressed[GitReadBackendConstants::ObjectHeaderSize];
+	int Result = Z_OK;
+	while (Result == Z_OK && Stream.avail_out > 0)
+	{
+		if (Stream.avail_in == 0)
+		{
+			const int64 Remaining = InReader.TotalSize() - InReader.Tell();
+			if (Remaining <= 0)
+			{
+				break;
+			}
+			const int32 ReadSize = (int32)FMath::Min<int64>(Remaining, sizeof(Compressed));
+			InReader.Serialize(Compressed, ReadSize);
+			Stream.next_in = Compressed;
+			Stream.avail_in = ReadSize;
+		}
+		Result = inflate(&Stream, Z_NO_FLUSH);
+	}
+	const bool bInflated = (Result == Z_OK || Result == Z_STREAM_END) && !InReader.IsError();
+	OutData.SetNum(InMaxSize - Stream.avail_out);
+	inflateEnd(&Stream);
+	return bInflated;
+}
+
+/** Sizes at the start of a delta: 7 bits per byte, least significant first */
+static bool ReadDeltaSize(const TArray<uint8>& InDelta, int32& InOutPosition, uint64& OutSize)
+{
+	OutSize = 0;
+	for (int32 Shift = 0; InOutPosition < InDelta.Num() && Shift < 64; Shift += 7)
+	{
+		const uint8 Byte = InDelta[InOutPosition++];
+		OutSize |= (uint64)(Byte & 0x7f) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Rebuild an object from its base and a delta: a sequence of copies from the base and of inserted bytes */
+static bool ApplyDelta(const TArray<uint8>& InBase, const TArray<uint8>& InDelta, TArray<uint8>& OutResult)
+{
+	int32 Position = 0;
+	uint64 BaseSize;
+	uint64 ResultSize;
+	if (!ReadDeltaSize(InDelta, Position, BaseSize) || !ReadDeltaSize(InDelta, Position, ResultSize)
+		|| BaseSize != (uint64)InBase.Num() || ResultSize > (uint64)GitReadBackendConstants::MaxObjectSize)
+	{
+		return false;
+	}
+	OutResult.Reset(ResultSize);
+	while (Position < InDelta.Num())
+	{
+		const uint8 Instruction = InDelta[Position++];
+		if (Instruction & 0x80)
+		{
+			// Copy: the bits 0 to 3 tell which bytes of the offset follow, the bits 4 to 6 which bytes of the size
+			uint32 CopyOffset = 0;
+			uint32 CopySize = 0;
+			for (int32 Byte = 0; Byte < 7; Byte++)
+			{
+				if (Instruction & (1 << Byte))
+				{
+					if (Position >= InDelta.Num())
+					{
+						return false;
+					}
+					uint32& Value = Byte < 4 ? CopyOffset : CopySize;
+					Value |= (uint32)InDelta[Position++] << (8 * (Byte < 4 ? Byte : Byte - 4));
+				}
+			}
+			if (CopySize == 0)
+			{
+				CopySize = 0x10000;
+			}
+			if ((uint64)CopyOffset + CopySize > (uint64)InBase.Num())
+			{
+				return false;
+			}
+			OutResult.Append(InBase.GetData() + CopyOffset, CopySize);
+		}
+		else if (Instruction != 0)
+		{
+			// Insert the next bytes of the delta
+			if (Position + Instruction > InDelta.Num())
+			{
+				return false;
+			}
+			OutResult.Append(InDelta.GetData() + Position, Instruction);
+			Position += Instruction;
+		}
+		else
+		{
+			// Reserved
+			return false;
+		}
+	}
+	return (uint64)OutResult.Num() == ResultSize;
+}
+
+bool FGitNativeReadBackend::ReadObject(const FGitDirs& InDirs, const FString& InSha, FString& OutType, TArray<uint8>& OutContent, int32 InDeltaDepth)
+{
+	if (ReadLooseObject(InDirs, InSha, OutType, OutContent))
+	{
+		return true;
+	}
+	FString PackFilename;
+	int64 Offset;
+	return FindPackedObject(InDirs, InSha, PackFilename, Offset) && ReadPackedObject(InDirs, PackFilename, Offset, InDeltaDepth, OutType, OutContent);
+}
+
+bool FGitNativeReadBackend::FindPackedObject(const FGitDirs& InDirs, const FString& InSha, FString& OutPackFilename, int64& OutOffset)
+{
+	uint8 Id[GitReadBackendConstants::ObjectIdSize];
+	if (InSha.Len() != 2 * GitReadBackendConstants::ObjectIdSize || HexToBytes(InSha, Id) != GitReadBackendConstants::ObjectIdSize)
+	{
+		return false;
+	}
+
+	const FString PackDir = InDirs.CommonDir / TEXT("objects/pack");
+	TArray<FString> IndexFilenames;
+	IFileManager::Get().FindFiles(IndexFilenames, *(PackDir / TEXT("*.idx")), true, false);
+
+	FScopeLock ScopeLock(&PackCriticalSection);
+	// Forget the packs removed by a repack
+	TSet<FString> PackFilenames;
+	for (const FString& IndexFilename : IndexFilenames)
+	{
+		PackFilenames.Add(PackDir / FPaths::GetBaseFilename(IndexFilename) + TEXT(".pack"));
+	}
+	for (auto It = PackIndexes.CreateIterator(); It; ++It)
+	{
+		if (!PackFilenames.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FString& PackFilename : PackFilenames)
+	{
+		TArray<uint8>* Index = PackIndexes.Find(PackFilename);
+		if (!Index)
+		{
+			// Version 2: magic, version, fan-out table, then the sorted ids, their CRCs, their offsets and the large offsets
+			TArray<uint8> Data;
+			if (!FFileHelper::LoadFileToArray(Data, *(FPaths::ChangeExtension(PackFilename, TEXT("idx"))), FILEREAD_Silent) || Data.Num() < 8 + 256 * 4
+				|| FMemory::Memcmp(Data.GetData(), "\377tOc", 4) != 0 || ReadBigEndian32(Data.GetData() + 4) != 2)
+			{
+				// The object could be in this pack: let git look for it
+				return false;
+			}
+			const uint32 NumObjects = ReadBigEndian32(Data.GetData() + 8 + 255 * 4);
+			if ((int64)Data.Num() < 8 + 256 * 4 + (int64)NumObjects * (GitReadBackendConstants::ObjectIdSize + 8) + 2 * GitReadBackendConstants::ObjectIdSize)
+			{
+				return false;
+			}
+			Index = &PackIndexes.Add(PackFilename, MoveTemp(Data));
+		}
+
+		const uint8* Bytes = Index->GetData();
+		const uint8* FanOut = Bytes + 8;
+		const uint32 NumObjects = ReadBigEndian32(FanOut + 255 * 4);
+		const uint8* Ids = FanOut + 256 * 4;
+		// Binary search among the ids starting with the same byte
+		uint32 Low = Id[0] == 0 ? 0 : ReadBigEndian32(FanOut + (Id[0] - 1) * 4);
+		uint32 High = ReadBigEndian32(FanOut + Id[0] * 4);
+		while (Low < High)
+		{
+			const uint32 Middle = Low + (High - Low) / 2;
+			const int32 Comparison = FMemory::Memcmp(Ids + (int64)Middle * GitReadBackendConstants::ObjectIdSize, Id, GitReadBackendConstants::ObjectIdSize);
+			if (Comparison < 0)
+			{
+				Low = Middle + 1;
+			}
+			else if (Comparison > 0)
+			{
+				High = Middle;
+			}
+			else
+			{
+				const uint8* Offsets = Ids + (int64)NumObjects * (GitReadBackendConstants::ObjectIdSize + 4);
+				const uint32 Offset = ReadBigEndian32(Offsets + (int64)Middle * 4);
+				if (Offset & 0x80000000)
+				{
+					// Packs bigger than 2GB: index in the table of 8-byte offsets
+					const int64 LargeOffsetPosition = (Offsets - Bytes) + (int64)NumObjects * 4 + (int64)(Offset & 0x7fffffff) * 8;
+					if (LargeOffsetPosition + 8 > Index->Num())
+					{
+						return false;
+					}
+					OutOffset = (int64)ReadBigEndian64(Bytes + LargeOffsetPosition);
+				}
+				else
+				{
+					OutOffset = Offset;
+				}
+				OutPackFilename = PackFilename;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/** Read the header of the object at an offset of a pack: its type, its inflated size, and the base of a delta */
+static bool ReadPackedHeader(FArchive& InReader, int64 InOffset, uint8& OutType, uint64& OutSize, int64& OutBaseOffset, FString& OutBaseSha)
+{
+	if (InOffset < 12 || InOffset >= InReader.TotalSize())
+	{
+		return false;
+	}
+	InReader.Seek(InOffset);
+
+	// Type in bits 4 to 6 of the first byte, then the inflated size 4 bits then 7 bits per byte, least significant first
+	uint8 Byte;
+	InReader.Serialize(&Byte, 1);
+	OutType = (Byte >> 4) & 7;
+	OutSize = Byte & 0x0f;
+	for (int32 Shift = 4; Byte & 0x80; Shift += 7)
+	{
+		if (Shift > 57)
+		{
+			return false;
+		}
+		InReader.Serialize(&Byte, 1);
+		OutSize |= (uint64)(Byte & 0x7f) << Shift;
+	}
+
+	if (OutType == GitReadBackendConstants::PackOfsDelta)
+	{
+		// Distance back to the base in the same pack, 7 bits per byte, most significant first, each continuation adding one
+		InReader.Serialize(&Byte, 1);
+		uint64 Distance = Byte & 0x7f;
+		while (Byte & 0x80)
+		{
+			if (Distance > (MAX_uint64 >> 8))
+			{
+				return false;
+			}
+			InReader.Serialize(&Byte, 1);
+			Distance = ((Distance + 1) << 7) | (Byte & 0x7f);
+		}
+		if (Distance == 0 || Distance >= (uint64)InOffset)
+		{
+			return false;
+		}
+		OutBaseOffset = InOffset - (int64)Distance;
+	}
+	else if (OutType == GitReadBackendConstants::PackRefDelta)
+	{
+		uint8 BaseId[GitReadBackendConstants::ObjectIdSize];
+		InReader.Serialize(BaseId, sizeof(BaseId));
+		OutBaseSha = BytesToHex(BaseId, sizeof(BaseId)).ToLower();
+	}
+	else if (OutType < 1 || OutType > 4)
+	{
+		return false;
+	}
+	return !InReader.IsError();
+}
+
+bool FGitNativeReadBackend::ReadPackedObject(const FGitDirs& InDirs, const FString& InPackFilename, int64 InOffset, int32 InDeltaDepth, FString& OutType, TArray<uint8>& OutContent)
+{
+	static const TCHAR* TypeNames[] = { nullptr, TEXT("commit"), TEXT("tree"), TEXT("blob"), TEXT("tag") };
+
+	if (InDeltaDepth > GitReadBackendConstants::MaxDeltaDepth)
+	{
+		return false;
+	}
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InPackFilename, FILEREAD_Silent));
+	uint8 Type;
+	uint64 Size;
+	int64 BaseOffset = 0;
+	FString BaseSha;
+	if (!Reader || !ReadPackedHeader(*Reader, InOffset, Type, Size, BaseOffset, BaseSha) || Size > (uint64)GitReadBackendConstants::MaxObjectSize)
+	{
+		return false;
+	}
+
+	TArray<uint8> Data;
+	if (!InflateFromArchive(*Reader, (int32)Size, Data))
+	{
+		return false;
+	}
+	Reader.Reset();
+	if (Type != GitReadBackendConstants::PackOfsDelta && Type != GitReadBackendConstants::PackRefDelta)
+	{
+		OutType = TypeNames[Type];
+		OutContent = MoveTemp(Data);
+		return true;
+	}
+
+	// The base of a delta can itself be a delta
+	TArray<uint8> Base;
+	const bool bHasBase = Type == GitReadBackendConstants::PackOfsDelta
+		? ReadPackedObject(InDirs, InPackFilename, BaseOffset, InDeltaDepth + 1, OutType, Base)
+		: ReadObject(InDirs, BaseSha, OutType, Base, InDeltaDepth + 1);
+	return bHasBase && ApplyDelta(Base, Data, OutContent);
+}
+
+bool FGitNativeReadBackend::ReadObjectSize(const FGitDirs& InDirs, const FString& InSha, int64& OutSize)
+{
+	TArray<uint8> Header;
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*(InDirs.CommonDir / TEXT("objects") / InSha.Left(2) / InSha.RightChop(2)), FILEREAD_Silent));
+	if (Reader)
+	{
+		// "<type> <size>\0"
+		int32 HeaderEnd;
+		if (!InflatePrefix(*Reader, GitReadBackendConstants::ObjectHeaderSize, Header) || !Header.Find((uint8)0, HeaderEnd))
+		{
+			return false;
+		}
+		const FString HeaderString(HeaderEnd, (const ANSICHAR*)Header.GetData());
+		FString SizeString;
+		if (!HeaderString.Split(TEXT(" "), nullptr, &SizeString) || SizeString.IsEmpty() || !SizeString.IsNumeric())
+		{
+			return false;
+		}
+		OutSize = FCString::Atoi64(*SizeString);
+		return true;
+	}
+
+	FString PackFilename;
+	int64 Offset;
+	if (!FindPackedObject(InDirs, InSha, PackFilename, Offset))
+	{
+		return false;
+	}
+	Reader.Reset(IFileManager::Get().CreateFileReader(*PackFilename, FILEREAD_Silent));
+	uint8 Type;
+	uint64 Size;
+	int64 BaseOffset = 0;
+	FString BaseSha;
+	if (!Reader || !ReadPackedHeader(*Reader, Offset, Type, Size, BaseOffset, BaseSha))
+	{
+		return false;
+	}
+	if (Type != GitReadBackendConstants::PackOfsDelta && Type != GitReadBackendConstants::PackRefDelta)
+	{
+		OutSize = (int64)Size;
+		return true;
+	}
+
+	// A delta starts with the size of its base, then with the size of the object it gives
+	int32 Position = 0;
+	uint64 BaseSize;
+	uint64 ResultSize;
+	if (!InflatePrefix(*Reader, GitReadBackendConstants::ObjectHeaderSize, Header) || !ReadDeltaSize(Header, Position, BaseSize) || !ReadDeltaSize(Header, Position, ResultSize))
+	{
+		return false;
+	}
+	OutSize = (int64)ResultSize;
+	return true;
+}
+
+bool FGitNativeReadBackend::GetBranchName(const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	FGitDirs Dirs;
+	FString HeadRef;
+	// The abbreviated commit of a detached HEAD depends on the number of objects: leave it to git
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadSymbolicHead(Dirs, HeadRef) || !HeadRef.StartsWith(TEXT("refs/heads/")))
+	{
+		return false;
+	}
+	OutBranchName = HeadRef.RightChop(11);
+	return true;
+}
+
+bool FGitNativeReadBackend::GetRemoteBranchName(const FString& InRepositoryRoot, FString& OutBranchName)
+{
+	FGitDirs Dirs;
+	FString HeadRef;
+	FGitConfig Config;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadSymbolicHead(Dirs, HeadRef) || !HeadRef.StartsWith(TEXT("refs/heads/"))
+		|| !ReadConfig(Dirs.CommonDir / TEXT("config"), Config) || !Config.bIsSupported)
+	{
+		return false;
+	}
+
+	const FString Branch = HeadRef.RightChop(11);
+	const FString* Remote = Config.Values.Find(TEXT("branch.") + Branch + TEXT(".remote"));
+	const FString* Merge = Config.Values.Find(TEXT("branch.") + Branch + TEXT(".merge"));
+	if (!Remote || !Merge || !Merge->StartsWith(TEXT("refs/heads/")))
+	{
+		return false;
+	}
+	const FString MergeBranch = Merge->RightChop(11);
+	if (*Remote == TEXT("."))
+	{
+		// Tracking a local branch
+		OutBranchName = MergeBranch;
+		return true;
+	}
+
+	// Only the default refspec maps the remote branch to "<remote>/<branch>"
+	const FString* FetchRefspec = Config.Values.Find(TEXT("remote.") + *Remote + TEXT(".fetch"));
+	const FString DefaultRefspec = FString::Printf(TEXT("+refs/heads/*:refs/remotes/%s/*"), **Remote);
+	FString TrackingSha;
+	if (!FetchRefspec || *FetchRefspec != DefaultRefspec || !ResolveRef(Dirs, FString::Printf(TEXT("refs/remotes/%s/%s"), **Remote, *MergeBranch), TrackingSha))
+	{
+		return false;
+	}
+	OutBranchName = *Remote / MergeBranch;
+	return true;
+}
+
+bool FGitNativeReadBackend::GetCommitInfo(const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary)
+{
+	FGitDirs Dirs;
+	FString CommitId;
+	FString Type;
+	TArray<uint8> Content;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ResolveRef(Dirs, TEXT("HEAD"), CommitId) || !ReadObject(Dirs, CommitId, Type, Content) || Type != TEXT("commit"))
+	{
+		return false;
+	}
+
+	const FUTF8ToTCHAR Converted((const ANSICHAR*)Content.GetData(), Content.Num());
+	const FString Commit(Converted.Length(), Converted.Get());
+	TArray<FString> Lines;
+	Commit.ParseIntoArray(Lines, TEXT("\n"), false);
+	int32 LineIndex = 0;
+	for (; LineIndex < Lines.Num() && !Lines[LineIndex].IsEmpty(); LineIndex++)
+	{
+		// Messages in another encoding than UTF-8 are converted by git
+		if (Lines[LineIndex].StartsWith(TEXT("encoding ")))
+		{
+			return false;
+		}
+	}
+
+	// The subject is the first paragraph of the message, joined on a single line as with "%s"
+	FString Summary;
+	for (LineIndex++; LineIndex < Lines.Num(); LineIndex++)
+	{
+		const FString Line = Lines[LineIndex].TrimStartAndEnd();
+		if (Line.IsEmpty())
+		{
+			if (Summary.IsEmpty())
+			{
+				continue;
+			}
+			break;
+		}
+		if (!Summary.IsEmpty())
+		{
+			Summary += TEXT(' ');
+		}
+		Summary += Line;
+	}
+
+	OutCommitId = MoveTemp(CommitId);
+	OutCommitSummary = MoveTemp(Summary);
+	return true;
+}
+
+bool FGitNativeReadBackend::GetRemoteUrl(const FString& InRepositoryRoot, FString& OutRemoteUrl)
+{
+	FGitDirs Dirs;
+	FGitConfig Config;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadConfig(Dirs.CommonDir / TEXT("config"), Config) || !Config.bIsSupported)
+	{
+		return false;
+	}
+	const FString* Url = Config.Values.Find(TEXT("remote.origin.url"));
+	if (!Url)
+	{
+		return false;
+	}
+	// "url.<base>.insteadOf" rewrites the URL, possibly from the global config
+	FGitConfig GlobalConfig;
+	if (!ReadGlobalConfig(GlobalConfig))
+	{
+		return false;
+	}
+	for (const TMap<FString, FString>* Values : { &Config.Values, &GlobalConfig.Values })
+	{
+		for (const auto& Value : *Values)
+		{
+			if (Value.Key.StartsWith(TEXT("url.")))
+			{
+				return false;
+			}
+		}
+	}
+	OutRemoteUrl = *Url;
+	return true;
+}
+
+bool FGitNativeReadBackend::GetUserConfig(const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail)
+{
+	FGitDirs Dirs;
+	FGitConfig Config;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadGlobalConfig(Config))
+	{
+		return false;
+	}
+	// The repository config takes precedence over the global one
+	if (!ReadConfig(Dirs.CommonDir / TEXT("config"), Config) || !Config.bIsSupported)
+	{
+		return false;
+	}
+	// Else git would look into the system config
+	const FString* UserName = Config.Values.Find(TEXT("user.name"));
+	const FString* UserEmail = Config.Values.Find(TEXT("user.email"));
+	if (!UserName || !UserEmail)
+	{
+		return false;
+	}
+	OutUserName = *UserName;
+	OutUserEmail = *UserEmail;
+	return true;
+}
+
+bool FGitNativeReadBackend::UpdateIndex(const FGitDirs& InDirs)
+{
+	const FString Filename = InDirs.GitDir / TEXT("index");
+	const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+	const int64 Size = IFileManager::Get().FileSize(*Filename);
+	if (Size < 0)
+	{
+		return false;
+	}
+	if (Filename == IndexFilename && TimeStamp == IndexTimeStamp && Size == IndexSize)
+	{
+		return true;
+	}
+	IndexFilename.Empty();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent) || Data.Num() < 12 + GitReadBackendConstants::IndexChecksumSize
+		|| FMemory::Memcmp(Data.GetData(), "DIRC", 4) != 0)
+	{
+		return false;
+	}
+	const uint8* Bytes = Data.GetData();
+	const int32 End = Data.Num() - GitReadBackendConstants::IndexChecksumSize;
+	const uint32 Version = ReadBigEndian32(Bytes + 4);
+	const uint32 NumEntries = ReadBigEndian32(Bytes + 8);
+	if (Version < 2 || Version > 4)
+	{
+		return false;
+	}
+
+	// Each entry: ctime, mtime, dev, ino, mode, uid, gid, size (4 bytes each but the 8-byte times), SHA-1, flags, then the path
+	const int32 EntryHeaderSize = 62;
+	TArray<FString> Paths;
+	Paths.Reserve(NumEntries);
+	TArray<ANSICHAR> PreviousPath;
+	int32 Offset = 12;
+	for (uint32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
+	{
+		if (Offset + EntryHeaderSize > End)
+		{
+			return false;
+		}
+		const uint8* Entry = Bytes + Offset;
+		const uint32 Mode = ReadBigEndian32(Entry + 24);
+		const uint16 Flags = ReadBigEndian16(Entry + 60);
+		if ((Mode & 0170000) == 0040000)
+		{
+			// Directory entry of a sparse index
+			return false;
+		}
+		int32 PathOffset = Offset + EntryHeaderSize;
+		if (Version >= 3 && (Flags & 0x4000))
+		{
+			PathOffset += 2;
+		}
+
+		TArray<ANSICHAR> Path;
+		int32 PathLength = 0;
+		if (Version == 4)
+		{
+			// Prefix compression: number of bytes to remove from the previous path, then the suffix
+			int32 Position = PathOffset;
+			uint8 Byte = Bytes[Position++];
+			uint32 Strip = Byte & 0x7f;
+			while (Byte & 0x80)
+			{
+				if (Position >= End)
+				{
+					return false;
+				}
+				Byte = Bytes[Position++];
+				Strip = ((Strip + 1) << 7) + (Byte & 0x7f);
+			}
+			if (Strip > (uint32)PreviousPath.Num())
+			{
+				return false;
+			}
+			const int32 SuffixStart = Position;
+			while (Position < End && Bytes[Position] != 0)
+			{
+				Position++;
+			}
+			if (Position >= End)
+			{
+				return false;
+			}
+			Path.Append(PreviousPath.GetData(), PreviousPath.Num() - Strip);
+			Path.Append((const ANSICHAR*)Bytes + SuffixStart, Position - SuffixStart);
+			Offset = Position + 1;
+		}
+		else
+		{
+			while (PathOffset + PathLength < End && Bytes[PathOffset + PathLength] != 0)
+			{
+				PathLength++;
+			}
+			if (PathOffset + PathLength >= End)
+			{
+				return false;
+			}
+			Path.Append((const ANSICHAR*)Bytes + PathOffset, PathLength);
+			// Entries are padded with 1 to 8 NUL bytes to a multiple of 8 bytes
+			Offset += ((PathOffset - Offset) + PathLength + 8) & ~7;
+		}
+
+		// Unmerged paths have one entry per stage, but are listed once
+		if (Path != PreviousPath)
+		{
+			FUTF8ToTCHAR Converted(Path.GetData(), Path.Num());
+			Paths.Emplace(Converted.Length(), Converted.Get());
+		}
+		PreviousPath = MoveTemp(Path);
+	}
+
+	// Extensions: a split index only holds the changes to a shared one
+	while (Offset + 8 <= End)
+	{
+		if (FMemory::Memcmp(Bytes + Offset, "link", 4) == 0 || FMemory::Memcmp(Bytes + Offset, "sdir", 4) == 0)
+		{
+			return false;
+		}
+		Offset += 8 + ReadBigEndian32(Bytes + Offset + 4);
+	}
+
+	IndexPaths = MoveTemp(Paths);
+	IndexFilename = Filename;
+	IndexTimeStamp = TimeStamp;
+	IndexSize = Size;
+	return true;
+}
+
+bool FGitNativeReadBackend::ListFiles(const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles)
+{
+	FGitDirs Dirs;
+	FGitConfig Config;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadConfig(Dirs.CommonDir / TEXT("config"), Config))
+	{
+		return false;
+	}
+	// Paths are compared as stored in the index
+	const FString* ObjectFormat = Config.Values.Find(TEXT("extensions.objectformat"));
+	const FString* IgnoreCase = Config.Values.Find(TEXT("core.ignorecase"));
+	const FString* PrecomposeUnicode = Config.Values.Find(TEXT("core.precomposeunicode"));
+	if ((ObjectFormat && *ObjectFormat != TEXT("sha1")) || (IgnoreCase && IgnoreCase->ToBool()) || (PrecomposeUnicode && PrecomposeUnicode->ToBool()))
+	{
+		return false;
+	}
+
+	FString Root = InRepositoryRoot;
+	Root.RemoveFromEnd(TEXT("/"));
+	FString Directory = InDirectory;
+	FPaths::NormalizeFilename(Directory);
+	if (!Directory.StartsWith(Root, ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+	Directory = Directory.RightChop(Root.Len());
+	Directory.RemoveFromStart(TEXT("/"));
+	Directory.RemoveFromEnd(TEXT("/"));
+	const FString Prefix = Directory.IsEmpty() ? Directory : Directory + TEXT("/");
+
+	FScopeLock ScopeLock(&IndexCriticalSection);
+	if (!UpdateIndex(Dirs))
+	{
+		return false;
+	}
+	for (const FString& Path : IndexPaths)
+	{
+		if (Path.StartsWith(Prefix, ESearchCase::CaseSensitive) || Path.Equals(Directory, ESearchCase::CaseSensitive))
+		{
+			OutFiles.Add(Path);
+		}
+	}
+	return true;
+}
+
+bool FGitNativeReadBackend::CheckLockable(const FString& InRepositoryRoot, const TArray<FString>& InWildcards, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	FGitDirs Dirs;
+	FGitConfig Config;
+	FGitConfig GlobalConfig;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadConfig(Dirs.CommonDir / TEXT("config"), Config) || !Config.bIsSupported)
+	{
+		return false;
+	}
+	if (!ReadGlobalConfig(GlobalConfig))
+	{
+		return false;
+	}
+
+	// The attributes file of the user: core.attributesFile, else the default one of git in the XDG config directory
+	FString UserAttributesFilename;
+	const FString* AttributesFile = Config.Values.Find(TEXT("core.attributesfile"));
+	if (!AttributesFile)
+	{
+		AttributesFile = GlobalConfig.Values.Find(TEXT("core.attributesfile"));
+	}
+	if (AttributesFile)
+	{
+		if (AttributesFile->StartsWith(TEXT("~/")))
+		{
+			const FString Home = GetHomeDir();
+			if (Home.IsEmpty())
+			{
+				return false;
+			}
+			UserAttributesFilename = Home / AttributesFile->RightChop(2);
+		}
+		else if (FPaths::IsRelative(*AttributesFile))
+		{
+			// Relative to the directory git runs from
+			UserAttributesFilename = InRepositoryRoot / *AttributesFile;
+		}
+		else
+		{
+			UserAttributesFilename = *AttributesFile;
+		}
+	}
+	else
+	{
+		const FString XdgConfigHome = GetXdgConfigHome();
+		if (!XdgConfigHome.IsEmpty())
+		{
+			UserAttributesFilename = XdgConfigHome / TEXT("git/attributes");
+		}
+	}
+
+	// From the lowest to the highest precedence. Only these files, at the root, can match a path without directory.
+	TArray<FString> Lines;
+	for (const FString& AttributesFilename : { UserAttributesFilename, InRepositoryRoot / TEXT(".gitattributes"), Dirs.CommonDir / TEXT("info/attributes") })
+	{
+		FString Content;
+		if (!AttributesFilename.IsEmpty() && FFileHelper::LoadFileToString(Content, *AttributesFilename, FFileHelper::EHashOptions::None, FILEREAD_Silent))
+		{
+			TArray<FString> FileLines;
+			Content.ParseIntoArrayLines(FileLines);
+			Lines += MoveTemp(FileLines);
+		}
+	}
+
+	TArray<FString> Results;
+	for (const FString& Wildcard : InWildcards)
+	{
+		FString Value = TEXT("unspecified");
+		for (const FString& RawLine : Lines)
+		{
+			const FString Line = RawLine.TrimStartAndEnd();
+			if (Line.IsEmpty() || Line[0] == TEXT('#') || Line.StartsWith(TEXT("[attr]")))
+			{
+				continue;
+			}
+			TArray<FString> Tokens;
+			Line.ParseIntoArrayWS(Tokens);
+			FString Pattern = Tokens[0];
+			if (Pattern[0] == TEXT('"') || Pattern.Contains(TEXT("[")) || Pattern.Contains(TEXT("\\")))
+			{
+				// Quoted patterns, character classes and escapes are left to git
+				return false;
+			}
+			// Patterns anchored at the root, or matching at any depth, match a path without directory
+			while (Pattern.RemoveFromStart(TEXT("**/")))
+			{
+			}
+			if (Pattern.StartsWith(TEXT("/")))
+			{
+				Pattern = Pattern.RightChop(1);
+			}
+			if (Pattern.Contains(TEXT("/")) || !Wildcard.MatchesWildcard(Pattern, ESearchCase::CaseSensitive))
+			{
+				continue;
+			}
+			for (int32 TokenIndex = 1; TokenIndex < Tokens.Num(); TokenIndex++)
+			{
+				const FString& Token = Tokens[TokenIndex];
+				if (Token == TEXT("lockable"))
+				{
+					Value = TEXT("set");
+				}
+				else if (Token == TEXT("-lockable"))
+				{
+					Value = TEXT("unset");
+				}
+				else if (Token == TEXT("!lockable"))
+				{
+					Value = TEXT("unspecified");
+				}
+				else if (Token.StartsWith(TEXT("lockable=")))
+				{
+					Value = Token.RightChop(9);
+				}
+			}
+		}
+		Results.Add(FString::Printf(TEXT("%s: lockable: %s"), *Wildcard, *Value));
+	}
+	OutResults += MoveTemp(Results);
+	return true;
+}
+
+bool FGitNativeReadBackend::ReadTree(const FGitDirs& InDirs, const FString& InTreeId, TArray<FGitTreeEntry>& OutEntries)
+{
+	FString Type;
+	TArray<uint8> Content;
+	if (!ReadObject(InDirs, InTreeId, Type, Content) || Type != TEXT("tree"))
+	{
+		return false;
+	}
+
+	// "<octal mode> <name>\0<binary id>" for each entry
+	int32 Position = 0;
+	while (Position < Content.Num())
+	{
+		int32 Space = Position;
+		while (Space < Content.Num() && Content[Space] != ' ')
+		{
+			Space++;
+		}
+		int32 NameEnd = Space;
+		while (NameEnd < Content.Num() && Content[NameEnd] != 0)
+		{
+			NameEnd++;
+		}
+		if (NameEnd + 1 + GitReadBackendConstants::ObjectIdSize > Content.Num())
+		{
+			return false;
+		}
+		FGitTreeEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Entry.Mode = FString(Space - Position, (const ANSICHAR*)Content.GetData() + Position);
+		const FUTF8ToTCHAR Name((const ANSICHAR*)Content.GetData() + Space + 1, NameEnd - Space - 1);
+		Entry.Name = FString(Name.Length(), Name.Get());
+		Entry.Id = BytesToHex(Content.GetData() + NameEnd + 1, GitReadBackendConstants::ObjectIdSize).ToLower();
+		Position = NameEnd + 1 + GitReadBackendConstants::ObjectIdSize;
+	}
+	return true;
+}
+
+bool FGitNativeReadBackend::ReadCommit(const FGitDirs& InDirs, const FString& InCommitId, FGitCommit& OutCommit)
+{
+	FString Type;
+	TArray<uint8> Content;
+	if (!ReadObject(InDirs, InCommitId, Type, Content) || Type != TEXT("commit"))
+	{
+		return false;
+	}
+
+	const FUTF8ToTCHAR Converted((const ANSICHAR*)Content.GetData(), Content.Num());
+	const FString Commit(Converted.Length(), Converted.Get());
+	const int32 MessageStart = Commit.Find(TEXT("\n\n"), ESearchCase::CaseSensitive);
+	const FString Headers = MessageStart == INDEX_NONE ? Commit : Commit.Left(MessageStart);
+	TArray<FString> Lines;
+	Headers.ParseIntoArray(Lines, TEXT("\n"), true);
+	for (const FString& Line : Lines)
+	{
+		if (Line.StartsWith(TEXT("tree "), ESearchCase::CaseSensitive))
+		{
+			OutCommit.TreeId = Line.RightChop(5);
+		}
+		else if (Line.StartsWith(TEXT("parent "), ESearchCase::CaseSensitive))
+		{
+			OutCommit.ParentIds.Add(Line.RightChop(7));
+		}
+		else if (Line.StartsWith(TEXT("author "), ESearchCase::CaseSensitive))
+		{
+			// "author <name> <<email>> <time> <zone>"
+			int32 EmailStart;
+			int32 EmailEnd;
+			if (!Line.FindChar(TEXT('<'), EmailStart) || !Line.FindLastChar(TEXT('>'), EmailEnd) || EmailEnd < EmailStart)
+			{
+				return false;
+			}
+			OutCommit.AuthorName = Line.Mid(7, EmailStart - 7).TrimEnd();
+			OutCommit.AuthorTime = FCString::Atoi64(*Line.RightChop(EmailEnd + 1).TrimStart());
+		}
+		else if (Line.StartsWith(TEXT("encoding "), ESearchCase::CaseSensitive))
+		{
+			// Messages in another encoding than UTF-8 are converted by git
+			return false;
+		}
+	}
+
+	// The raw message, as "%B" without its trailing newlines
+	OutCommit.Message = MessageStart == INDEX_NONE ? FString() : Commit.RightChop(MessageStart + 2);
+	while (OutCommit.Message.EndsWith(TEXT("\n"), ESearchCase::CaseSensitive))
+	{
+		OutCommit.Message = OutCommit.Message.LeftChop(1);
+	}
+	return GitSourceControlUtils::IsObjectId(OutCommit.TreeId);
+}
+
+bool FGitNativeReadBackend::FindPathEntry(const FGitDirs& InDirs, const FString& InTreeId, const TArray<FString>& InComponents, const FGitPathEntry* InPrevious, FGitPathEntry& OutEntry)
+{
+	OutEntry = FGitPathEntry();
+	FString TreeId = InTreeId;
+	for (int32 Depth = 0; Depth < InComponents.Num(); Depth++)
+	{
+		// Same subtree as in the previous commit: so is the rest of the path
+		if (InPrevious && InPrevious->TreeIds.IsValidIndex(Depth) && InPrevious->TreeIds[Depth] == TreeId)
+		{
+			for (int32 Index = Depth; Index < InPrevious->TreeIds.Num(); Index++)
+			{
+				OutEntry.TreeIds.Add(InPrevious->TreeIds[Index]);
+			}
+			OutEntry.Mode = InPrevious->Mode;
+			OutEntry.Id = InPrevious->Id;
+			return true;
+		}
+
+		OutEntry.TreeIds.Add(TreeId);
+		TArray<FGitTreeEntry> Entries;
+		if (!ReadTree(InDirs, TreeId, Entries))
+		{
+			return false;
+		}
+		const FGitTreeEntry* Entry = Entries.FindByPredicate([&InComponents, Depth](const FGitTreeEntry& InEntry)
+		{
+			return InEntry.Name.Equals(InComponents[Depth], ESearchCase::CaseSensitive);
+		});
+		if (!Entry)
+		{
+			return true;
+		}
+		if (Depth + 1 == InComponents.Num())
+		{
+			OutEntry.Mode = Entry->Mode;
+			OutEntry.Id = Entry->Id;
+			return true;
+		}
+		if (Entry->Mode != TEXT("40000"))
+		{
+			// A file where the path expects a directory
+			return true;
+		}
+		TreeId = Entry->Id;
+	}
+	return true;
+}
+
+bool FGitNativeReadBackend::HasDeletedFiles(const FGitDirs& InDirs, const FString& InOldTreeId, const FString& InNewTreeId, bool& bOutHasDeletedFiles)
+{
+	if (InOldTreeId == InNewTreeId)
+	{
+		return true;
+	}
+	TArray<FGitTreeEntry> OldEntries;
+	TArray<FGitTreeEntry> NewEntries;
+	if (!ReadTree(InDirs, InOldTreeId, OldEntries) || !ReadTree(InDirs, InNewTreeId, NewEntries))
+	{
+		return false;
+	}
+
+	// The keys of a map ignore the case: names only differing by their case are left to git
+	TMap<FString, const FGitTreeEntry*> NewEntriesByName;
+	NewEntriesByName.Reserve(NewEntries.Num());
+	for (const FGitTreeEntry& NewEntry : NewEntries)
+	{
+		if (NewEntriesByName.Contains(NewEntry.Name))
+		{
+			return false;
+		}
+		NewEntriesByName.Add(NewEntry.Name, &NewEntry);
+	}
+	for (const FGitTreeEntry& OldEntry : OldEntries)
+	{
+		const FGitTreeEntry* const* NewEntry = NewEntriesByName.Find(OldEntry.Name);
+		const bool bOldIsTree = OldEntry.Mode == TEXT("40000");
+		if (!NewEntry || !(*NewEntry)->Name.Equals(OldEntry.Name, ESearchCase::CaseSensitive) || bOldIsTree != ((*NewEntry)->Mode == TEXT("40000")))
+		{
+			bOutHasDeletedFiles = true;
+			return true;
+		}
+		if (bOldIsTree && !HasDeletedFiles(InDirs, OldEntry.Id, (*NewEntry)->Id, bOutHasDeletedFiles))
+		{
+			return false;
+		}
+		if (bOutHasDeletedFiles)
+		{
+			return true;
+		}
+	}
+	return true;
+}
+
+bool FGitNativeReadBackend::GetHistory(const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TGitSourceControlHistory& OutHistory, TArray<FString>& OutErrorMessages)
+{
+	// The tip of the merged branch is left to git
+	if (bMergeConflict)
+	{
+		return false;
+	}
+	FGitDirs Dirs;
+	FGitConfig Config;
+	FGitConfig GlobalConfig;
+	if (!FindGitDirs(InRepositoryRoot, Dirs) || !ReadConfig(Dirs.CommonDir / TEXT("config"), Config) || !Config.bIsSupported || !ReadGlobalConfig(GlobalConfig))
+	{
+		return false;
+	}
+	// SHA-256 ids, messages converted for the output, and histories altered by a shallow clone, grafts or replacements are left to git
+	const FString* ObjectFormat = Config.Values.Find(TEXT("extensions.objectformat"));
+	if ((ObjectFormat && *ObjectFormat != TEXT("sha1")) || Config.Values.Contains(TEXT("i18n.logoutputencoding")) || GlobalConfig.Values.Contains(TEXT("i18n.logoutputencoding")))
+	{
+		return false;
+	}
+	FString PackedRefs;
+	FFileHelper::LoadFileToString(PackedRefs, *(Dirs.CommonDir / TEXT("packed-refs")), FFileHelper::EHashOptions::None, FILEREAD_Silent);
+	if (FPaths::FileExists(Dirs.CommonDir / TEXT("shallow")) || FPaths::FileExists(Dirs.CommonDir / TEXT("info/grafts"))
+		|| FPaths::DirectoryExists(Dirs.CommonDir / TEXT("refs/replace")) || PackedRefs.Contains(TEXT(" refs/replace/"), ESearchCase::CaseSensitive))
+	{
+		return false;
+	}
+
+	// Relative to the root, as in the output of git, and split to look it up in the trees
+	FString RelativePath = InFile;
+	FPaths::NormalizeFilename(RelativePath);
+	if (!FPaths::IsRelative(RelativePath))
+	{
+		FString Root = InRepositoryRoot;
+		FPaths::NormalizeDirectoryName(Root);
+		if (!RelativePath.StartsWith(Root + TEXT("/"), ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
+		RelativePath = RelativePath.RightChop(Root.Len() + 1);
+	}
+	TArray<FString> Components;
+	RelativePath.ParseIntoArray(Components, TEXT("/"));
+	if (Components.Num() == 0 || Components.Contains(TEXT(".")) || Components.Contains(TEXT("..")))
+	{
+		return false;
+	}
+
+	FString CommitId;
+	FGitCommit Commit;
+	FGitPathEntry Entry;
+	if (!ResolveRef(Dirs, TEXT("HEAD"), CommitId) || !ReadCommit(Dirs, CommitId, Commit) || !FindPathEntry(Dirs, Commit.TreeId, Components, nullptr, Entry))
+	{
+		return false;
+	}
+
+	// Not in a partial clone, where it would fetch the blob of every revision, as "ls-tree --long" of the git command line
+	const bool bWithFileSize = !FGitSparseCheckout::Get().IsPartialClone();
+	TGitSourceControlHistory History;
+	while (History.Num() < GitReadBackendConstants::MaxHistoryCount)
+	{
+		// "git log --follow" walks both sides of a merge, in the order of the dates of their commits
+		if (Commit.ParentIds.Num() > 1)
+		{
+			return false;
+		}
+		const bool bHasParent = Commit.ParentIds.Num() == 1;
+		FGitCommit Parent;
+		FGitPathEntry ParentEntry;
+		if (bHasParent && (!ReadCommit(Dirs, Commit.ParentIds[0], Parent) || !FindPathEntry(Dirs, Parent.TreeId, Components, &Entry, ParentEntry)))
+		{
+			return false;
+		}
+		// Only regular files: directories, symbolic links and submodules are left to git
+		if ((!Entry.Mode.IsEmpty() && !Entry.Mode.StartsWith(TEXT("100"))) || (!ParentEntry.Mode.IsEmpty() && !ParentEntry.Mode.StartsWith(TEXT("100"))))
+		{
+			return false;
+		}
+
+		if (Entry.Mode != ParentEntry.Mode || Entry.Id != ParentEntry.Id)
+		{
+			FString Action;
+			if (ParentEntry.Id.IsEmpty())
+			{
+				// git looks for the source of a rename among the files deleted by the same commit
+				bool bHasDeletedFiles = false;
+				if (bHasParent && (!HasDeletedFiles(Dirs, Parent.TreeId, Commit.TreeId, bHasDeletedFiles) || bHasDeletedFiles))
+				{
+					return false;
+				}
+				Action = TEXT("add");
+			}
+			else if (Entry.Id.IsEmpty())
+			{
+				Action = TEXT("delete");
+			}
+			else
+			{
+				Action = TEXT("modified");
+			}
+
+			TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> Revision = MakeShared<FGitSourceControlRevision, ESPMode::ThreadSafe>();
+			Revision->CommitId = CommitId;
+			Revision->ShortCommitId = CommitId.Left(8);
+			Revision->CommitIdNumber = static_cast<int32>(FParse::HexNumber(*Revision->ShortCommitId));
+			Revision->UserName = Commit.AuthorName;
+			Revision->Date = FDateTime::FromUnixTimestamp(Commit.AuthorTime);
+			Revision->Description = Commit.Message;
+			Revision->Action = MoveTemp(Action);
+			Revision->Filename = RelativePath;
+			Revision->FileHash = Entry.Id;
+			if (bWithFileSize && !Entry.Id.IsEmpty())
+			{
+				int64 FileSize;
+				if (!ReadObjectSize(Dirs, Entry.Id, FileSize))
+				{
+					return false;
+				}
+				Revision->FileSize = static_cast<int32>(FileSize);
+			}
+			Revision->PathToRepoRoot = InRepositoryRoot;
+			History.Add(MoveTemp(Revision));
+		}
+
+		if (!bHasParent)
+		{
+			break;
+		}
+		CommitId = Commit.ParentIds[0];
+		Commit = MoveTemp(Parent);
+		Entry = MoveTemp(ParentEntry);
+	}
+
+	// The log starts with the most recent change
+	for (int32 RevisionIndex = 0; RevisionIndex < History.Num(); RevisionIndex++)
+	{
+		History[RevisionIndex]->RevisionNumber = History.Num() - RevisionIndex;
+	}
+	OutHistory += MoveTemp(History);
+	return true;
+}
+
+namespace GitReadBackend
+{
+bool Read(const FString& InPathToGitBinary, TFunctionRef<bool(IGitReadBackend& Backend)> InQuery)
+{
+	static FGitNativeReadBackend NativeBackend;
+
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (GitSourceControl && GitSourceControl->AccessSettings().IsUsingNativeReadBackend() && InQuery(NativeBackend))
+	{
+		return true;
+	}
+	FGitCliReadBackend CliBackend(InPathToGitBinary);
+	return InQuery(CliBackend);
+}
+} // namespace GitReadBackend
@@ -0,0 +1,188 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GitSourceControlRevision.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+/**
+ * Read-only queries on a repository, that do not change the working tree, the index or the refs.
+ *
+ * Each query returns false when the backend cannot answer it, so that the next backend can be asked.
+ */
+class IGitReadBackend
+{
+public:
+	virtual ~IGitReadBackend() = default;
+
+	/** Name of the backend, for the logs */
+	virtual const TCHAR* GetName() const = 0;
+
+	/** Short name of the current branch, or "HEAD detached at <commit>" */
+	virtual bool GetBranchName(const FString& InRepositoryRoot, FString& OutBranchName) = 0;
+
+	/** Short name of the upstream of the current branch, like "origin/main" */
+	virtual bool GetRemoteBranchName(const FString& InRepositoryRoot, FString& OutBranchName) = 0;
+
+	/** Id and subject of the commit at HEAD */
+	virtual bool GetCommitInfo(const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary) = 0;
+
+	/** URL of the "origin" remote */
+	virtual bool GetRemoteUrl(const FString& InRepositoryRoot, FString& OutRemoteUrl) = 0;
+
+	/** User name and email, from the repository config else from the global one */
+	virtual bool GetUserConfig(const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail) = 0;
+
+	/** Files of the index under an absolute directory, relative to the repository root, like "git ls-files <directory>" */
+	virtual bool ListFiles(const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles) = 0;
+
+	/** Results of "git check-attr lockable" for wildcards such as "*.uasset", one "<wildcard>: lockable: <value>" per wildcard */
+	virtual bool CheckLockable(const FString& InRepositoryRoot, const TArray<FString>& InWildcards, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages) = 0;
+
+	/** History of a file, as "git log --follow --name-status" with the id and size of the file at each revision */
+	virtual bool GetHistory(const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TGitSourceControlHistory& OutHistory, TArray<FString>& OutErrorMessages) = 0;
+};
+
+/** Runs the git command line for each query. Answers all of them, as long as git does */
+class FGitCliReadBackend : public IGitReadBackend
+{
+public:
+	explicit FGitCliReadBackend(const FString& InPathToGitBinary);
+
+	virtual const TCHAR* GetName() const override { return TEXT("cli"); }
+	virtual bool GetBranchName(const FString& InRepositoryRoot, FString& OutBranchName) override;
+	virtual bool GetRemoteBranchName(const FString& InRepositoryRoot, FString& OutBranchName) override;
+	virtual bool GetCommitInfo(const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary) override;
+	virtual bool GetRemoteUrl(const FString& InRepositoryRoot, FString& OutRemoteUrl) override;
+	virtual bool GetUserConfig(const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail) override;
+	virtual bool ListFiles(const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles) override;
+	virtual bool CheckLockable(const FString& InRepositoryRoot, const TArray<FString>& InWildcards, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages) override;
+	virtual bool GetHistory(const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TGitSourceControlHistory& OutHistory, TArray<FString>& OutErrorMessages) override;
+
+private:
+	FString PathToGitBinary;
+};
+
+/**
+ * Reads the files of the .git directory in process, without launching git: HEAD, refs and packed-refs,
+ * config, gitattributes, the index, and the loose and packed objects.
+ *
+ * It only answers the common cases, and declines anything it does not fully understand (SHA-256 packs,
+ * config includes, url rewrites, split or sparse index, merges and renames in a history...) so that
+ * the git command line answers instead. The status of the working tree is not among its queries: it stays on git.
+ */
+class FGitNativeReadBackend : public IGitReadBackend
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("native"); }
+	virtual bool GetBranchName(const FString& InRepositoryRoot, FString& OutBranchName) override;
+	virtual bool GetRemoteBranchName(const FString& InRepositoryRoot, FString& OutBranchName) override;
+	virtual bool GetCommitInfo(const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary) override;
+	virtual bool GetRemoteUrl(const FString& InRepositoryRoot, FString& OutRemoteUrl) override;
+	virtual bool GetUserConfig(const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail) override;
+	virtual bool ListFiles(const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles) override;
+	virtual bool CheckLockable(const FString& InRepositoryRoot, const TArray<FString>& InWildcards, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages) override;
+	virtual bool GetHistory(const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TGitSourceControlHistory& OutHistory, TArray<FString>& OutErrorMessages) override;
+
+	/** The common git directory of a repository, with its config, info/ and objects/, shared by its linked worktrees */
+	static bool GetCommonDir(const FString& InRepositoryRoot, FString& OutCommonDir);
+
+private:
+	/** Location of the git directory of a repository, and of its common directory for linked worktrees */
+	struct FGitDirs
+	{
+		FString GitDir;
+		FString CommonDir;
+	};
+
+	/** Entries of a config file, keyed by lower case "section.key" or "section.subsection.key" */
+	struct FGitConfig
+	{
+		TMap<FString, FString> Values;
+		/** Includes and url rewrites would change the values: leave such configs to git */
+		bool bIsSupported = true;
+	};
+
+	/** Entry of a tree object */
+	struct FGitTreeEntry
+	{
+		FString Mode;
+		FString Name;
+		FString Id;
+	};
+
+	/** Entry of a path in the tree of a commit, with the trees leading to it */
+	struct FGitPathEntry
+	{
+		/** Ids of the root tree then of the subtrees down to the path, as far as they exist */
+		TArray<FString> TreeIds;
+		/** Mode and id of the entry, empty if the path does not exist */
+		FString Mode;
+		FString Id;
+	};
+
+	/** Fields of a commit object read for a history */
+	struct FGitCommit
+	{
+		FString TreeId;
+		TArray<FString> ParentIds;
+		FString AuthorName;
+		int64 AuthorTime = 0;
+		FString Message;
+	};
+
+	static bool FindGitDirs(const FString& InRepositoryRoot, FGitDirs& OutDirs);
+	static bool ReadConfig(const FString& InFilename, FGitConfig& OutConfig);
+	/** Home directory of the user, and its XDG config directory ($XDG_CONFIG_HOME else ~/.config), empty if unknown */
+	static FString GetHomeDir();
+	static FString GetXdgConfigHome();
+	/** Read the config of the user, from the XDG then the home directory, the latter taking precedence. False if git may read another one */
+	static bool ReadGlobalConfig(FGitConfig& OutConfig);
+	static bool ReadSymbolicHead(const FGitDirs& InDirs, FString& OutRef);
+	static bool ResolveRef(const FGitDirs& InDirs, const FString& InRef, FString& OutSha);
+	static bool ReadLooseObject(const FGitDirs& InDirs, const FString& InSha, FString& OutType, TArray<uint8>& OutContent);
+
+	/** Read an object, loose or else from a pack, resolving its deltas */
+	bool ReadObject(const FGitDirs& InDirs, const FString& InSha, FString& OutType, TArray<uint8>& OutContent, int32 InDeltaDepth = 0);
+	/** Look for an object in the .idx files of the packs, loading the ones not read yet */
+	bool FindPackedObject(const FGitDirs& InDirs, const FString& InSha, FString& OutPackFilename, int64& OutOffset);
+	/** Read the object at an offset of a .pack file, applying it to its base if it is a delta */
+	bool ReadPackedObject(const FGitDirs& InDirs, const FString& InPackFilename, int64 InOffset, int32 InDeltaDepth, FString& OutType, TArray<uint8>& OutContent);
+	/** Size of an object, from its headers only: the content of a blob is not inflated */
+	bool ReadObjectSize(const FGitDirs& InDirs, const FString& InSha, int64& OutSize);
+
+	bool ReadTree(const FGitDirs& InDirs, const FString& InTreeId, TArray<FGitTreeEntry>& OutEntries);
+	bool ReadCommit(const FGitDirs& InDirs, const FString& InCommitId, FGitCommit& OutCommit);
+	/** Find a path in a tree, reusing the entry of the previous commit from the first subtree they share */
+	bool FindPathEntry(const FGitDirs& InDirs, const FString& InTreeId, const TArray<FString>& InComponents, const FGitPathEntry* InPrevious, FGitPathEntry& OutEntry);
+	/** Whether a path of the old tree is missing from the new one: a file added along could be a rename */
+	bool HasDeletedFiles(const FGitDirs& InDirs, const FString& InOldTreeId, const FString& InNewTreeId, bool& bOutHasDeletedFiles);
+
+	/** Load the paths of the index, if it changed since the last call */
+	bool UpdateIndex(const FGitDirs& InDirs);
+
+	FCriticalSection IndexCriticalSection;
+	FString IndexFilename;
+	FDateTime IndexTimeStamp;
+	int64 IndexSize = -1;
+	/** Paths relative to the repository root, sorted as in the index */
+	TArray<FString> IndexPaths;
+
+	FCriticalSection PackCriticalSection;
+	/** Content of the .idx files, by filename of their .pack: packs are only ever added or removed, never modified */
+	TMap<FString, TArray<uint8>> PackIndexes;
+};
+
+namespace GitReadBackend
+{
+/**
+ * Run a query on the native backend if it is enabled, falling back to the git command line
+ * @returns the result of the query on the first backend that could answer it
+ */
+bool Read(const FString& InPathToGitBinary, TFunctionRef<bool(IGitReadBackend& Backend)> InQuery);
+} // namespace GitReadBackend
@@ -9,6 +9,7 @@
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
 #include "GitSourceControlModule.h"
+#include "GitSourceControlRevisionCache.h"
 #include "GitSourceControlUtils.h"
 #include "ISourceControlModule.h"
 
@@ -39,7 +40,32 @@ bool FGitSourceControlRevision::Get( FString& InOutFilename ) const
 		PathToRepositoryRoot = PathToRepoRoot;
 	}
 
-	// if a filename for the temp file wasn't supplied generate a unique-ish one
+	// Diff against the revision
+	const FString Parameter = FString::Printf(TEXT("%s:%s"), *CommitId, *Filename);
+
+	// if a filename for the temp file wasn't supplied use the content-addressed cache, so that the same content is only ever extracted once
+	if(InOutFilename.Len() == 0)
+	{
+		FGitRevisionCache& RevisionCache = FGitRevisionCache::Get();
+		if (RevisionCache.FindFile(Filename, CommitId, InOutFilename))
+		{
+			return true;
+		}
+
+		FString BlobHash = FileHash;
+		if (GitSourceControlUtils::IsObjectId(BlobHash) || GitSourceControlUtils::GetBlobHash(PathToGitBinary, PathToRepositoryRoot, Parameter, BlobHash))
+		{
+			const FString Extension = FPaths::GetExtension(Filename, true);
+			if (GitSourceControlUtils::RunDumpToBlobCache(PathToGitBinary, PathToRepositoryRoot, Parameter, BlobHash, Extension, InOutFilename))
+			{
+				RevisionCache.AddFile(Filename, CommitId, BlobHash, InOutFilename);
+				return true;
+			}
+			InOutFilename.Empty();
+		}
+	}
+
+	// else generate a unique-ish one
 	if(InOutFilename.Len() == 0)
 	{
 		// create the diff dir if we don't already have it (Git wont)
@@ -49,9 +75,6 @@ bool FGitSourceControlRevision::Get( FString& InOutFilename ) const
 		InOutFilename = FPaths::ConvertRelativePathToFull(TempFileName);
 	}
 
-	// Diff against the revision
-	const FString Parameter = FString::Printf(TEXT("%s:%s"), *CommitId, *Filename);
-
 	bool bCommandSuccessful;
 	if(FPaths::FileExists(InOutFilename))
 	{
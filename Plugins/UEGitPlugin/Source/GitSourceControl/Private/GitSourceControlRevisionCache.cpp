@@ -0,0 +1,208 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlRevisionCache.h"
+
+#include "GitSourceControlPersistentFile.h"
+#include "HAL/FileManager.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace GitRevisionCacheConstants
+{
+/** Identifies a revision cache index file */
+const uint32 Magic = 0x43524947; // "GIRC"
+/** To be bumped when the layout of the file changes */
+const int32 Version = 2;
+/** The maximum size of the extracted files kept in the cache */
+const int64 MaxBytes = 4LL * 1024 * 1024 * 1024;
+} // namespace GitRevisionCacheConstants
+
+FGitRevisionCache& FGitRevisionCache::Get()
+{
+	static FGitRevisionCache RevisionCache;
+	return RevisionCache;
+}
+
+FString FGitRevisionCache::GetIndexFilename()
+{
+	return GitPersistentFile::GetFilename(TEXT("RevisionCache.bin"));
+}
+
+FString FGitRevisionCache::MakeKey(const FString& InPath, const FString& InCommitId)
+{
+	return InCommitId + TEXT(":") + InPath;
+}
+
+void FGitRevisionCache::Load()
+{
+	TMap<FString, FString> LoadedBlobHashes;
+	TMap<FString, FCachedFile> LoadedFiles;
+	if (!GitPersistentFile::Load(GetIndexFilename(), GitRevisionCacheConstants::Magic, GitRevisionCacheConstants::Version, [&LoadedBlobHashes, &LoadedFiles](FArchive& Reader)
+	{
+		Reader << LoadedBlobHashes << LoadedFiles;
+		return true;
+	}))
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&CriticalSection);
+	BlobHashes = MoveTemp(LoadedBlobHashes);
+	Files = MoveTemp(LoadedFiles);
+
+	// Forget the files deleted since the last session, and restore the LRU order
+	Stats.BytesCached = 0;
+	for (auto It = Files.CreateIterator(); It; ++It)
+	{
+		if (!FPaths::FileExists(It.Value().Filename))
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		Stats.BytesCached += It.Value().Size;
+		AccessCounter = FMath::Max(AccessCounter, It.Value().LastAccess);
+	}
+	for (auto It = BlobHashes.CreateIterator(); It; ++It)
+	{
+		if (!Files.Contains(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	bDirty = false;
+}
+
+void FGitRevisionCache::Save()
+{
+	TArray<uint8> Buffer;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (!bDirty)
+		{
+			return;
+		}
+
+		// Not the tips of the branches: a fetch outside of the editor may move them before the next session
+		FMemoryWriter Writer(Buffer);
+		Writer << BlobHashes << Files;
+		bDirty = false;
+	}
+
+	GitPersistentFile::Save(GetIndexFilename(), GitRevisionCacheConstants::Magic, GitRevisionCacheConstants::Version, Buffer);
+}
+
+bool FGitRevisionCache::FindFile(const FString& InPath, const FString& InCommitId, FString& OutFilename)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	const FString* BlobHash = BlobHashes.Find(MakeKey(InPath, InCommitId));
+	FCachedFile* File = BlobHash ? Files.Find(*BlobHash) : nullptr;
+	if (File == nullptr || !FPaths::FileExists(File->Filename))
+	{
+		Stats.Misses++;
+		return false;
+	}
+
+	File->LastAccess = ++AccessCounter;
+	bDirty = true;
+	Stats.Hits++;
+	Stats.BytesServed += File->Size;
+	OutFilename = File->Filename;
+	return true;
+}
+
+void FGitRevisionCache::AddFile(const FString& InPath, const FString& InCommitId, const FString& InBlobHash, const FString& InFilename)
+{
+	const int64 FileSize = IFileManager::Get().FileSize(*InFilename);
+	if (FileSize < 0)
+	{
+		return;
+	}
+
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		BlobHashes.Add(MakeKey(InPath, InCommitId), InBlobHash);
+		FCachedFile* File = Files.Find(InBlobHash);
+		if (File == nullptr)
+		{
+			File = &Files.Add(InBlobHash);
+			File->Filename = InFilename;
+			File->Size = FileSize;
+			Stats.BytesCached += FileSize;
+		}
+		File->LastAccess = ++AccessCounter;
+		bDirty = true;
+
+		EvictLeastRecentlyUsed();
+	}
+	Save();
+}
+
+void FGitRevisionCache::EvictLeastRecentlyUsed()
+{
+	if (Stats.BytesCached <= GitRevisionCacheConstants::MaxBytes)
+	{
+		return;
+	}
+
+	TArray<FString> LeastRecentlyUsed;
+	Files.GenerateKeyArray(LeastRecentlyUsed);
+	LeastRecentlyUsed.Sort([this](const FString& A, const FString& B)
+	{
+		return Files[A].LastAccess < Files[B].LastAccess;
+	});
+
+	TSet<FString> Evicted;
+	// Always keep the most recent file, even if it is bigger than the cache
+	for (int32 Index = 0; Index < LeastRecentlyUsed.Num() - 1 && Stats.BytesCached > GitRevisionCacheConstants::MaxBytes; Index++)
+	{
+		const FCachedFile& File = Files[LeastRecentlyUsed[Index]];
+		IFileManager::Get().Delete(*File.Filename, false, false, true);
+		Stats.BytesCached -= File.Size;
+		Stats.BytesEvicted += File.Size;
+		Evicted.Add(LeastRecentlyUsed[Index]);
+		Files.Remove(LeastRecentlyUsed[Index]);
+	}
+	for (auto It = BlobHashes.CreateIterator(); It; ++It)
+	{
+		if (Evicted.Contains(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TSharedPtr<FGitSourceControlRevision, ESPMode::ThreadSafe> FGitRevisionCache::FindBranchRevision(const FString& InBranchName)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	if (const TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>* Revision = BranchRevisions.Find(InBranchName))
+	{
+		Stats.Hits++;
+		// Return a copy, that the caller is free to point to its own file
+		return MakeShareable(new FGitSourceControlRevision(Revision->Get()));
+	}
+	Stats.Misses++;
+	return nullptr;
+}
+
+void FGitRevisionCache::AddBranchRevision(const FString& InBranchName, const TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>& InRevision)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	BranchRevisions.Add(InBranchName, MakeShareable(new FGitSourceControlRevision(InRevision.Get())));
+}
+
+void FGitRevisionCache::InvalidateBranches()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	BranchRevisions.Reset();
+}
+
+FGitRevisionCacheStats FGitRevisionCache::GetStats() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Stats;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GitSourceControlRevision.h"
+#include "HAL/CriticalSection.h"
+
+/** Counters of the revision cache, to check how effective it is */
+struct FGitRevisionCacheStats
+{
+	/** Lookups answered by the cache, without running git */
+	int64 Hits = 0;
+	/** Lookups that had to run git */
+	int64 Misses = 0;
+	/** Bytes served from the cache */
+	int64 BytesServed = 0;
+	/** Bytes currently in the cache */
+	int64 BytesCached = 0;
+	/** Bytes deleted from the cache to stay within its size limit */
+	int64 BytesEvicted = 0;
+};
+
+/**
+ * Cache of the revisions extracted for diffs, persisted across editor sessions.
+ *
+ * Extracted files are stored in the content-addressed blob cache and indexed by (path, commit),
+ * bounded in size by evicting the least recently used ones. The revision at the tip of each branch
+ * is memoized too, for the session only, until a fetch, pull or push moves the remote branches.
+ */
+class FGitRevisionCache
+{
+public:
+	static FGitRevisionCache& Get();
+
+	/** Load the index of the cache persisted by the last session */
+	void Load();
+
+	/** Write the index of the cache to disk, if it changed */
+	void Save();
+
+	/** Find the file extracted for a path at a commit */
+	bool FindFile(const FString& InPath, const FString& InCommitId, FString& OutFilename);
+
+	/** Add a file extracted for a path at a commit, evicting the least recently used ones if the cache is full */
+	void AddFile(const FString& InPath, const FString& InCommitId, const FString& InBlobHash, const FString& InFilename);
+
+	/** Find the revision at the tip of a branch */
+	TSharedPtr<FGitSourceControlRevision, ESPMode::ThreadSafe> FindBranchRevision(const FString& InBranchName);
+
+	/** Memoize the revision at the tip of a branch */
+	void AddBranchRevision(const FString& InBranchName, const TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>& InRevision);
+
+	/** Forget the tips of the branches, after a fetch, pull or push moved them */
+	void InvalidateBranches();
+
+	FGitRevisionCacheStats GetStats() const;
+
+private:
+	/** A file in the blob cache */
+	struct FCachedFile
+	{
+		FString Filename;
+		int64 Size = 0;
+		/** Position in the LRU order (higher is more recent) */
+		uint64 LastAccess = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FCachedFile& File)
+		{
+			return Ar << File.Filename << File.Size << File.LastAccess;
+		}
+	};
+
+	/** Path of the index of the cache */
+	static FString GetIndexFilename();
+
+	static FString MakeKey(const FString& InPath, const FString& InCommitId);
+
+	/** Evict the least recently used files until the cache fits within its size limit */
+	void EvictLeastRecentlyUsed();
+
+	mutable FCriticalSection CriticalSection;
+
+	/** Blob hash of each (path, commit) */
+	TMap<FString, FString> BlobHashes;
+
+	/** Extracted files, by blob hash */
+	TMap<FString, FCachedFile> Files;
+
+	/** Revision at the tip of each branch */
+	TMap<FString, TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>> BranchRevisions;
+
+	uint64 AccessCounter = 0;
+	bool bDirty = false;
+	FGitRevisionCacheStats Stats;
+};
@@ -9,9 +9,8 @@
 #include "Async/Async.h"
 
 FGitSourceControlRunner::FGitSourceControlRunner()
+	: State(MakeShared<FState, ESPMode::ThreadSafe>())
 {
-	bRunThread = true;
-	bRefreshSpawned = false;
 	StopEvent = FPlatformProcess::GetSynchEventFromPool(true);
 	Thread = FRunnableThread::Create(this, TEXT("GitSourceControlRunner"));
 }
@@ -33,49 +32,48 @@ bool FGitSourceControlRunner::Init()
 
 uint32 FGitSourceControlRunner::Run()
 {
-	while (bRunThread)
+	while (State->bRunThread)
 	{
 		StopEvent->Wait(30000);
-		if (!bRunThread)
+		if (!State->bRunThread)
 		{
 			break;
 		}
 		// If we're not running the task already
-		if (!bRefreshSpawned)
+		if (!State->bRefreshSpawned)
 		{
 			// Flag that we're running the task already
-			bRefreshSpawned = true;
-			const auto ExecuteResult = Async(EAsyncExecution::TaskGraphMainThread, [this] {
+			State->bRefreshSpawned = true;
+			// Do not wait for the game thread: the runner must stay responsive to Stop() while the editor is busy.
+			// The task and the completion only hold the shared state, since the runner can be deleted before they run.
+			AsyncTask(ENamedThreads::GameThread, [State = State] {
 				FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
 				// Module not loaded, bail. Usually happens when editor is shutting down, and this prevents a crash from bad timing.
-				if (!GitSourceControl)
+				if (!GitSourceControl || !State->bRunThread)
 				{
-					return ECommandResult::Failed;
+					State->bRefreshSpawned = false;
+					return;
 				}
 				FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
 				TSharedRef<FGitFetch, ESPMode::ThreadSafe> RefreshOperation = ISourceControlOperation::Create<FGitFetch>();
 				RefreshOperation->bUpdateStatus = true;
+				RefreshOperation->bBackgroundRefresh = true;
+				const FSourceControlOperationComplete OnComplete = FSourceControlOperationComplete::CreateLambda([State](const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
+				{
+					// Mark task as done
+					State->bRefreshSpawned = false;
+				});
 #if ENGINE_MAJOR_VERSION >= 5
-				const ECommandResult::Type Result = Provider.Execute(RefreshOperation, FSourceControlChangelistPtr(), FGitSourceControlModule::GetEmptyStringArray(), EConcurrency::Asynchronous,
-					FSourceControlOperationComplete::CreateRaw(this, &FGitSourceControlRunner::OnSourceControlOperationComplete));
+				const ECommandResult::Type Result = Provider.Execute(RefreshOperation, FSourceControlChangelistPtr(), FGitSourceControlModule::GetEmptyStringArray(), EConcurrency::Asynchronous, OnComplete);
 #else
-				const ECommandResult::Type Result = Provider.Execute(RefreshOperation, FGitSourceControlModule::GetEmptyStringArray(), EConcurrency::Asynchronous,
-					FSourceControlOperationComplete::CreateRaw(this, &FGitSourceControlRunner::OnSourceControlOperationComplete));
+				const ECommandResult::Type Result = Provider.Execute(RefreshOperation, FGitSourceControlModule::GetEmptyStringArray(), EConcurrency::Asynchronous, OnComplete);
 #endif
-				return Result;
-				});
-			// Wait for result if not already completed
-			if (bRefreshSpawned && bRunThread)
-			{
-				// Get the result
-				ECommandResult::Type Result = ExecuteResult.Get();
-				// If still not completed,
-				if (bRefreshSpawned)
+				// Mark failures as done, successes have to complete
+				if (Result != ECommandResult::Succeeded)
 				{
-					// mark failures as done, successes have to complete
-					bRefreshSpawned = Result == ECommandResult::Succeeded;
+					State->bRefreshSpawned = false;
 				}
-			}
+			});
 		}
 	}
 
@@ -84,12 +82,6 @@ uint32 FGitSourceControlRunner::Run()
 
 void FGitSourceControlRunner::Stop()
 {
-	bRunThread = false;
+	State->bRunThread = false;
 	StopEvent->Trigger();
 }
-
-void FGitSourceControlRunner::OnSourceControlOperationComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
-{
-	// Mark task as done
-	bRefreshSpawned = false;
-}
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 
 #include "HAL/Runnable.h"
+#include "Templates/Atomic.h"
 
 #include "ISourceControlProvider.h"
 #include "ISourceControlOperation.h"
@@ -23,12 +24,16 @@ public:
 	bool Init() override;
 	uint32 Run() override;
 	void Stop() override;
-	void OnSourceControlOperationComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
-
 
 private:
+	/** Flags shared with the refresh queued on the game thread and with its completion, that may outlive the runner */
+	struct FState
+	{
+		TAtomic<bool> bRunThread{true};
+		TAtomic<bool> bRefreshSpawned{false};
+	};
+
 	FRunnableThread* Thread;
 	FEvent* StopEvent;
-	bool bRunThread;
-	bool bRefreshSpawned;
+	TSharedRef<FState, ESPMode::ThreadSafe> State;
 };
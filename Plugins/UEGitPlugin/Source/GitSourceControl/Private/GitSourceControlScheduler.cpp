@@ -0,0 +1,235 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlScheduler.h"
+
+#include "GitSourceControlCommand.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+#include "ISourceControlOperation.h"
+#include "Misc/ScopeLock.h"
+#include "SourceControlOperations.h"
+
+namespace GitCommandSchedulerConstants
+{
+/** Number of worker threads of each lane */
+const int32 NumWorkers[(int32)EGitCommandLane::Num] = { 2, 1, 1 };
+/** Number of files above which a check-in, sync or revert goes to the bulk lane */
+const int32 BulkFileCount = 50;
+} // namespace GitCommandSchedulerConstants
+
+FGitCommandScheduler::FWorker::FWorker(FGitCommandScheduler& InScheduler, EGitCommandLane InLane)
+	: Scheduler(InScheduler)
+	, Lane(InLane)
+{
+}
+
+uint32 FGitCommandScheduler::FWorker::Run()
+{
+	FEvent* WorkEvent = Scheduler.Lanes[(int32)Lane].WorkEvent;
+	while (!Scheduler.bStopping)
+	{
+		if (FGitSourceControlCommand* Command = Scheduler.Dequeue(Lane))
+		{
+			Command->DoThreadedWork();
+			// The command may already have been deleted by the provider
+			Scheduler.OnCommandDone(Lane);
+		}
+		else
+		{
+			WorkEvent->Wait();
+		}
+	}
+	// Pass the stop signal on to the next worker of the lane
+	WorkEvent->Trigger();
+	return 0;
+}
+
+FGitCommandScheduler::FGitCommandScheduler()
+{
+	static const TCHAR* LaneNames[(int32)EGitCommandLane::Num] = { TEXT("Interactive"), TEXT("Background"), TEXT("Bulk") };
+
+	for (int32 LaneIndex = 0; LaneIndex < (int32)EGitCommandLane::Num; LaneIndex++)
+	{
+		Lanes[LaneIndex].WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		for (int32 WorkerIndex = 0; WorkerIndex < GitCommandSchedulerConstants::NumWorkers[LaneIndex]; WorkerIndex++)
+		{
+			FWorker* Worker = Workers.Emplace_GetRef(MakeUnique<FWorker>(*this, (EGitCommandLane)LaneIndex)).Get();
+			const FString ThreadName = FString::Printf(TEXT("GitSourceControl%s%d"), LaneNames[LaneIndex], WorkerIndex);
+			Threads.Add(FRunnableThread::Create(Worker, *ThreadName));
+		}
+	}
+}
+
+FGitCommandScheduler::~FGitCommandScheduler()
+{
+	FPlatformAtomics::InterlockedExchange(&bStopping, 1);
+	for (FLane& Lane : Lanes)
+	{
+		Lane.WorkEvent->Trigger();
+	}
+	for (FRunnableThread* Thread : Threads)
+	{
+		if (Thread)
+		{
+			Thread->WaitForCompletion();
+			delete Thread;
+		}
+	}
+	Threads.Reset();
+	Workers.Reset();
+
+	for (FLane& Lane : Lanes)
+	{
+		// Let the provider collect the commands that will never run: abandoning one queues the commands merged into it again, to be abandoned in turn
+		while (Lane.Pending.Num() > 0)
+		{
+			const FPendingCommand PendingCommand = Lane.Pending.Pop();
+			PendingCommand.Command->Abandon();
+		}
+		FPlatformProcess::ReturnSynchEventToPool(Lane.WorkEvent);
+		Lane.WorkEvent = nullptr;
+	}
+}
+
+EGitCommandLane FGitCommandScheduler::GetLane(const FGitSourceControlCommand& InCommand)
+{
+	// The user is waiting for synchronous commands, and for the force updates of the states
+	if (!InCommand.bAutoDelete || InCommand.bInteractive)
+	{
+		return EGitCommandLane::Interactive;
+	}
+
+	const FName OperationName = InCommand.Operation->GetName();
+	if (OperationName == "Fetch" || OperationName == "UpdateStatus")
+	{
+		return EGitCommandLane::Background;
+	}
+	if ((OperationName == "CheckIn" || OperationName == "Sync" || OperationName == "Revert") && InCommand.Files.Num() > GitCommandSchedulerConstants::BulkFileCount)
+	{
+		return EGitCommandLane::Bulk;
+	}
+	return EGitCommandLane::Interactive;
+}
+
+void FGitCommandScheduler::Schedule(FGitSourceControlCommand& InCommand)
+{
+	const EGitCommandLane LaneIndex = GetLane(InCommand);
+	FLane& Lane = Lanes[(int32)LaneIndex];
+	InCommand.Scheduler = this;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (TryCoalesce(Lane, InCommand))
+		{
+			Lane.Stats.Coalesced++;
+			return;
+		}
+		Lane.Pending.Add({ &InCommand, FPlatformTime::Seconds() });
+		Lane.Stats.QueueDepth = Lane.Pending.Num();
+	}
+	Lane.WorkEvent->Trigger();
+}
+
+bool FGitCommandScheduler::TryCoalesce(FLane& InLane, FGitSourceControlCommand& InCommand)
+{
+	if (InCommand.Operation->GetName() != "UpdateStatus")
+	{
+		return false;
+	}
+	TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> Operation = StaticCastSharedRef<FUpdateStatus>(InCommand.Operation);
+
+	for (const FPendingCommand& PendingCommand : InLane.Pending)
+	{
+		FGitSourceControlCommand& Pending = *PendingCommand.Command;
+		// A canceled command would only queue it again
+		if (Pending.Operation->GetName() != "UpdateStatus" || Pending.PathToRepositoryRoot != InCommand.PathToRepositoryRoot || Pending.IsCanceled())
+		{
+			continue;
+		}
+		TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> PendingOperation = StaticCastSharedRef<FUpdateStatus>(Pending.Operation);
+		if (PendingOperation->ShouldUpdateHistory() != Operation->ShouldUpdateHistory() ||
+			PendingOperation->ShouldGetOpenedOnly() != Operation->ShouldGetOpenedOnly() ||
+			PendingOperation->ShouldUpdateModifiedState() != Operation->ShouldUpdateModifiedState())
+		{
+			continue;
+		}
+
+		// Without files, a status update covers the whole project: only merge it with another one
+		bool bOverlaps = Pending.Files.Num() == 0 && InCommand.Files.Num() == 0;
+		if (!bOverlaps && Pending.Files.Num() > 0 && InCommand.Files.Num() > 0)
+		{
+			const TSet<FString> PendingFiles(Pending.Files);
+			for (const FString& File : InCommand.Files)
+			{
+				if (PendingFiles.Contains(File))
+				{
+					bOverlaps = true;
+					break;
+				}
+			}
+			if (bOverlaps)
+			{
+				for (const FString& File : InCommand.Files)
+				{
+					if (!PendingFiles.Contains(File))
+					{
+						Pending.Files.Add(File);
+					}
+				}
+			}
+		}
+		if (bOverlaps)
+		{
+			Pending.CoalescedCommands.Add(&InCommand);
+			return true;
+		}
+	}
+	return false;
+}
+
+FGitSourceControlCommand* FGitCommandScheduler::Dequeue(EGitCommandLane InLane)
+{
+	FLane& Lane = Lanes[(int32)InLane];
+	FGitSourceControlCommand* Command = nullptr;
+	bool bMorePending = false;
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (Lane.Pending.Num() > 0)
+		{
+			const FPendingCommand PendingCommand = Lane.Pending[0];
+			Lane.Pending.RemoveAt(0);
+			Command = PendingCommand.Command;
+
+			const double WaitSeconds = FPlatformTime::Seconds() - PendingCommand.QueuedTime;
+			Command->QueueWaitSeconds = WaitSeconds;
+			Lane.Stats.QueueDepth = Lane.Pending.Num();
+			Lane.Stats.Running++;
+			Lane.Stats.Started++;
+			Lane.Stats.TotalWaitSeconds += WaitSeconds;
+			Lane.Stats.MaxWaitSeconds = FMath::Max(Lane.Stats.MaxWaitSeconds, WaitSeconds);
+			bMorePending = Lane.Pending.Num() > 0;
+		}
+	}
+	if (bMorePending)
+	{
+		// The event only wakes up one worker: pass it on to another idle one
+		Lane.WorkEvent->Trigger();
+	}
+	return Command;
+}
+
+void FGitCommandScheduler::OnCommandDone(EGitCommandLane InLane)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Lanes[(int32)InLane].Stats.Running--;
+}
+
+FGitCommandLaneStats FGitCommandScheduler::GetStats(EGitCommandLane InLane) const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Lanes[(int32)InLane].Stats;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Runnable.h"
+
+class FGitSourceControlCommand;
+class FEvent;
+class FRunnableThread;
+
+/** Priority lanes of the command scheduler, each with its own worker threads */
+enum class EGitCommandLane : uint8
+{
+	/** Commands the user is waiting for: synchronous ones, force updates of the states, check out, revert... */
+	Interactive,
+	/** Periodic refreshes: fetch and asynchronous status updates */
+	Background,
+	/** Long running commands on many files: big check-ins, syncs and reverts */
+	Bulk,
+
+	Num
+};
+
+/** Metrics of a lane, displayed in the settings panel */
+struct FGitCommandLaneStats
+{
+	/** Commands waiting for a worker */
+	int32 QueueDepth = 0;
+	/** Commands being executed */
+	int32 Running = 0;
+	/** Commands started since the scheduler was created */
+	int64 Started = 0;
+	/** Status updates merged into a pending one instead of being queued */
+	int64 Coalesced = 0;
+	/** Time spent by the started commands waiting for a worker */
+	double TotalWaitSeconds = 0.0;
+	double MaxWaitSeconds = 0.0;
+
+	double GetAverageWaitSeconds() const
+	{
+		return Started > 0 ? TotalWaitSeconds / Started : 0.0;
+	}
+};
+
+/**
+ * Runs the commands of the provider on dedicated threads, by priority lane.
+ *
+ * Interactive commands never wait behind a background fetch or a bulk check-in, since each lane
+ * has its own workers. An UpdateStatus overlapping one still pending in its lane is merged into it
+ * rather than running git twice.
+ */
+class FGitCommandScheduler
+{
+public:
+	FGitCommandScheduler();
+
+	/** Abandon the pending commands and join the workers (the provider cancels the running ones first) */
+	~FGitCommandScheduler();
+
+	/** The lane a command should run in, from its operation, concurrency and number of files */
+	static EGitCommandLane GetLane(const FGitSourceControlCommand& InCommand);
+
+	/** Queue a command in its lane, or merge it into a pending command doing the same work */
+	void Schedule(FGitSourceControlCommand& InCommand);
+
+	FGitCommandLaneStats GetStats(EGitCommandLane InLane) const;
+
+private:
+	struct FPendingCommand
+	{
+		FGitSourceControlCommand* Command;
+		double QueuedTime;
+	};
+
+	struct FLane
+	{
+		TArray<FPendingCommand> Pending;
+		FGitCommandLaneStats Stats;
+		/** Wakes up one worker of the lane */
+		FEvent* WorkEvent = nullptr;
+	};
+
+	/** A worker thread pulling the commands of a lane */
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(FGitCommandScheduler& InScheduler, EGitCommandLane InLane);
+
+		virtual uint32 Run() override;
+
+	private:
+		FGitCommandScheduler& Scheduler;
+		EGitCommandLane Lane;
+	};
+
+	/** Merge a status update into a pending one of the lane with the same options and overlapping files, if any */
+	bool TryCoalesce(FLane& InLane, FGitSourceControlCommand& InCommand);
+
+	/** Take the next command of a lane, or nullptr if there is none */
+	FGitSourceControlCommand* Dequeue(EGitCommandLane InLane);
+
+	/** Called by a worker when it is done with a command */
+	void OnCommandDone(EGitCommandLane InLane);
+
+	mutable FCriticalSection CriticalSection;
+
+	FLane Lanes[(int32)EGitCommandLane::Num];
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	TArray<FRunnableThread*> Threads;
+
+	volatile int32 bStopping = 0;
+};
@@ -66,6 +66,20 @@ bool FGitSourceControlSettings::SetLfsUserName(const FString& InString)
 	return bChanged;
 }
 
+bool FGitSourceControlSettings::IsUsingNativeReadBackend() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return bUsingNativeReadBackend;
+}
+
+bool FGitSourceControlSettings::SetUsingNativeReadBackend(const bool InUsingNativeReadBackend)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	const bool bChanged = (bUsingNativeReadBackend != InUsingNativeReadBackend);
+	bUsingNativeReadBackend = InUsingNativeReadBackend;
+	return bChanged;
+}
+
 // This is called at startup nearly before anything else in our module: BinaryPath will then be used by the provider
 void FGitSourceControlSettings::LoadSettings()
 {
@@ -74,6 +88,7 @@ void FGitSourceControlSettings::LoadSettings()
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), BinaryPath, IniFile);
 	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingGitLfsLocking"), bUsingGitLfsLocking, IniFile);
 	GConfig->GetString(*GitSettingsConstants::SettingsSection, TEXT("LfsUserName"), LfsUserName, IniFile);
+	GConfig->GetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingNativeReadBackend"), bUsingNativeReadBackend, IniFile);
 }
 
 void FGitSourceControlSettings::SaveSettings() const
@@ -83,5 +98,6 @@ void FGitSourceControlSettings::SaveSettings() const
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("BinaryPath"), *BinaryPath, IniFile);
 	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingGitLfsLocking"), bUsingGitLfsLocking, IniFile);
 	GConfig->SetString(*GitSettingsConstants::SettingsSection, TEXT("LfsUserName"), *LfsUserName, IniFile);
+	GConfig->SetBool(*GitSettingsConstants::SettingsSection, TEXT("UsingNativeReadBackend"), bUsingNativeReadBackend, IniFile);
 	GConfig->Flush(false, IniFile);
 }
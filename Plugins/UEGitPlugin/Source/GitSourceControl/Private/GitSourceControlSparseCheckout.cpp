@@ -0,0 +1,219 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlSparseCheckout.h"
+
+#include "GitSourceControlModule.h"
+#include "GitSourceControlUtils.h"
+#include "ISourceControlModule.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
+
+FGitSparseCheckout& FGitSparseCheckout::Get()
+{
+	static FGitSparseCheckout SparseCheckout;
+	return SparseCheckout;
+}
+
+static FString WithTrailingSlash(const FString& InPath)
+{
+	return InPath.EndsWith(TEXT("/")) ? InPath : InPath + TEXT("/");
+}
+
+bool FGitSparseCheckout::Refresh(const FString& InPathToGitBinary, const FString& InRepositoryRoot)
+{
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (GitSourceControl && !GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25))
+	{
+		// No "sparse-checkout" command before Git 2.25: only a partial clone would need care, and there is nothing to restrict
+		return true;
+	}
+
+	// A single command for all the settings; it fails when none of them is set, which is the common case
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Parameters{TEXT("--get-regexp"), TEXT("\"^(core\\.sparsecheckout|extensions\\.partialclone|remote\\..*\\.promisor)\"")};
+	GitSourceControlUtils::RunCommand(TEXT("config"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+
+	bool bSparseCheckout = false;
+	bool bConeMode = false;
+	bool bPartialClone = false;
+	for (const FString& Result : Results)
+	{
+		FString Key;
+		FString Value;
+		if (!Result.Split(TEXT(" "), &Key, &Value))
+		{
+			continue;
+		}
+		if (Key == TEXT("core.sparsecheckout"))
+		{
+			bSparseCheckout = Value == TEXT("true");
+		}
+		else if (Key == TEXT("core.sparsecheckoutcone"))
+		{
+			bConeMode = Value == TEXT("true");
+		}
+		else if (Key == TEXT("extensions.partialclone"))
+		{
+			bPartialClone |= !Value.IsEmpty();
+		}
+		else if (Key.EndsWith(TEXT(".promisor")))
+		{
+			bPartialClone |= Value == TEXT("true");
+		}
+	}
+
+	TArray<FString> Cones;
+	if (bSparseCheckout)
+	{
+		if (!bConeMode)
+		{
+			UE_LOG(LogSourceControl, Warning, TEXT("Sparse-checkout is not in cone mode: status and remote queries are not restricted to the checked out files."));
+			bSparseCheckout = false;
+		}
+		else if (!GitSourceControlUtils::RunCommand(TEXT("sparse-checkout"), InPathToGitBinary, InRepositoryRoot, {TEXT("list")}, FGitSourceControlModule::GetEmptyStringArray(), Cones, ErrorMessages))
+		{
+			return false;
+		}
+	}
+
+	const FString Root = WithTrailingSlash(InRepositoryRoot);
+	FWriteScopeLock WriteLock(Lock);
+	RepositoryRoot = Root;
+	bIsSparse = bSparseCheckout;
+	bIsPartialClone = bPartialClone;
+	ConeDirectories.Reset();
+	ConeParents.Reset();
+	if (bIsSparse)
+	{
+		// The files at the root are always checked out
+		ConeParents.Add(Root);
+		for (const FString& Cone : Cones)
+		{
+			const FString ConeDirectory = WithTrailingSlash(Root + Cone);
+			ConeDirectories.Add(ConeDirectory);
+			for (FString Parent = FPaths::GetPath(FPaths::GetPath(ConeDirectory)); Parent.Len() >= Root.Len(); Parent = FPaths::GetPath(Parent))
+			{
+				ConeParents.Add(WithTrailingSlash(Parent));
+			}
+		}
+		UE_LOG(LogSourceControl, Log, TEXT("Sparse-checkout with %d cone(s)%s"), ConeDirectories.Num(), bIsPartialClone ? TEXT(", partial clone") : TEXT(""));
+	}
+	else if (bIsPartialClone)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Partial clone: blobs are fetched on demand"));
+	}
+	return true;
+}
+
+bool FGitSparseCheckout::IsSparse() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return bIsSparse;
+}
+
+bool FGitSparseCheckout::IsPartialClone() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return bIsPartialClone;
+}
+
+TArray<FString> FGitSparseCheckout::FilterToCone(const TArray<FString>& InPaths) const
+{
+	FReadScopeLock ReadLock(Lock);
+	if (!bIsSparse)
+	{
+		return InPaths;
+	}
+
+	TArray<FString> Paths;
+	for (const FString& Path : InPaths)
+	{
+		if (IsInConeLocked(Path))
+		{
+			Paths.Add(Path);
+		}
+		else if (Path.EndsWith(TEXT("/")))
+		{
+			// Only query the parts of the directory that are checked out
+			for (const FString& ConeDirectory : ConeDirectories)
+			{
+				if (ConeDirectory.StartsWith(Path))
+				{
+					Paths.AddUnique(ConeDirectory);
+				}
+			}
+		}
+	}
+	return Paths;
+}
+
+bool FGitSparseCheckout::IsInCone(const FString& InPath) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return !bIsSparse || IsInConeLocked(InPath);
+}
+
+bool FGitSparseCheckout::IsInConeLocked(const FString& InPath) const
+{
+	if (!InPath.StartsWith(RepositoryRoot))
+	{
+		// Not in this repository: nothing to restrict
+		return true;
+	}
+	for (const FString& ConeDirectory : ConeDirectories)
+	{
+		if (InPath.StartsWith(ConeDirectory))
+		{
+			return true;
+		}
+	}
+	// The files directly in the parents of the cones are checked out, but not their other directories
+	return !InPath.EndsWith(TEXT("/")) && ConeParents.Contains(FPaths::GetPath(InPath) + TEXT("/"));
+}
+
+bool FGitSparseCheckout::Hydrate(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InDirectories, TArray<FString>& OutErrorMessages)
+{
+	if (!IsSparse())
+	{
+		// The whole tree is already checked out
+		return true;
+	}
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (GitSourceControl && !GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 26))
+	{
+		OutErrorMessages.Add(TEXT("Adding directories to the sparse-checkout requires Git 2.26 or later"));
+		return false;
+	}
+
+	TArray<FString> Directories;
+	for (const FString& Directory : InDirectories)
+	{
+		FString RelativeDirectory = Directory;
+		if (!FPaths::IsRelative(RelativeDirectory) && !FPaths::MakePathRelativeTo(RelativeDirectory, *WithTrailingSlash(InRepositoryRoot)))
+		{
+			OutErrorMessages.Add(FString::Printf(TEXT("'%s' is outside repository"), *Directory));
+			continue;
+		}
+		RelativeDirectory.RemoveFromEnd(TEXT("/"));
+		if (!RelativeDirectory.IsEmpty())
+		{
+			Directories.Add(MoveTemp(RelativeDirectory));
+		}
+	}
+	if (Directories.Num() == 0)
+	{
+		return OutErrorMessages.Num() == 0;
+	}
+
+	// A single checkout of all the directories, for git to fetch their missing blobs in one batch
+	TArray<FString> Results;
+	const double StartTime = FPlatformTime::Seconds();
+	bool bResult = GitSourceControlUtils::RunCommand(TEXT("sparse-checkout"), InPathToGitBinary, InRepositoryRoot, {TEXT("add")}, Directories, Results, OutErrorMessages);
+	UE_LOG(LogSourceControl, Log, TEXT("Hydrated %d directories in %.3fs"), Directories.Num(), FPlatformTime::Seconds() - StartTime);
+	bResult &= Refresh(InPathToGitBinary, InRepositoryRoot);
+	return bResult;
+}
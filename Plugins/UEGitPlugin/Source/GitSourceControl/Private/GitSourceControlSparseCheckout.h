@@ -0,0 +1,66 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Layout of a repository cloned with "git sparse-checkout" cones and/or as a partial clone ("--filter=blob:none").
+ *
+ * In cone mode, the working tree only has the files of the cone directories, and the files directly in their parent
+ * directories: the status and remote queries are restricted to those. In a partial clone, the blobs are only fetched
+ * when git needs their content, so the queries avoid anything that would read the content of the whole history.
+ */
+class FGitSparseCheckout
+{
+public:
+	static FGitSparseCheckout& Get();
+
+	/** The layout of another repository than the one of the editor, for the tests: the editor uses Get() */
+	FGitSparseCheckout() = default;
+
+	/**
+	 * Read the sparse-checkout cones and the partial clone remote of a repository
+	 * @returns false if git could not be run
+	 */
+	bool Refresh(const FString& InPathToGitBinary, const FString& InRepositoryRoot);
+
+	/** Whether the working tree is restricted to sparse-checkout cones */
+	bool IsSparse() const;
+
+	/** Whether the repository is a partial clone, with blobs fetched on demand */
+	bool IsPartialClone() const;
+
+	/**
+	 * Restrict absolute paths to the cones: directories (ending with a '/') that contain cones are replaced by these cones,
+	 * and paths outside of the cones are removed. Returns the paths unchanged if the repository is not sparse.
+	 */
+	TArray<FString> FilterToCone(const TArray<FString>& InPaths) const;
+
+	/** Whether an absolute path is in the working tree of the cones */
+	bool IsInCone(const FString& InPath) const;
+
+	/**
+	 * Add directories to the cones with "git sparse-checkout add", so that their files are checked out.
+	 * In a partial clone, git fetches all the missing blobs of these directories in a single batch.
+	 *
+	 * @param	InDirectories		Directories relative to the repository root, or absolute
+	 */
+	bool Hydrate(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InDirectories, TArray<FString>& OutErrorMessages);
+
+private:
+	bool IsInConeLocked(const FString& InPath) const;
+
+	mutable FRWLock Lock;
+	FString RepositoryRoot;
+	bool bIsSparse = false;
+	bool bIsPartialClone = false;
+	/** Absolute cone directories, ending with a '/' */
+	TArray<FString> ConeDirectories;
+	/** Absolute parent directories of the cones, ending with a '/', whose own files are in the working tree */
+	TSet<FString> ConeParents;
+};
@@ -0,0 +1,57 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlStartupSnapshot.h"
+
+#include "GitSourceControlPersistentFile.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace GitStartupSnapshotConstants
+{
+/** Identifies a startup snapshot file */
+const uint32 Magic = 0x53534947; // "GISS"
+/** To be bumped when the layout of the file changes */
+const int32 Version = 1;
+} // namespace GitStartupSnapshotConstants
+
+static void SerializeSnapshot(FArchive& Ar, FGitStartupSnapshot& Snapshot)
+{
+	Ar << Snapshot.RepositoryRoot << Snapshot.UserName << Snapshot.UserEmail;
+	Ar << Snapshot.BranchName << Snapshot.RemoteBranchName << Snapshot.RemoteUrl;
+	Ar << Snapshot.LockableTypes << Snapshot.bUsingGitLfsLocking;
+}
+
+FString FGitStartupSnapshot::GetFilename()
+{
+	return GitPersistentFile::GetFilename(TEXT("Startup.bin"));
+}
+
+bool FGitStartupSnapshot::Load(const FString& InRepositoryRoot)
+{
+	FGitStartupSnapshot Loaded;
+	if (!GitPersistentFile::Load(GetFilename(), GitStartupSnapshotConstants::Magic, GitStartupSnapshotConstants::Version, [&Loaded](FArchive& Reader)
+	{
+		SerializeSnapshot(Reader, Loaded);
+		return true;
+	}))
+	{
+		return false;
+	}
+	if (Loaded.RepositoryRoot != InRepositoryRoot)
+	{
+		return false;
+	}
+
+	*this = MoveTemp(Loaded);
+	return true;
+}
+
+bool FGitStartupSnapshot::Save() const
+{
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+	SerializeSnapshot(Writer, const_cast<FGitStartupSnapshot&>(*this));
+	return GitPersistentFile::Save(GetFilename(), GitStartupSnapshotConstants::Magic, GitStartupSnapshotConstants::Version, Buffer);
+}
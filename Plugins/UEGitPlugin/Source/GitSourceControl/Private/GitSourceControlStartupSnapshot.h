@@ -0,0 +1,40 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Repository configuration found by the last editor session, persisted in the Saved directory.
+ *
+ * It lets the provider be available as soon as the editor starts, while the same queries run again
+ * in the background to update it in place.
+ */
+struct FGitStartupSnapshot
+{
+	FString RepositoryRoot;
+	FString UserName;
+	FString UserEmail;
+	FString BranchName;
+	FString RemoteBranchName;
+	FString RemoteUrl;
+	/** Extensions of the files lockable with Git LFS, as found by check-attr */
+	TArray<FString> LockableTypes;
+	/** Whether Git LFS locking was still enabled once the lockable types were known */
+	bool bUsingGitLfsLocking = false;
+
+	/**
+	 * Load the snapshot of a repository
+	 * @returns false if there is none, if it was written for another repository or by another version
+	 */
+	bool Load(const FString& InRepositoryRoot);
+
+	/** Write the snapshot to disk */
+	bool Save() const;
+
+private:
+	static FString GetFilename();
+};
@@ -14,6 +14,186 @@
 
 #define LOCTEXT_NAMESPACE "GitSourceControl.State"
 
+FGitState FGitFileStateTable::Get(FGitPathId InPathId) const
+{
+	FGitState State;
+	State.FileState = GetFileState(InPathId);
+	State.TreeState = GetTreeState(InPathId);
+	State.LockState = GetLockState(InPathId);
+	State.LockUser = GetLockUser(InPathId);
+	State.RemoteState = GetRemoteState(InPathId);
+	State.HeadBranch = GetHeadBranch(InPathId);
+	return State;
+}
+
+// Rows not written yet read as the default FGitState
+EFileState::Type FGitFileStateTable::GetFileState(FGitPathId InPathId) const
+{
+	return FileStates.IsValidIndex(InPathId) ? (EFileState::Type)FileStates[InPathId] : FGitState().FileState;
+}
+
+ETreeState::Type FGitFileStateTable::GetTreeState(FGitPathId InPathId) const
+{
+	return TreeStates.IsValidIndex(InPathId) ? (ETreeState::Type)TreeStates[InPathId] : FGitState().TreeState;
+}
+
+ELockState::Type FGitFileStateTable::GetLockState(FGitPathId InPathId) const
+{
+	return LockStates.IsValidIndex(InPathId) ? (ELockState::Type)LockStates[InPathId] : FGitState().LockState;
+}
+
+ERemoteState::Type FGitFileStateTable::GetRemoteState(FGitPathId InPathId) const
+{
+	return RemoteStates.IsValidIndex(InPathId) ? (ERemoteState::Type)RemoteStates[InPathId] : FGitState().RemoteState;
+}
+
+const FString& FGitFileStateTable::GetLockUser(FGitPathId InPathId) const
+{
+	return FGitPathTable::Get().GetPath(LockUsers.IsValidIndex(InPathId) ? LockUsers[InPathId] : FGitPathTable::EmptyId);
+}
+
+const FString& FGitFileStateTable::GetHeadBranch(FGitPathId InPathId) const
+{
+	return FGitPathTable::Get().GetPath(HeadBranches.IsValidIndex(InPathId) ? HeadBranches[InPathId] : FGitPathTable::EmptyId);
+}
+
+void FGitFileStateTable::SetFileState(FGitPathId InPathId, EFileState::Type InFileState)
+{
+	Grow(InPathId);
+	FileStates[InPathId] = (uint8)InFileState;
+}
+
+void FGitFileStateTable::SetTreeState(FGitPathId InPathId, ETreeState::Type InTreeState)
+{
+	Grow(InPathId);
+	TreeStates[InPathId] = (uint8)InTreeState;
+}
+
+void FGitFileStateTable::SetLockState(FGitPathId InPathId, ELockState::Type InLockState, const FString& InLockUser)
+{
+	Grow(InPathId);
+	LockStates[InPathId] = (uint8)InLockState;
+	LockUsers[InPathId] = InLockUser.IsEmpty() ? FGitPathTable::EmptyId : FGitPathTable::Get().Intern(InLockUser);
+}
+
+void FGitFileStateTable::SetRemoteState(FGitPathId InPathId, ERemoteState::Type InRemoteState, const FString& InHeadBranch)
+{
+	Grow(InPathId);
+	RemoteStates[InPathId] = (uint8)InRemoteState;
+	HeadBranches[InPathId] = InHeadBranch.IsEmpty() ? FGitPathTable::EmptyId : FGitPathTable::Get().Intern(InHeadBranch);
+}
+
+void FGitFileStateTable::Reset(FGitPathId InPathId)
+{
+	if (FileStates.IsValidIndex(InPathId))
+	{
+		const FGitState DefaultState;
+		FileStates[InPathId] = (uint8)DefaultState.FileState;
+		TreeStates[InPathId] = (uint8)DefaultState.TreeState;
+		LockStates[InPathId] = (uint8)DefaultState.LockState;
+		RemoteStates[InPathId] = (uint8)DefaultState.RemoteState;
+		LockUsers[InPathId] = FGitPathTable::EmptyId;
+		HeadBranches[InPathId] = FGitPathTable::EmptyId;
+	}
+}
+
+void FGitFileStateTable::Empty()
+{
+	FileStates.Empty();
+	TreeStates.Empty();
+	LockStates.Empty();
+	RemoteStates.Empty();
+	LockUsers.Empty();
+	HeadBranches.Empty();
+}
+
+SIZE_T FGitFileStateTable::GetAllocatedSize() const
+{
+	return FileStates.GetAllocatedSize() + TreeStates.GetAllocatedSize() + LockStates.GetAllocatedSize() + RemoteStates.GetAllocatedSize()
+		+ LockUsers.GetAllocatedSize() + HeadBranches.GetAllocatedSize();
+}
+
+void FGitFileStateTable::Grow(FGitPathId InPathId)
+{
+	const int32 OldNum = FileStates.Num();
+	if ((int32)InPathId < OldNum)
+	{
+		return;
+	}
+
+	// Ids are dense, so the columns simply grow up to the latest id (the array slack amortizes it)
+	const int32 NewNum = (int32)InPathId + 1;
+	const FGitState DefaultState;
+	FileStates.SetNumUninitialized(NewNum);
+	TreeStates.SetNumUninitialized(NewNum);
+	LockStates.SetNumUninitialized(NewNum);
+	RemoteStates.SetNumUninitialized(NewNum);
+	LockUsers.SetNumUninitialized(NewNum);
+	HeadBranches.SetNumUninitialized(NewNum);
+	for (int32 Index = OldNum; Index < NewNum; Index++)
+	{
+		FileStates[Index] = (uint8)DefaultState.FileState;
+		TreeStates[Index] = (uint8)DefaultState.TreeState;
+		LockStates[Index] = (uint8)DefaultState.LockState;
+		RemoteStates[Index] = (uint8)DefaultState.RemoteState;
+		LockUsers[Index] = FGitPathTable::EmptyId;
+		HeadBranches[Index] = FGitPathTable::EmptyId;
+	}
+}
+
+FGitSourceControlState::FGitSourceControlState(const FString& InLocalFilename)
+	: PathId(FGitPathTable::Get().Intern(InLocalFilename))
+	, FilenameId(PathId)
+	, StateTable(nullptr)
+	, TimeStamp(0)
+	, HeadModTime(0)
+{
+}
+
+FGitSourceControlState::FGitSourceControlState(FGitPathId InPathId, const FGitFileStateTable* InStateTable)
+	: PathId(InPathId)
+	, FilenameId(InPathId)
+	, StateTable(InStateTable)
+	, TimeStamp(0)
+	, HeadModTime(0)
+{
+}
+
+EFileState::Type FGitSourceControlState::GetFileState() const
+{
+	return StateTable ? StateTable->GetFileState(PathId) : State.FileState;
+}
+
+ETreeState::Type FGitSourceControlState::GetTreeState() const
+{
+	return StateTable ? StateTable->GetTreeState(PathId) : State.TreeState;
+}
+
+ELockState::Type FGitSourceControlState::GetLockState() const
+{
+	return StateTable ? StateTable->GetLockState(PathId) : State.LockState;
+}
+
+ERemoteState::Type FGitSourceControlState::GetRemoteState() const
+{
+	return StateTable ? StateTable->GetRemoteState(PathId) : State.RemoteState;
+}
+
+const FString& FGitSourceControlState::GetLockUser() const
+{
+	return StateTable ? StateTable->GetLockUser(PathId) : State.LockUser;
+}
+
+const FString& FGitSourceControlState::GetHeadBranch() const
+{
+	return StateTable ? StateTable->GetHeadBranch(PathId) : State.HeadBranch;
+}
+
+void FGitSourceControlState::SetFilename(const FString& InFilename)
+{
+	FilenameId = FGitPathTable::Get().Intern(InFilename);
+}
+
 int32 FGitSourceControlState::GetHistorySize() const
 {
 	return History.Num();
@@ -162,9 +342,9 @@ FText FGitSourceControlState::GetDisplayName() const
 	case EGitState::NotAtHead:
 		return LOCTEXT("NotCurrent", "Not current");
 	case EGitState::LockedOther:
-		return FText::Format(LOCTEXT("CheckedOutOther", "Checked out by: {0}"), FText::FromString(State.LockUser));
+		return FText::Format(LOCTEXT("CheckedOutOther", "Checked out by: {0}"), FText::FromString(GetLockUser()));
 	case EGitState::NotLatest:
-		return FText::Format(LOCTEXT("ModifiedOtherBranch", "Modified in branch: {0}"), FText::FromString(State.HeadBranch));
+		return FText::Format(LOCTEXT("ModifiedOtherBranch", "Modified in branch: {0}"), FText::FromString(GetHeadBranch()));
 	case EGitState::Unmerged:
 		return LOCTEXT("Conflicted", "Conflicted");
 	case EGitState::Added:
@@ -194,9 +374,10 @@ FText FGitSourceControlState::GetDisplayTooltip() const
 	case EGitState::NotAtHead:
 		return LOCTEXT("NotCurrent_Tooltip", "The file(s) are not at the head revision");
 	case EGitState::LockedOther:
-		return FText::Format(LOCTEXT("CheckedOutOther_Tooltip", "Checked out by: {0}"), FText::FromString(State.LockUser));
+		return FText::Format(LOCTEXT("CheckedOutOther_Tooltip", "Checked out by: {0}"), FText::FromString(GetLockUser()));
 	case EGitState::NotLatest:
-		return FText::Format(LOCTEXT("ModifiedOtherBranch_Tooltip", "Modified in branch: {0} CL:{1} ({2})"), FText::FromString(State.HeadBranch), FText::FromString(HeadCommit), FText::FromString(HeadAction));
+		return FText::Format(LOCTEXT("ModifiedOtherBranch_Tooltip", "Modified in branch: {0} CL:{1} ({2})"), FText::FromString(GetHeadBranch()),
+			FText::FromString(HeadCommit.IsEmpty() ? TEXT("Unknown") : HeadCommit), FText::FromString(HeadAction.IsEmpty() ? TEXT("Changed") : HeadAction));
 	case EGitState::Unmerged:
 		return LOCTEXT("ContentsConflict_Tooltip", "The contents of the item conflict with updates received from the repository.");
 	case EGitState::Added:
@@ -221,7 +402,7 @@ FText FGitSourceControlState::GetDisplayTooltip() const
 
 const FString& FGitSourceControlState::GetFilename() const
 {
-	return LocalFilename;
+	return FGitPathTable::Get().GetPath(FilenameId);
 }
 
 const FDateTime& FGitSourceControlState::GetTimeStamp() const
@@ -245,13 +426,13 @@ bool FGitSourceControlState::CanCheckIn() const
 	}
 
 	// We can check back in if we're locked.
-	if (State.LockState == ELockState::Locked)
+	if (GetLockState() == ELockState::Locked)
 	{
 		return true;
 	}
 
 	// We can check in any file that has been modified, unless someone else locked it.
-	if (State.LockState != ELockState::LockedOther && IsModified() && IsSourceControlled())
+	if (GetLockState() != ELockState::LockedOther && IsModified() && IsSourceControlled())
 	{
 		return true;
 	}
@@ -261,7 +442,7 @@ bool FGitSourceControlState::CanCheckIn() const
 
 bool FGitSourceControlState::CanCheckout() const
 {
-	if (State.LockState == ELockState::Unlockable)
+	if (GetLockState() == ELockState::Unlockable)
 	{
 		// Everything is already available for check in (checked out).
 		return false;
@@ -269,20 +450,20 @@ bool FGitSourceControlState::CanCheckout() const
 	else
 	{
 		// We don't want to allow checkout if the file is out-of-date, as modifying an out-of-date binary file will most likely result in a merge conflict
-		return State.LockState == ELockState::NotLocked && IsCurrent();
+		return GetLockState() == ELockState::NotLocked && IsCurrent();
 	}
 }
 
 bool FGitSourceControlState::IsCheckedOut() const
 {
-	if (State.LockState == ELockState::Unlockable)
+	if (GetLockState() == ELockState::Unlockable)
 	{
 		return IsSourceControlled(); // TODO: try modified instead? might block editing the file with a holding pattern
 	}
 	else
 	{
 		// We check for modified here too, because sometimes you don't lock a file but still want to push it. CanCheckout still true, so that you can lock it later...
-		return State.LockState == ELockState::Locked || (State.FileState == EFileState::Modified && State.LockState != ELockState::LockedOther);
+		return GetLockState() == ELockState::Locked || (GetFileState() == EFileState::Modified && GetLockState() != ELockState::LockedOther);
 	}
 }
 
@@ -294,12 +475,12 @@ bool FGitSourceControlState::IsCheckedOutOther(FString* Who) const
 		// But, if there is no lock user, it shows information about modification in other branches, which is important.
 		// So, only show our own lock user if it hasn't been modified in another branch.
 		// This is a very, very rare state (maybe impossible), but one that should be displayed properly.
-		if (State.LockState == ELockState::LockedOther || (State.LockState == ELockState::Locked && !IsModifiedInOtherBranch()))
+		if (GetLockState() == ELockState::LockedOther || (GetLockState() == ELockState::Locked && !IsModifiedInOtherBranch()))
 		{
-			*Who = State.LockUser;
+			*Who = GetLockUser();
 		}
 	}
-	return State.LockState == ELockState::LockedOther;
+	return GetLockState() == ELockState::LockedOther;
 }
 
 bool FGitSourceControlState::IsCheckedOutInOtherBranch(const FString& CurrentBranch) const
@@ -310,7 +491,7 @@ bool FGitSourceControlState::IsCheckedOutInOtherBranch(const FString& CurrentBra
 
 bool FGitSourceControlState::IsModifiedInOtherBranch(const FString& CurrentBranch) const
 {
-	return State.RemoteState == ERemoteState::NotLatest;
+	return GetRemoteState() == ERemoteState::NotLatest;
 }
 
 bool FGitSourceControlState::GetOtherBranchHeadModification(FString& HeadBranchOut, FString& ActionOut, int32& HeadChangeListOut) const
@@ -320,36 +501,36 @@ bool FGitSourceControlState::GetOtherBranchHeadModification(FString& HeadBranchO
 		return false;
 	}
 
-	HeadBranchOut = State.HeadBranch;
-	ActionOut = HeadAction; // TODO: from ERemoteState
+	HeadBranchOut = GetHeadBranch();
+	ActionOut = HeadAction.IsEmpty() ? TEXT("Changed") : HeadAction; // TODO: from ERemoteState
 	HeadChangeListOut = 0; // TODO: get head commit
 	return true;
 }
 
 bool FGitSourceControlState::IsCurrent() const
 {
-	return State.RemoteState != ERemoteState::NotAtHead && State.RemoteState != ERemoteState::NotLatest;
+	return GetRemoteState() != ERemoteState::NotAtHead && GetRemoteState() != ERemoteState::NotLatest;
 }
 
 bool FGitSourceControlState::IsSourceControlled() const
 {
-	return State.TreeState != ETreeState::Untracked && State.TreeState != ETreeState::Ignored && State.TreeState != ETreeState::NotInRepo;
+	return GetTreeState() != ETreeState::Untracked && GetTreeState() != ETreeState::Ignored && GetTreeState() != ETreeState::NotInRepo;
 }
 
 bool FGitSourceControlState::IsAdded() const
 {
 	// Added is when a file was untracked and is now added.
-	return State.FileState == EFileState::Added;
+	return GetFileState() == EFileState::Added;
 }
 
 bool FGitSourceControlState::IsDeleted() const
 {
-	return State.FileState == EFileState::Deleted;
+	return GetFileState() == EFileState::Deleted;
 }
 
 bool FGitSourceControlState::IsIgnored() const
 {
-	return State.TreeState == ETreeState::Ignored;
+	return GetTreeState() == ETreeState::Ignored;
 }
 
 bool FGitSourceControlState::CanEdit() const
@@ -371,24 +552,24 @@ bool FGitSourceControlState::CanDelete() const
 
 bool FGitSourceControlState::IsUnknown() const
 {
-	return State.FileState == EFileState::Unknown && State.TreeState == ETreeState::NotInRepo;
+	return GetFileState() == EFileState::Unknown && GetTreeState() == ETreeState::NotInRepo;
 }
 
 bool FGitSourceControlState::IsModified() const
 {
-	return State.TreeState == ETreeState::Working ||
-		State.TreeState == ETreeState::Staged;
+	return GetTreeState() == ETreeState::Working ||
+		GetTreeState() == ETreeState::Staged;
 }
 
 
 bool FGitSourceControlState::CanAdd() const
 {
-	return State.TreeState == ETreeState::Untracked;
+	return GetTreeState() == ETreeState::Untracked;
 }
 
 bool FGitSourceControlState::IsConflicted() const
 {
-	return State.FileState == EFileState::Unmerged;
+	return GetFileState() == EFileState::Unmerged;
 }
 
 bool FGitSourceControlState::CanRevert() const
@@ -401,7 +582,7 @@ bool FGitSourceControlState::CanRevert() const
 EGitState::Type FGitSourceControlState::GetGitState() const
 {
 	// No matter what, we must pull from remote, even if we have locked or if we have modified.
-	switch (State.RemoteState)
+	switch (GetRemoteState())
 	{
 	case ERemoteState::NotAtHead:
 		return EGitState::NotAtHead;
@@ -411,18 +592,18 @@ EGitState::Type FGitSourceControlState::GetGitState() const
 
 	/** Someone else locked this file across branches. */
 	// We cannot push under any circumstance, if someone else has locked.
-	if (State.LockState == ELockState::LockedOther)
+	if (GetLockState() == ELockState::LockedOther)
 	{
 		return EGitState::LockedOther;
 	}
 
 	// We could theoretically push, but we shouldn't.
-	if (State.RemoteState == ERemoteState::NotLatest)
+	if (GetRemoteState() == ERemoteState::NotLatest)
 	{
 		return EGitState::NotLatest;
 	}
 
-	switch (State.FileState)
+	switch (GetFileState())
 	{
 	case EFileState::Unmerged:
 		return EGitState::Unmerged;
@@ -436,12 +617,12 @@ EGitState::Type FGitSourceControlState::GetGitState() const
 		break;
 	}
 
-	if (State.TreeState == ETreeState::Untracked)
+	if (GetTreeState() == ETreeState::Untracked)
 	{
 		return EGitState::Untracked;
 	}
 
-	if (State.LockState == ELockState::Locked)
+	if (GetLockState() == ELockState::Locked)
 	{
 		return EGitState::CheckedOut;
 	}
@@ -0,0 +1,152 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlTracer.h"
+
+#include "GitSourceControlCommand.h"
+#include "IGitSourceControlWorker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+
+UE_TRACE_CHANNEL_DEFINE(GitSourceControlChannel)
+
+namespace GitCommandTracerConstants
+{
+/** Number of processes kept for the CSV export */
+const int32 MaxTraces = 4096;
+} // namespace GitCommandTracerConstants
+
+static TAutoConsoleVariable<bool> CVarGitLogCommands(
+	TEXT("git.LogCommands"),
+	false,
+	TEXT("Log each git process launched by the plugin, with its duration and return code."));
+
+FGitCommandTracer& FGitCommandTracer::Get()
+{
+	static FGitCommandTracer Tracer;
+	return Tracer;
+}
+
+FString FGitCommandTracer::GetCommandName(const FString& InCommand)
+{
+	TArray<FString> Tokens;
+	InCommand.ParseIntoArrayWS(Tokens);
+	for (const FString& Token : Tokens)
+	{
+		if (!Token.StartsWith(TEXT("-")))
+		{
+			return Token;
+		}
+	}
+	return InCommand;
+}
+
+void FGitCommandTracer::Record(FGitCommandTrace&& InTrace)
+{
+	if (CVarGitLogCommands.GetValueOnAnyThread())
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("git %s: %d parameter(s), %d file(s), %.3fs (waited %.3fs), %lld/%lld bytes out/err, returned %d [%s]"),
+			*InTrace.Command, InTrace.NumParameters, InTrace.NumFiles, InTrace.WallSeconds, InTrace.QueueWaitSeconds,
+			InTrace.StdOutBytes, InTrace.StdErrBytes, InTrace.ReturnCode, *InTrace.Worker.ToString());
+	}
+
+	const FString CommandName = GetCommandName(InTrace.Command);
+	FScopeLock ScopeLock(&CriticalSection);
+	FGitCommandTraceTotals& CommandTotals = Totals.FindOrAdd(CommandName);
+	CommandTotals.Count++;
+	CommandTotals.Failures += InTrace.ReturnCode != 0 ? 1 : 0;
+	CommandTotals.TotalSeconds += InTrace.WallSeconds;
+	CommandTotals.MaxSeconds = FMath::Max(CommandTotals.MaxSeconds, InTrace.WallSeconds);
+	CommandTotals.StdOutBytes += InTrace.StdOutBytes;
+	CommandTotals.StdErrBytes += InTrace.StdErrBytes;
+	CommandTotals.NumFiles += InTrace.NumFiles;
+
+	if (Traces.Num() < GitCommandTracerConstants::MaxTraces)
+	{
+		Traces.Add(MoveTemp(InTrace));
+	}
+	else
+	{
+		Traces[NextTrace] = MoveTemp(InTrace);
+		NextTrace = (NextTrace + 1) % GitCommandTracerConstants::MaxTraces;
+	}
+}
+
+TMap<FString, FGitCommandTraceTotals> FGitCommandTracer::GetTotals() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Totals;
+}
+
+bool FGitCommandTracer::ExportCsv(const FString& InFilename) const
+{
+	FString Csv(TEXT("StartTime,Command,NumParameters,NumFiles,WallSeconds,QueueWaitSeconds,StdOutBytes,StdErrBytes,ReturnCode,Worker\n"));
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		for (int32 Index = 0; Index < Traces.Num(); Index++)
+		{
+			const FGitCommandTrace& Trace = Traces[(NextTrace + Index) % Traces.Num()];
+			Csv += FString::Printf(TEXT("%.6f,\"%s\",%d,%d,%.6f,%.6f,%lld,%lld,%d,%s\n"), Trace.StartTime, *Trace.Command.Replace(TEXT("\""), TEXT("\"\"")),
+				Trace.NumParameters, Trace.NumFiles, Trace.WallSeconds, Trace.QueueWaitSeconds, Trace.StdOutBytes, Trace.StdErrBytes, Trace.ReturnCode, *Trace.Worker.ToString());
+		}
+	}
+	if (!FFileHelper::SaveStringToFile(Csv, *InFilename))
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to write %s"), *InFilename);
+		return false;
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("Git commands written to %s"), *InFilename);
+	return true;
+}
+
+void FGitCommandTracer::LogStats() const
+{
+	TMap<FString, FGitCommandTraceTotals> SortedTotals = GetTotals();
+	SortedTotals.ValueSort([](const FGitCommandTraceTotals& A, const FGitCommandTraceTotals& B) { return A.TotalSeconds > B.TotalSeconds; });
+
+	UE_LOG(LogSourceControl, Log, TEXT("%-16s %8s %8s %10s %9s %9s %12s %10s"), TEXT("Command"), TEXT("Count"), TEXT("Failed"), TEXT("Total(s)"), TEXT("Avg(ms)"), TEXT("Max(ms)"), TEXT("StdOut"), TEXT("Files"));
+	for (const auto& Pair : SortedTotals)
+	{
+		const FGitCommandTraceTotals& CommandTotals = Pair.Value;
+		UE_LOG(LogSourceControl, Log, TEXT("%-16s %8lld %8lld %10.3f %9.1f %9.1f %12lld %10lld"), *Pair.Key, CommandTotals.Count, CommandTotals.Failures, CommandTotals.TotalSeconds,
+			1000.0 * CommandTotals.TotalSeconds / CommandTotals.Count, 1000.0 * CommandTotals.MaxSeconds, CommandTotals.StdOutBytes, CommandTotals.NumFiles);
+	}
+}
+
+void FGitCommandTracer::Reset()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Totals.Reset();
+	Traces.Reset();
+	NextTrace = 0;
+}
+
+FGitScopedCommandTrace::FGitScopedCommandTrace(const FString& InCommand, int32 InNumParameters, int32 InNumFiles)
+{
+	Trace.Command = InCommand;
+	Trace.NumParameters = InNumParameters;
+	Trace.NumFiles = InNumFiles;
+	Trace.StartTime = FPlatformTime::Seconds();
+	if (const FGitSourceControlCommand* Command = FGitSourceControlCommand::GetCurrent())
+	{
+		Trace.Worker = Command->Worker->GetName();
+		Trace.QueueWaitSeconds = Command->QueueWaitSeconds;
+	}
+}
+
+FGitScopedCommandTrace::~FGitScopedCommandTrace()
+{
+	Trace.WallSeconds = FPlatformTime::Seconds() - Trace.StartTime;
+	FGitCommandTracer::Get().Record(MoveTemp(Trace));
+}
+
+void FGitScopedCommandTrace::SetResult(int32 InReturnCode, int64 InStdOutBytes, int64 InStdErrBytes)
+{
+	Trace.ReturnCode = InReturnCode;
+	Trace.StdOutBytes = InStdOutBytes;
+	Trace.StdErrBytes = InStdErrBytes;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Trace/Trace.h"
+
+/** Unreal Insights channel of the git processes, enabled with "-trace=cpu,GitSourceControl" */
+UE_TRACE_CHANNEL_EXTERN(GitSourceControlChannel)
+
+/** Timing event of a git process in Unreal Insights, named after its command */
+#if ENGINE_MAJOR_VERSION == 5
+#define GIT_TRACE_COMMAND_SCOPE(Command) TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(Command, GitSourceControlChannel)
+#else
+#define GIT_TRACE_COMMAND_SCOPE(Command) TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(Command)
+#endif
+
+/** A git process launched by the plugin */
+struct FGitCommandTrace
+{
+	/** The git command, with its global options, like "--no-optional-locks status" */
+	FString Command;
+	int32 NumParameters = 0;
+	int32 NumFiles = 0;
+	/** Start of the process, in FPlatformTime::Seconds() */
+	double StartTime = 0.0;
+	double WallSeconds = 0.0;
+	int64 StdOutBytes = 0;
+	int64 StdErrBytes = 0;
+	int32 ReturnCode = 0;
+	/** Worker of the command that launched the process, None outside of a command */
+	FName Worker;
+	/** Time that command waited in the scheduler before running */
+	double QueueWaitSeconds = 0.0;
+};
+
+/** Totals of the processes of a same git command */
+struct FGitCommandTraceTotals
+{
+	int64 Count = 0;
+	int64 Failures = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+	int64 StdOutBytes = 0;
+	int64 StdErrBytes = 0;
+	int64 NumFiles = 0;
+};
+
+/**
+ * Records every git process launched by the plugin, to find the commands that dominate editor hitches.
+ *
+ * Keeps the totals by git command since the start of the editor (or the last reset), and the last processes for a CSV export.
+ */
+class FGitCommandTracer
+{
+public:
+	static FGitCommandTracer& Get();
+
+	void Record(FGitCommandTrace&& InTrace);
+
+	/** Totals by git command ("status", "log"...), the global options left out */
+	TMap<FString, FGitCommandTraceTotals> GetTotals() const;
+
+	/** Write the last processes to a CSV file, oldest first */
+	bool ExportCsv(const FString& InFilename) const;
+
+	/** Log the totals, by decreasing total time */
+	void LogStats() const;
+
+	void Reset();
+
+	/** The git command of a command line, without the global options: "status" for "--no-optional-locks status" */
+	static FString GetCommandName(const FString& InCommand);
+
+private:
+	FGitCommandTracer() = default;
+
+	mutable FCriticalSection CriticalSection;
+	TMap<FString, FGitCommandTraceTotals> Totals;
+	/** Ring buffer of the last processes */
+	TArray<FGitCommandTrace> Traces;
+	int32 NextTrace = 0;
+};
+
+/**
+ * Measures a git process: records it on destruction, with the worker and queue wait of the command run by the current thread.
+ */
+class FGitScopedCommandTrace
+{
+public:
+	FGitScopedCommandTrace(const FString& InCommand, int32 InNumParameters, int32 InNumFiles);
+	~FGitScopedCommandTrace();
+
+	void SetResult(int32 InReturnCode, int64 InStdOutBytes, int64 InStdErrBytes);
+
+private:
+	FGitCommandTrace Trace;
+};
@@ -6,9 +6,19 @@
 #include "GitSourceControlUtils.h"
 
 #include "GitMessageLog.h"
+#include "GitSourceControlAttributeCache.h"
 #include "GitSourceControlCommand.h"
+#include "GitSourceControlLockIndex.h"
 #include "GitSourceControlModule.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlOperations.h"
+#include "GitSourceControlPackageReloader.h"
+#include "GitSourceControlPathTable.h"
 #include "GitSourceControlProvider.h"
+#include "GitSourceControlReadBackend.h"
+#include "GitSourceControlRevisionCache.h"
+#include "GitSourceControlSparseCheckout.h"
+#include "GitSourceControlTracer.h"
 #include "HAL/PlatformProcess.h"
 
 #include "HAL/PlatformFile.h"
@@ -29,6 +39,7 @@
 #include "Logging/MessageLog.h"
 #include "Misc/DateTime.h"
 #include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
 #include "Misc/Timespan.h"
 
 #include "PackageTools.h"
@@ -41,6 +52,12 @@
 #endif
 
 #include "Async/Async.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/PlatformMisc.h"
 #include "UObject/Linker.h"
 
 #ifndef GIT_DEBUG_STATUS
@@ -53,12 +70,28 @@ namespace GitSourceControlConstants
 {
 /** The maximum number of files we submit in a single Git command */
 const int32 MaxFilesPerBatch = 50;
+/** The maximum number of batches of a read-only Git command run concurrently */
+const int32 MaxParallelBatches = 8;
+/** The number of empty reads of a process pipe after which we stop yielding and start sleeping */
+const int32 StreamYieldReads = 16;
+/** The delay during which saved packages are collected before being staged together */
+const float SaveStagingWindowSeconds = 0.5f;
+/** The number of times a file is sent to the LFS server to be locked or unlocked, when it fails for a transient reason */
+const int32 MaxLfsLockAttempts = 3;
+/** The delay before the first retry of a failed lock or unlock, doubled at each attempt */
+const float LfsLockRetryDelaySeconds = 0.5f;
+/** One background fetch out of this many fetches all the branches, to prune deleted ones and find new status branches */
+const int32 FullFetchInterval = 10;
+/** The number of times files are restored by a revert, when the editor still holds some of them */
+const int32 MaxRevertAttempts = 10;
+const float RevertRetryDelaySeconds = 0.1f;
 } // namespace GitSourceControlConstants
 
 FGitScopedTempFile::FGitScopedTempFile(const FText& InText)
 {
 	Filename = FPaths::CreateTempFilename(*FPaths::ProjectLogDir(), TEXT("Git-Temp"), TEXT(".txt"));
-	if (!FFileHelper::SaveStringToFile(InText.ToString(), *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	bIsValid = FFileHelper::SaveStringToFile(InText.ToString(), *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	if (!bIsValid)
 	{
 		UE_LOG(LogSourceControl, Error, TEXT("Failed to write to temp file: %s"), *Filename);
 	}
@@ -80,41 +113,75 @@ const FString& FGitScopedTempFile::GetFilename() const
 	return Filename;
 }
 
+bool FGitScopedTempFile::IsValid() const
+{
+	return bIsValid;
+}
+
 FDateTime FGitLockedFilesCache::LastUpdated = FDateTime::MinValue();
-TMap<FString, FString> FGitLockedFilesCache::LockedFiles = TMap<FString, FString>();
+
+static FGitLfsLockIndex& GetLockIndex()
+{
+	static FGitLfsLockIndex LockIndex;
+	return LockIndex;
+}
+
+void FGitLockedFilesCache::LoadIndex(const FString& InRepositoryRoot)
+{
+	GetLockIndex().Load(InRepositoryRoot);
+}
+
+bool FGitLockedFilesCache::IsPopulated()
+{
+	return GetLockIndex().IsPopulated();
+}
+
+bool FGitLockedFilesCache::GetLockUser(const FString& filePath, FString& lockUser)
+{
+	return GetLockIndex().FindLockOwner(filePath, lockUser);
+}
+
+TMap<FString, FString> FGitLockedFilesCache::GetLockedFiles()
+{
+	return GetLockIndex().GetLockOwners();
+}
 
 void FGitLockedFilesCache::SetLockedFiles(const TMap<FString, FString>& newLocks)
-{	
-	for (auto lock : LockedFiles)
+{
+	TArray<FGitLfsLock> Locks;
+	Locks.Reserve(newLocks.Num());
+	for (const auto& lock : newLocks)
 	{
-		if (!newLocks.Contains(lock.Key))
-		{
-			OnFileLockChanged(lock.Key, lock.Value, false);
-		}
-	}
-	
-	for (auto lock : newLocks)
-	{		
-		if (!LockedFiles.Contains(lock.Key))
-		{
-			OnFileLockChanged(lock.Key, lock.Value, true);
-		}		
+		FGitLfsLock& Lock = Locks.AddDefaulted_GetRef();
+		Lock.Path = lock.Key;
+		Lock.Owner = lock.Value;
 	}
+	SetLockedFiles(Locks);
+}
 
-	LockedFiles = newLocks;
+void FGitLockedFilesCache::SetLockedFiles(const TArray<FGitLfsLock>& newLocks)
+{
+	// Only the locks that changed since the last listing are reported
+	GetLockIndex().ApplyListing(newLocks, &FGitLockedFilesCache::OnFileLockChanged);
+	GetLockIndex().Save();
 }
 
 void FGitLockedFilesCache::AddLockedFile(const FString& filePath, const FString& lockUser)
 {
-	LockedFiles.Add(filePath, lockUser);
-	OnFileLockChanged(filePath, lockUser, true);
+	FGitLfsLock Lock;
+	Lock.Path = filePath;
+	Lock.Owner = lockUser;
+	GetLockIndex().AddLock(Lock, &FGitLockedFilesCache::OnFileLockChanged);
 }
 
 void FGitLockedFilesCache::RemoveLockedFile(const FString& filePath)
 {
-	FString user;
-	LockedFiles.RemoveAndCopyValue(filePath, user);
-	OnFileLockChanged(filePath, user, false);
+	GetLockIndex().RemoveLock(filePath, &FGitLockedFilesCache::OnFileLockChanged);
+}
+
+void FGitLockedFilesCache::SaveIndex()
+{
+	GetLockIndex().Save();
 }
 
 void FGitLockedFilesCache::OnFileLockChanged(const FString& filePath, const FString& lockUser, bool locked)
@@ -191,6 +258,155 @@ namespace GitSourceControlUtils
 		return ChangeRepositoryRootIfSubmodule(AbsoluteFilePaths, PathToRepositoryRoot);
 	}
 
+// Report the last "Phase: NN%" progress line of a chunk of the error stream of git (with --progress)
+static void ReportProgress(FGitSourceControlCommand& InCommand, const FString& InChunk)
+{
+	int32 PercentIndex = INDEX_NONE;
+	if (!InChunk.FindLastChar(TEXT('%'), PercentIndex))
+	{
+		return;
+	}
+	int32 NumberStart = PercentIndex;
+	while (NumberStart > 0 && FChar::IsDigit(InChunk[NumberStart - 1]))
+	{
+		NumberStart--;
+	}
+	if (NumberStart == PercentIndex)
+	{
+		return;
+	}
+	// Progress lines are rewritten in place using carriage returns
+	int32 LineStart = NumberStart;
+	while (LineStart > 0 && InChunk[LineStart - 1] != TEXT('\r') && InChunk[LineStart - 1] != TEXT('\n'))
+	{
+		LineStart--;
+	}
+	FString Phase = InChunk.Mid(LineStart, NumberStart - LineStart).TrimStartAndEnd();
+	Phase.RemoveFromStart(TEXT("remote:"));
+	Phase.RemoveFromEnd(TEXT(":"));
+	InCommand.SetProgress(Phase.TrimStartAndEnd(), FCString::Atoi(*InChunk.Mid(NumberStart, PercentIndex - NumberStart)));
+}
+
+// Only keep the final state of the progress lines rewritten in place, for the log and the messages of the command
+static void StripProgressUpdates(FString& InOutErrors)
+{
+	if (!InOutErrors.Contains(TEXT("\r")))
+	{
+		return;
+	}
+	TArray<FString> Lines;
+	InOutErrors.ParseIntoArray(Lines, TEXT("\n"), false);
+	for (FString& Line : Lines)
+	{
+		int32 LastCarriageReturn = INDEX_NONE;
+		Line.TrimEndInline();
+		if (Line.FindLastChar(TEXT('\r'), LastCarriageReturn))
+		{
+			Line.RightChopInline(LastCarriageReturn + 1);
+		}
+	}
+	InOutErrors = FString::Join(Lines, TEXT("\n"));
+}
+
+#if GIT_USE_CANCELLABLE_PROCESS
+// Equivalent of FPlatformProcess::ExecProcess(), that kills git if the command running it gets canceled, and reports its progress
+static bool ExecGitProcess(const FString& InBinary, const FString& InParameters, int32& OutReturnCode, FString& OutResults, FString& OutErrors)
+{
+	OutReturnCode = -1;
+	FGitSourceControlCommand* Command = FGitSourceControlCommand::GetCurrent();
+
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdErrRead = nullptr;
+	void* StdErrWrite = nullptr;
+	verify(FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite));
+	verify(FPlatformProcess::CreatePipe(StdErrRead, StdErrWrite));
+
+	bool bCanceled = false;
+	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*InBinary, *InParameters, false, true, true, nullptr, 0, nullptr, StdOutWrite, nullptr, StdErrWrite);
+	if (ProcessHandle.IsValid())
+	{
+		// Outputs are kept as bytes until the end, so that multi-byte UTF-8 characters split between two reads are decoded properly
+		TArray<uint8> StdOut;
+		TArray<uint8> StdErr;
+		TArray<uint8> Chunk;
+		int32 IdleReads = 0;
+		auto ReadPipes = [&]()
+		{
+			bool bRead = false;
+			Chunk.Reset();
+			if (FPlatformProcess::ReadPipeToArray(StdOutRead, Chunk) && Chunk.Num() > 0)
+			{
+				StdOut.Append(Chunk);
+				bRead = true;
+			}
+			Chunk.Reset();
+			if (FPlatformProcess::ReadPipeToArray(StdErrRead, Chunk) && Chunk.Num() > 0)
+			{
+				StdErr.Append(Chunk);
+				if (Command)
+				{
+					const FUTF8ToTCHAR Progress(reinterpret_cast<const ANSICHAR*>(Chunk.GetData()), Chunk.Num());
+					ReportProgress(*Command, FString(Progress.Length(), Progress.Get()));
+				}
+				bRead = true;
+			}
+			return bRead;
+		};
+
+		while (true)
+		{
+			if (Command && Command->IsCanceled())
+			{
+				FPlatformProcess::TerminateProc(ProcessHandle, true);
+				bCanceled = true;
+				break;
+			}
+			if (ReadPipes())
+			{
+				IdleReads = 0;
+			}
+			else if (FPlatformProcess::IsProcRunning(ProcessHandle))
+			{
+				FPlatformProcess::Sleep(IdleReads++ < GitSourceControlConstants::StreamYieldReads ? 0.0f : 0.001f);
+			}
+			else
+			{
+				// Drain what was written between the last read and the exit of the process
+				while (ReadPipes())
+				{
+				}
+				break;
+			}
+		}
+
+		if (!bCanceled)
+		{
+			FPlatformProcess::GetProcReturnCode(ProcessHandle, &OutReturnCode);
+		}
+		FPlatformProcess::CloseProc(ProcessHandle);
+
+		const FUTF8ToTCHAR Results(reinterpret_cast<const ANSICHAR*>(StdOut.GetData()), StdOut.Num());
+		OutResults = FString(Results.Length(), Results.Get());
+		const FUTF8ToTCHAR Errors(reinterpret_cast<const ANSICHAR*>(StdErr.GetData()), StdErr.Num());
+		OutErrors = FString(Errors.Length(), Errors.Get());
+		if (bCanceled)
+		{
+			OutErrors += TEXT("\nCanceled by the user");
+		}
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to launch '%s'"), *InBinary);
+	}
+
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::ClosePipe(StdErrRead, StdErrWrite);
+
+	return ProcessHandle.IsValid() && !bCanceled;
+}
+#endif
+
 // Launch the Git command line process and extract its results & errors
 bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, FString& OutResults, FString& OutErrors, const int32 ExpectedReturnCode /* = 0 */)
 {
@@ -266,10 +482,21 @@ bool RunCommandInternalRaw(const FString& InCommand, const FString& InPathToGitB
 	}
 #endif
 
-	FPlatformProcess::ExecProcess(*PathToGitOrEnvBinary, *FullCommand, &ReturnCode, &OutResults, &OutErrors);
+	{
+		GIT_TRACE_COMMAND_SCOPE(*InCommand);
+		FGitScopedCommandTrace CommandTrace(InCommand, InParameters.Num(), InFiles.Num());
+#if GIT_USE_CANCELLABLE_PROCESS
+		ExecGitProcess(PathToGitOrEnvBinary, FullCommand, ReturnCode, OutResults, OutErrors);
+#else
+		FPlatformProcess::ExecProcess(*PathToGitOrEnvBinary, *FullCommand, &ReturnCode, &OutResults, &OutErrors);
+#endif
+		// Sizes of the outputs once decoded, in characters
+		CommandTrace.SetResult(ReturnCode, OutResults.Len(), OutErrors.Len());
+	}
+	StripProgressUpdates(OutErrors);
 
 #if UE_BUILD_DEBUG
-	// TODO: add a setting to easily enable Verbose logging
+	// The processes can also be logged in any build with "git.LogCommands 1"
 	UE_LOG(LogSourceControl, Verbose, TEXT("RunCommand(%s):\n%s"), *InCommand, *OutResults);
 	if (ReturnCode != ExpectedReturnCode)
 	{
@@ -529,7 +756,6 @@ bool CheckGitAvailability(const FString& InPathToGitBinary, FGitVersion* OutVers
 
 void ParseGitVersion(const FString& InVersionString, FGitVersion* OutVersion)
 {
-#if UE_BUILD_DEBUG
 	// Parse "git version 2.31.1.vfs.0.3" into the string "2.31.1.vfs.0.3"
 	const FString& TokenVersionStringPtr = InVersionString.RightChop(12);
 	if (!TokenVersionStringPtr.IsEmpty())
@@ -574,7 +800,6 @@ void ParseGitVersion(const FString& InVersionString, FGitVersion* OutVersion)
 			}
 		}
 	}
-#endif
 }
 
 // Find the root of the Git repository, looking from the provided path and upward in its parent directories.
@@ -623,33 +848,10 @@ bool FindRootDirectory(const FString& InPath, FString& OutRepositoryRoot)
 
 void GetUserConfig(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutUserName, FString& OutUserEmail)
 {
-	bool bResults;
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("user.name"));
-	bResults = RunCommandInternal(TEXT("config"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
-	{
-		OutUserName = InfoMessages[0];
-	}
-	else
-	{
-		OutUserName = TEXT("");
-	}
-
-	Parameters.Reset(1);
-	Parameters.Add(TEXT("user.email"));
-	InfoMessages.Reset();
-	bResults &= RunCommandInternal(TEXT("config"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
-	{
-		OutUserEmail = InfoMessages[0];
-	}
-	else
+	GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
 	{
-		OutUserEmail = TEXT("");
-	}
+		return Backend.GetUserConfig(InRepositoryRoot, OutUserName, OutUserEmail);
+	});
 }
 
 bool GetBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName)
@@ -665,37 +867,11 @@ bool GetBranchName(const FString& InPathToGitBinary, const FString& InRepository
 		OutBranchName = Provider.GetBranchName();
 		return true;
 	}
-	
-	bool bResults;
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--short"));
-	Parameters.Add(TEXT("--quiet")); // no error message while in detached HEAD
-	Parameters.Add(TEXT("HEAD"));
-	bResults = RunCommand(TEXT("symbolic-ref"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
-	{
-		OutBranchName = InfoMessages[0];
-	}
-	else
-	{
-		Parameters.Reset(2);
-		Parameters.Add(TEXT("-1"));
-		Parameters.Add(TEXT("--format=\"%h\"")); // no error message while in detached HEAD
-		bResults = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-		if (bResults && InfoMessages.Num() > 0)
-		{
-			OutBranchName = "HEAD detached at ";
-			OutBranchName += InfoMessages[0];
-		}
-		else
-		{
-			bResults = false;
-		}
-	}
 
-	return bResults;
+	return GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
+	{
+		return Backend.GetBranchName(InRepositoryRoot, OutBranchName);
+	});
 }
 
 bool GetRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutBranchName)
@@ -712,18 +888,10 @@ bool GetRemoteBranchName(const FString& InPathToGitBinary, const FString& InRepo
 		return true;
 	}
 
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--abbrev-ref"));
-	Parameters.Add(TEXT("--symbolic-full-name"));
-	Parameters.Add(TEXT("@{u}"));
-	bool bResults = RunCommand(TEXT("rev-parse"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(),
-								InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
+	const bool bResults = GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
 	{
-		OutBranchName = InfoMessages[0];
-	}
+		return Backend.GetRemoteBranchName(InRepositoryRoot, OutBranchName);
+	});
 	if (!bResults)
 	{
 		static bool bRunOnce = true;
@@ -763,47 +931,142 @@ bool GetRemoteBranchesWildcard(const FString& InPathToGitBinary, const FString&
 	
 bool GetCommitInfo(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutCommitId, FString& OutCommitSummary)
 {
-	bool bResults;
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("-1"));
-	Parameters.Add(TEXT("--format=\"%H %s\""));
-	bResults = RunCommandInternal(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
+	return GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
 	{
-		OutCommitId = InfoMessages[0].Left(40);
-		OutCommitSummary = InfoMessages[0].RightChop(41);
-	}
-
-	return bResults;
+		return Backend.GetCommitInfo(InRepositoryRoot, OutCommitId, OutCommitSummary);
+	});
 }
 
 bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryRoot, FString& OutRemoteUrl)
 {
-	TArray<FString> InfoMessages;
-	TArray<FString> ErrorMessages;
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("get-url"));
-	Parameters.Add(TEXT("origin"));
-	const bool bResults = RunCommandInternal(TEXT("remote"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), InfoMessages, ErrorMessages);
-	if (bResults && InfoMessages.Num() > 0)
+	return GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
 	{
-		OutRemoteUrl = InfoMessages[0];
-	}
-
-	return bResults;
+		return Backend.GetRemoteUrl(InRepositoryRoot, OutRemoteUrl);
+	});
 }
 
 TArray<FString> GetSourceControlledAssetPaths()
 {
-	return
+	// In a sparse-checkout, only the cones are in the working tree
+	return FGitSparseCheckout::Get().FilterToCone(
 	{
 		FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),
 		FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir()),
 		FPaths::ConvertRelativePathToFull(FPaths::ProjectPluginsDir()),
 		FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath())
+	});
+}
+
+bool IsReadOnlyCommand(const FString& InCommand)
+{
+	// Commands that never write to the index or the refs, and can thus run concurrently on the same repository.
+	// Skip leading global options such as "--no-optional-locks" to find the actual git command.
+	static const TArray<FString> ReadOnlyCommands = {
+		TEXT("status"), TEXT("log"), TEXT("ls-files"), TEXT("ls-tree"), TEXT("check-attr"),
+		TEXT("diff"), TEXT("show"), TEXT("cat-file"), TEXT("rev-parse")
 	};
+
+	TArray<FString> Tokens;
+	InCommand.ParseIntoArrayWS(Tokens);
+	for (const FString& Token : Tokens)
+	{
+		if (!Token.StartsWith(TEXT("-")))
+		{
+			return ReadOnlyCommands.Contains(Token);
+		}
+	}
+	return false;
+}
+
+/** Threads running the git processes of parallel batches, created on first use */
+static FCriticalSection GitProcessPoolCriticalSection;
+static FQueuedThreadPool* GitProcessPool = nullptr;
+
+/** A worker of RunGitProcessesInParallel(), run by a thread of the pool */
+class FGitProcessWork final : public IQueuedWork
+{
+public:
+	explicit FGitProcessWork(TFunctionRef<void()> InWorker)
+		: Worker(InWorker)
+		, DoneEvent(FPlatformProcess::GetSynchEventFromPool(true))
+	{
+	}
+
+	virtual ~FGitProcessWork()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(DoneEvent);
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		Worker();
+		DoneEvent->Trigger();
+	}
+
+	virtual void Abandon() override
+	{
+		DoneEvent->Trigger();
+	}
+
+	void Wait()
+	{
+		DoneEvent->Wait();
+	}
+
+private:
+	TFunctionRef<void()> Worker;
+	FEvent* DoneEvent;
+};
+
+void RunGitProcessesInParallel(int32 InNumWorkers, TFunctionRef<void()> InWorker)
+{
+	FQueuedThreadPool* Pool = nullptr;
+	if (InNumWorkers > 1 && FPlatformProcess::SupportsMultithreading())
+	{
+		FScopeLock ScopeLock(&GitProcessPoolCriticalSection);
+		if (GitProcessPool == nullptr)
+		{
+			GitProcessPool = FQueuedThreadPool::Allocate();
+			if (!GitProcessPool->Create(GitSourceControlConstants::MaxParallelBatches - 1, 128 * 1024, TPri_Normal, TEXT("GitProcessPool")))
+			{
+				delete GitProcessPool;
+				GitProcessPool = nullptr;
+			}
+		}
+		Pool = GitProcessPool;
+	}
+
+	TArray<TUniquePtr<FGitProcessWork>> Works;
+	if (Pool != nullptr)
+	{
+		for (int32 WorkerIndex = 1; WorkerIndex < InNumWorkers; WorkerIndex++)
+		{
+			Works.Add(MakeUnique<FGitProcessWork>(InWorker));
+			Pool->AddQueuedWork(Works.Last().Get());
+		}
+	}
+
+	InWorker();
+
+	// The calling thread pulled all the work left: the workers not started yet have nothing to do
+	for (const TUniquePtr<FGitProcessWork>& Work : Works)
+	{
+		if (!Pool->RetractQueuedWork(Work.Get()))
+		{
+			Work->Wait();
+		}
+	}
+}
+
+void ShutdownGitProcessPool()
+{
+	FScopeLock ScopeLock(&GitProcessPoolCriticalSection);
+	if (GitProcessPool != nullptr)
+	{
+		GitProcessPool->Destroy();
+		delete GitProcessPool;
+		GitProcessPool = nullptr;
+	}
 }
 
 bool RunCommand(const FString& InCommand, const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters,
@@ -813,21 +1076,59 @@ bool RunCommand(const FString& InCommand, const FString& InPathToGitBinary, cons
 
 	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
 	{
+		const int32 NumBatches = FMath::DivideAndRoundUp(InFiles.Num(), GitSourceControlConstants::MaxFilesPerBatch);
+		const int32 NumWorkers = FMath::Min3(NumBatches, GitSourceControlConstants::MaxParallelBatches, FPlatformMisc::NumberOfCores());
+
 		// Batch files up so we dont exceed command-line limits
-		int32 FileCount = 0;
-		while (FileCount < InFiles.Num())
+		TArray<TArray<FString>> BatchResults;
+		TArray<TArray<FString>> BatchErrors;
+		TArray<bool> BatchSuccess;
+		BatchResults.SetNum(NumBatches);
+		BatchErrors.SetNum(NumBatches);
+		BatchSuccess.SetNumZeroed(NumBatches);
+
+		// Batches run on behalf of the command of the calling thread, and stop as soon as it gets canceled
+		FGitSourceControlCommand* Command = FGitSourceControlCommand::GetCurrent();
+		auto RunBatch = [&](const int32 BatchIndex)
+		{
+			FGitScopedCurrentCommand ScopedCurrentCommand(Command);
+			if (Command && Command->IsCanceled())
+			{
+				return;
+			}
+			const int32 FirstFile = BatchIndex * GitSourceControlConstants::MaxFilesPerBatch;
+			const int32 NumFiles = FMath::Min(GitSourceControlConstants::MaxFilesPerBatch, InFiles.Num() - FirstFile);
+			const TArray<FString> FilesInBatch(InFiles.GetData() + FirstFile, NumFiles);
+			BatchSuccess[BatchIndex] = RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, FilesInBatch, BatchResults[BatchIndex], BatchErrors[BatchIndex]);
+		};
+
+		if (NumWorkers > 1 && IsReadOnlyCommand(InCommand))
 		{
-			TArray<FString> FilesInBatch;
-			for (int32 FileIndex = 0; FileCount < InFiles.Num() && FileIndex < GitSourceControlConstants::MaxFilesPerBatch; FileIndex++, FileCount++)
+			// Read-only commands: a bounded number of workers pull batches until there are none left
+			TAtomic<int32> NextBatch(0);
+			RunGitProcessesInParallel(NumWorkers, [&]()
 			{
-				FilesInBatch.Add(InFiles[FileCount]);
+				for (int32 BatchIndex = NextBatch++; BatchIndex < NumBatches; BatchIndex = NextBatch++)
+				{
+					RunBatch(BatchIndex);
+				}
+			});
+		}
+		else
+		{
+			// Commands writing to the index (add, rm, commit...) would contend on index.lock: keep them serialized
+			for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+			{
+				RunBatch(BatchIndex);
 			}
+		}
 
-			TArray<FString> BatchResults;
-			TArray<FString> BatchErrors;
-			bResult &= RunCommandInternal(InCommand, InPathToGitBinary, InRepositoryRoot, InParameters, FilesInBatch, BatchResults, BatchErrors);
-			OutResults += BatchResults;
-			OutErrorMessages += BatchErrors;
+		// Merge the outputs in batch order, so that results are the same as with a single command
+		for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+		{
+			bResult &= BatchSuccess[BatchIndex];
+			OutResults += MoveTemp(BatchResults[BatchIndex]);
+			OutErrorMessages += MoveTemp(BatchErrors[BatchIndex]);
 		}
 	}
 	else
@@ -875,29 +1176,262 @@ bool RunLFSCommand(const FString& InCommand, const FString& InRepositoryRoot, co
 	return GitSourceControlUtils::RunCommand(Command, LFSLockBinary, InRepositoryRoot, InParameters, InFiles, OutResults, OutErrorMessages);
 }
 
-// Run a Git "commit" command by batches
-bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles,
-			   TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+// Errors worth sending the request again: the server or the network, rather than the file (already locked, not found...)
+static bool IsTransientLfsLockError(const FString& InError)
 {
-	bool bResult = true;
-
-	TArray<FString> AddParameters{TEXT("-A")};
+	static const TCHAR* TransientMarkers[] = {
+		TEXT("timeout"), TEXT("timed out"), TEXT("connection"), TEXT("EOF"), TEXT("Too Many Requests"), TEXT("rate limit"),
+		TEXT("429"), TEXT("500"), TEXT("502"), TEXT("503"), TEXT("504")
+	};
+	for (const TCHAR* Marker : TransientMarkers)
+	{
+		if (InError.Contains(Marker))
+		{
+			return true;
+		}
+	}
+	return false;
+}
 
-	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
+// Path named by a git-lfs error: "Locking Content/A.uasset failed: ..." or "Unable to unlock Content\A.uasset: ...", with forward slashes
+static FString GetLfsErrorPath(const FString& InError)
+{
+	static const TCHAR* Prefixes[] = { TEXT("Locking "), TEXT("Unlocking "), TEXT("Unable to lock "), TEXT("Unable to unlock ") };
+	for (const TCHAR* Prefix : Prefixes)
 	{
-		// Batch files up so we dont exceed command-line limits
-		int32 FileCount = 0;
+		if (InError.StartsWith(Prefix))
 		{
-			TArray<FString> FilesInBatch;
-			for (int32 FileIndex = 0; FileIndex < GitSourceControlConstants::MaxFilesPerBatch; FileIndex++, FileCount++)
+			FString Path = InError.RightChop(FCString::Strlen(Prefix));
+			int32 End = Path.Find(TEXT(" failed"), ESearchCase::CaseSensitive);
+			if (End == INDEX_NONE)
 			{
-				FilesInBatch.Add(InFiles[FileCount]);
+				End = Path.Find(TEXT(": "), ESearchCase::CaseSensitive);
 			}
-			bResult &= RunCommandInternal(TEXT("add"), InPathToGitBinary, InRepositoryRoot, AddParameters, FilesInBatch, OutResults, OutErrorMessages);
-			// First batch is a simple "git commit" command with only the first files
-			bResult &= RunCommandInternal(TEXT("commit"), InPathToGitBinary, InRepositoryRoot, InParameters, FilesInBatch, OutResults, OutErrorMessages);
+			if (End != INDEX_NONE)
+			{
+				Path.LeftInline(End);
+			}
+			return Path.TrimQuotes().Replace(TEXT("\\"), TEXT("/"));
 		}
-
+	}
+	return FString();
+}
+
+// Owner of the lock of a file on the LFS server, as listed by "git-lfs locks": "Content/A.uasset	UserName	ID:123"
+static FString GetLfsLockOwner(const FString& InRepositoryRoot, const FString& GitBinaryFallback, const FString& InFile)
+{
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Parameters{FString::Printf(TEXT("--path=\"%s\""), *InFile)};
+	if (RunLFSCommand(TEXT("locks"), InRepositoryRoot, GitBinaryFallback, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages))
+	{
+		for (const FString& Result : Results)
+		{
+			TArray<FString> Informations;
+			Result.ParseIntoArray(Informations, TEXT("\t"), true);
+			if (Informations.Num() >= 2 && Informations[0].TrimEnd() == InFile && !Informations[1].StartsWith(TEXT("ID:")))
+			{
+				return Informations[1].TrimEnd();
+			}
+		}
+	}
+	return FString();
+}
+
+bool RunLFSLockCommand(const FString& InCommand, const FString& InRepositoryRoot, const FString& GitBinaryFallback, const TArray<FString>& InFiles,
+					   TArray<FString>& OutSucceededFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	// git-lfs reports each file it handled: "Locked Content/A.uasset" or "Unlocked Content/A.uasset"
+	const bool bLock = InCommand == TEXT("lock");
+	const FString SuccessPrefix = bLock ? TEXT("Locked ") : TEXT("Unlocked ");
+	FGitSourceControlCommand* Command = FGitSourceControlCommand::GetCurrent();
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	const FString LockUser = GitSourceControl ? GitSourceControl->GetProvider().GetLockUser() : FString();
+
+	TArray<FString> PendingFiles = InFiles;
+	float RetryDelay = GitSourceControlConstants::LfsLockRetryDelaySeconds;
+	for (int32 Attempt = 1; PendingFiles.Num() > 0; Attempt++)
+	{
+		// Each git-lfs process sends its requests one after another: spread the files over a bounded number of processes
+		const int32 FilesPerBatch = FMath::Clamp(FMath::DivideAndRoundUp(PendingFiles.Num(), GitSourceControlConstants::MaxParallelBatches), 1, GitSourceControlConstants::MaxFilesPerBatch);
+		const int32 NumBatches = FMath::DivideAndRoundUp(PendingFiles.Num(), FilesPerBatch);
+		TArray<TArray<FString>> BatchResults;
+		TArray<TArray<FString>> BatchErrors;
+		BatchResults.SetNum(NumBatches);
+		BatchErrors.SetNum(NumBatches);
+
+		TAtomic<int32> NextBatch(0);
+		RunGitProcessesInParallel(FMath::Min(NumBatches, GitSourceControlConstants::MaxParallelBatches), [&]()
+		{
+			FGitScopedCurrentCommand ScopedCurrentCommand(Command);
+			for (int32 BatchIndex = NextBatch++; BatchIndex < NumBatches; BatchIndex = NextBatch++)
+			{
+				if (Command && Command->IsCanceled())
+				{
+					return;
+				}
+				const int32 FirstFile = BatchIndex * FilesPerBatch;
+				const TArray<FString> FilesInBatch(PendingFiles.GetData() + FirstFile, FMath::Min(FilesPerBatch, PendingFiles.Num() - FirstFile));
+				RunLFSCommand(InCommand, InRepositoryRoot, GitBinaryFallback, FGitSourceControlModule::GetEmptyStringArray(), FilesInBatch, BatchResults[BatchIndex], BatchErrors[BatchIndex]);
+			}
+		});
+
+		// Merge the results file by file: a batch can partly succeed
+		TSet<FString> SucceededFiles;
+		TArray<FString> Errors;
+		for (int32 BatchIndex = 0; BatchIndex < NumBatches; BatchIndex++)
+		{
+			for (FString& Result : BatchResults[BatchIndex])
+			{
+				if (Result.StartsWith(SuccessPrefix))
+				{
+					SucceededFiles.Add(Result.RightChop(SuccessPrefix.Len()).TrimEnd().Replace(TEXT("\\"), TEXT("/")));
+				}
+				OutResults.Add(MoveTemp(Result));
+			}
+			Errors.Append(MoveTemp(BatchErrors[BatchIndex]));
+		}
+		TArray<FString> ErrorPaths;
+		ErrorPaths.Reserve(Errors.Num());
+		for (const FString& Error : Errors)
+		{
+			ErrorPaths.Add(GetLfsErrorPath(Error));
+		}
+
+		TArray<FString> RetryFiles;
+		for (const FString& File : PendingFiles)
+		{
+			if (SucceededFiles.Contains(File))
+			{
+				OutSucceededFiles.Add(File);
+				continue;
+			}
+			// An error naming the file tells why it failed; without one, the whole process failed
+			const FString NormalizedFile = File.Replace(TEXT("\\"), TEXT("/"));
+			const int32 ErrorIndex = ErrorPaths.IndexOfByKey(NormalizedFile);
+			const FString* FileError = ErrorIndex != INDEX_NONE ? &Errors[ErrorIndex] : nullptr;
+			if (FileError == nullptr || IsTransientLfsLockError(*FileError))
+			{
+				RetryFiles.Add(File);
+			}
+			else if (bLock && Attempt > 1 && !LockUser.IsEmpty() && GetLfsLockOwner(InRepositoryRoot, GitBinaryFallback, File) == LockUser)
+			{
+				// Already locked by the current user: the request of a previous attempt reached the server, but its response did not come back
+				OutSucceededFiles.Add(File);
+				OutResults.Add(SuccessPrefix + File);
+				for (int32 Index = Errors.Num() - 1; Index >= 0; Index--)
+				{
+					if (ErrorPaths[Index] == NormalizedFile)
+					{
+						Errors.RemoveAt(Index);
+						ErrorPaths.RemoveAt(Index);
+					}
+				}
+			}
+		}
+
+		const bool bCanceled = Command && Command->IsCanceled();
+		if (RetryFiles.Num() == 0 || Attempt >= GitSourceControlConstants::MaxLfsLockAttempts || bCanceled)
+		{
+			OutErrorMessages.Append(MoveTemp(Errors));
+			break;
+		}
+		UE_LOG(LogSourceControl, Log, TEXT("git-lfs %s: %d file(s) failed, retrying in %.1fs"), *InCommand, RetryFiles.Num(), RetryDelay);
+		FPlatformProcess::Sleep(RetryDelay);
+		RetryDelay *= 2.0f;
+		PendingFiles = MoveTemp(RetryFiles);
+	}
+
+	return OutSucceededFiles.Num() == InFiles.Num();
+}
+
+bool RunQueuedLFSLockCommand(const FString& InCommand, const FString& InRepositoryRoot, const FString& GitBinaryFallback, const TArray<FString>& InFiles,
+							 TArray<FString>& OutSucceededFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	const EGitOfflineOperation Operation = InCommand == TEXT("lock") ? EGitOfflineOperation::Lock : EGitOfflineOperation::Unlock;
+	if (!OfflineQueue.IsRemoteReachable())
+	{
+		OfflineQueue.Enqueue(Operation, InFiles);
+		OutSucceededFiles.Append(InFiles);
+		OutResults.Add(FString::Printf(TEXT("git-lfs %s of %d file(s) queued until the remote is reachable"), *InCommand, InFiles.Num()));
+		return true;
+	}
+
+	TArray<FString> SucceededFiles;
+	TArray<FString> ErrorMessages;
+	const bool bSuccess = RunLFSLockCommand(InCommand, InRepositoryRoot, GitBinaryFallback, InFiles, SucceededFiles, OutResults, ErrorMessages);
+	if (!bSuccess && FGitOfflineQueue::IsNetworkError(ErrorMessages))
+	{
+		// The remote went away: queue the files it did not handle
+		OfflineQueue.SetRemoteReachable(false);
+		const TSet<FString> SucceededSet(SucceededFiles);
+		TArray<FString> QueuedFiles = InFiles.FilterByPredicate([&SucceededSet](const FString& File) { return !SucceededSet.Contains(File); });
+		OfflineQueue.Enqueue(Operation, QueuedFiles);
+		OutResults.Append(MoveTemp(ErrorMessages));
+		OutResults.Add(FString::Printf(TEXT("git-lfs %s of %d file(s) queued until the remote is reachable"), *InCommand, QueuedFiles.Num()));
+		OutSucceededFiles.Append(MoveTemp(SucceededFiles));
+		OutSucceededFiles.Append(MoveTemp(QueuedFiles));
+		return true;
+	}
+	OutSucceededFiles.Append(MoveTemp(SucceededFiles));
+	OutErrorMessages.Append(MoveTemp(ErrorMessages));
+	return bSuccess;
+}
+
+// Run a Git "add" and a Git "commit" command with a list of files too long for the command line, passed through a file instead
+static bool RunCommitFromPathspecFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles,
+									  TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	const FGitScopedTempFile PathspecFile(FText::FromString(FString::Join(InFiles, TEXT("\n"))));
+	if (!PathspecFile.IsValid())
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("Failed to write to temp file: %s"), *PathspecFile.GetFilename()));
+		return false;
+	}
+	const FString PathspecParameter = FString::Printf(TEXT("--pathspec-from-file=\"%s\""), *FPaths::ConvertRelativePathToFull(PathspecFile.GetFilename()));
+
+	const TArray<FString> AddParameters{TEXT("-A"), PathspecParameter};
+	bool bResult = RunCommandInternal(TEXT("add"), InPathToGitBinary, InRepositoryRoot, AddParameters, FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+	if (bResult)
+	{
+		TArray<FString> CommitParameters{InParameters};
+		CommitParameters.Add(PathspecParameter);
+		bResult = RunCommandInternal(TEXT("commit"), InPathToGitBinary, InRepositoryRoot, CommitParameters, FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+	}
+	return bResult;
+}
+
+// Run a Git "commit" command by batches
+bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles,
+			   TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	bool bResult = true;
+
+	TArray<FString> AddParameters{TEXT("-A")};
+
+	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch)
+	{
+		// Git 2.25 can read the files from a file, to make a single commit whatever the number of files
+		const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+		if (GitSourceControl && GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25))
+		{
+			return RunCommitFromPathspecFile(InPathToGitBinary, InRepositoryRoot, InParameters, InFiles, OutResults, OutErrorMessages);
+		}
+
+		// Batch files up so we dont exceed command-line limits
+		int32 FileCount = 0;
+		{
+			TArray<FString> FilesInBatch;
+			for (int32 FileIndex = 0; FileIndex < GitSourceControlConstants::MaxFilesPerBatch; FileIndex++, FileCount++)
+			{
+				FilesInBatch.Add(InFiles[FileCount]);
+			}
+			bResult &= RunCommandInternal(TEXT("add"), InPathToGitBinary, InRepositoryRoot, AddParameters, FilesInBatch, OutResults, OutErrorMessages);
+			// First batch is a simple "git commit" command with only the first files
+			bResult &= RunCommandInternal(TEXT("commit"), InPathToGitBinary, InRepositoryRoot, InParameters, FilesInBatch, OutResults, OutErrorMessages);
+		}
+
 		TArray<FString> Parameters;
 		for (const auto& Parameter : InParameters)
 		{
@@ -1104,10 +1638,18 @@ public:
 	ETreeState::Type TreeState;
 };
 
+/** Stages of an unmerged file in the index, as listed by "git ls-files --unmerged" */
+struct FGitConflictStatus
+{
+	FString CommonAncestorFileId; ///< 1: Object Id of the file in the common ancestor of merged branches (warning: not the commit Id)
+	FString LocalFileId;		  ///< 2: Object Id of the file in the local branch
+	FString RemoteFileId;		  ///< 3: Object Id of the file in the remote branch
+};
+
 /**
- * Extract the status of a unmerged (conflict) file
+ * Extract the status of all unmerged (conflict) files, parsing the output of "git ls-files --unmerged -z" chunk by chunk, as it is streamed.
  *
- * Example output of git ls-files --unmerged Content/Blueprints/BP_Test.uasset
+ * Example output of git ls-files --unmerged (records are separated by NUL characters instead of new lines with -z)
 100644 d9b33098273547b57c0af314136f35b494e16dcb 1	Content/Blueprints/BP_Test.uasset
 100644 a14347dc3b589b78fb19ba62a7e3982f343718bc 2	Content/Blueprints/BP_Test.uasset
 100644 f3137a7167c840847cd7bd2bf07eefbfb2d9bcd2 3	Content/Blueprints/BP_Test.uasset
@@ -1119,54 +1661,110 @@ public:
 class FGitConflictStatusParser
 {
 public:
-	/** Parse the unmerge status: extract the base SHA1 identifier of the file */
-	FGitConflictStatusParser(const TArray<FString>& InResults)
+	/** Parse a chunk of output; records split across chunks are completed by the next chunk */
+	void Parse(const uint8* InData, int32 InSize)
 	{
-		const FString& CommonAncestor = InResults[0]; // 1: The common ancestor of merged branches
-		CommonAncestorFileId = CommonAncestor.Mid(7, 40);
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
-		CommonAncestorFileId = CommonAncestor.Mid(7, 40);
-		CommonAncestorFilename = CommonAncestor.Right(50);
-
-		if (ensure(InResults.IsValidIndex(2)))
+		int32 Start = 0;
+		for (int32 Index = 0; Index < InSize; Index++)
 		{
-			const FString& RemoteBranch = InResults[2]; // 1: The common ancestor of merged branches
-			RemoteFileId = RemoteBranch.Mid(7, 40);
-			RemoteFilename = RemoteBranch.Right(50);
+			if (InData[Index] == 0)
+			{
+				if (Pending.Num() > 0)
+				{
+					Pending.Append(InData + Start, Index - Start);
+					ParseRecord(Pending.GetData(), Pending.Num());
+					Pending.Reset();
+				}
+				else
+				{
+					ParseRecord(InData + Start, Index - Start);
+				}
+				Start = Index + 1;
+			}
 		}
-#endif
+		Pending.Append(InData + Start, InSize - Start);
 	}
 
-	FString CommonAncestorFileId; ///< SHA1 Id of the file (warning: not the commit Id)
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
-	FString RemoteFileId;		///< SHA1 Id of the file (warning: not the commit Id)
+	/** Conflicts by file, relative to the repository root */
+	TMap<FString, FGitConflictStatus> Conflicts;
 
-	FString CommonAncestorFilename;
-	FString RemoteFilename;
-#endif
+private:
+	void ParseRecord(const uint8* InRecord, int32 InSize)
+	{
+		// "<mode> <object id> <stage>\t<path>": split on the separators, as the length of the object id depends on the hash algorithm (SHA-1 or SHA-256)
+		int32 TabIndex = 0;
+		while (TabIndex < InSize && InRecord[TabIndex] != '\t')
+		{
+			TabIndex++;
+		}
+		int32 ObjectIdStart = 0;
+		while (ObjectIdStart < TabIndex && InRecord[ObjectIdStart] != ' ')
+		{
+			ObjectIdStart++;
+		}
+		ObjectIdStart++;
+		int32 StageStart = TabIndex;
+		while (StageStart > ObjectIdStart && InRecord[StageStart - 1] != ' ')
+		{
+			StageStart--;
+		}
+		const int32 PathStart = TabIndex + 1;
+		if (PathStart >= InSize || StageStart - 1 <= ObjectIdStart || StageStart + 1 != TabIndex)
+		{
+			return;
+		}
+
+		const FUTF8ToTCHAR Path(reinterpret_cast<const ANSICHAR*>(InRecord + PathStart), InSize - PathStart);
+		FGitConflictStatus& Conflict = Conflicts.FindOrAdd(FString(Path.Length(), Path.Get()));
+		const FString ObjectId = FString(StageStart - 1 - ObjectIdStart, reinterpret_cast<const ANSICHAR*>(InRecord + ObjectIdStart));
+		switch (InRecord[StageStart])
+		{
+		case '1': Conflict.CommonAncestorFileId = ObjectId; break;
+		case '2': Conflict.LocalFileId = ObjectId; break;
+		case '3': Conflict.RemoteFileId = ObjectId; break;
+		default: break;
+		}
+	}
+
+	/** Bytes of a record not terminated yet at the end of the last chunk */
+	TArray<uint8> Pending;
 };
 
-/** Execute a command to get the details of a conflict */
-static void RunGetConflictStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, FGitSourceControlState& InOutFileState)
+/** Execute a single command to get the details of all the conflicts, and join them to the states of the conflicted files */
+static void RunGetConflictStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, TMap<FString, FGitSourceControlState>& InOutStates)
 {
-	TArray<FString> ErrorMessages;
-	TArray<FString> Results;
-	TArray<FString> Files;
-	Files.Add(InFile);
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--unmerged"));
-	bool bResult = RunCommandInternal(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, ErrorMessages);
-	if (bResult && Results.Num() == 3)
+	FGitConflictStatusParser ConflictStatusParser;
+	int32 ReturnCode = 0;
+	const bool bResult = RunCommandStreamed(InPathToGitBinary, InRepositoryRoot, TEXT("ls-files --unmerged -z"), [&ConflictStatusParser](const uint8* Data, int32 Size)
+	{
+		ConflictStatusParser.Parse(Data, Size);
+		return true;
+	}, ReturnCode);
+	if (!bResult)
+	{
+		return;
+	}
+
+	for (const auto& Conflict : ConflictStatusParser.Conflicts)
 	{
-		// Parse the unmerge status: extract the base revision (or the other branch?)
-		FGitConflictStatusParser ConflictStatus(Results);
+		// Only files with a common ancestor can be merged
+		const FGitConflictStatus& ConflictStatus = Conflict.Value;
+		if (ConflictStatus.CommonAncestorFileId.IsEmpty() || ConflictStatus.LocalFileId.IsEmpty() || ConflictStatus.RemoteFileId.IsEmpty())
+		{
+			continue;
+		}
+		FGitSourceControlState* FileState = InOutStates.Find(FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, Conflict.Key)));
+		if (FileState == nullptr || !FileState->IsConflicted())
+		{
+			continue;
+		}
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
-		InOutFileState.PendingResolveInfo.BaseFile = ConflictStatus.CommonAncestorFilename;
-		InOutFileState.PendingResolveInfo.BaseRevision = ConflictStatus.CommonAncestorFileId;
-		InOutFileState.PendingResolveInfo.RemoteFile = ConflictStatus.RemoteFilename;
-		InOutFileState.PendingResolveInfo.RemoteRevision = ConflictStatus.RemoteFileId;
+		FileState->PendingResolveInfo.BaseFile = Conflict.Key;
+		FileState->PendingResolveInfo.BaseRevision = ConflictStatus.CommonAncestorFileId;
+		FileState->PendingResolveInfo.RemoteFile = Conflict.Key;
+		FileState->PendingResolveInfo.RemoteRevision = ConflictStatus.RemoteFileId;
 #else
-		InOutFileState.PendingMergeBaseFileHash = ConflictStatus.CommonAncestorFileId;
+		FileState->PendingMergeBaseFileHash = ConflictStatus.CommonAncestorFileId;
 #endif
 	}
 }
@@ -1186,23 +1784,30 @@ TArray<UPackage*> UnlinkPackages(const TArray<FString>& InPackageNames)
 				PackagesToUnlink.Add(*PackageName);
 			}
 		}
-		// Form a list of loaded packages to reload...
+		// Form a list of loaded packages to reload, skipping the ones that are not loaded
 		LoadedPackages.Reserve(PackagesToUnlink.Num());
+		bool bPartiallyLoaded = false;
 		for (const FString& PackageName : PackagesToUnlink)
 		{
-			UPackage* Package = FindPackage(nullptr, *PackageName);
-			if (Package)
+			if (UPackage* Package = FindPackage(nullptr, *PackageName))
 			{
 				LoadedPackages.Emplace(Package);
+				bPartiallyLoaded |= !Package->IsFullyLoaded();
+			}
+		}
 
-				// Detach the linkers of any loaded packages so that SCC can overwrite the files...
-				if (!Package->IsFullyLoaded())
-				{
-					FlushAsyncLoading();
-					Package->FullyLoad();
-				}
-				ResetLoaders(Package);
+		// Detach the linkers of any loaded packages so that SCC can overwrite the files, flushing the async loading only once
+		if (bPartiallyLoaded)
+		{
+			FlushAsyncLoading();
+		}
+		for (UPackage* Package : LoadedPackages)
+		{
+			if (!Package->IsFullyLoaded())
+			{
+				Package->FullyLoad();
 			}
+			ResetLoaders(Package);
 		}
 	}
 	return LoadedPackages;
@@ -1236,20 +1841,20 @@ void AbsoluteFilenames(const FString& InRepositoryRoot, TArray<FString>& InFileN
 {
 	for (auto& FileName : InFileNames)
 	{
-		FileName = FPaths::ConvertRelativePathToFull(InRepositoryRoot, FileName);
+		FileName = FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, FileName));
 	}
 }
 
-/** Run a 'git ls-files' command to get all files tracked by Git recursively in a directory.
+/** List all files tracked by Git recursively in a directory, as with 'git ls-files'.
  *
  * Called in case of a "directory status" (no file listed in the command) when using the "Submit to Revision Control" menu.
  */
 bool ListFilesInDirectoryRecurse(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InDirectory, TArray<FString>& OutFiles)
 {
-	TArray<FString> ErrorMessages;
-	TArray<FString> Directory;
-	Directory.Add(InDirectory);
-	const bool bResult = RunCommandInternal(TEXT("ls-files"), InPathToGitBinary, InRepositoryRoot, FGitSourceControlModule::GetEmptyStringArray(), Directory, OutFiles, ErrorMessages);
+	const bool bResult = GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
+	{
+		return Backend.ListFiles(InRepositoryRoot, InDirectory, OutFiles);
+	});
 	AbsoluteFilenames(InRepositoryRoot, OutFiles);
 	return bResult;
 }
@@ -1305,6 +1910,7 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 	TMap<FString, FString> LockedFiles;
 	TMap<FString, FString> Results = InResults;
 	bool bCheckedLockedFiles = false;
+	bool bHasConflicts = false;
 
 	FString Result;
 
@@ -1327,11 +1933,8 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 
 			FileState.State.FileState = StatusParser.FileState;
 			FileState.State.TreeState = StatusParser.TreeState;
-			if (FileState.IsConflicted())
-			{
-				// In case of a conflict (unmerged file) get the base revision to merge
-				RunGetConflictStatus(InPathToGitBinary, InRepositoryRoot, File, FileState);
-			}
+			// In case of a conflict (unmerged file) the base revision to merge is fetched below, for all conflicts at once
+			bHasConflicts |= FileState.IsConflicted();
 		}
 		else
 		{
@@ -1406,6 +2009,12 @@ static void ParseFileStatusResult(const FString& InPathToGitBinary, const FStrin
 		OutStates.Add(File, MoveTemp(FileState));
 	}
 
+	if (bHasConflicts)
+	{
+		// Get the base revision to merge of all unmerged files
+		RunGetConflictStatus(InPathToGitBinary, InRepositoryRoot, OutStates);
+	}
+
 	// The above cannot detect deleted assets since there is no file left to enumerate (either by the Content Browser or by git ls-files)
 	// => so we also parse the status results to explicitly look for Deleted/Missing assets
 	ParseDirectoryStatusResult(InUsingLfsLocking, Results, OutStates);
@@ -1437,6 +2046,151 @@ void ParseStatusResults(const FString& InPathToGitBinary, const FString& InRepos
 	ParseFileStatusResult(InPathToGitBinary, InRepositoryRoot, InUsingLfsLocking, Files, InResults, OutStates);
 }
 
+/** Files changed on a branch compared to HEAD, valid as long as neither of them move and the paths diffed are the same */
+struct FGitBranchDivergence
+{
+	FString HeadSha;
+	FString BranchSha;
+	/** Paths the files were restricted to: the sparse-checkout cones can change (git.hydrate) */
+	TArray<FString> FilesToDiff;
+	/** Changed files, relative to the repository root */
+	TSet<FString> ChangedFiles;
+};
+
+/** Divergence of each remote branch, shared by all status updates */
+static FCriticalSection RemoteDivergenceCriticalSection;
+static TMap<FString, FGitBranchDivergence> RemoteDivergenceCache;
+
+// Run a single "show-ref" to get the SHA of HEAD and of the branches to diff, which keys the divergence cache
+static bool GetRefShas(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InBranches, FString& OutHeadSha, TMap<FString, FString>& OutBranchShas)
+{
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	TArray<FString> Parameters{TEXT("--head")};
+	Parameters.Append(InBranches);
+	// "show-ref" returns 1 if one of the patterns is not found, so rely on the results instead of the return code
+	RunCommand(TEXT("show-ref"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+
+	TMap<FString, FString> ShaByRef;
+	for (const FString& Result : Results)
+	{
+		FString Sha, Ref;
+		if (Result.Split(TEXT(" "), &Sha, &Ref))
+		{
+			ShaByRef.Add(MoveTemp(Ref), MoveTemp(Sha));
+		}
+	}
+
+	const FString* HeadSha = ShaByRef.Find(TEXT("HEAD"));
+	if (HeadSha == nullptr)
+	{
+		return false;
+	}
+	OutHeadSha = *HeadSha;
+	for (const FString& Branch : InBranches)
+	{
+		// Branches to diff are either remote tracking branches (origin/main) or local ones
+		const FString* BranchSha = ShaByRef.Find(TEXT("refs/remotes/") + Branch);
+		if (BranchSha == nullptr)
+		{
+			BranchSha = ShaByRef.Find(TEXT("refs/heads/") + Branch);
+		}
+		if (BranchSha != nullptr)
+		{
+			OutBranchShas.Add(Branch, *BranchSha);
+		}
+	}
+	return true;
+}
+
+// Compute in a single "log" pass the files changed by the commits of each moved branch that are not in HEAD (HEAD..Branch)
+// Also reports the files changed by several of these commits: only those may have been reverted since
+static void ComputeBranchLogs(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InBranches, const TMap<FString, FString>& InBranchShas,
+							  const TArray<FString>& InFilesToDiff, TMap<FString, TSet<FString>>& OutChangedFiles, TMap<FString, TSet<FString>>& OutRevisitedFiles, TArray<FString>& OutErrorMessages)
+{
+	// "--full-history --sparse" keep the commits that don't touch the paths, so that the graph walked below stays whole, while the pathspec restricts the files listed
+	TArray<FString> Parameters{TEXT("\"--pretty=format:%x01%H %P\""), TEXT("--name-only"), TEXT("--full-history"), TEXT("--sparse"), TEXT("^HEAD")};
+	if (FGitSparseCheckout::Get().IsPartialClone())
+	{
+		// Rename detection reads the content of the files: in a partial clone, it would fetch the blobs of all the commits
+		Parameters.Add(TEXT("--no-renames"));
+	}
+	for (const FString& Branch : InBranches)
+	{
+		Parameters.Add(InBranchShas[Branch]);
+	}
+	Parameters.Add(TEXT("--"));
+
+	// "log" has no --pathspec-from-file, and RunCommand() would split more paths in batches, each listing all the commits:
+	// beyond a batch of paths (in a sparse-checkout with many cones), run a single log of all the files and filter them here instead
+	const bool bUsePathspec = InFilesToDiff.Num() <= GitSourceControlConstants::MaxFilesPerBatch;
+	const TArray<FString> RelativePathsToDiff = bUsePathspec ? TArray<FString>() : RelativeFilenames(InFilesToDiff, InRepositoryRoot);
+
+	TArray<FString> Results;
+	if (!RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, bUsePathspec ? InFilesToDiff : FGitSourceControlModule::GetEmptyStringArray(), Results, OutErrorMessages))
+	{
+		return;
+	}
+
+	// Commits not in HEAD, with their parents and the files they changed
+	TMap<FString, TArray<FString>> CommitParents;
+	TMap<FString, TArray<FString>> CommitFiles;
+	TArray<FString>* CurrentFiles = nullptr;
+	for (FString& Result : Results)
+	{
+		if (Result.Len() > 0 && Result[0] == TCHAR(1))
+		{
+			TArray<FString> Shas;
+			Result.RightChop(1).ParseIntoArray(Shas, TEXT(" "), true);
+			if (Shas.Num() > 0)
+			{
+				const FString Commit = Shas[0];
+				Shas.RemoveAt(0);
+				CommitParents.Add(Commit, MoveTemp(Shas));
+				// Keep the files of a commit already listed, in case the output is ever made of several batches
+				CurrentFiles = &CommitFiles.FindOrAdd(Commit);
+			}
+		}
+		else if (CurrentFiles != nullptr && Result.Len() > 0)
+		{
+			if (bUsePathspec || RelativePathsToDiff.ContainsByPredicate([&Result](const FString& RelativePath) { return Result.StartsWith(RelativePath, ESearchCase::IgnoreCase); }))
+			{
+				CurrentFiles->AddUnique(MoveTemp(Result));
+			}
+		}
+	}
+
+	// Walk the commits reachable from each branch: commits missing from the log are in HEAD
+	for (const FString& Branch : InBranches)
+	{
+		TSet<FString>& ChangedFiles = OutChangedFiles.Add(Branch);
+		TSet<FString>& RevisitedFiles = OutRevisitedFiles.Add(Branch);
+		TSet<FString> Visited;
+		TArray<FString> ToVisit{InBranchShas[Branch]};
+		while (ToVisit.Num() > 0)
+		{
+			const FString Commit = ToVisit.Pop();
+			bool bAlreadyVisited = false;
+			Visited.Add(Commit, &bAlreadyVisited);
+			const TArray<FString>* Parents = CommitParents.Find(Commit);
+			if (bAlreadyVisited || Parents == nullptr)
+			{
+				continue;
+			}
+			for (const FString& File : CommitFiles[Commit])
+			{
+				bool bAlreadyChanged = false;
+				ChangedFiles.Add(File, &bAlreadyChanged);
+				if (bAlreadyChanged)
+				{
+					RevisitedFiles.Add(File);
+				}
+			}
+			ToVisit.Append(*Parents);
+		}
+	}
+}
+
 void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& Files,
 				 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
 {
@@ -1451,7 +2205,7 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
 	const TArray<FString> StatusBranches = Provider.GetStatusBranchNames();
 
-	TSet<FString> BranchesToDiff{ StatusBranches };
+	TArray<FString> BranchesToDiff{ StatusBranches };
 
 	bool bDiffAgainstRemoteCurrent = false;
 
@@ -1462,7 +2216,7 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 		// We have a valid remote, so diff against it.
 		bDiffAgainstRemoteCurrent = true;
 		// Ensure that the remote branch is in there.
-		BranchesToDiff.Add(CurrentBranchName);
+		BranchesToDiff.AddUnique(CurrentBranchName);
 	}
 
 	if (!BranchesToDiff.Num())
@@ -1472,10 +2226,6 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 
 	TArray<FString> ErrorMessages;
 
-	TArray<FString> LogResults;
-	TArray<FString> DiffResults;
-	TArray<FString> Intersection;
-
 	TMap<FString, FString> NewerFiles;
 
 	const FString AbsoluteProjectDirPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
@@ -1483,79 +2233,142 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 	const FString AbsoluteBinariesDirPath = FPaths::Combine(AbsoluteProjectDirPath, "Binaries/");
 	const FString AbsoluteChecksumFilePath = FPaths::Combine(AbsoluteProjectDirPath, ".checksum");
 
-	//const TArray<FString>& RelativeFiles = RelativeFilenames(Files, InRepositoryRoot);
 	// Get the full remote status of the Content and Plugins folder, since it's the only lockable folder we track in editor. 
 	// This shows any new files as well.
 	// Also update the status of `.checksum`.
-	const TArray<FString> FilesToDiff
+	// In a sparse-checkout, only the cones: the other files are not in the working tree to be updated
+	const TArray<FString> FilesToDiff = FGitSparseCheckout::Get().FilterToCone(
 	{
 		FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()),
 		AbsoluteChecksumFilePath,
 		AbsoluteBinariesDirPath,
 		AbsolutePluginsDirPath,
-	};
-	
-	TArray<FString> ParametersLog{TEXT("--pretty="), TEXT("--name-only"), TEXT(""), TEXT("--")};
-	for (auto& Branch : BranchesToDiff)
+	});
+	if (FilesToDiff.Num() == 0)
 	{
-		bool bCurrentBranch;
-		if (bDiffAgainstRemoteCurrent && Branch.Equals(CurrentBranchName))
-		{
-			bCurrentBranch = true;
-		}
-		else
-		{
-			bCurrentBranch = false;
-		}
-		// empty defaults to HEAD
-		// .. means commits in the right that are not in the left
-		ParametersLog[2] = FString::Printf(TEXT("..%s"), *Branch);
+		return;
+	}
+
+	// A single "show-ref" tells which branches moved since the last update: only those are computed again
+	FString HeadSha;
+	TMap<FString, FString> BranchShas;
+	if (!GetRefShas(InPathToGitBinary, InRepositoryRoot, BranchesToDiff, HeadSha, BranchShas))
+	{
+		return;
+	}
+	BranchesToDiff.RemoveAll([&BranchShas](const FString& Branch) { return !BranchShas.Contains(Branch); });
 
-		const bool bResultLog = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, ParametersLog, FilesToDiff, LogResults, ErrorMessages);
-		if (bResultLog)
+	TMap<FString, TSet<FString>> BranchChangedFiles;
+	TArray<FString> MovedBranches;
+	{
+		FScopeLock ScopeLock(&RemoteDivergenceCriticalSection);
+		for (const FString& Branch : BranchesToDiff)
 		{
-			// Status Branches may not be initialized because they're not in use by the project. They can also be not initilaized in some other quirky circumstances
-			// eg. When running multi client / dedicated server in editor without running them under the same process, those game instances will run as an editor instance
-			// which means editor plugins are enabled and running, but they don't run UnrealEdEngine, so the status branches are not initialized.
-			if (StatusBranches.Num() > 0)
+			const FGitBranchDivergence* Divergence = RemoteDivergenceCache.Find(Branch);
+			if (Divergence != nullptr && Divergence->HeadSha == HeadSha && Divergence->BranchSha == BranchShas[Branch] && Divergence->FilesToDiff == FilesToDiff)
 			{
-				// Check if the files state in the branch in which is changed is actually different from compared branch
-				// This opens files for edit if they were modified in another branch but have since been reverted back to state in status.
-				TArray<FString> DiffParametersLog{ TEXT("--pretty="), TEXT("--name-only"), FString::Printf(TEXT("...%s"), *Branch), TEXT(""), TEXT("--") };
-				const bool bResultDiff = RunCommand(TEXT("diff"), InPathToGitBinary, InRepositoryRoot, DiffParametersLog, FilesToDiff, DiffResults, ErrorMessages);
-				// Get the intersection of the 2 containers
-				Intersection = DiffResults.FilterByPredicate([&LogResults](const FString& ChangedFile) { return LogResults.Contains(ChangedFile); });
+				BranchChangedFiles.Add(Branch, Divergence->ChangedFiles);
 			}
 			else
 			{
-				Intersection = LogResults;
+				MovedBranches.Add(Branch);
 			}
+		}
+	}
 
-			for (const FString& NewerFileName : Intersection)
+	if (MovedBranches.Num() > 0)
+	{
+		TMap<FString, TSet<FString>> LogChangedFiles;
+		TMap<FString, TSet<FString>> LogRevisitedFiles;
+		ComputeBranchLogs(InPathToGitBinary, InRepositoryRoot, MovedBranches, BranchShas, FilesToDiff, LogChangedFiles, LogRevisitedFiles, ErrorMessages);
+
+		for (const FString& Branch : MovedBranches)
+		{
+			TSet<FString>* LogResults = LogChangedFiles.Find(Branch);
+			if (LogResults == nullptr)
 			{
-				const FString& NewerFilePath = FPaths::ConvertRelativePathToFull(InRepositoryRoot, NewerFileName);
+				// The log failed: don't cache anything, so that it is tried again on next update
+				continue;
+			}
 
-				// Don't care about mergeable files (.collection, .ini, .uproject, etc)
-				if (!IsFileLFSLockable(NewerFileName))
+			FGitBranchDivergence Divergence;
+			Divergence.HeadSha = HeadSha;
+			Divergence.BranchSha = BranchShas[Branch];
+			Divergence.FilesToDiff = FilesToDiff;
+
+			// Status Branches may not be initialized because they're not in use by the project. They can also be not initilaized in some other quirky circumstances
+			// eg. When running multi client / dedicated server in editor without running them under the same process, those game instances will run as an editor instance
+			// which means editor plugins are enabled and running, but they don't run UnrealEdEngine, so the status branches are not initialized.
+			const TSet<FString>& RevisitedFiles = LogRevisitedFiles[Branch];
+			if (StatusBranches.Num() > 0 && RevisitedFiles.Num() > 0)
+			{
+				// Check if the files state in the branch in which is changed is actually different from compared branch
+				// This opens files for edit if they were modified in another branch but have since been reverted back to state in status.
+				// A file changed by a single commit of the branch can't have been reverted: only diff the others, in a single batch
+				TArray<FString> DiffResults;
+				TArray<FString> DiffParametersLog{ TEXT("--pretty="), TEXT("--name-only"), FString::Printf(TEXT("HEAD...%s"), *Divergence.BranchSha), TEXT("--") };
+				if (FGitSparseCheckout::Get().IsPartialClone())
+				{
+					DiffParametersLog.Insert(TEXT("--no-renames"), 0);
+				}
+				const TArray<FString> DiffFiles = RevisitedFiles.Num() <= GitSourceControlConstants::MaxFilesPerBatch ? RevisitedFiles.Array() : FilesToDiff;
+				if (!RunCommand(TEXT("diff"), InPathToGitBinary, InRepositoryRoot, DiffParametersLog, DiffFiles, DiffResults, ErrorMessages))
+				{
+					continue;
+				}
+				const TSet<FString> StillChangedFiles(MoveTemp(DiffResults));
+				for (const FString& ChangedFile : *LogResults)
 				{
-					// Check if there's newer binaries pending on this branch
-					if (bCurrentBranch && (NewerFilePath == AbsoluteChecksumFilePath || NewerFilePath.StartsWith(AbsoluteBinariesDirPath, ESearchCase::IgnoreCase) ||
-						NewerFilePath.StartsWith(AbsolutePluginsDirPath, ESearchCase::IgnoreCase)))
+					if (!RevisitedFiles.Contains(ChangedFile) || StillChangedFiles.Contains(ChangedFile))
 					{
-						Provider.bPendingRestart = true;
+						Divergence.ChangedFiles.Add(ChangedFile);
 					}
-					continue;
 				}
+			}
+			else
+			{
+				Divergence.ChangedFiles = MoveTemp(*LogResults);
+			}
+
+			BranchChangedFiles.Add(Branch, Divergence.ChangedFiles);
+			FScopeLock ScopeLock(&RemoteDivergenceCriticalSection);
+			RemoteDivergenceCache.Add(Branch, MoveTemp(Divergence));
+		}
+	}
 
-				if (bCurrentBranch || !NewerFiles.Contains(NewerFilePath))
+	for (const FString& Branch : BranchesToDiff)
+	{
+		const TSet<FString>* ChangedFiles = BranchChangedFiles.Find(Branch);
+		if (ChangedFiles == nullptr)
+		{
+			continue;
+		}
+		const bool bCurrentBranch = bDiffAgainstRemoteCurrent && Branch.Equals(CurrentBranchName);
+
+		for (const FString& NewerFileName : *ChangedFiles)
+		{
+			// Don't care about mergeable files (.collection, .ini, .uproject, etc)
+			if (!IsFileLFSLockable(NewerFileName))
+			{
+				// Check if there's newer binaries pending on this branch
+				if (bCurrentBranch)
 				{
-					NewerFiles.Add(NewerFilePath, Branch);
+					const FString& NewerFilePath = FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, NewerFileName));
+					if (NewerFilePath == AbsoluteChecksumFilePath || NewerFilePath.StartsWith(AbsoluteBinariesDirPath, ESearchCase::IgnoreCase) ||
+						NewerFilePath.StartsWith(AbsolutePluginsDirPath, ESearchCase::IgnoreCase))
+					{
+						Provider.bPendingRestart = true;
+					}
 				}
+				continue;
+			}
+
+			const FString& NewerFilePath = FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, NewerFileName));
+			if (bCurrentBranch || !NewerFiles.Contains(NewerFilePath))
+			{
+				NewerFiles.Add(NewerFilePath, Branch);
 			}
 		}
-		LogResults.Reset();
-		DiffResults.Reset();
-		Intersection.Reset();
 	}
 
 	for (const auto& NewFile : NewerFiles)
@@ -1570,48 +2383,78 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
 	OutErrorMessages.Append(ErrorMessages);
 }
 
-const FTimespan CacheLimit = FTimespan::FromSeconds(30);
+// Parse the output of "git-lfs locks --json" into a list of locks with absolute paths
+static bool ParseLfsLocksJson(const FString& InRepositoryRoot, const TArray<FString>& InResults, TArray<FGitLfsLock>& OutLocks)
+{
+	const FString Json = FString::Join(InResults, TEXT("\n"));
+	TArray<TSharedPtr<FJsonValue>> JsonLocks;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, JsonLocks))
+	{
+		return false;
+	}
+
+	OutLocks.Reserve(OutLocks.Num() + JsonLocks.Num());
+	for (const TSharedPtr<FJsonValue>& JsonLock : JsonLocks)
+	{
+		const TSharedPtr<FJsonObject>* JsonObject = nullptr;
+		if (!JsonLock.IsValid() || !JsonLock->TryGetObject(JsonObject))
+		{
+			continue;
+		}
+		FGitLfsLock& Lock = OutLocks.AddDefaulted_GetRef();
+		(*JsonObject)->TryGetStringField(TEXT("id"), Lock.Id);
+		Lock.Path = FPaths::ConvertRelativePathToFull(InRepositoryRoot, (*JsonObject)->GetStringField(TEXT("path")));
+		const TSharedPtr<FJsonObject>* JsonOwner = nullptr;
+		if ((*JsonObject)->TryGetObjectField(TEXT("owner"), JsonOwner))
+		{
+			(*JsonOwner)->TryGetStringField(TEXT("name"), Lock.Owner);
+		}
+	}
+	return true;
+}
 
 bool GetAllLocks(const FString& InRepositoryRoot, const FString& GitBinaryFallback, TArray<FString>& OutErrorMessages, TMap<FString, FString>& OutLocks, bool bInvalidateCache)
 {
-	// You may ask, why are we ignoring state cache, and instead maintaining our own lock cache?
+	// You may ask, why are we ignoring state cache, and instead maintaining our own lock index?
 	// The answer is that state cache updating is another operation, and those that update status
 	// (and thus the state cache) are using GetAllLocks. However, querying remote locks are almost always
 	// irrelevant in most of those update status cases. So, we need to provide a fast way to provide
-	// an updated local lock state. We could do this through the relevant lfs lock command arguments, which
-	// as you will see below, we use only for offline cases, but the exec cost of doing this isn't worth it
-	// when we can easily maintain this cache here. So, we are really emulating an internal Git LFS locks cache
-	// call, which gets fed into the state cache, rather than reimplementing the state cache :)
-	const FDateTime CurrentTime = FDateTime::Now();
-	bool bCacheExpired = bInvalidateCache;
-	if (!bInvalidateCache)
+	// an updated local lock state. The lock index is kept up to date by our own lock/unlock operations,
+	// refreshed from the server by the background fetch (which invalidates it), and persisted across
+	// editor sessions, so that a status update never has to wait for the LFS server.
+	// While offline, the index also holds the lock intents waiting in the offline journal.
+	if ((!bInvalidateCache || !FGitOfflineQueue::Get().IsRemoteReachable()) && FGitLockedFilesCache::IsPopulated())
 	{
-		const FTimespan CacheTimeElapsed = CurrentTime - FGitLockedFilesCache::LastUpdated;
-		bCacheExpired = CacheTimeElapsed > CacheLimit;
+		OutLocks = FGitLockedFilesCache::GetLockedFiles();
+		return true;
 	}
+
 	bool bResult = false;
-	if (bCacheExpired)
 	{
-		// Our cache expired, or they asked us to expire cache. Query locks directly from the remote server.
+		// The index is empty, or they asked us to refresh it. Query locks directly from the remote server.
 		TArray<FString> ErrorMessages;
 		TArray<FString> Results;
-		bResult = RunLFSCommand(TEXT("locks"), InRepositoryRoot, GitBinaryFallback, FGitSourceControlModule::GetEmptyStringArray(), FGitSourceControlModule::GetEmptyStringArray(),
+		const TArray<FString> JsonParams{TEXT("--json")};
+		bResult = RunLFSCommand(TEXT("locks"), InRepositoryRoot, GitBinaryFallback, JsonParams, FGitSourceControlModule::GetEmptyStringArray(),
 								Results, OutErrorMessages);
-		if (bResult)
+		TArray<FGitLfsLock> Locks;
+		if (bResult && ParseLfsLocksJson(InRepositoryRoot, Results, Locks))
 		{
-			for (const FString& Result : Results)
-			{
-				FGitLfsLocksParser LockFile(InRepositoryRoot, Result);
 #if UE_BUILD_DEBUG && GIT_DEBUG_STATUS
-				UE_LOG(LogSourceControl, Log, TEXT("LockedFile(%s, %s)"), *LockFile.LocalFilename, *LockFile.LockUser);
-#endif
-				OutLocks.Add(MoveTemp(LockFile.LocalFilename), MoveTemp(LockFile.LockUser));
+			for (const FGitLfsLock& Lock : Locks)
+			{
+				UE_LOG(LogSourceControl, Log, TEXT("LockedFile(%s, %s)"), *Lock.Path, *Lock.Owner);
 			}
-			FGitLockedFilesCache::LastUpdated = CurrentTime;
-			FGitLockedFilesCache::SetLockedFiles(OutLocks);
-			return bResult;
+#endif
+			// Apply the listing as a difference with the known locks: only the locks that changed are updated
+			FGitLockedFilesCache::LastUpdated = FDateTime::Now();
+			FGitLockedFilesCache::SetLockedFiles(Locks);
+			OutLocks = FGitLockedFilesCache::GetLockedFiles();
+			return true;
 		}
-		// We tried to invalidate the UE cache, but we failed for some reason. Try updating lock state from LFS cache.
+		bResult = false;
+		// We tried to refresh the lock index, but we failed for some reason. Try updating lock state from LFS cache.
 		// Get the last known state of remote locks
 		TArray<FString> Params;
 		Params.Add(TEXT("--cached"));
@@ -1679,7 +2522,7 @@ void GetLockedFiles(const TArray<FString>& InFiles, TArray<FString>& OutFiles)
 	for (const auto& State : LocalStates)
 	{
 		const auto& GitState = StaticCastSharedRef<FGitSourceControlState>(State);
-		if (GitState->State.LockState == ELockState::Locked)
+		if (GitState->GetLockState() == ELockState::Locked)
 		{
 			OutFiles.Add(GitState->GetFilename());
 		}
@@ -1689,69 +2532,250 @@ void GetLockedFiles(const TArray<FString>& InFiles, TArray<FString>& OutFiles)
 FString GetFullPathFromGitStatus(const FString& Result, const FString& InRepositoryRoot)
 {
 	const FString& RelativeFilename = FilenameFromGitStatus(Result);
-	FString File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename);
-	return File;
+	return FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, RelativeFilename));
+}
+
+bool RunBulkRevert(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutRevertedFiles,
+				   TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
+{
+	// A single status of the tracked files: of the files themselves if they fit on a command line, else of the whole working tree, filtered below
+	const TArray<FString> Parameters{TEXT("--porcelain"), TEXT("--no-renames"), TEXT("--untracked-files=no")};
+	const bool bStatusOfFiles = InFiles.Num() <= GitSourceControlConstants::MaxFilesPerBatch;
+	TArray<FString> Results;
+	if (!RunCommand(TEXT("--no-optional-locks status"), InPathToGitBinary, InRepositoryRoot, Parameters,
+					bStatusOfFiles ? InFiles : FGitSourceControlModule::GetEmptyStringArray(), Results, OutErrorMessages))
+	{
+		return false;
+	}
+
+	const TSet<FString> RequestedFiles(InFiles);
+	TSet<FString> AddedFiles;
+	TArray<FString> ChangedFiles;
+	for (const FString& Result : Results)
+	{
+		if (Result.Len() < 4)
+		{
+			continue;
+		}
+		const FString File = GetFullPathFromGitStatus(Result, InRepositoryRoot);
+		if (!RequestedFiles.Contains(File))
+		{
+			continue;
+		}
+		// Only in the index, not in HEAD: unstaged but kept in the working tree, as the revert of an add always did.
+		// Everything else (modified, deleted, unmerged) is restored from HEAD.
+		const TCHAR IndexState = Result[0];
+		const TCHAR WorkingTreeState = Result[1];
+		if (IndexState == TEXT('A') && WorkingTreeState != TEXT('A') && WorkingTreeState != TEXT('U'))
+		{
+			AddedFiles.Add(File);
+		}
+		else
+		{
+			ChangedFiles.Add(File);
+		}
+	}
+
+	bool bResult = true;
+	if (ChangedFiles.Num() > 0)
+	{
+		// Git 2.25 reads the files from a file: a single process whatever their number, tried again while the editor still holds some of them
+		const FGitScopedTempFile PathspecFile(FText::FromString(FString::Join(ChangedFiles, TEXT("\n"))));
+		const TArray<FString> RestoreParameters{TEXT("--source=HEAD"), TEXT("--staged"), TEXT("--worktree"),
+												FString::Printf(TEXT("--pathspec-from-file=\"%s\""), *FPaths::ConvertRelativePathToFull(PathspecFile.GetFilename()))};
+		TArray<FString> ErrorMessages;
+		bResult = false;
+		if (!PathspecFile.IsValid())
+		{
+			ErrorMessages.Add(FString::Printf(TEXT("Failed to write to temp file: %s"), *PathspecFile.GetFilename()));
+		}
+		for (int32 Attempt = 0; PathspecFile.IsValid() && !bResult && Attempt < GitSourceControlConstants::MaxRevertAttempts; Attempt++)
+		{
+			if (Attempt > 0)
+			{
+				FPlatformProcess::Sleep(GitSourceControlConstants::RevertRetryDelaySeconds);
+			}
+			ErrorMessages.Reset();
+			bResult = RunCommand(TEXT("restore"), InPathToGitBinary, InRepositoryRoot, RestoreParameters, FGitSourceControlModule::GetEmptyStringArray(), OutResults, ErrorMessages);
+		}
+		OutErrorMessages.Append(MoveTemp(ErrorMessages));
+	}
+	if (AddedFiles.Num() > 0)
+	{
+		const FGitScopedTempFile PathspecFile(FText::FromString(FString::Join(AddedFiles.Array(), TEXT("\n"))));
+		const TArray<FString> ResetParameters{TEXT("-q"), FString::Printf(TEXT("--pathspec-from-file=\"%s\""), *FPaths::ConvertRelativePathToFull(PathspecFile.GetFilename()))};
+		if (!PathspecFile.IsValid())
+		{
+			OutErrorMessages.Add(FString::Printf(TEXT("Failed to write to temp file: %s"), *PathspecFile.GetFilename()));
+		}
+		bResult &= PathspecFile.IsValid() && RunCommand(TEXT("reset"), InPathToGitBinary, InRepositoryRoot, ResetParameters, FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+	}
+
+	// The locks of all the files but the added ones are released, modified or not
+	OutRevertedFiles = InFiles.FilterByPredicate([&AddedFiles](const FString& File) { return !AddedFiles.Contains(File); });
+	UE_LOG(LogSourceControl, Verbose, TEXT("Reverted %d file(s): %d restored from HEAD, %d unstaged, %d unchanged"), InFiles.Num(), ChangedFiles.Num(), AddedFiles.Num(),
+		InFiles.Num() - ChangedFiles.Num() - AddedFiles.Num());
+	return bResult;
 }
 
 #if ENGINE_MAJOR_VERSION == 5
-bool UpdateChangelistStateByCommand()
+/** Changelist of the files found by a status command, and the paths it covered */
+struct FGitChangelistStatus
 {
-	// TODO: This is a temporary solution.
-	FModuleManager &ModuleManager = FModuleManager::Get();
-	FName GitModuleName = "GitSourceControl";
+	/** Modified files, true if they have changes in the index */
+	TMap<FString, bool> ModifiedFiles;
+	/** Files and directories given to the status command: their other files are unmodified */
+	TSet<FString> QueriedFiles;
+	TArray<FString> QueriedDirectories;
+};
 
-	if (!ModuleManager.IsModuleLoaded(GitModuleName))
+// The changelists only hold the files of the Content directory, as filled by the full refresh: the other files of a status (Config, Plugins...) are left out
+static FGitChangelistStatus MakeChangelistStatus(const TArray<FString>& InFiles, const TMap<FString, FString>& InResults)
+{
+	const FString ContentDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir());
+	FGitChangelistStatus Status;
+	Status.ModifiedFiles.Reserve(InResults.Num());
+	for (const auto& Pair : InResults)
 	{
-		UE_LOG(LogSourceControl, Warning, TEXT("GitSourceControl module is not loaded."));
-		return false;
+		const FString& Result = Pair.Value;
+		if (Result.Len() < 2 || !Pair.Key.StartsWith(ContentDir, ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		// "XY path": X is the status of the index, Y the one of the working tree, "??" for untracked files, which belong to Staged like new files
+		const bool bStaged = !TChar<TCHAR>::IsWhitespace(Result[0]) && Result[0] != TEXT('!');
+		if (bStaged || !TChar<TCHAR>::IsWhitespace(Result[1]))
+		{
+			Status.ModifiedFiles.Add(Pair.Key, bStaged);
+		}
 	}
-	
-	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
-	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
-	if (!Provider.IsGitAvailable())
+	Status.QueriedFiles.Reserve(InFiles.Num());
+	for (const FString& File : InFiles)
 	{
-		return false;
+		// Assets always have an extension: only stat the paths that do not
+		if (File.EndsWith(TEXT("/")) || (FPaths::GetExtension(File).IsEmpty() && IFileManager::Get().DirectoryExists(*File)))
+		{
+			const FString Directory = File.EndsWith(TEXT("/")) ? File : File + TEXT("/");
+			if (Directory.StartsWith(ContentDir, ESearchCase::IgnoreCase))
+			{
+				Status.QueriedDirectories.Add(Directory);
+			}
+			else if (ContentDir.StartsWith(Directory, ESearchCase::IgnoreCase))
+			{
+				// A parent of the Content directory, like the project directory
+				Status.QueriedDirectories.AddUnique(ContentDir);
+			}
+		}
+		else if (File.StartsWith(ContentDir, ESearchCase::IgnoreCase))
+		{
+			Status.QueriedFiles.Add(File);
+		}
 	}
+	return Status;
+}
+
+/** Apply the result of a status command to the Staged and Working changelists, moving only the files whose changelist changed */
+static void ApplyChangelistStatus(FGitChangelistStatus&& InStatus)
+{
+	if (!IsInGameThread())
+	{
+		// The changelists are read by the editor on the game thread
+		AsyncTask(ENamedThreads::GameThread, [Status = MoveTemp(InStatus)]() mutable { ApplyChangelistStatus(MoveTemp(Status)); });
+		return;
+	}
+
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl)
+	{
+		return;
+	}
+	FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
 	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> StagedChangelist = Provider.GetStateInternal(FGitSourceControlChangelist::StagedChangelist);
 	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> WorkingChangelist = Provider.GetStateInternal(FGitSourceControlChangelist::WorkingChangelist);
-	StagedChangelist->Files.RemoveAll([](const FSourceControlStateRef& InState){ return true; });
-	WorkingChangelist->Files.RemoveAll([](const FSourceControlStateRef& InState){ return true; });
 
-	TArray<FString> Files;
-	Files.Add(TEXT("Content/"));
-	TArray<FString> Parameters;
-	Parameters.Add(TEXT("--porcelain"));
-	TArray<FString> Results;
-	TArray<FString> ErrorMsg;
-	const bool bResult = RunCommand(TEXT("--no-optional-locks status"), Provider.GetGitBinaryPath(), Provider.GetPathToRepositoryRoot(), Parameters, Files, Results, ErrorMsg);
-	for (const auto& Result : Results)
+	const auto RemoveFromChangelists = [&StagedChangelist, &WorkingChangelist](const TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>& State)
 	{
-		FString File = GetFullPathFromGitStatus(Result, Provider.GetPathToRepositoryRoot());
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(File);
-		// Staged check
-		if (!TChar<TCHAR>::IsWhitespace(Result[0]))
+		StagedChangelist->RemoveFile(State);
+		WorkingChangelist->RemoveFile(State);
+		State->Changelist = FGitSourceControlChangelist();
+	};
+
+	// Files queried but not reported are unmodified: they leave the changelists
+	for (const FString& File : InStatus.QueriedFiles)
+	{
+		if (!InStatus.ModifiedFiles.Contains(File))
 		{
-			WorkingChangelist->Files.Remove(State);
-			UpdateFileStagingOnSavedInternal(Result);
-			State->Changelist = FGitSourceControlChangelist::StagedChangelist;
-			StagedChangelist->Files.AddUnique(State);
-			continue;
+			RemoveFromChangelists(Provider.GetStateInternal(File));
 		}
-		// Working check
-		if (!TChar<TCHAR>::IsWhitespace(Result[1]))
+	}
+	if (InStatus.QueriedDirectories.Num() > 0)
+	{
+		TArray<TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe>> UnmodifiedStates;
+		for (const auto& Changelist : {StagedChangelist, WorkingChangelist})
+		{
+			for (const FSourceControlStateRef& State : Changelist->GetFilesStates())
+			{
+				const FString& Filename = State->GetFilename();
+				if (!InStatus.ModifiedFiles.Contains(Filename) && InStatus.QueriedDirectories.ContainsByPredicate([&Filename](const FString& Directory) { return Filename.StartsWith(Directory); }))
+				{
+					UnmodifiedStates.Add(StaticCastSharedRef<FGitSourceControlState>(State));
+				}
+			}
+		}
+		for (const auto& State : UnmodifiedStates)
 		{
-			StagedChangelist->Files.Remove(State);
-			State->Changelist = FGitSourceControlChangelist::WorkingChangelist;
-			WorkingChangelist->Files.AddUnique(State);
+			RemoveFromChangelists(State);
 		}
 	}
+
+	for (const auto& Pair : InStatus.ModifiedFiles)
+	{
+		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(Pair.Key);
+		TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe>& From = Pair.Value ? WorkingChangelist : StagedChangelist;
+		TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe>& To = Pair.Value ? StagedChangelist : WorkingChangelist;
+		From->RemoveFile(State);
+		To->AddFile(State);
+		State->Changelist = To->Changelist;
+	}
+}
+
+bool UpdateChangelistStateByCommand()
+{
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("GitSourceControl module is not loaded."));
+		return false;
+	}
+	const FGitSourceControlProvider& Provider = GitSourceControl->GetProvider();
+	if (!Provider.IsGitAvailable())
+	{
+		return false;
+	}
+
+	// Full refresh of the changelists: the status of the whole Content directory
+	const FString& RepositoryRoot = Provider.GetPathToRepositoryRoot();
+	const TArray<FString> Files{FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir())};
+	const TArray<FString> Parameters{TEXT("--porcelain"), TEXT("-uall")};
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	if (!RunCommand(TEXT("--no-optional-locks status"), Provider.GetGitBinaryPath(), RepositoryRoot, Parameters, Files, Results, ErrorMessages))
+	{
+		return false;
+	}
+	TMap<FString, FString> ResultsMap;
+	for (const FString& Result : Results)
+	{
+		ResultsMap.Add(GetFullPathFromGitStatus(Result, RepositoryRoot), Result);
+	}
+	ApplyChangelistStatus(MakeChangelistStatus(Files, ResultsMap));
 	return true;
 }
 #endif
 	
 // Run a batch of Git "status" command to update status of given files and/or directories.
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking, const TArray<FString>& InFiles,
-					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates)
+					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates, const bool bInCheckRemote)
 {
 	// Remove files that aren't in the repository
 	const TArray<FString>& RepoFiles = InFiles.FilterByPredicate([InRepositoryRoot](const FString& File) { return File.StartsWith(InRepositoryRoot); });
@@ -1772,7 +2796,7 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InReposito
 	for (const auto& Result : Results)
 	{
 		const FString& RelativeFilename = FilenameFromGitStatus(Result);
-		const FString& File = FPaths::ConvertRelativePathToFull(InRepositoryRoot, RelativeFilename);
+		const FString& File = FGitPathTable::Get().GetPath(FGitPathTable::Get().InternRelative(InRepositoryRoot, RelativeFilename));
 		ResultsMap.Add(File, Result);
 	}
 	if (bResult)
@@ -1781,41 +2805,90 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InReposito
 	}
 
 #if ENGINE_MAJOR_VERSION == 5
-	UpdateChangelistStateByCommand();
+	if (bResult)
+	{
+		// Move only the queried files between the changelists, from the status we already have
+		ApplyChangelistStatus(MakeChangelistStatus(RepoFiles, ResultsMap));
+	}
 #endif
 
-	CheckRemote(InPathToGitBinary, InRepositoryRoot, RepoFiles, OutErrorMessages, OutStates);
+	if (bInCheckRemote)
+	{
+		CheckRemote(InPathToGitBinary, InRepositoryRoot, RepoFiles, OutErrorMessages, OutStates);
+	}
 
 	return bResult;
 }
 
 #if ENGINE_MAJOR_VERSION == 5
-void UpdateFileStagingOnSaved(const FString& Filename, UPackage* Pkg, FObjectPostSaveContext ObjectSaveContext)
+/** Staged files saved since the last flush, to be added again all at once */
+static FCriticalSection SaveStagingCriticalSection;
+static TSet<FString> PendingSaveStaging;
+static bool bSaveStagingFlushScheduled = false;
+
+static bool OnSaveStagingWindowElapsed(float /* DeltaTime */)
 {
-	UpdateFileStagingOnSavedInternal(Filename);
+	FlushFileStagingOnSaved(false);
+	return false; // One shot ticker
 }
-	
-bool UpdateFileStagingOnSavedInternal(const FString& Filename)
+
+void UpdateFileStagingOnSaved(const FString& Filename, UPackage* Pkg, FObjectPostSaveContext ObjectSaveContext)
 {
-	bool bResult = false;
 	FGitSourceControlModule& GitSourceControl = FModuleManager::GetModuleChecked<FGitSourceControlModule>("GitSourceControl");
 	FGitSourceControlProvider& Provider = GitSourceControl.GetProvider();
 	if (!Provider.IsGitAvailable())
 	{
-		return bResult;
+		return;
 	}
+	// Only the files already staged need to be added again, to stage their new content
 	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(Filename);
+	if (!State->Changelist.GetName().Equals(TEXT("Staged")))
+	{
+		return;
+	}
 
-	if (State->Changelist.GetName().Equals(TEXT("Staged")))
+	// A "Save All" saves many packages in a row: collect them, and stage them in a single git command once the saves are done
+	FScopeLock ScopeLock(&SaveStagingCriticalSection);
+	PendingSaveStaging.Add(Filename);
+	if (!bSaveStagingFlushScheduled)
 	{
-		TArray<FString> File;
-		File.Add(Filename);
-		TArray<FString> DummyResults;
-		TArray<FString> DummyMsgs;
-		bResult = RunCommand(TEXT("add"), Provider.GetGitBinaryPath(), Provider.GetPathToRepositoryRoot(), FGitSourceControlModule::GetEmptyStringArray(), File, DummyResults, DummyMsgs);
+		bSaveStagingFlushScheduled = true;
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&OnSaveStagingWindowElapsed), GitSourceControlConstants::SaveStagingWindowSeconds);
 	}
-	
-	return bResult;
+}
+
+void FlushFileStagingOnSaved(const bool bInSynchronous)
+{
+	TArray<FString> Files;
+	{
+		FScopeLock ScopeLock(&SaveStagingCriticalSection);
+		Files = PendingSaveStaging.Array();
+		PendingSaveStaging.Reset();
+		bSaveStagingFlushScheduled = false;
+	}
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (Files.Num() == 0 || !GitSourceControl || !GitSourceControl->GetProvider().IsGitAvailable())
+	{
+		return;
+	}
+
+	// Through the command queue, so that "git add" runs in order with the other commands writing the index
+	GitSourceControl->GetProvider().Execute(ISourceControlOperation::Create<FGitStageSaved>(), FSourceControlChangelistPtr(), Files,
+											bInSynchronous ? EConcurrency::Synchronous : EConcurrency::Asynchronous);
+}
+
+bool RunStageFiles(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages)
+{
+	TArray<FString> Results;
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (InFiles.Num() > GitSourceControlConstants::MaxFilesPerBatch && GitSourceControl && GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25))
+	{
+		// Git 2.25 can read the files from a file: a single process whatever the number of files
+		const FGitScopedTempFile PathspecFile(FText::FromString(FString::Join(InFiles, TEXT("\n"))));
+		const TArray<FString> Parameters{FString::Printf(TEXT("--pathspec-from-file=\"%s\""), *FPaths::ConvertRelativePathToFull(PathspecFile.GetFilename()))};
+		return PathspecFile.IsValid() && RunCommand(TEXT("add"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, OutErrorMessages);
+	}
+	return RunCommand(TEXT("add"), InPathToGitBinary, InRepositoryRoot, FGitSourceControlModule::GetEmptyStringArray(), InFiles, Results, OutErrorMessages);
 }
 #endif
 	
@@ -1830,20 +2903,18 @@ void UpdateStateOnAssetRename(const FAssetData& InAssetData, const FString& InOl
 	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(InOldName);	
 
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
-	State->LocalFilename = InAssetData.GetObjectPathString();
+	State->SetFilename(InAssetData.GetObjectPathString());
 #else
-	State->LocalFilename = InAssetData.ObjectPath.ToString();
+	State->SetFilename(InAssetData.ObjectPath.ToString());
 #endif
 }
 
 // Run a Git `cat-file --filters` command to dump the binary content of a revision into a file.
-bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName)
+bool RunCommandStreamed(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InCommand, TFunctionRef<bool(const uint8*, int32)> OnData, int32& OutReturnCode)
 {
-	int32 ReturnCode = -1;
+	OutReturnCode = -1;
 	FString FullCommand;
 
-	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
-
 	if (!InRepositoryRoot.IsEmpty())
 	{
 		// Specify the working copy (the root) of the git repository (before the command itself)
@@ -1851,13 +2922,7 @@ bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepository
 		FullCommand += InRepositoryRoot;
 		FullCommand += TEXT("\" ");
 	}
-
-	// then the git command itself
-	// Newer versions (2.9.3.windows.2) support smudge/clean filters used by Git LFS, git-fat, git-annex, etc
-	FullCommand += TEXT("cat-file --filters ");
-
-	// Append to the command the parameter
-	FullCommand += TEXT("\"") + InParameter + TEXT("\"");
+	FullCommand += InCommand;
 
 	const bool bLaunchDetached = false;
 	const bool bLaunchHidden = true;
@@ -1868,90 +2933,205 @@ bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepository
 
 	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
 
-	UE_LOG(LogSourceControl, Log, TEXT("RunDumpToFile: 'git %s'"), *FullCommand);
-
-    FString PathToGitOrEnvBinary = InPathToGitBinary;
-    #if PLATFORM_MAC
-        // The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
-        FString PathEnv = FPlatformMisc::GetEnvironmentVariable(TEXT("PATH"));
-        FString GitInstallPath = FPaths::GetPath(InPathToGitBinary);
-
-        TArray<FString> PathArray;
-        PathEnv.ParseIntoArray(PathArray, FPlatformMisc::GetPathVarDelimiter());
-        bool bHasGitInstallPath = false;
-        for (auto Path : PathArray)
-        {
-            if (GitInstallPath.Equals(Path, ESearchCase::CaseSensitive))
-            {
-                bHasGitInstallPath = true;
-                break;
-            }
-        }
-
-        if (!bHasGitInstallPath)
-        {
-            PathToGitOrEnvBinary = FString("/usr/bin/env");
-            FullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *GitInstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToGitBinary, *FullCommand);
-        }
-    #endif
+	UE_LOG(LogSourceControl, Log, TEXT("RunCommandStreamed: 'git %s'"), *FullCommand);
+
+	FString PathToGitOrEnvBinary = InPathToGitBinary;
+#if PLATFORM_MAC
+	// The Cocoa application does not inherit shell environment variables, so add the path expected to have git-lfs to PATH
+	FString PathEnv = FPlatformMisc::GetEnvironmentVariable(TEXT("PATH"));
+	FString GitInstallPath = FPaths::GetPath(InPathToGitBinary);
+
+	TArray<FString> PathArray;
+	PathEnv.ParseIntoArray(PathArray, FPlatformMisc::GetPathVarDelimiter());
+	bool bHasGitInstallPath = false;
+	for (auto Path : PathArray)
+	{
+		if (GitInstallPath.Equals(Path, ESearchCase::CaseSensitive))
+		{
+			bHasGitInstallPath = true;
+			break;
+		}
+	}
+
+	if (!bHasGitInstallPath)
+	{
+		PathToGitOrEnvBinary = FString("/usr/bin/env");
+		FullCommand = FString::Printf(TEXT("PATH=\"%s%s%s\" \"%s\" %s"), *GitInstallPath, FPlatformMisc::GetPathVarDelimiter(), *PathEnv, *InPathToGitBinary, *FullCommand);
+	}
+#endif
 
 #if ENGINE_MAJOR_VERSION == 5 && 0
 	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*PathToGitOrEnvBinary, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, *InRepositoryRoot, PipeWrite, nullptr, nullptr);
 #else
 	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*PathToGitOrEnvBinary, *FullCommand, bLaunchDetached, bLaunchHidden, bLaunchReallyHidden, nullptr, 0, *InRepositoryRoot, PipeWrite);
 #endif
-	if(ProcessHandle.IsValid())
-	{
-		FPlatformProcess::Sleep(0.01f);
-
-		TArray<uint8> BinaryFileContent;
-		bool bShouldContinue = true;
-		while (FPlatformProcess::IsProcRunning(ProcessHandle) || bShouldContinue)
-		{
-			TArray<uint8> BinaryData;
-			bShouldContinue = FPlatformProcess::ReadPipeToArray(PipeRead, BinaryData);
-			if (BinaryData.Num() > 0)
+	bool bDataAccepted = true;
+	if (ProcessHandle.IsValid())
+	{
+		GIT_TRACE_COMMAND_SCOPE(*InCommand);
+		FGitScopedCommandTrace CommandTrace(InCommand, 0, 0);
+		int64 StdOutBytes = 0;
+		FGitSourceControlCommand* Command = FGitSourceControlCommand::GetCurrent();
+		// The chunk is reused for each read, so memory use is bounded by the size of the pipe buffer
+		TArray<uint8> Chunk;
+		int32 IdleReads = 0;
+		bool bProcessExited = false;
+		while (bDataAccepted)
+		{
+			if (Command && Command->IsCanceled())
 			{
-				// @todo: this is hacky!
-				bool bIsLFSMessage = BinaryData[0] == 68 // Check for D in "Downloading"
-									&& BinaryData.Last() == 10; // Check for new line
-				if (GitSourceControl.AccessSettings().IsUsingGitLfsLocking() && bIsLFSMessage)
-				{
-					continue;
-				}
-				BinaryFileContent.Append(MoveTemp(BinaryData));
+				bDataAccepted = false;
+				break;
 			}
-		}
-
-		FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
-		if (ReturnCode == 0)
-		{
-			// Save buffer into temp file
-			if (FFileHelper::SaveArrayToFile(BinaryFileContent, *InDumpFileName))
+			Chunk.Reset();
+			if (FPlatformProcess::ReadPipeToArray(PipeRead, Chunk) && Chunk.Num() > 0)
+			{
+				StdOutBytes += Chunk.Num();
+				bDataAccepted = OnData(Chunk.GetData(), Chunk.Num());
+				IdleReads = 0;
+			}
+			else if (bProcessExited)
+			{
+				// The process exited and the pipe is drained
+				break;
+			}
+			else if (FPlatformProcess::IsProcRunning(ProcessHandle))
 			{
-				UE_LOG(LogSourceControl, Log, TEXT("Wrote '%s' (%do)"), *InDumpFileName, BinaryFileContent.Num());
+				// There is no blocking read on platform pipes: yield while the process is producing data, then back off
+				FPlatformProcess::Sleep(IdleReads++ < GitSourceControlConstants::StreamYieldReads ? 0.0f : 0.001f);
 			}
 			else
 			{
-				UE_LOG(LogSourceControl, Error, TEXT("Could not write %s"), *InDumpFileName);
-				ReturnCode = -1;
+				// The process may have written its last bytes between the last read and its exit: read until the pipe is empty
+				bProcessExited = true;
 			}
 		}
+
+		if (bDataAccepted)
+		{
+			FPlatformProcess::GetProcReturnCode(ProcessHandle, &OutReturnCode);
+		}
 		else
 		{
-			UE_LOG(LogSourceControl, Error, TEXT("DumpToFile: ReturnCode=%d"), ReturnCode);
+			FPlatformProcess::TerminateProc(ProcessHandle);
 		}
-
 		FPlatformProcess::CloseProc(ProcessHandle);
+		CommandTrace.SetResult(OutReturnCode, StdOutBytes, 0);
 	}
 	else
 	{
-		UE_LOG(LogSourceControl, Error, TEXT("Failed to launch 'git cat-file'"));
+		UE_LOG(LogSourceControl, Error, TEXT("Failed to launch 'git %s'"), *InCommand);
 	}
 
 	FPlatformProcess::ClosePipe(PipeRead, PipeWrite);
 
-	return (ReturnCode == 0);
+	return bDataAccepted && (OutReturnCode == 0);
+}
+
+bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName)
+{
+	FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	const bool bUsingGitLfsLocking = GitSourceControl.AccessSettings().IsUsingGitLfsLocking();
+
+	// Newer versions (2.9.3.windows.2) support smudge/clean filters used by Git LFS, git-fat, git-annex, etc
+	const FString Command = FString::Printf(TEXT("cat-file --filters \"%s\""), *InParameter);
+
+	// Write to a temporary file next to the destination, so that an interrupted dump is never reused as a complete one
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString PartialFileName = InDumpFileName + TEXT(".partial");
+	TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenWrite(*PartialFileName));
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("Could not write %s"), *InDumpFileName);
+		return false;
+	}
+
+	int64 BytesWritten = 0;
+	int32 ReturnCode = -1;
+	bool bResult = RunCommandStreamed(InPathToGitBinary, InRepositoryRoot, Command, [&](const uint8* Data, int32 Size)
+	{
+		// @todo: this is hacky!
+		const bool bIsLFSMessage = Data[0] == 68 // Check for D in "Downloading"
+								&& Data[Size - 1] == 10; // Check for new line
+		if (bUsingGitLfsLocking && bIsLFSMessage)
+		{
+			return true;
+		}
+		BytesWritten += Size;
+		return FileHandle->Write(Data, Size);
+	}, ReturnCode);
+	FileHandle.Reset();
+
+	if (bResult)
+	{
+		PlatformFile.DeleteFile(*InDumpFileName);
+		bResult = PlatformFile.MoveFile(*InDumpFileName, *PartialFileName);
+	}
+	if (bResult)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("Wrote '%s' (%lldo)"), *InDumpFileName, BytesWritten);
+	}
+	else
+	{
+		UE_LOG(LogSourceControl, Error, TEXT("DumpToFile: could not write %s (ReturnCode=%d)"), *InDumpFileName, ReturnCode);
+		PlatformFile.DeleteFile(*PartialFileName);
+	}
+
+	return bResult;
+}
+
+bool GetBlobHash(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, FString& OutBlobHash)
+{
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const TArray<FString> Parameters{TEXT("--verify"), TEXT("--quiet"), FString::Printf(TEXT("\"%s\""), *InParameter)};
+	const bool bResults = RunCommand(TEXT("rev-parse"), InPathToGitBinary, InRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+	if (bResults && Results.Num() > 0)
+	{
+		// The whole first token: 40 hexadecimal digits, or 64 in a SHA-256 repository
+		TArray<FString> Tokens;
+		Results[0].ParseIntoArrayWS(Tokens);
+		if (Tokens.Num() > 0 && IsObjectId(Tokens[0]))
+		{
+			OutBlobHash = MoveTemp(Tokens[0]);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IsObjectId(const FString& InString)
+{
+	if (InString.Len() != 40 && InString.Len() != 64)
+	{
+		return false;
+	}
+	for (const TCHAR Char : InString)
+	{
+		if (!FChar::IsHexDigit(Char))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FString GetBlobCacheFilename(const FString& InBlobHash, const FString& InExtension)
+{
+	// Fan out on the first two hex digits, like the Git object store
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("GitSourceControl") / TEXT("BlobCache") / InBlobHash.Left(2) / InBlobHash + InExtension);
+}
+
+bool RunDumpToBlobCache(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InBlobHash, const FString& InExtension, FString& OutCachedFileName)
+{
+	OutCachedFileName = GetBlobCacheFilename(InBlobHash, InExtension);
+	if (FPaths::FileExists(OutCachedFileName))
+	{
+		// The content of a blob never changes: reuse it directly
+		return true;
+	}
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutCachedFileName), true);
+	return RunDumpToFile(InPathToGitBinary, InRepositoryRoot, InParameter, OutCachedFileName);
 }
 
 /**
@@ -2000,103 +3180,178 @@ static FString LogStatusToString(TCHAR InStatus)
 	return FString();
 }
 
+/** Format of the log parsed by FGitLogParser: each commit starts with \x01, its fields end with a NUL */
+static const TCHAR* GitLogFormat = TEXT("--format=%x01%H%x00%an%x00%at%x00%B%x00");
+
 /**
- * Parse the array of strings results of a 'git log' command
+ * Parse the output of a 'git log -z --name-status' with GitLogFormat, in a single pass over the whole output.
  *
- * Example git log results:
-commit 97a4e7626681895e073aaefd68b8ac087db81b0b
-Author: Sébastien Rombauts <sebastien.rombauts@gmail.com>
-Date:   2014-2015-05-15 21:32:27 +0200
-
-	Another commit used to test History
-
-	 - with many lines
-	 - some <xml>
-	 - and strange characteres $*+
-
-M	Content/Blueprints/Blueprint_CeilingLight.uasset
-R100	Content/Textures/T_Concrete_Poured_D.uasset Content/Textures/T_Concrete_Poured_D2.uasset
-
-commit 355f0df26ebd3888adbb558fd42bb8bd3e565000
-Author: Sébastien Rombauts <sebastien.rombauts@gmail.com>
-Date:   2014-2015-05-12 11:28:14 +0200
-
-	Testing git status, edit, and revert
-
-A	Content/Blueprints/Blueprint_CeilingLight.uasset
-C099	Content/Textures/T_Concrete_Poured_N.uasset Content/Textures/T_Concrete_Poured_N2.uasset
+ * The fields are read in place from the buffer, without a string per line, and a revision is a single allocation with its reference count.
+ *
+ * Example output (with NUL characters shown as |, and \x01 as ^):
+^97a4e7626681895e073aaefd68b8ac087db81b0b|Sébastien Rombauts|1431718347|Another commit used to test History
+
+ - with many lines
+|
+M|Content/Blueprints/Blueprint_CeilingLight.uasset|^355f0df26ebd3888adbb558fd42bb8bd3e565000|Sébastien Rombauts|1431422894|Testing git status, edit, and revert
+|
+R100|Content/Textures/T_Concrete_Poured_D.uasset|Content/Textures/T_Concrete_Poured_D2.uasset|
 */
-static void ParseLogResults(const TArray<FString>& InResults, TGitSourceControlHistory& OutHistory)
+class FGitLogParser
 {
-	TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
-	for (const auto& Result : InResults)
+public:
+	FGitLogParser(const uint8* InData, int32 InSize)
+		: Data(InData)
+		, Size(InSize)
+	{
+	}
+
+	void Parse(TGitSourceControlHistory& OutHistory)
 	{
-		if (Result.StartsWith(TEXT("commit "))) // Start of a new commit
+		while (Position < Size)
 		{
-			// End of the previous commit
-			if (SourceControlRevision->RevisionNumber != 0)
+			if (Data[Position++] != CommitMarker)
+			{
+				continue;
+			}
+			TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe> SourceControlRevision = MakeShared<FGitSourceControlRevision, ESPMode::ThreadSafe>();
+
+			const FField CommitId = NextField();
+			SourceControlRevision->CommitId = ToString(CommitId); // Full commit SHA1 hexadecimal string
+			SourceControlRevision->ShortCommitId = SourceControlRevision->CommitId.Left(8); // Short revision ; first 8 hex characters (max that can hold a 32 bit integer)
+			SourceControlRevision->CommitIdNumber = static_cast<int32>(ParseHex(CommitId, 8));
+			SourceControlRevision->UserName = ToString(NextField());
+			SourceControlRevision->Date = FDateTime::FromUnixTimestamp(ParseDecimal(NextField()));
+			FField Description = NextField();
+			while (Description.Size > 0 && Description.Data[Description.Size - 1] == '\n')
 			{
-				OutHistory.Add(MoveTemp(SourceControlRevision));
+				Description.Size--;
+			}
+			SourceControlRevision->Description = ToString(Description);
 
-				SourceControlRevision = MakeShareable(new FGitSourceControlRevision);
+			// Name of the file, after an uppercase status letter ("A"/"M"...), and after the source for a Renamed/Copied file ("R100"/"C099")
+			while (Position < Size && Data[Position] != CommitMarker)
+			{
+				FField Status = NextField();
+				while (Status.Size > 0 && Status.Data[0] == '\n')
+				{
+					Status.Data++;
+					Status.Size--;
+				}
+				if (Status.Size == 0)
+				{
+					continue;
+				}
+				FField Filename = NextField();
+				if (Status.Data[0] == 'R' || Status.Data[0] == 'C')
+				{
+					Filename = NextField();
+				}
+				SourceControlRevision->Action = LogStatusToString(Status.Data[0]); // Readable action string ("Added", Modified"...) instead of "A"/"M"...
+				SourceControlRevision->Filename = ToString(Filename); // relative filename
 			}
-			SourceControlRevision->CommitId = Result.RightChop(7); // Full commit SHA1 hexadecimal string
-			SourceControlRevision->ShortCommitId = SourceControlRevision->CommitId.Left(8); // Short revision ; first 8 hex characters (max that can hold a 32
-																							// bit integer)
-			SourceControlRevision->CommitIdNumber = FParse::HexNumber(*SourceControlRevision->ShortCommitId);
+
 			SourceControlRevision->RevisionNumber = -1; // RevisionNumber will be set at the end, based off the index in the History
+			OutHistory.Add(MoveTemp(SourceControlRevision));
 		}
-		else if (Result.StartsWith(TEXT("Author: "))) // Author name & email
+
+		// Then set the revision number of each Revision based on its index (reverse order since the log starts with the most recent change)
+		for (int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
 		{
-			// Remove the 'email' part of the UserName
-			FString UserNameEmail = Result.RightChop(8);
-			int32 EmailIndex = 0;
-			if (UserNameEmail.FindLastChar('<', EmailIndex))
+			const auto& SourceControlRevisionItem = OutHistory[RevisionIndex];
+			SourceControlRevisionItem->RevisionNumber = OutHistory.Num() - RevisionIndex;
+
+			// Special case of a move ("branch" in Perforce term): point to the previous change (so the next one in the order of the log)
+			if ((SourceControlRevisionItem->Action == "branch") && (RevisionIndex < OutHistory.Num() - 1))
 			{
-				SourceControlRevision->UserName = UserNameEmail.Left(EmailIndex - 1);
+				SourceControlRevisionItem->BranchSource = OutHistory[RevisionIndex + 1];
 			}
 		}
-		else if (Result.StartsWith(TEXT("Date:   "))) // Commit date
-		{
-			FString Date = Result.RightChop(8);
-			SourceControlRevision->Date = FDateTime::FromUnixTimestamp(FCString::Atoi(*Date));
-		}
-		//	else if(Result.IsEmpty()) // empty line before/after commit message has already been taken care by FString::ParseIntoArray()
-		else if (Result.StartsWith(TEXT("    "))) // Multi-lines commit message
+	}
+
+private:
+	static constexpr uint8 CommitMarker = 0x01;
+
+	/** A field borrowed from the buffer */
+	struct FField
+	{
+		const uint8* Data;
+		int32 Size;
+	};
+
+	/** The field at the current position, up to the next NUL (or the next commit, for a truncated output) */
+	FField NextField()
+	{
+		const int32 Start = Position;
+		while (Position < Size && Data[Position] != 0 && Data[Position] != CommitMarker)
 		{
-			SourceControlRevision->Description += Result.RightChop(4);
-			SourceControlRevision->Description += TEXT("\n");
+			Position++;
 		}
-		else // Name of the file, starting with an uppercase status letter ("A"/"M"...)
+		const FField Field{Data + Start, Position - Start};
+		if (Position < Size && Data[Position] == 0)
 		{
-			const TCHAR Status = Result[0];
-			SourceControlRevision->Action = LogStatusToString(Status); // Readable action string ("Added", Modified"...) instead of "A"/"M"...
-			// Take care of special case for Renamed/Copied file: extract the second filename after second tabulation
-			int32 IdxTab;
-			if (Result.FindLastChar('\t', IdxTab))
-			{
-				SourceControlRevision->Filename = Result.RightChop(IdxTab + 1); // relative filename
-			}
+			Position++;
 		}
+		return Field;
 	}
-	// End of the last commit
-	if (SourceControlRevision->RevisionNumber != 0)
+
+	static FString ToString(const FField& InField)
 	{
-		OutHistory.Add(MoveTemp(SourceControlRevision));
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(InField.Data), InField.Size);
+		return FString(Converted.Length(), Converted.Get());
 	}
 
-	// Then set the revision number of each Revision based on its index (reverse order since the log starts with the most recent change)
-	for (int32 RevisionIndex = 0; RevisionIndex < OutHistory.Num(); RevisionIndex++)
+	static uint32 ParseHex(const FField& InField, int32 InMaxDigits)
 	{
-		const auto& SourceControlRevisionItem = OutHistory[RevisionIndex];
-		SourceControlRevisionItem->RevisionNumber = OutHistory.Num() - RevisionIndex;
+		uint32 Value = 0;
+		for (int32 Index = 0; Index < FMath::Min(InField.Size, InMaxDigits); Index++)
+		{
+			const uint8 Char = InField.Data[Index];
+			const uint32 Digit = (Char >= '0' && Char <= '9') ? Char - '0' : (Char >= 'a' && Char <= 'f') ? Char - 'a' + 10 : (Char >= 'A' && Char <= 'F') ? Char - 'A' + 10 : 0;
+			Value = (Value << 4) | Digit;
+		}
+		return Value;
+	}
 
-		// Special case of a move ("branch" in Perforce term): point to the previous change (so the next one in the order of the log)
-		if ((SourceControlRevisionItem->Action == "branch") && (RevisionIndex < OutHistory.Num() - 1))
+	static int64 ParseDecimal(const FField& InField)
+	{
+		int64 Value = 0;
+		for (int32 Index = 0; Index < InField.Size && InField.Data[Index] >= '0' && InField.Data[Index] <= '9'; Index++)
 		{
-			SourceControlRevisionItem->BranchSource = OutHistory[RevisionIndex + 1];
+			Value = Value * 10 + (InField.Data[Index] - '0');
 		}
+		return Value;
+	}
+
+	const uint8* Data;
+	int32 Size;
+	int32 Position = 0;
+};
+
+void ParseLog(const uint8* InData, int32 InSize, TGitSourceControlHistory& OutHistory)
+{
+	FGitLogParser(InData, InSize).Parse(OutHistory);
+}
+
+/** Run a 'git log' with the format of FGitLogParser, reading its whole output into a single buffer to parse it in place */
+static bool RunLog(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameters, TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory)
+{
+	TArray<uint8> Buffer;
+	int32 ReturnCode = 0;
+	const FString Command = FString::Printf(TEXT("log -z %s %s"), GitLogFormat, *InParameters);
+	const bool bResult = RunCommandStreamed(InPathToGitBinary, InRepositoryRoot, Command, [&Buffer](const uint8* Data, int32 Size)
+	{
+		Buffer.Append(Data, Size);
+		return true;
+	}, ReturnCode);
+	if (!bResult)
+	{
+		OutErrorMessages.Add(FString::Printf(TEXT("'git %s' failed (%d)"), *Command, ReturnCode));
+		return false;
 	}
+
+	ParseLog(Buffer.GetData(), Buffer.Num(), OutHistory);
+	return true;
 }
 
 /**
@@ -2111,57 +3366,66 @@ public:
 	/** Parse the unmerge status: extract the base SHA1 identifier of the file */
 	FGitLsTreeParser(const TArray<FString>& InResults)
 	{
-		const FString& FirstResult = InResults[0];
-		FileHash = FirstResult.Mid(12, 40);
-		int32 IdxTab;
-		if (FirstResult.FindChar('\t', IdxTab))
+		// "<mode> <type> <object> [<size>]\t<file>", with an object id of 40 hexadecimal digits, or 64 in a SHA-256 repository
+		FString Entry;
+		if (!InResults[0].Split(TEXT("\t"), &Entry, nullptr))
+		{
+			Entry = InResults[0];
+		}
+		TArray<FString> Tokens;
+		Entry.ParseIntoArrayWS(Tokens);
+		if (Tokens.Num() > 2)
 		{
-			const FString SizeString = FirstResult.Mid(53, IdxTab - 53);
-			FileSize = FCString::Atoi(*SizeString);
+			FileHash = Tokens[2];
+		}
+		if (Tokens.Num() > 3)
+		{
+			FileSize = FCString::Atoi(*Tokens[3]);
 		}
 	}
 
 	FString FileHash; ///< SHA1 Id of the file (warning: not the commit Id)
-	int32 FileSize; ///< Size of the file (in bytes)
+	int32 FileSize = 0; ///< Size of the file (in bytes)
 };
 
-// Run a Git "log" command and parse it.
 bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict,
 				   TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory)
 {
-	bool bResults;
+	return GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
 	{
-		TArray<FString> Results;
-		TArray<FString> Parameters;
-		Parameters.Add(TEXT("--follow")); // follow file renames
-		Parameters.Add(TEXT("--date=raw"));
-		Parameters.Add(TEXT("--name-status")); // relative filename at this revision, preceded by a status character
-		Parameters.Add(TEXT("--pretty=medium")); // make sure format matches expected in ParseLogResults
-		if (bMergeConflict)
-		{
-			// In case of a merge conflict, we also need to get the tip of the "remote branch" (MERGE_HEAD) before the log of the "current branch" (HEAD)
-			// @todo does not work for a cherry-pick! Test for a rebase.
-			Parameters.Add(TEXT("MERGE_HEAD"));
-			Parameters.Add(TEXT("--max-count 1"));
-		}
-		else
-		{
-			Parameters.Add(TEXT("--max-count 250")); // Increase default count to 250 from 100
-		}
-		TArray<FString> Files;
-		Files.Add(*InFile);
-		bResults = RunCommand(TEXT("log"), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, OutErrorMessages);
-		if (bResults)
-		{
-			ParseLogResults(Results, OutHistory);
-		}
+		return Backend.GetHistory(InRepositoryRoot, InFile, bMergeConflict, OutHistory, OutErrorMessages);
+	});
+}
+
+// Run a Git "log" command and parse it.
+bool RunLogHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict,
+				   TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory)
+{
+	// Follow file renames, with the relative filename at each revision preceded by a status character
+	FString LogParameters = TEXT("--follow --name-status");
+	if (bMergeConflict)
+	{
+		// In case of a merge conflict, we also need to get the tip of the "remote branch" (MERGE_HEAD) before the log of the "current branch" (HEAD)
+		// @todo does not work for a cherry-pick! Test for a rebase.
+		LogParameters += TEXT(" MERGE_HEAD --max-count=1");
 	}
+	else
+	{
+		LogParameters += TEXT(" --max-count=250"); // Increase default count to 250 from 100
+	}
+	LogParameters += FString::Printf(TEXT(" -- \"%s\""), *InFile);
+	bool bResults = RunLog(InPathToGitBinary, InRepositoryRoot, LogParameters, OutErrorMessages, OutHistory);
 	for (auto& Revision : OutHistory)
 	{
 		// Get file (blob) sha1 id and size
 		TArray<FString> Results;
 		TArray<FString> Parameters;
-		Parameters.Add(TEXT("--long")); // Show object size of blob (file) entries.
+		if (!FGitSparseCheckout::Get().IsPartialClone())
+		{
+			// Show object size of blob (file) entries. Not in a partial clone, where it would fetch the blob of every revision:
+			// the blob is only fetched when the revision is opened.
+			Parameters.Add(TEXT("--long"));
+		}
 		Parameters.Add(Revision->GetRevision());
 		TArray<FString> Files;
 		Files.Add(*Revision->GetFilename());
@@ -2230,9 +3494,12 @@ bool UpdateCachedStates(const TMap<const FString, FGitState>& InResults)
 	// TODO without LFS : Workaround a bug with the Source Control Module not updating file state after a simple "Save" with no "Checkout" (when not using File Lock)
 	const FDateTime Now = bUsingGitLfsLocking ? FDateTime::Now() : FDateTime::MinValue();
 
+	// The cached states are views over the state table: write the new states to its rows
+	FGitFileStateTable& StateTable = Provider.GetFileStateTable();
 	for (const auto& Pair : InResults)
 	{
-		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(Pair.Key);
+		const FGitPathId PathId = FGitPathTable::Get().Intern(Pair.Key);
+		TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> State = Provider.GetStateInternal(PathId);
 		const FGitState& NewState = Pair.Value;
 		if (NewState.FileState != EFileState::Unset)
 		{
@@ -2241,34 +3508,25 @@ bool UpdateCachedStates(const TMap<const FString, FGitState>& InResults)
 			{
 				continue;
 			}
-			State->State.FileState = NewState.FileState;
+			StateTable.SetFileState(PathId, NewState.FileState);
 		}
 		if (NewState.TreeState != ETreeState::Unset)
 		{
-			State->State.TreeState = NewState.TreeState;
+			StateTable.SetTreeState(PathId, NewState.TreeState);
 		}
 		// If we're updating lock state, also update user
 		if (NewState.LockState != ELockState::Unset)
 		{
-			State->State.LockState = NewState.LockState;
-			State->State.LockUser = NewState.LockUser;
+			StateTable.SetLockState(PathId, NewState.LockState, NewState.LockUser);
 		}
 		if (NewState.RemoteState != ERemoteState::Unset)
 		{
-			State->State.RemoteState = NewState.RemoteState;
-			if (NewState.RemoteState == ERemoteState::UpToDate)
-			{
-				State->State.HeadBranch = TEXT("");
-			}
-			else
-			{
-				State->State.HeadBranch = NewState.HeadBranch;
-			}
+			StateTable.SetRemoteState(PathId, NewState.RemoteState, NewState.RemoteState == ERemoteState::UpToDate ? FString() : NewState.HeadBranch);
 		}
 		State->TimeStamp = Now;
 
 		// We've just updated the state, no need for UpdateStatus to be ran for this file again.
-		Provider.AddFileToIgnoreForceCache(State->LocalFilename);
+		Provider.AddFileToIgnoreForceCache(Pair.Key);
 	}
 
 	return true;
@@ -2369,46 +3627,78 @@ void RemoveRedundantErrors(FGitSourceControlCommand& InCommand, const FString& I
 	}
 }
 
-static TArray<FString> LockableTypes;
+static FRWLock LockableTypesLock;
+/** Lockable extensions like ".uasset", used until the attributes of the repository are read */
+static TSet<FString> LockableTypes;
 
 bool IsFileLFSLockable(const FString& InFile)
 {
-	for (const auto& Type : LockableTypes)
+	FGitAttributeCache& AttributeCache = FGitAttributeCache::Get();
+	if (AttributeCache.IsLoaded())
 	{
-		if (InFile.EndsWith(Type))
-		{
-			return true;
-		}
+		AttributeCache.RefreshIfChanged();
+		return AttributeCache.IsLockable(InFile);
 	}
-	return false;
+
+	FReadScopeLock ReadLock(LockableTypesLock);
+	return LockableTypes.Contains(FPaths::GetExtension(InFile, true));
 }
 
 bool CheckLFSLockable(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages)
 {
 	TArray<FString> Results;
-	TArray<FString> Parameters;
-	LockableTypes.Empty(); // clear previous results
-	Parameters.Add(TEXT("lockable")); // follow file renames
 
-	const bool bResults = RunCommand(TEXT("check-attr"), InPathToGitBinary, InRepositoryRoot, Parameters, InFiles, Results, OutErrorMessages);
+	const bool bResults = GitReadBackend::Read(InPathToGitBinary, [&](IGitReadBackend& Backend)
+	{
+		return Backend.CheckLockable(InRepositoryRoot, InFiles, Results, OutErrorMessages);
+	});
 	if (!bResults)
 	{
 		return false;
 	}
 
+	TArray<FString> NewLockableTypes;
 	for (int i = 0; i < InFiles.Num(); i++)
 	{
 		const FString& Result = Results[i];
 		if (Result.EndsWith("set") && !Result.EndsWith("unset"))
 		{
 			const FString FileExt = InFiles[i].RightChop(1); // Remove wildcard (*)
-			LockableTypes.Add(FileExt);
+			NewLockableTypes.Add(FileExt);
+		}
+	}
+
+	// Compile the patterns of all the attributes files once, for the lookups of each file afterward
+	FGitAttributeCache& AttributeCache = FGitAttributeCache::Get();
+	if (AttributeCache.Load(InPathToGitBinary, InRepositoryRoot))
+	{
+		for (const FString& Extension : AttributeCache.GetLockableExtensions())
+		{
+			NewLockableTypes.AddUnique(Extension);
 		}
 	}
+	// Replace the previous results at once, since the types are read by other threads
+	SetLockableTypes(NewLockableTypes);
 
 	return true;
 }
 
+TArray<FString> GetLockableTypes()
+{
+	FReadScopeLock ReadLock(LockableTypesLock);
+	return LockableTypes.Array();
+}
+
+void SetLockableTypes(const TArray<FString>& InLockableTypes)
+{
+	FWriteScopeLock WriteLock(LockableTypesLock);
+	LockableTypes.Reset();
+	for (const FString& Type : InLockableTypes)
+	{
+		LockableTypes.Add(Type.ToLower());
+	}
+}
+
 bool FetchRemote(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot, bool InUsingGitLfsLocking, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages)
 {
 	// Force refresh lock states
@@ -2417,13 +3707,153 @@ bool FetchRemote(const FString& InPathToGitBinary, const FString& InPathToReposi
 		TMap<FString, FString> Locks;
 		GetAllLocks(InPathToRepositoryRoot, InPathToGitBinary, OutErrorMessages, Locks, true);
 	}
-	TArray<FString> Params{"--no-tags"};
+	// Report the progress of the transfer, which git only does on a terminal otherwise
+	TArray<FString> Params{"--no-tags", "--progress"};
 	// fetch latest repo
 	// TODO specify branches?
 
 	Params.Add(TEXT("--prune"));
-	return RunCommand(TEXT("fetch"), InPathToGitBinary, InPathToRepositoryRoot, Params,
-					  FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+	const bool bResult = RunCommand(TEXT("fetch"), InPathToGitBinary, InPathToRepositoryRoot, Params,
+									FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages);
+	if (bResult)
+	{
+		// The remote branches may have moved
+		FGitRevisionCache::Get().InvalidateBranches();
+	}
+	return bResult;
+}
+
+/** HEAD and the fetched branches at the end of the last background fetch, to tell whether the remote states can have changed */
+static FCriticalSection BackgroundFetchCriticalSection;
+static FString LastBackgroundFetchHeadSha;
+static FString LastBackgroundFetchBranchShas;
+static int32 NumBackgroundFetches = 0;
+
+// Keep the commit-graph and multi-pack-index up to date with the fetched objects, for the history walks of CheckRemote and GetHistory
+static void WriteCommitGraph(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot)
+{
+	const FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl || !GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 24))
+	{
+		return;
+	}
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	// An incremental layer with the new commits only, merged with the others by git as they pile up
+	TArray<FString> Parameters{TEXT("write"), TEXT("--reachable"), TEXT("--split")};
+	if (GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 27))
+	{
+		// Bloom filters of the changed paths, for "log -- <path>"
+		Parameters.Add(TEXT("--changed-paths"));
+	}
+	if (!RunCommand(TEXT("commit-graph"), InPathToGitBinary, InPathToRepositoryRoot, Parameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages))
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("commit-graph write failed: %s"), ErrorMessages.Num() ? *ErrorMessages[0] : TEXT(""));
+	}
+	Results.Reset();
+	ErrorMessages.Reset();
+	if (!RunCommand(TEXT("multi-pack-index"), InPathToGitBinary, InPathToRepositoryRoot, {TEXT("write")}, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages))
+	{
+		UE_LOG(LogSourceControl, Verbose, TEXT("multi-pack-index write failed: %s"), ErrorMessages.Num() ? *ErrorMessages[0] : TEXT(""));
+	}
+}
+
+bool FetchRemoteRefs(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot, bool InUsingGitLfsLocking, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages, bool& bOutRefsMoved)
+{
+	bOutRefsMoved = true;
+	FGitSourceControlModule* GitSourceControl = FGitSourceControlModule::GetThreadSafe();
+	if (!GitSourceControl)
+	{
+		return false;
+	}
+
+	// The upstream of the current branch first, then the status branches
+	TArray<FString> Branches;
+	FString UpstreamBranch;
+	if (GetRemoteBranchName(InPathToGitBinary, InPathToRepositoryRoot, UpstreamBranch))
+	{
+		Branches.Add(UpstreamBranch);
+	}
+	for (const FString& StatusBranch : GitSourceControl->GetProvider().GetStatusBranchNames())
+	{
+		Branches.AddUnique(StatusBranch);
+	}
+
+	int32 FetchIndex;
+	{
+		FScopeLock ScopeLock(&BackgroundFetchCriticalSection);
+		FetchIndex = NumBackgroundFetches++;
+	}
+	if (Branches.Num() == 0 || FetchIndex % GitSourceControlConstants::FullFetchInterval == 0)
+	{
+		// From time to time, a full fetch prunes deleted branches and finds the new ones matching the status branch patterns
+		if (!FetchRemote(InPathToGitBinary, InPathToRepositoryRoot, InUsingGitLfsLocking, OutResults, OutErrorMessages))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if (InUsingGitLfsLocking)
+		{
+			TMap<FString, FString> Locks;
+			GetAllLocks(InPathToRepositoryRoot, InPathToGitBinary, OutErrorMessages, Locks, true);
+		}
+
+		// One fetch per remote, of the remote tracking branches only: "origin/main" is "+refs/heads/main:refs/remotes/origin/main" on "origin"
+		TMap<FString, TArray<FString>> RefspecsByRemote;
+		for (const FString& Branch : Branches)
+		{
+			FString Remote, RemoteBranch;
+			if (Branch.Split(TEXT("/"), &Remote, &RemoteBranch))
+			{
+				RefspecsByRemote.FindOrAdd(Remote).Add(FString::Printf(TEXT("+refs/heads/%s:refs/remotes/%s/%s"), *RemoteBranch, *Remote, *RemoteBranch));
+			}
+		}
+		for (const auto& Pair : RefspecsByRemote)
+		{
+			TArray<FString> Params{TEXT("--no-tags"), TEXT("--progress")};
+			if (GitSourceControl->GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 29))
+			{
+				Params.Add(TEXT("--no-write-fetch-head"));
+			}
+			Params.Add(Pair.Key);
+			Params.Append(Pair.Value);
+			if (!RunCommand(TEXT("fetch"), InPathToGitBinary, InPathToRepositoryRoot, Params, FGitSourceControlModule::GetEmptyStringArray(), OutResults, OutErrorMessages))
+			{
+				return false;
+			}
+		}
+		FGitRevisionCache::Get().InvalidateBranches();
+	}
+
+	// Compare with the previous background fetch, including HEAD which the user may have moved in between
+	FString HeadSha;
+	TMap<FString, FString> BranchShas;
+	if (!GetRefShas(InPathToGitBinary, InPathToRepositoryRoot, Branches, HeadSha, BranchShas))
+	{
+		return true;
+	}
+	FString Shas;
+	for (const FString& Branch : Branches)
+	{
+		const FString* BranchSha = BranchShas.Find(Branch);
+		Shas += FString::Printf(TEXT("%s=%s "), *Branch, BranchSha ? **BranchSha : TEXT(""));
+	}
+	bool bRemoteRefsMoved;
+	{
+		FScopeLock ScopeLock(&BackgroundFetchCriticalSection);
+		bRemoteRefsMoved = Shas != LastBackgroundFetchBranchShas;
+		bOutRefsMoved = bRemoteRefsMoved || HeadSha != LastBackgroundFetchHeadSha;
+		LastBackgroundFetchHeadSha = MoveTemp(HeadSha);
+		LastBackgroundFetchBranchShas = MoveTemp(Shas);
+	}
+	if (bRemoteRefsMoved)
+	{
+		// New objects were fetched
+		WriteCommitGraph(InPathToGitBinary, InPathToRepositoryRoot);
+	}
+	return true;
 }
 
 bool PullOrigin(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutFiles,
@@ -2487,37 +3917,47 @@ bool PullOrigin(const FString& InPathToGitBinary, const FString& InPathToReposit
 		OutFiles.Append(AbsoluteDifferentFiles);
 	}
 
+	// The packages updated by the pull; those that are not loaded are skipped by the unlink
 	TArray<FString> Files;
 	for (const auto& File : OutFiles)
 	{
-		if (IsFileLFSLockable(File))
+		if (FPackageName::IsPackageExtension(*FPaths::GetExtension(File)))
 		{
 			Files.Add(File);
 		}
 	}
 
 	const bool bShouldReload = Files.Num() > 0;
-	TArray<UPackage*> PackagesToReload;
+	TArray<TWeakObjectPtr<UPackage>> PackagesToReload;
+	double UnlinkSeconds = 0.0;
 	if (bShouldReload)
 	{
-		const auto PackagesToReloadResult = Async(EAsyncExecution::TaskGraphMainThread, [=] {
-			return UnlinkPackages(Files);
+		const auto PackagesToReloadResult = Async(EAsyncExecution::TaskGraphMainThread, [&Files, &UnlinkSeconds] {
+			const double StartTime = FPlatformTime::Seconds();
+			// Weak pointers, taken on the game thread: the garbage collector can run during the pull
+			TArray<TWeakObjectPtr<UPackage>> Packages;
+			for (UPackage* Package : UnlinkPackages(Files))
+			{
+				Packages.Emplace(Package);
+			}
+			UnlinkSeconds = FPlatformTime::Seconds() - StartTime;
+			return Packages;
 		});
 		PackagesToReload = PackagesToReloadResult.Get();
 	}
 
 	// Reset HEAD and index to remote
 	TArray<FString> InfoMessages;
-	bool bSuccess = RunCommand(TEXT("pull"), InPathToGitBinary, InPathToRepositoryRoot, { "--rebase", "--autostash" }, FGitSourceControlModule::GetEmptyStringArray(),
+	bool bSuccess = RunCommand(TEXT("pull"), InPathToGitBinary, InPathToRepositoryRoot, { "--rebase", "--autostash", "--progress" }, FGitSourceControlModule::GetEmptyStringArray(),
 										  InfoMessages, OutErrorMessages);
+	FGitRevisionCache::Get().InvalidateBranches();
 
-	if (bShouldReload)
+	if (PackagesToReload.Num() > 0)
 	{
-		const auto ReloadPackagesResult = Async(EAsyncExecution::TaskGraphMainThread, [=] {
-			TArray<UPackage*> Packages = PackagesToReload;
-			ReloadPackages(Packages);
+		// Reloaded in chunks over the next frames, without waiting for them
+		AsyncTask(ENamedThreads::GameThread, [PackagesToReload, UnlinkSeconds] {
+			FGitPackageReloader::Start(PackagesToReload, UnlinkSeconds);
 		});
-		ReloadPackagesResult.Wait();
 	}
 
 	return bSuccess;
@@ -2525,23 +3965,22 @@ bool PullOrigin(const FString& InPathToGitBinary, const FString& InPathToReposit
 
 TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> GetOriginRevisionOnBranch( const FString & InPathToGitBinary, const FString & InRepositoryRoot, const FString & InRelativeFileName, TArray<FString> & OutErrorMessages, const FString & BranchName )
 {
-	TGitSourceControlHistory OutHistory;
-
-	TArray< FString > Results;
-	TArray< FString > Parameters;
-	Parameters.Add( BranchName );
-	Parameters.Add( TEXT( "--date=raw" ) );
-	Parameters.Add( TEXT( "--pretty=medium" ) ); // make sure format matches expected in ParseLogResults
+	// The tip of the branch only changes with a fetch, pull or push, which invalidate the cache
+	TSharedPtr<FGitSourceControlRevision, ESPMode::ThreadSafe> Revision = FGitRevisionCache::Get().FindBranchRevision( BranchName );
+	if ( !Revision.IsValid() )
+	{
+		TGitSourceControlHistory OutHistory;
 
-	TArray< FString > Files;
-	const auto bResults = RunCommand( TEXT( "show" ), InPathToGitBinary, InRepositoryRoot, Parameters, Files, Results, OutErrorMessages );
+		RunLog( InPathToGitBinary, InRepositoryRoot, FString::Printf( TEXT( "--max-count=1 %s" ), *BranchName ), OutErrorMessages, OutHistory );
 
-	if ( bResults )
-	{
-		ParseLogResults( Results, OutHistory );
+		if ( OutHistory.Num() > 0 )
+		{
+			FGitRevisionCache::Get().AddBranchRevision( BranchName, OutHistory[ 0 ] );
+			Revision = OutHistory[ 0 ];
+		}
 	}
 
-	if ( OutHistory.Num() > 0 )
+	if ( Revision.IsValid() )
 	{
 		auto AbsoluteFileName = FPaths::ConvertRelativePathToFull( InRelativeFileName );
 
@@ -2552,12 +3991,10 @@ TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> GetOriginRevisionOnBranc
 			AbsoluteFileName.RemoveAt( 0 );
 		}
 
-		OutHistory[ 0 ]->Filename = AbsoluteFileName;
-
-		return OutHistory[ 0 ];
+		Revision->Filename = AbsoluteFileName;
 	}
 
-	return nullptr;
+	return Revision;
 }
 
 } // namespace GitSourceControlUtils
@@ -27,6 +27,7 @@
 #endif
 #include "SourceControlOperations.h"
 #include "GitSourceControlModule.h"
+#include "GitSourceControlScheduler.h"
 #include "GitSourceControlUtils.h"
 
 
@@ -160,6 +161,29 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 					.Font(Font)
 				]
 			]
+			// Command queues
+			+SVerticalBox::Slot()
+			.FillHeight(1.0f)
+			.Padding(2.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SHorizontalBox)
+				.ToolTipText(LOCTEXT("CommandQueues_Tooltip", "Commands waiting and running in each lane of the scheduler, with their average and maximum wait for a worker"))
+				+SHorizontalBox::Slot()
+				.FillWidth(1.0f)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("CommandQueues", "Command queues"))
+					.Font(Font)
+				]
+				+SHorizontalBox::Slot()
+				.FillWidth(2.0f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SGitSourceControlSettings::GetCommandQueueStats)
+					.Font(Font)
+				]
+			]
 			// Separator
 			+SVerticalBox::Slot()
 			.AutoHeight()
@@ -425,6 +449,7 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 	#define TT_UserName LOCTEXT("UserNameLabel_Tooltip", "Git Username fetched from local config")
 	#define TT_Email LOCTEXT("GitUserEmail_Tooltip", "Git E-mail fetched from local config")
 	#define TT_LFS LOCTEXT("UseGitLfsLocking_Tooltip", "Uses Git LFS 2 File Locking workflow (CheckOut and Commit/Push).")
+	#define TT_CommandQueues LOCTEXT("CommandQueues_Tooltip", "Commands waiting and running in each lane of the scheduler, with their average and maximum wait for a worker")
 
 	ChildSlot
 	[
@@ -508,6 +533,23 @@ void SGitSourceControlSettings::ConstructBasedOnEngineVersion( )
 				.ToolTipText( TT_Email )
 			]
 		]
+		// Command queues
+		+SVerticalBox::Slot()
+		[
+			SNew(SHorizontalBox)
+			ROW_LEFT( 10.0f )
+			[
+				SNew(STextBlock)
+				.Text(LOCTEXT("CommandQueuesLabel", "Command queues"))
+				.ToolTipText( TT_CommandQueues )
+			]
+			ROW_RIGHT( 10.0f )
+			[
+				SNew(STextBlock)
+				.Text(this, &Self::GetCommandQueueStats)
+				.ToolTipText( TT_CommandQueues )
+			]
+		]
 		// LFS Config
 		+SVerticalBox::Slot()
 		.AutoHeight()
@@ -643,6 +685,31 @@ FText SGitSourceControlSettings::GetUserEmail() const
 	return FText::FromString(UserEmail);
 }
 
+FText SGitSourceControlSettings::GetCommandQueueStats() const
+{
+	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
+	const FGitCommandScheduler* Scheduler = GitSourceControl.GetProvider().GetScheduler();
+	if (Scheduler == nullptr)
+	{
+		return LOCTEXT("CommandQueuesIdle", "No command issued yet");
+	}
+
+	static const FText LaneNames[(int32)EGitCommandLane::Num] = {
+		LOCTEXT("InteractiveLane", "Interactive"),
+		LOCTEXT("BackgroundLane", "Background"),
+		LOCTEXT("BulkLane", "Bulk")
+	};
+	TArray<FString> Lanes;
+	for (int32 LaneIndex = 0; LaneIndex < (int32)EGitCommandLane::Num; LaneIndex++)
+	{
+		const FGitCommandLaneStats Stats = Scheduler->GetStats((EGitCommandLane)LaneIndex);
+		Lanes.Add(FText::Format(LOCTEXT("CommandLaneStats", "{0}: {1} queued, {2} running, wait {3} ms avg / {4} ms max"),
+			LaneNames[LaneIndex], Stats.QueueDepth, Stats.Running,
+			FMath::RoundToInt(Stats.GetAverageWaitSeconds() * 1000.0), FMath::RoundToInt(Stats.MaxWaitSeconds * 1000.0)).ToString());
+	}
+	return FText::FromString(FString::Join(Lanes, TEXT("\n")));
+}
+
 EVisibility SGitSourceControlSettings::MustInitializeGitRepository() const
 {
 	const FGitSourceControlModule& GitSourceControl = FGitSourceControlModule::Get();
@@ -44,6 +44,9 @@ private:
 	FText GetUserName() const;
 	FText GetUserEmail() const;
 
+	/** Delegate to get the queue depths and wait times of the command scheduler */
+	FText GetCommandQueueStats() const;
+
 	EVisibility MustInitializeGitRepository() const;
 	bool CanInitializeGitRepository() const;
 	bool CanUseGitLfsLocking() const;
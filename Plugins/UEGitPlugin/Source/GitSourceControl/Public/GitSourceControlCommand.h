@@ -7,9 +7,13 @@
 
 #include "GitSourceControlChangelist.h"
 #include "ISourceControlProvider.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
 #include "Misc/IQueuedWork.h"
 #include "Runtime/Launch/Resources/Version.h"
 
+class FGitCommandScheduler;
+
 /** Accumulated error and info messages for a revision control operation.  */
 struct FGitSourceControlResultInfo
 {
@@ -37,6 +41,8 @@ public:
 
 	FGitSourceControlCommand(const TSharedRef<class ISourceControlOperation, ESPMode::ThreadSafe>& InOperation, const TSharedRef<class IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const FSourceControlOperationComplete& InOperationCompleteDelegate = FSourceControlOperationComplete());
 
+	virtual ~FGitSourceControlCommand() override;
+
 	/**
 	 *  Modify the repo root if all selected files are in a plugin subfolder, and the plugin subfolder is a git repo
 	 *  This supports the case where each plugin is a sub module
@@ -63,12 +69,31 @@ public:
 	 */
 	virtual void DoThreadedWork() override;
 
-	/** Attempt to cancel the operation */
+	/** Attempt to cancel the operation, ignored by the commands modifying the repository */
 	void Cancel();
 
+	/** Can the operation be canceled? */
+	bool CanCancel() const;
+
 	/** Is the operation canceled? */
 	bool IsCanceled() const;
 
+	/**
+	 * Wait for the command to be processed by its worker thread.
+	 * @param	InWaitTimeMs	The maximum time to wait, in milliseconds
+	 * @returns true if the command has been processed
+	 */
+	bool WaitForCompletion(uint32 InWaitTimeMs);
+
+	/** Report the progress of the Git process run by this command, from its worker thread */
+	void SetProgress(const FString& InPhase, int32 InPercent);
+
+	/** Get the last progress reported, if any since the last call */
+	bool ConsumeProgress(FString& OutPhase, int32& OutPercent);
+
+	/** The command executed by the current thread, if any: lets the Git processes it launches check for cancellation and report their progress */
+	static FGitSourceControlCommand* GetCurrent();
+
 	/** Save any results and call any registered callbacks. */
 	ECommandResult::Type ReturnResults();
 
@@ -112,6 +137,9 @@ public:
 	/** If true, this command will be automatically cleaned up in Tick() */
 	bool bAutoDelete;
 
+	/** If true, the game thread waits on this asynchronous command: the scheduler runs it in the Interactive lane */
+	bool bInteractive = false;
+
 	/** Whether we are running multi-treaded or not*/
 	EConcurrency::Type Concurrency;
 
@@ -128,4 +156,39 @@ public:
 
 	/** Branch names for status queries */
 	TArray< FString > StatusBranchNames;
+
+	/** If true, the results of this cancelled command have already been returned */
+	bool bCancelReturned;
+
+	/** Commands merged into this one by the scheduler, completed along with it */
+	TArray<FGitSourceControlCommand*> CoalescedCommands;
+
+	/** The scheduler running this command, that queues the merged commands again if this one is canceled or abandoned */
+	FGitCommandScheduler* Scheduler = nullptr;
+
+	/** Time spent waiting in the scheduler before running, for the tracing of the git processes */
+	double QueueWaitSeconds;
+
+private:
+	/** Complete the merged commands with the results of this one, or queue them again if it did not run to completion */
+	void CompleteCoalescedCommands(bool bInAbandoned);
+
+	/** Triggered when the command has been processed by its worker thread */
+	FEvent* CompletedEvent;
+
+	/** Last progress reported by the Git process */
+	FCriticalSection ProgressCriticalSection;
+	FString ProgressPhase;
+	int32 ProgressPercent;
+	bool bProgressChanged;
+};
+
+/** Make a command the current one of this thread, for the Git processes run on its behalf (by parallel batches for instance) */
+struct FGitScopedCurrentCommand
+{
+	FGitScopedCurrentCommand(FGitSourceControlCommand* InCommand);
+	~FGitScopedCurrentCommand();
+
+private:
+	FGitSourceControlCommand* PreviousCommand;
 };
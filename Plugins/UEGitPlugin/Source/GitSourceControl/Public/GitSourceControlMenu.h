@@ -46,11 +46,14 @@ private:
 	TSharedRef<class FExtender> OnExtendLevelEditorViewMenu(const TSharedRef<class FUICommandList> CommandList);
 #endif
 
-	static void DisplayInProgressNotification(const FText& InOperationInProgressString);
+	static void DisplayInProgressNotification(const FSourceControlOperationRef& InOperation);
 	static void RemoveInProgressNotification();
 	static void DisplaySucessNotification(const FName& InOperationName);
 	static void DisplayFailureNotification(const FName& InOperationName);
 
+	/** Show the progress of the git command of the operation in progress in its notification */
+	static void OnCommandProgress(const FSourceControlOperationRef& InOperation, const FString& InPhase, int32 InPercent);
+
 private:
 #if ENGINE_MAJOR_VERSION < 5
 	FDelegateHandle ViewMenuExtenderHandle;
@@ -65,6 +68,12 @@ private:
 	/** Current revision control operation from extended menu if any */
 	static TWeakPtr<class SNotificationItem> OperationInProgressNotification;
 
+	/** The operation of the notification, and its text without the progress */
+	static TWeakPtr<ISourceControlOperation, ESPMode::ThreadSafe> OperationInProgress;
+	static FText OperationInProgressText;
+
+	FDelegateHandle CommandProgressHandle;
+
 	/** Delegate called when a revision control operation has completed */
 	void OnSourceControlOperationComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
 };
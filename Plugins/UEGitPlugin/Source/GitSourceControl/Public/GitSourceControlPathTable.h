@@ -0,0 +1,77 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ChunkedArray.h"
+#include "Misc/ScopeRWLock.h"
+
+/** Stable 32-bit id of a path (or a user or branch name) interned in the path table */
+typedef uint32 FGitPathId;
+
+/**
+ * Interned strings of the provider: absolute paths of the files, and the few user and branch names of their states.
+ *
+ * Each string is stored once and gets an id that never changes for the session, so the state cache can be
+ * indexed by id and hash the path a single time per git result. Strings are never moved in memory,
+ * so GetPath() returns a reference that stays valid. Thread safe.
+ */
+class GITSOURCECONTROL_API FGitPathTable
+{
+public:
+	/** Id of the empty string */
+	static const FGitPathId EmptyId = 0;
+
+	/** The path table of the process */
+	static FGitPathTable& Get();
+
+	FGitPathTable();
+
+	/** Intern an absolute path (or a name), returning its id */
+	FGitPathId Intern(const FString& InPath);
+
+	/**
+	 * Intern the absolute path of a file relative to a repository root, as output by git.
+	 * Git paths are already normalized, so they are appended to the root without a ConvertRelativePathToFull().
+	 */
+	FGitPathId InternRelative(const FString& InRepositoryRoot, const FString& InRelativePath);
+
+	/** @returns the id of an interned path, or EmptyId if it was never interned */
+	FGitPathId Find(const FString& InPath) const;
+
+	/** @returns the path of an id */
+	const FString& GetPath(FGitPathId InId) const;
+
+	/** Number of interned strings */
+	int32 Num() const;
+
+	/** Memory used by the table, for the benchmarks */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Map keys point to the strings of the chunked array, so each path is stored only once */
+	struct FPathKeyFuncs : BaseKeyFuncs<TPair<const FString*, FGitPathId>, const FString*, false>
+	{
+		static const FString* GetSetKey(const TPair<const FString*, FGitPathId>& Element)
+		{
+			return Element.Key;
+		}
+		static bool Matches(const FString* A, const FString* B)
+		{
+			return A->Equals(*B, ESearchCase::IgnoreCase);
+		}
+		static uint32 GetKeyHash(const FString* Key)
+		{
+			return GetTypeHash(*Key);
+		}
+	};
+
+	mutable FRWLock Lock;
+
+	TChunkedArray<FString> Paths;
+
+	TMap<const FString*, FGitPathId, FDefaultSetAllocator, FPathKeyFuncs> Ids;
+};
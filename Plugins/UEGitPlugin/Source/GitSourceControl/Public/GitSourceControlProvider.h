@@ -9,6 +9,7 @@
 #include "ISourceControlProvider.h"
 #include "IGitSourceControlWorker.h"
 #include "GitSourceControlMenu.h"
+#include "GitSourceControlState.h"
 #include "Runtime/Launch/Resources/Version.h"
 
 class FGitSourceControlChangelistState;
@@ -18,6 +19,9 @@ class FGitSourceControlCommand;
 
 DECLARE_DELEGATE_RetVal(FGitSourceControlWorkerRef, FGetGitSourceControlWorker)
 
+/** Progress reported by a running command: operation, phase ("Receiving objects"...) and percentage */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FGitCommandProgress, const FSourceControlOperationRef&, const FString&, int32)
+
 /// Git version and capabilites extracted from the string "git version 2.11.0.windows.3"
 struct FGitVersion
 {
@@ -41,6 +45,37 @@ struct FGitVersion
 		, ForkPatch(0)
 	{
 	}
+
+	inline bool IsGreaterOrEqualThan(int InMajor, int InMinor) const
+	{
+		return (Major > InMajor) || (Major == InMajor && Minor >= InMinor);
+	}
+};
+
+/** Timings of the last startup of the provider, in seconds from the start of CheckRepositoryStatus() */
+struct FGitStartupStats
+{
+	/** Until the provider was available, from the startup snapshot or else after the first status */
+	double TimeToAvailable = -1.0;
+	/** Until the local status of the project was known */
+	double TimeToStatus = -1.0;
+	/** Until the files were compared with the remote branches */
+	double TimeToRemoteStatus = -1.0;
+	/** Whether the provider was made available from the snapshot of the last session */
+	bool bFromSnapshot = false;
+};
+
+/** Force updates of the states requested through GetState(), and the status commands they were merged into */
+struct FGitForceUpdateStats
+{
+	/** Calls of GetState() with ForceUpdate */
+	int64 NumRequests = 0;
+	/** Paths of these calls, before merging */
+	int64 NumPathsRequested = 0;
+	/** Paths not updated again: just updated, or waiting on the force update already in flight */
+	int64 NumPathsSkipped = 0;
+	/** Status commands issued */
+	int64 NumCommands = 0;
 };
 
 class GITSOURCECONTROL_API FGitSourceControlProvider final : public ISourceControlProvider
@@ -174,6 +209,15 @@ public:
 	/** Helper function used to update state cache */
 	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> GetStateInternal(const FString& Filename);
 
+	/** Helper function used to update state cache, for a path already interned */
+	TSharedRef<FGitSourceControlState, ESPMode::ThreadSafe> GetStateInternal(FGitPathId InPathId);
+
+	/** The states of the files of the cache, that the cached state objects are views of */
+	FGitFileStateTable& GetFileStateTable()
+	{
+		return FileStateTable;
+	}
+
 #if ENGINE_MAJOR_VERSION == 5	
 	/** Helper function used to update changelists state cache */
 	TSharedRef<FGitSourceControlChangelistState, ESPMode::ThreadSafe> GetStateInternal(const FGitSourceControlChangelist& InChangelist);
@@ -212,6 +256,30 @@ public:
 	const FString& GetRemoteBranchName() const { return RemoteBranchName; }
 
 	TArray<FString> GetStatusBranchNames() const;
+
+	/** The scheduler running the commands, if any was started yet (for its metrics) */
+	const class FGitCommandScheduler* GetScheduler() const
+	{
+		return Scheduler;
+	}
+
+	/** Timings of the startup of the provider, for the benchmarks */
+	const FGitStartupStats& GetStartupStats() const
+	{
+		return StartupStats;
+	}
+
+	/** Number of force updates requested and of commands issued for them, since the start of the editor */
+	const FGitForceUpdateStats& GetForceUpdateStats() const
+	{
+		return ForceUpdateStats;
+	}
+
+	/** Progress of the running commands (fetch, push, pull), broadcast from Tick() */
+	FGitCommandProgress& OnCommandProgress()
+	{
+		return CommandProgress;
+	}
 	
 	/** Indicates editor binaries are to be updated upon next sync */
 	bool bPendingRestart;
@@ -254,6 +322,24 @@ private:
 	/** Update repository status on Connect and UpdateStatus operations */
 	void UpdateRepositoryStatus(const class FGitSourceControlCommand& InCommand);
 
+	/** Report the provider as available and start the background refreshes */
+	void SetRepositoryAvailable(double InStartTime);
+
+	/** Persist the configuration of the repository for the startup of the next session */
+	void SaveStartupSnapshot() const;
+
+	/** Issue a single status command for the files of a force update */
+	void IssueForceUpdate(const TArray<FString>& InFiles);
+
+	/** Block until the force updates in flight for these files are completed, ticking the command queue */
+	void WaitForForceUpdates(const TArray<FString>& InFiles);
+
+	/** The force update in flight for this file, if it can still be waited on */
+	FGitSourceControlCommand* FindInFlightForceUpdate(const FString& InFile) const;
+
+	/** Stop tracking the files of a command about to be deleted as force updates in flight */
+	void ForgetForceUpdate(const FGitSourceControlCommand& InCommand);
+
 	/** Path to the root of the Unreal revision control repository: usually the ProjectDir */
 	FString PathToRepositoryRoot;
 
@@ -281,8 +367,11 @@ private:
 	/** Current Commit description's Summary */
 	FString CommitSummary;
 
-	/** State cache */
-	TMap<FString, TSharedRef<class FGitSourceControlState, ESPMode::ThreadSafe> > StateCache;
+	/** State cache, by path id */
+	TMap<FGitPathId, TSharedRef<class FGitSourceControlState, ESPMode::ThreadSafe> > StateCache;
+
+	/** States of the files of the cache, as a compact table indexed by path id */
+	FGitFileStateTable FileStateTable;
 #if ENGINE_MAJOR_VERSION == 5
 	TMap<FGitSourceControlChangelist, TSharedRef<class FGitSourceControlChangelistState, ESPMode::ThreadSafe> > ChangelistsStateCache;
 #endif
@@ -296,6 +385,9 @@ private:
 	/** For notifying when the revision control states in the cache have changed */
 	FSourceControlStateChanged OnSourceControlStateChanged;
 
+	/** For notifying of the progress of the running commands */
+	FGitCommandProgress CommandProgress;
+
 	/** Git version for feature checking */
 	FGitVersion GitVersion;
 
@@ -306,10 +398,21 @@ private:
 		Ignore these files when forcing status updates. We add to this list when we've just updated the status already.
 		UE's SourceControl has a habit of performing a double status update, immediately after an operation.
 	*/
-	TArray<FString> IgnoreForceCache;
+	TSet<FString> IgnoreForceCache;
+
+	/** Absolute paths of the force updates issued and not completed yet, with the command updating them */
+	TMap<FString, FGitSourceControlCommand*> InFlightForceUpdates;
+
+	FGitForceUpdateStats ForceUpdateStats;
 
 	/** Array of branch name patterns for status queries */
 	TArray<FString> StatusBranchNamePatternsInternal;
 		
 	class FGitSourceControlRunner* Runner = nullptr;
+
+	/** Runs the commands on dedicated threads, by priority lane */
+	class FGitCommandScheduler* Scheduler = nullptr;
+
+	/** Timings of the last startup */
+	FGitStartupStats StartupStats;
 };
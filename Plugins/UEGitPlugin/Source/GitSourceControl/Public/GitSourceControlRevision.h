@@ -70,7 +70,7 @@ public:
 	FDateTime Date;
 
 	/** The size of the file at this revision */
-	int32 FileSize;
+	int32 FileSize = 0;
 
 	/** Dynamic repository root **/
 	FString PathToRepoRoot;
@@ -29,6 +29,12 @@ public:
 	/** Set the username used by the Git LFS 2 File Locks server */
 	bool SetLfsUserName(const FString& InString);
 
+	/** Tell if read-only queries first read the .git directory in process, before falling back to the git command line */
+	bool IsUsingNativeReadBackend() const;
+
+	/** Configure the usage of the in-process reader of the .git directory */
+	bool SetUsingNativeReadBackend(const bool InUsingNativeReadBackend);
+
 	/** Load settings from ini file */
 	void LoadSettings();
 
@@ -47,4 +53,7 @@ private:
 
 	/** Username used by the Git LFS 2 File Locks server */
 	FString LfsUserName;
+
+	/** Tells if read-only queries first read the .git directory in process */
+	bool bUsingNativeReadBackend = true;
 };
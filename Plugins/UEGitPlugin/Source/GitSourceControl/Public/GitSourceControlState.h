@@ -6,6 +6,7 @@
 #pragma once
 
 #include "GitSourceControlChangelist.h"
+#include "GitSourceControlPathTable.h"
 #include "GitSourceControlRevision.h"
 #include "Runtime/Launch/Resources/Version.h"
 
@@ -125,17 +126,56 @@ struct FGitState
 	FString HeadBranch;
 };
 
+/**
+ * The states of the files of the provider cache, as a structure of arrays indexed by path id:
+ * one byte per state and one interned id per name, instead of two strings per file.
+ */
+class GITSOURCECONTROL_API FGitFileStateTable
+{
+public:
+	/** @returns the state of a file, as the combined state of a map */
+	FGitState Get(FGitPathId InPathId) const;
+
+	EFileState::Type GetFileState(FGitPathId InPathId) const;
+	ETreeState::Type GetTreeState(FGitPathId InPathId) const;
+	ELockState::Type GetLockState(FGitPathId InPathId) const;
+	ERemoteState::Type GetRemoteState(FGitPathId InPathId) const;
+	const FString& GetLockUser(FGitPathId InPathId) const;
+	const FString& GetHeadBranch(FGitPathId InPathId) const;
+
+	void SetFileState(FGitPathId InPathId, EFileState::Type InFileState);
+	void SetTreeState(FGitPathId InPathId, ETreeState::Type InTreeState);
+	void SetLockState(FGitPathId InPathId, ELockState::Type InLockState, const FString& InLockUser);
+	void SetRemoteState(FGitPathId InPathId, ERemoteState::Type InRemoteState, const FString& InHeadBranch);
+
+	/** Reset the state of a file to unknown */
+	void Reset(FGitPathId InPathId);
+
+	void Empty();
+
+	/** Memory used by the table, for the benchmarks */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Make room for a path id, filling the new rows with the default state */
+	void Grow(FGitPathId InPathId);
+
+	TArray<uint8> FileStates;
+	TArray<uint8> TreeStates;
+	TArray<uint8> LockStates;
+	TArray<uint8> RemoteStates;
+	TArray<FGitPathId> LockUsers;
+	TArray<FGitPathId> HeadBranches;
+};
+
 class GITSOURCECONTROL_API FGitSourceControlState : public ISourceControlState
 {
 public:
-    explicit FGitSourceControlState(const FString &InLocalFilename) :
-        LocalFilename( InLocalFilename ),
-        TimeStamp( 0 ),
-        HeadAction( TEXT( "Changed" ) ),
-        HeadModTime( 0 ),
-        HeadCommit( TEXT( "Unknown" ) )
-    {
-    }
+	/** A standalone state, as parsed from a git command */
+	explicit FGitSourceControlState(const FString& InLocalFilename);
+
+	/** A thin view over the row of a file in the state table of the provider cache */
+	FGitSourceControlState(FGitPathId InPathId, const FGitFileStateTable* InStateTable);
 
 	/** ISourceControlState interface */
 	virtual int32 GetHistorySize() const override;
@@ -183,16 +223,39 @@ public:
 	virtual bool IsConflicted() const override;
 	virtual bool CanRevert() const override;
 
+	/** Status of the file, read from the state table for the states of the cache */
+	EFileState::Type GetFileState() const;
+	ETreeState::Type GetTreeState() const;
+	ELockState::Type GetLockState() const;
+	ERemoteState::Type GetRemoteState() const;
+	const FString& GetLockUser() const;
+	const FString& GetHeadBranch() const;
+
+	/** Id of the file in the path table */
+	FGitPathId GetPathId() const
+	{
+		return PathId;
+	}
+
+	/** Change the filename reported by the state (after an asset rename), without moving it in the cache */
+	void SetFilename(const FString& InFilename);
+
 private:
 	EGitState::Type GetGitState() const;
 
+	/** Id of the file, its row in the state table */
+	FGitPathId PathId;
+
+	/** Id of the filename reported by GetFilename() */
+	FGitPathId FilenameId;
+
+	/** Table holding the status of the file, null for a standalone state */
+	const FGitFileStateTable* StateTable;
+
 public:
 	/** History of the item, if any */
 	TGitSourceControlHistory History;
 
-	/** Filename on disk */
-	FString LocalFilename;
-
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
 	/** Pending rev info with which a file must be resolved, invalid if no resolve pending */
 	FResolveInfo PendingResolveInfo;
@@ -202,7 +265,7 @@ public:
 	/** File Id with which our local revision diverged from the remote revision */
 	FString PendingMergeBaseFileHash;
 
-	/** Status of the file */
+	/** Status of a standalone state, parsed from git before it is merged into the cache (unused by the views of the cache) */
 	FGitState State;
 
 #if ENGINE_MAJOR_VERSION == 5
@@ -212,12 +275,12 @@ public:
 	/** The timestamp of the last update */
 	FDateTime TimeStamp;
 
-	/** The action within the head branch TODO */
+	/** The action within the head branch TODO (empty if unknown) */
 	FString HeadAction;
 
 	/** The last file modification time in the head branch TODO */
 	int64 HeadModTime;
 
-	/** The change list the last modification TODO */
+	/** The change list the last modification TODO (empty if unknown) */
 	FString HeadCommit;
 };
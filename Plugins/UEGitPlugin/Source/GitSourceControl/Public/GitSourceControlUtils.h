@@ -12,6 +12,12 @@
 #include "UObject/ObjectSaveContext.h"
 #endif
 
+// Launch git with its error stream piped separately, so that commands can be canceled and report their progress
+// (requires the stderr pipe of CreateProc, else fall back to ExecProcess)
+#ifndef GIT_USE_CANCELLABLE_PROCESS
+#define GIT_USE_CANCELLABLE_PROCESS (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+#endif
+
 class FGitSourceControlState;
 
 class FGitSourceControlCommand;
@@ -29,30 +35,49 @@ public:
 	/** Destructor - delete temp file */
 	~FGitScopedTempFile();
 
-	/** Get the filename of this temp file - empty if it failed to be created */
+	/** Get the filename of this temp file */
 	const FString& GetFilename() const;
 
+	/** Whether the text was written to the temp file */
+	bool IsValid() const;
+
 private:
 	/** The filename we are writing to */
 	FString Filename;
+
+	/** Result of the write of the text */
+	bool bIsValid = false;
 };
 
 struct FGitVersion;
 
+struct FGitLfsLock;
+
+/** Locks of the repository, backed by a local lock index persisted across editor sessions */
 class FGitLockedFilesCache
 {
 public:
+	/** Last time the locks were listed from the LFS server */
 	static FDateTime LastUpdated;
 
- static const TMap<FString, FString>& GetLockedFiles() { return LockedFiles; }
- static void SetLockedFiles(const TMap<FString, FString>& newLocks);
- static void AddLockedFile(const FString& filePath, const FString& lockUser);
- static void RemoveLockedFile(const FString& filePath);
+	/** Load the lock index persisted for the repository, so that locks are known before querying the server */
+	static void LoadIndex(const FString& InRepositoryRoot);
+	/** @returns true if the locks are known, from the persisted index or from a listing of the server */
+	static bool IsPopulated();
+
+	static bool GetLockUser(const FString& filePath, FString& lockUser);
+	static TMap<FString, FString> GetLockedFiles();
+	static void SetLockedFiles(const TMap<FString, FString>& newLocks);
+	static void SetLockedFiles(const TArray<FGitLfsLock>& newLocks);
+	/** Add or remove a single lock, kept in memory until SaveIndex() is called for the whole batch */
+	static void AddLockedFile(const FString& filePath, const FString& lockUser);
+	static void RemoveLockedFile(const FString& filePath);
+	/** Persist the lock index if it changed, once the locks of a command are all added or removed */
+	static void SaveIndex();
 
 private:
- static void OnFileLockChanged(const FString& filePath, const FString& lockUser, bool locked);
- // update local read/write state when our own lock statuses change
-	static TMap<FString, FString> LockedFiles;
+	// update local read/write state when our own lock statuses change
+	static void OnFileLockChanged(const FString& filePath, const FString& lockUser, bool locked);
 };
 
 namespace GitSourceControlUtils
@@ -170,9 +195,33 @@ bool GetRemoteUrl(const FString& InPathToGitBinary, const FString& InRepositoryR
 // A list of asset paths that we will always check locks, status, etc on startup and periodically 
 TArray<FString> GetSourceControlledAssetPaths();
 
+/**
+ * Tell if a Git command only reads the repository, so that its batches of files can run concurrently.
+ *
+ * @param	InCommand			The Git command - e.g. status, or "--no-optional-locks status"
+ * @returns true if the command does not write to the index or the refs
+ */
+bool IsReadOnlyCommand(const FString& InCommand);
+
+/**
+ * Run a worker on the calling thread and on the threads of the pool of git processes, and wait for all of them.
+ *
+ * The threads of the task graph are not used: each git process blocks its thread for seconds, starving the tasks of the engine.
+ * The workers pull their work from a shared counter: the calling thread alone gets it done if the pool is busy.
+ *
+ * @param	InNumWorkers		The number of workers, including the calling thread
+ * @param	InWorker			The worker, called once by each thread
+ */
+void RunGitProcessesInParallel(int32 InNumWorkers, TFunctionRef<void()> InWorker);
+
+/** Join the threads of the pool of git processes, when the module shuts down */
+void ShutdownGitProcessPool();
+
 /**
  * Run a Git command - output is a string TArray.
  *
+ * Files are split in batches to avoid command-line limits; the batches of read-only commands run in parallel.
+ *
  * @param	InCommand			The Git command - e.g. commit
  * @param	InPathToGitBinary	The path to the Git binary
  * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory (can be empty)
@@ -212,6 +261,20 @@ bool ListFilesInDirectoryRecurse(const FString& InPathToGitBinary, const FString
  */
 bool RunCommit(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 
+/**
+ * Revert files to HEAD in a single pass: one status to classify them, one "restore" of the files changed since HEAD,
+ * and one "reset" of the files only added to the index, that stay in the working tree. Requires Git 2.25.
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
+ * @param	InFiles				The absolute paths of the files to revert
+ * @param	OutRevertedFiles	The files that were not added: the ones to unlock
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunBulkRevert(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutRevertedFiles,
+				   TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
+
 /**
  * @brief Detects how to parse the result of a "status" command to get workspace file states
  *
@@ -230,6 +293,8 @@ GITSOURCECONTROL_API void ParseStatusResults( const FString & InPathToGitBinary,
 /**
  * Checks remote branches to see file differences.
  *
+ * The files changed on each branch are cached by the SHA of HEAD and of the branch, so only the branches that moved are walked again.
+ *
  * @param	CurrentBranchName The current branch we are on.
  * @param	InPathToGitBinary	The path to the Git binary
  * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
@@ -248,10 +313,11 @@ void CheckRemote(const FString& InPathToGitBinary, const FString& InRepositoryRo
  * @param	InFiles				The files to be operated on
  * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
  * @param   OutStates           The resultant states
+ * @param	bInCheckRemote		Also compare the files with the remote branches (see CheckRemote), else leave their remote state up to date
  * @returns true if the command succeeded and returned no errors
  */
 bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const bool InUsingLfsLocking, const TArray<FString>& InFiles,
-					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates);
+					 TArray<FString>& OutErrorMessages, TMap<FString, FGitSourceControlState>& OutStates, const bool bInCheckRemote = true);
 
 #if ENGINE_MAJOR_VERSION == 5
 /**
@@ -262,14 +328,25 @@ bool RunUpdateStatus(const FString& InPathToGitBinary, const FString& InReposito
  * @param   ObjectSaveContext	Context for save (for adapting delegate)
  */
 void UpdateFileStagingOnSaved(const FString& Filename, UPackage* Pkg, FObjectPostSaveContext ObjectSaveContext);
-#endif
 
 /**
- * Keep Consistency of being file staged with simple argument
+ * Stage the files saved since the last flush, with a single command of the provider
  *
- * @param	Filename			Saved filename
+ * @param	bInSynchronous		Wait for the command, else only queue it
  */
-bool UpdateFileStagingOnSavedInternal(const FString& Filename);
+void FlushFileStagingOnSaved(const bool bInSynchronous);
+
+/**
+ * Run a Git "add" command to stage the new content of files, in a single process with Git 2.25
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
+ * @param	InFiles				The absolute paths of the files to stage
+ * @param	OutErrorMessages	Any errors (from StdErr) as an array per-line
+ * @returns true if the command succeeded and returned no errors
+ */
+bool RunStageFiles(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages);
+#endif
 	
 /**
  * 
@@ -282,17 +359,27 @@ void UpdateStateOnAssetRename(const FAssetData& InAssetData, const FString& InOl
 
 #if ENGINE_MAJOR_VERSION == 5
 /**
- * 
+ * Refresh the Staged and Working changelists from the status of the whole Content directory.
  *
- * @param	Filename			Saved filename
- * @param	Pkg					Package (for adapting delegate)
- * @param   ObjectSaveContext	Context for save (for adapting delegate)
+ * RunUpdateStatus already keeps them up to date for the files it queries: this is only needed for a full refresh.
  */
 bool UpdateChangelistStateByCommand();
 #endif
 	
 /**
- * Run a Git "cat-file" command to dump the binary content of a revision into a file.
+ * Run a Git command and stream its binary output, chunk by chunk, without buffering it all in memory.
+ *
+ * @param	InPathToGitBinary	The path to the Git binary
+ * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
+ * @param	InCommand			The Git command with its parameters
+ * @param	OnData				Called with each chunk of the output; returning false stops and kills the command
+ * @param	OutReturnCode		The return code of the command
+ * @returns true if the command succeeded and all the output was accepted
+*/
+bool RunCommandStreamed(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InCommand, TFunctionRef<bool(const uint8*, int32)> OnData, int32& OutReturnCode);
+
+/**
+ * Run a Git "cat-file" command to stream the binary content of a revision into a file.
  *
  * @param	InPathToGitBinary	The path to the Git binary
  * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
@@ -303,7 +390,33 @@ bool UpdateChangelistStateByCommand();
 bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InDumpFileName);
 
 /**
- * Run a Git "log" command and parse it.
+ * Run a Git "rev-parse" command to get the hash of the blob of a file at a revision.
+ *
+ * @param	InParameter			The revision and path of the file (rev:path)
+ * @param	OutBlobHash			The hash of the blob
+ * @returns true if the command succeeded and returned a hash
+*/
+bool GetBlobHash(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, FString& OutBlobHash);
+
+/** Whether a string is a full object id: 40 hexadecimal digits, or 64 in a SHA-256 repository */
+bool IsObjectId(const FString& InString);
+
+/** @returns the path of a blob in the content-addressed cache of revisions, keeping the extension the editor expects */
+FString GetBlobCacheFilename(const FString& InBlobHash, const FString& InExtension);
+
+/**
+ * Dump the content of a blob into the content-addressed cache of revisions, unless it is already there.
+ *
+ * @param	InParameter			The revision and path of the file (rev:path)
+ * @param	InBlobHash			The hash of the blob, as given by ls-tree or GetBlobHash()
+ * @param	InExtension			The extension of the file, with its dot
+ * @param	OutCachedFileName	The file in the cache
+ * @returns true if the blob is in the cache
+*/
+bool RunDumpToBlobCache(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InParameter, const FString& InBlobHash, const FString& InExtension, FString& OutCachedFileName);
+
+/**
+ * Get the history of a file, from the .git directory when the native read backend can answer, else from a Git "log" command.
  *
  * @param	InPathToGitBinary	The path to the Git binary
  * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
@@ -314,6 +427,18 @@ bool RunDumpToFile(const FString& InPathToGitBinary, const FString& InRepository
  */
 bool RunGetHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory);
 
+/** Run a Git "log" command and parse it, then a Git "ls-tree" for the file at each revision: the command line side of RunGetHistory() */
+bool RunLogHistory(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const FString& InFile, bool bMergeConflict, TArray<FString>& OutErrorMessages, TGitSourceControlHistory& OutHistory);
+
+/**
+ * Parse the whole output of a 'git log -z --name-status --format=%x01%H%x00%an%x00%at%x00%B%x00', as run by RunGetHistory.
+ *
+ * @param	InData				The UTF-8 output of the command
+ * @param	InSize				Its size in bytes
+ * @param	OutHistory			The revisions, from the most recent one
+ */
+void ParseLog(const uint8* InData, int32 InSize, TGitSourceControlHistory& OutHistory);
+
 /**
  * Helper function to convert a filename array to relative paths.
  * @param	InFileNames		The filename array
@@ -338,6 +463,26 @@ void RemoveRedundantErrors(FGitSourceControlCommand& InCommand, const FString& I
 
 	bool RunLFSCommand(const FString& InCommand, const FString& InRepositoryRoot, const FString& GitBinaryFallback, const TArray<FString>& InParameters, const TArray<FString>& InFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 
+/**
+ * Lock or unlock files with Git LFS, sending the requests of many files concurrently through a bounded number of git-lfs processes.
+ * The files that fail for a transient reason (timeout, server error...) are sent again, after an increasing delay.
+ * A file that a retried lock finds already locked by the current user counts as locked.
+ *
+ * @param	InCommand			"lock" or "unlock"
+ * @param	InFiles				Files relative to the repository root
+ * @param	OutSucceededFiles	The files that were locked or unlocked, even if others failed
+ * @returns true if all the files were locked or unlocked
+ */
+bool RunLFSLockCommand(const FString& InCommand, const FString& InRepositoryRoot, const FString& GitBinaryFallback, const TArray<FString>& InFiles,
+					   TArray<FString>& OutSucceededFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
+
+/**
+ * Lock or unlock files with Git LFS, or record the operation in the offline journal if the remote is unreachable.
+ * The queued files are reported as succeeded, since their lock state is applied locally until the journal is replayed.
+ */
+bool RunQueuedLFSLockCommand(const FString& InCommand, const FString& InRepositoryRoot, const FString& GitBinaryFallback, const TArray<FString>& InFiles,
+							 TArray<FString>& OutSucceededFiles, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
+
 /**
  * Helper function for various commands to update cached states.
  * @returns true if any states were updated
@@ -357,12 +502,14 @@ GITSOURCECONTROL_API bool CollectNewStates( const TMap< FString, FGitSourceContr
 bool CollectNewStates(const TArray<FString>& InFiles, TMap<const FString, FGitState>& OutResults, EFileState::Type FileState, ETreeState::Type TreeState = ETreeState::Unset, ELockState::Type LockState = ELockState::Unset, ERemoteState::Type RemoteState = ERemoteState::Unset);
 
 	/**
-		 * Run 'git lfs locks" to extract all lock information for all files in the repository
+		 * Get lock information for all files in the repository from the local lock index,
+		 * running 'git lfs locks' to refresh the index only if it is empty or if asked to.
 		 *
 		 * @param	InRepositoryRoot	The Git repository from where to run the command - usually the Game directory
 		 * @param   GitBinaryFallBack   The Git binary fallback path
 		 * @param	OutErrorMessages    Any errors (from StdErr) as an array per-line
 		 * @param	OutLocks		    The lock results (file, username)
+		 * @param	bInvalidateCache	Refresh the lock index from the LFS server
 		 * @returns true if the command succeeded and returned no errors
 		 */
 	bool GetAllLocks(const FString& InRepositoryRoot, const FString& GitBinaryFallBack, TArray<FString>& OutErrorMessages, TMap<FString, FString>& OutLocks, bool bInvalidateCache = false);
@@ -382,8 +529,23 @@ bool IsFileLFSLockable(const FString& InFile);
  */
 bool CheckLFSLockable(const FString& InPathToGitBinary, const FString& InRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutErrorMessages);
 
+/** The lockable extensions found by the last CheckLFSLockable(), to persist them across sessions */
+TArray<FString> GetLockableTypes();
+
+/** Restore the lockable extensions found by a previous session */
+void SetLockableTypes(const TArray<FString>& InLockableTypes);
+
 GITSOURCECONTROL_API bool FetchRemote( const FString & InPathToGitBinary, const FString & InPathToRepositoryRoot, bool InUsingGitLfsLocking, TArray< FString > & OutResults, TArray< FString > & OutErrorMessages );
 
+/**
+ * Fetch only the upstream of the current branch and the status branches, for the background refresh, and keep the commit-graph up to date
+ * @param	bOutRefsMoved	Whether HEAD or one of these branches moved since the previous call, else the remote states are still accurate
+ */
+bool FetchRemoteRefs(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot, bool InUsingGitLfsLocking, TArray<FString>& OutResults, TArray<FString>& OutErrorMessages, bool& bOutRefsMoved);
+
+/**
+ * Pull the current branch, unlinking the loaded packages it updates before, and reloading them over the next frames after
+ */
 bool PullOrigin(const FString& InPathToGitBinary, const FString& InPathToRepositoryRoot, const TArray<FString>& InFiles, TArray<FString>& OutFiles,
 				TArray<FString>& OutResults, TArray<FString>& OutErrorMessages);
 
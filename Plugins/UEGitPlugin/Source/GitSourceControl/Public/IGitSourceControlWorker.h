@@ -26,6 +26,15 @@ public:
 	 * @returns true if states were updated
 	 */
 	virtual bool UpdateStates() const = 0;
+
+	/**
+	 * Can the work be canceled while in progress, killing its git process? Only for queries and network transfers:
+	 * a command changing the index or the working tree would be left half applied.
+	 */
+	virtual bool CanCancel() const
+	{
+		return false;
+	}
 };
 
 typedef TSharedRef<IGitSourceControlWorker, ESPMode::ThreadSafe> FGitSourceControlWorkerRef;
@@ -0,0 +1,163 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlBenchmarkReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GitSourceControlProvider.h"
+#include "GitSourceControlTestRepository.h"
+#include "GitSourceControlUtils.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+double FGitBenchmarkTiming::GetMin() const
+{
+	return Seconds.Num() > 0 ? FMath::Min(Seconds) : 0.0;
+}
+
+double FGitBenchmarkTiming::GetMedian() const
+{
+	if (Seconds.Num() == 0)
+	{
+		return 0.0;
+	}
+	TArray<double> Sorted = Seconds;
+	Sorted.Sort();
+	const int32 Middle = Sorted.Num() / 2;
+	return (Sorted.Num() % 2) ? Sorted[Middle] : 0.5 * (Sorted[Middle - 1] + Sorted[Middle]);
+}
+
+double FGitBenchmarkTiming::GetMax() const
+{
+	return Seconds.Num() > 0 ? FMath::Max(Seconds) : 0.0;
+}
+
+FGitBenchmarkReport::FGitBenchmarkReport(const FString& InName)
+	: Name(InName)
+{
+}
+
+void FGitBenchmarkReport::SetRepository(const FGitTestRepository& InRepository)
+{
+	const FGitTestRepositorySpec& Spec = InRepository.GetSpec();
+	PathToGitBinary = InRepository.GetPathToGitBinary();
+	RepositorySpec = {
+		{TEXT("files"), Spec.NumFiles},
+		{TEXT("fileSize"), Spec.FileSize},
+		{TEXT("commits"), Spec.NumCommits},
+		{TEXT("filesPerCommit"), Spec.FilesPerCommit},
+		{TEXT("branches"), Spec.NumBranches},
+		{TEXT("lfsFiles"), InRepository.HasLfs() ? Spec.NumLfsFiles : 0},
+		{TEXT("conflicts"), Spec.NumConflicts},
+	};
+}
+
+const FGitBenchmarkTiming& FGitBenchmarkReport::Measure(const FString& InName, int32 InNumItems, int32 InIterations, TFunctionRef<void()> InSetup, TFunctionRef<bool()> InBody)
+{
+	FGitBenchmarkTiming& Timing = Timings.AddDefaulted_GetRef();
+	Timing.Name = InName;
+	Timing.NumItems = InNumItems;
+	Timing.Seconds.Reserve(InIterations);
+	for (int32 Iteration = 0; Iteration < InIterations; Iteration++)
+	{
+		InSetup();
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bSuccess = InBody();
+		Timing.Seconds.Add(FPlatformTime::Seconds() - StartTime);
+		if (!bSuccess)
+		{
+			Timing.NumFailures++;
+		}
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("%s %s (%d items): min %.3fs, median %.3fs, max %.3fs over %d iterations%s"), *Name, *InName, InNumItems,
+		Timing.GetMin(), Timing.GetMedian(), Timing.GetMax(), InIterations, Timing.NumFailures ? *FString::Printf(TEXT(", %d failed"), Timing.NumFailures) : TEXT(""));
+	return Timing;
+}
+
+const FGitBenchmarkTiming& FGitBenchmarkReport::Measure(const FString& InName, int32 InNumItems, int32 InIterations, TFunctionRef<bool()> InBody)
+{
+	return Measure(InName, InNumItems, InIterations, [] {}, InBody);
+}
+
+void FGitBenchmarkReport::AddValue(const FString& InName, double InValue)
+{
+	Values.Emplace(InName, InValue);
+	UE_LOG(LogSourceControl, Log, TEXT("%s %s: %.0f"), *Name, *InName, InValue);
+}
+
+bool FGitBenchmarkReport::Save(FString& OutFilename) const
+{
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("benchmark"), Name);
+	Report->SetStringField(TEXT("date"), FDateTime::UtcNow().ToIso8601());
+	Report->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Report->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+
+	FGitVersion GitVersion;
+	if (!PathToGitBinary.IsEmpty() && GitSourceControlUtils::CheckGitAvailability(PathToGitBinary, &GitVersion))
+	{
+		Report->SetStringField(TEXT("git"), FString::Printf(TEXT("%d.%d.%d"), GitVersion.Major, GitVersion.Minor, GitVersion.Patch));
+	}
+
+	if (RepositorySpec.Num() > 0)
+	{
+		TSharedRef<FJsonObject> Repository = MakeShared<FJsonObject>();
+		for (const TPair<FString, double>& Field : RepositorySpec)
+		{
+			Repository->SetNumberField(Field.Key, Field.Value);
+		}
+		Report->SetObjectField(TEXT("repository"), Repository);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Measures;
+	for (const FGitBenchmarkTiming& Timing : Timings)
+	{
+		TSharedRef<FJsonObject> Measure = MakeShared<FJsonObject>();
+		Measure->SetStringField(TEXT("name"), Timing.Name);
+		Measure->SetNumberField(TEXT("items"), Timing.NumItems);
+		Measure->SetNumberField(TEXT("iterations"), Timing.Seconds.Num());
+		Measure->SetNumberField(TEXT("failures"), Timing.NumFailures);
+		Measure->SetNumberField(TEXT("min"), Timing.GetMin());
+		Measure->SetNumberField(TEXT("median"), Timing.GetMedian());
+		Measure->SetNumberField(TEXT("max"), Timing.GetMax());
+		Measures.Add(MakeShared<FJsonValueObject>(Measure));
+	}
+	Report->SetArrayField(TEXT("measures"), Measures);
+
+	if (Values.Num() > 0)
+	{
+		TSharedRef<FJsonObject> ValuesObject = MakeShared<FJsonObject>();
+		for (const TPair<FString, double>& Value : Values)
+		{
+			ValuesObject->SetNumberField(Value.Key, Value.Value);
+		}
+		Report->SetObjectField(TEXT("values"), ValuesObject);
+	}
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Report, Writer))
+	{
+		return false;
+	}
+
+	OutFilename = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("GitSourceControl") / TEXT("Benchmarks")
+		/ FString::Printf(TEXT("%s-%s.json"), *Name, *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"))));
+	if (!FFileHelper::SaveStringToFile(Json, *OutFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to write the benchmark report '%s'"), *OutFilename);
+		return false;
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("Benchmark report written to '%s'"), *OutFilename);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
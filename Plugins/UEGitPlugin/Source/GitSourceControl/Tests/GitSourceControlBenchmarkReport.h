@@ -0,0 +1,67 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FGitTestRepository;
+
+/** Durations of the iterations of a measure */
+struct FGitBenchmarkTiming
+{
+	FString Name;
+	/** Files or commits processed by each iteration, to compare the measures of different sizes */
+	int32 NumItems = 0;
+	TArray<double> Seconds;
+	/** Iterations that reported a failure */
+	int32 NumFailures = 0;
+
+	double GetMin() const;
+	double GetMedian() const;
+	double GetMax() const;
+};
+
+/**
+ * Timings of a benchmark, written as JSON to Saved/GitSourceControl/Benchmarks for regression tracking.
+ *
+ * Each file holds the spec of the generated repository, the git version and the platform, then a min, median
+ * and max per measure: comparing the medians of two runs on the same machine tells whether a change regressed.
+ */
+class FGitBenchmarkReport
+{
+public:
+	explicit FGitBenchmarkReport(const FString& InName);
+
+	/** Record the spec of the repository the measures were made on */
+	void SetRepository(const FGitTestRepository& InRepository);
+
+	/**
+	 * Time a function over several iterations
+	 * @param	InSetup	Called before each iteration, not timed: to modify the files for instance
+	 * @param	InBody	The measured function, returning false on failure
+	 */
+	const FGitBenchmarkTiming& Measure(const FString& InName, int32 InNumItems, int32 InIterations, TFunctionRef<void()> InSetup, TFunctionRef<bool()> InBody);
+	const FGitBenchmarkTiming& Measure(const FString& InName, int32 InNumItems, int32 InIterations, TFunctionRef<bool()> InBody);
+
+	/** Record a value that is not a duration, like a size in bytes or a count */
+	void AddValue(const FString& InName, double InValue);
+
+	const TArray<FGitBenchmarkTiming>& GetTimings() const { return Timings; }
+
+	/** Write the report, and log a summary */
+	bool Save(FString& OutFilename) const;
+
+private:
+	FString Name;
+	FString PathToGitBinary;
+	TArray<TPair<FString, double>> RepositorySpec;
+	TArray<FGitBenchmarkTiming> Timings;
+	TArray<TPair<FString, double>> Values;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
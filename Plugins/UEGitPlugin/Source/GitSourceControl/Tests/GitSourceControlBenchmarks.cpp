@@ -0,0 +1,972 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GitSourceControlAttributeCache.h"
+#include "GitSourceControlBenchmarkReport.h"
+#include "GitSourceControlChangelistState.h"
+#include "GitSourceControlModule.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlOperations.h"
+#include "GitSourceControlPathTable.h"
+#include "GitSourceControlRevision.h"
+#include "GitSourceControlTestHelpers.h"
+#include "GitSourceControlTestRepository.h"
+#include "GitSourceControlTracer.h"
+#include "GitSourceControlUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SourceControlOperations.h"
+
+using namespace GitSourceControlTestHelpers;
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkFiles(
+	TEXT("git.Benchmark.Files"),
+	10000,
+	TEXT("Number of files of the repository generated by the Git benchmarks."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkCommits(
+	TEXT("git.Benchmark.Commits"),
+	1000,
+	TEXT("Number of commits of the repository generated by the Git benchmarks."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkBranches(
+	TEXT("git.Benchmark.Branches"),
+	8,
+	TEXT("Number of branches of the repository generated by the Git benchmarks."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkLfsFiles(
+	TEXT("git.Benchmark.LfsFiles"),
+	100,
+	TEXT("Number of binary assets tracked by git-lfs in the repository generated by the Git benchmarks, if git-lfs is installed."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkChangedFiles(
+	TEXT("git.Benchmark.ChangedFiles"),
+	1000,
+	TEXT("Number of files modified before each iteration of the Git benchmarks."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkRefreshFiles(
+	TEXT("git.Benchmark.RefreshFiles"),
+	20000,
+	TEXT("Number of files of the repository generated by the Git refresh benchmark, all of them modified."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkStates(
+	TEXT("git.Benchmark.States"),
+	100000,
+	TEXT("Number of file states of the Git state table benchmark."));
+
+static TAutoConsoleVariable<int32> CVarGitBenchmarkIterations(
+	TEXT("git.Benchmark.Iterations"),
+	5,
+	TEXT("Number of iterations of each measure of the Git benchmarks."));
+
+static FGitTestRepositorySpec GetBenchmarkSpec()
+{
+	FGitTestRepositorySpec Spec;
+	Spec.NumFiles = FMath::Max(1, CVarGitBenchmarkFiles.GetValueOnAnyThread());
+	Spec.NumCommits = FMath::Max(0, CVarGitBenchmarkCommits.GetValueOnAnyThread());
+	Spec.NumBranches = FMath::Max(0, CVarGitBenchmarkBranches.GetValueOnAnyThread());
+	Spec.NumLfsFiles = FMath::Max(0, CVarGitBenchmarkLfsFiles.GetValueOnAnyThread());
+	return Spec;
+}
+
+/** Git processes of a command launched by the plugin so far, from the command tracer */
+static int64 CountProcesses(const FString& InCommand)
+{
+	return FGitCommandTracer::Get().GetTotals().FindRef(InCommand).Count;
+}
+
+static void SaveReport(FGitTestContext& InContext, const FGitBenchmarkReport& InReport)
+{
+	FString Filename;
+	InContext.TestTrue(TEXT("Benchmark report written"), InReport.Save(Filename));
+}
+
+/** Each worker on a generated repository, run as the provider would on its thread */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkWorkersTest, "GitSourceControl.Benchmark.Workers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkWorkersTest::RunTest(const FString& Parameters)
+{
+	// The workers share the offline journal of the editor: a pending journal would be replayed onto the generated repository
+	const FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	if (!OfflineQueue.IsRemoteReachable() || OfflineQueue.Num() > 0)
+	{
+		AddWarning(TEXT("The editor is working offline: skipped until its journal is replayed"));
+		return true;
+	}
+
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkWorkers"), GetBenchmarkSpec())))
+		{
+			return;
+		}
+		FGitBenchmarkReport Report(TEXT("Workers"));
+		Report.SetRepository(Repository);
+
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const int32 NumChanged = FMath::Clamp(CVarGitBenchmarkChangedFiles.GetValueOnAnyThread(), 1, Repository.GetSpec().NumFiles);
+		const TArray<FString> ChangedFiles = Repository.GetFilePaths(0, NumChanged);
+		int32 Iteration = 0;
+		const auto ModifyFiles = [&Repository, &Iteration, NumChanged]()
+		{
+			Repository.ModifyFiles(0, NumChanged, FString::Printf(TEXT("benchmark %d"), Iteration++));
+		};
+
+		Report.Measure(TEXT("Connect"), 0, Iterations, [&Repository]()
+		{
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FConnect>(), MakeShared<FGitConnectWorker>(), {});
+		});
+
+		Report.Measure(TEXT("UpdateStatus"), NumChanged, Iterations, ModifyFiles, [&Repository, &ChangedFiles]()
+		{
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FUpdateStatus>(), MakeShared<FGitUpdateStatusWorker>(), ChangedFiles);
+		});
+
+		Report.Measure(TEXT("UpdateStatus.Content"), Repository.GetSpec().NumFiles, Iterations, ModifyFiles, [&Repository]()
+		{
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FUpdateStatus>(), MakeShared<FGitUpdateStatusWorker>(), {Repository.GetRoot() / TEXT("Content")});
+		});
+
+		// The revert by category classifies the files from the states of the provider, that the editor would have updated after the changes.
+		// The bulk revert classifies them from its own status: both are timed with the same setup, to compare them.
+		const auto ModifyFilesAndStates = [&ModifyFiles, &Repository, &ChangedFiles]()
+		{
+			ModifyFiles();
+			TSharedRef<FGitUpdateStatusWorker, ESPMode::ThreadSafe> Worker = MakeShared<FGitUpdateStatusWorker>();
+			ExecuteWorker(Repository, ISourceControlOperation::Create<FUpdateStatus>(), Worker, ChangedFiles);
+			UpdateProviderStates(Worker);
+		};
+		const auto Revert = [&Repository, &ChangedFiles]()
+		{
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FRevert>(), MakeShared<FGitRevertWorker>(), ChangedFiles);
+		};
+		IConsoleVariable* BulkRevert = IConsoleManager::Get().FindConsoleVariable(TEXT("git.BulkRevert"));
+		const bool bBulkRevert = BulkRevert->GetBool();
+		RunOnGameThread([BulkRevert]() { BulkRevert->Set(false, ECVF_SetByCode); });
+		Report.Measure(TEXT("Revert"), NumChanged, Iterations, ModifyFilesAndStates, Revert);
+		if (FGitSourceControlModule::Get().GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25))
+		{
+			RunOnGameThread([BulkRevert]() { BulkRevert->Set(true, ECVF_SetByCode); });
+			Report.Measure(TEXT("Revert.Bulk"), NumChanged, Iterations, ModifyFilesAndStates, Revert);
+		}
+		RunOnGameThread([BulkRevert, bBulkRevert]() { BulkRevert->Set(bBulkRevert, ECVF_SetByCode); });
+
+		Report.Measure(TEXT("CheckIn"), NumChanged, Iterations, ModifyFiles, [&Repository, &ChangedFiles, &Iteration]()
+		{
+			TSharedRef<FCheckIn, ESPMode::ThreadSafe> Operation = ISourceControlOperation::Create<FCheckIn>();
+			Operation->SetDescription(FText::FromString(FString::Printf(TEXT("Benchmark check in %d"), Iteration)));
+			return ExecuteWorker(Repository, Operation, MakeShared<FGitCheckInWorker>(), ChangedFiles);
+		});
+		RemoveProviderStates(ChangedFiles);
+
+		// Each iteration fetches, or pulls, the changes of a few files pushed from another clone
+		const int32 NumRemoteChanged = FMath::Min(10, Repository.GetSpec().NumFiles);
+		const auto PushRemoteChanges = [&Repository, &Iteration, &Context, NumRemoteChanged]()
+		{
+			Context.TestTrue(TEXT("Remote changes pushed"), Repository.PushRemoteChanges(0, NumRemoteChanged, FString::Printf(TEXT("remote %d"), Iteration++)));
+		};
+
+		Report.Measure(TEXT("Fetch"), NumRemoteChanged, Iterations, PushRemoteChanges, [&Repository]()
+		{
+			// Without the status update of the project files: the fetch only
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FGitFetch>(), MakeShared<FGitFetchWorker>(), {});
+		});
+
+		Report.Measure(TEXT("Sync"), NumRemoteChanged, Iterations, PushRemoteChanges, [&Repository]()
+		{
+			return ExecuteWorker(Repository, ISourceControlOperation::Create<FSync>(), MakeShared<FGitSyncWorker>(), {});
+		});
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** The utilities the workers spend their time in, on a generated repository */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkUtilsTest, "GitSourceControl.Benchmark.Utils", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkUtilsTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkUtils"), GetBenchmarkSpec())))
+		{
+			return;
+		}
+		FGitBenchmarkReport Report(TEXT("Utils"));
+		Report.SetRepository(Repository);
+
+		const FString& PathToGitBinary = Repository.GetPathToGitBinary();
+		const FString& Root = Repository.GetRoot();
+		const FGitTestRepositorySpec& Spec = Repository.GetSpec();
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const int32 NumChanged = FMath::Clamp(CVarGitBenchmarkChangedFiles.GetValueOnAnyThread(), 1, Spec.NumFiles);
+		const TArray<FString> ChangedFiles = Repository.ModifyFiles(0, NumChanged, TEXT("benchmark"));
+		const TArray<FString> AllFiles = Repository.GetFilePaths(0, Spec.NumFiles);
+
+		Report.Measure(TEXT("RunUpdateStatus"), NumChanged, Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TMap<FString, FGitSourceControlState> States;
+			return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, ChangedFiles, ErrorMessages, States, false);
+		});
+
+		Report.Measure(TEXT("RunUpdateStatus.AllFiles"), AllFiles.Num(), Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TMap<FString, FGitSourceControlState> States;
+			return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, AllFiles, ErrorMessages, States, false);
+		});
+
+		Report.Measure(TEXT("RunGetHistory"), Spec.NumCommits + 1, Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TGitSourceControlHistory History;
+			return GitSourceControlUtils::RunGetHistory(PathToGitBinary, Root, Repository.GetHistoryFilePath(), false, ErrorMessages, History)
+				&& History.Num() == Spec.NumCommits + 1;
+		});
+
+		if (Repository.HasLfs())
+		{
+			// A local bare remote has no lock API: this measures the lock index and the attribute lookups of the assets
+			TArray<FString> LfsFiles;
+			for (int32 Index = 0; Index < Spec.NumLfsFiles; Index++)
+			{
+				LfsFiles.Add(Repository.GetLfsFilePath(Index));
+			}
+			Report.Measure(TEXT("GetAllLocks.Index"), Spec.NumLfsFiles, Iterations, [&]()
+			{
+				TArray<FString> ErrorMessages;
+				TMap<FString, FString> Locks;
+				GitSourceControlUtils::GetAllLocks(Root, PathToGitBinary, ErrorMessages, Locks, false);
+				return true;
+			});
+			Report.Measure(TEXT("RunUpdateStatus.Lfs"), Spec.NumLfsFiles, Iterations, [&]()
+			{
+				TArray<FString> ErrorMessages;
+				TMap<FString, FGitSourceControlState> States;
+				return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, LfsFiles, ErrorMessages, States, false);
+			});
+		}
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** The status of all the files of a large project, modified: its batches of files run in parallel */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkRefreshTest, "GitSourceControl.Benchmark.Refresh", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkRefreshTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = FMath::Max(1, CVarGitBenchmarkRefreshFiles.GetValueOnAnyThread());
+		Spec.NumCommits = 10;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkRefresh"), Spec)))
+		{
+			return;
+		}
+		FGitBenchmarkReport Report(TEXT("Refresh"));
+		Report.SetRepository(Repository);
+
+		const FString& PathToGitBinary = Repository.GetPathToGitBinary();
+		const FString& Root = Repository.GetRoot();
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const TArray<FString> AllFiles = Repository.ModifyFiles(0, Spec.NumFiles, TEXT("refresh"));
+
+		TMap<FString, FGitSourceControlState> States;
+		Report.Measure(TEXT("RunUpdateStatus"), AllFiles.Num(), Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			States.Reset();
+			return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, AllFiles, ErrorMessages, States, false);
+		});
+		Context.TestEqual(TEXT("Modified files"), States.FilterByPredicate([](const TPair<FString, FGitSourceControlState>& State) { return State.Value.IsModified(); }).Num(), AllFiles.Num());
+
+		Report.Measure(TEXT("RunUpdateStatus.Content"), AllFiles.Num(), Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TMap<FString, FGitSourceControlState> ContentStates;
+			return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, {Root / TEXT("Content")}, ErrorMessages, ContentStates, false);
+		});
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** Check ins of 1k, 10k and 50k files, each a single commit with all its files */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkCommitTest, "GitSourceControl.Benchmark.Commit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkCommitTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		const int32 CommitSizes[] = {1000, 10000, 50000};
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = CommitSizes[UE_ARRAY_COUNT(CommitSizes) - 1];
+		Spec.NumCommits = 10;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkCommit"), Spec)))
+		{
+			return;
+		}
+		FGitBenchmarkReport Report(TEXT("Commit"));
+		Report.SetRepository(Repository);
+
+		const FString& PathToGitBinary = Repository.GetPathToGitBinary();
+		const FString& Root = Repository.GetRoot();
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const bool bPathspecFromFile = FGitSourceControlModule::Get().GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25);
+		int32 Iteration = 0;
+		for (const int32 NumFiles : CommitSizes)
+		{
+			const TArray<FString> Files = GitSourceControlUtils::RelativeFilenames(Repository.GetFilePaths(0, NumFiles), Root);
+			const auto ModifyFiles = [&Repository, &Iteration, NumFiles]()
+			{
+				Repository.ModifyFiles(0, NumFiles, FString::Printf(TEXT("commit %d"), Iteration++));
+			};
+			const int64 NumCommitProcesses = CountProcesses(TEXT("commit"));
+			Report.Measure(FString::Printf(TEXT("RunCommit.%d"), NumFiles), NumFiles, Iterations, ModifyFiles, [&]()
+			{
+				TArray<FString> Results;
+				TArray<FString> ErrorMessages;
+				const TArray<FString> CommitParameters{FString::Printf(TEXT("-m \"Benchmark commit %d\""), Iteration)};
+				return GitSourceControlUtils::RunCommit(PathToGitBinary, Root, CommitParameters, Files, Results, ErrorMessages);
+			});
+
+			// With Git 2.25, a single commit process per check in rather than a commit amended by each batch of files
+			if (bPathspecFromFile)
+			{
+				Context.TestEqual(FString::Printf(TEXT("Commit processes of %d check ins of %d files"), Iterations, NumFiles), CountProcesses(TEXT("commit")) - NumCommitProcesses, Iterations);
+			}
+			TArray<FString> CommittedFiles;
+			Repository.RunGit(TEXT("diff-tree"), {TEXT("--no-commit-id"), TEXT("--name-only"), TEXT("-r"), TEXT("HEAD")}, &CommittedFiles);
+			Context.TestEqual(FString::Printf(TEXT("Files of the last commit of %d files"), NumFiles), CommittedFiles.Num(), NumFiles);
+		}
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+#if ENGINE_MAJOR_VERSION == 5
+/**
+ * A "Save All" of thousands of staged files, staged again by a single StageSaved command as the flush of the saves runs it,
+ * against the git add per save it replaced, timed on a sample of the files
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkStageSavedTest, "GitSourceControl.Benchmark.StageSaved", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkStageSavedTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 3000;
+		Spec.NumCommits = 10;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkStageSaved"), Spec)))
+		{
+			return;
+		}
+		FGitBenchmarkReport Report(TEXT("StageSaved"));
+		Report.SetRepository(Repository);
+
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const int32 NumSampleFiles = 100;
+		int32 Iteration = 0;
+		// Files of the "Staged" changelist, then saved again in the editor
+		const auto StageAndSaveFiles = [&Repository, &Iteration, &Spec]()
+		{
+			Repository.ModifyFiles(0, Spec.NumFiles, FString::Printf(TEXT("staged %d"), Iteration));
+			Repository.RunGit(TEXT("add"), {TEXT("--all")});
+			Repository.ModifyFiles(0, Spec.NumFiles, FString::Printf(TEXT("saved %d"), Iteration++));
+		};
+
+		const TArray<FString> Files = Repository.GetFilePaths(0, Spec.NumFiles);
+		int64 NumAddProcesses = 0;
+		Report.Measure(TEXT("StageSaved"), Files.Num(), Iterations, StageAndSaveFiles, [&]()
+		{
+			const int64 NumAddProcessesBefore = CountProcesses(TEXT("add"));
+			const bool bStaged = ExecuteWorker(Repository, ISourceControlOperation::Create<FGitStageSaved>(), MakeShared<FGitStageSavedWorker>(), Files);
+			NumAddProcesses += CountProcesses(TEXT("add")) - NumAddProcessesBefore;
+			return bStaged;
+		});
+		Report.AddValue(TEXT("StageSaved.AddProcesses"), (double)NumAddProcesses / Iterations);
+
+		TArray<FString> UnstagedFiles;
+		Repository.RunGit(TEXT("diff"), {TEXT("--name-only")}, &UnstagedFiles);
+		Context.TestEqual(TEXT("Saved files left unstaged"), UnstagedFiles.Num(), 0);
+		const int64 ExpectedAddProcesses = FGitSourceControlModule::Get().GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 25)
+			? 1 : FMath::DivideAndRoundUp(Files.Num(), 50);
+		Context.TestEqual(FString::Printf(TEXT("git add processes for %d saves"), Files.Num()), NumAddProcesses, ExpectedAddProcesses * Iterations);
+
+		const TArray<FString> SampleFiles = Repository.GetFilePaths(0, NumSampleFiles);
+		Report.Measure(TEXT("AddPerSave"), SampleFiles.Num(), Iterations, StageAndSaveFiles, [&]()
+		{
+			bool bStaged = true;
+			for (const FString& File : SampleFiles)
+			{
+				TArray<FString> Results;
+				TArray<FString> ErrorMessages;
+				bStaged &= GitSourceControlUtils::RunCommand(TEXT("add"), Repository.GetPathToGitBinary(), Repository.GetRoot(), FGitSourceControlModule::GetEmptyStringArray(), {File}, Results, ErrorMessages);
+			}
+			return bStaged;
+		});
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/**
+ * The membership of the Staged and Working changelists of 20k modified files, as updated from each status,
+ * against the AddUnique and Remove scans of the file array of the full rescan it replaced
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkChangelistsTest, "GitSourceControl.Benchmark.Changelists", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkChangelistsTest::RunTest(const FString& Parameters)
+{
+	const int32 NumFiles = FMath::Max(1, CVarGitBenchmarkRefreshFiles.GetValueOnAnyThread());
+	const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+	const FString Root = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	TArray<FSourceControlStateRef> States;
+	States.Reserve(NumFiles);
+	for (int32 Index = 0; Index < NumFiles; Index++)
+	{
+		States.Add(MakeShared<FGitSourceControlState, ESPMode::ThreadSafe>(Root / FString::Printf(TEXT("Content/Dir%03d/File%05d.uasset"), Index / 100, Index)));
+	}
+	FGitBenchmarkReport Report(TEXT("Changelists"));
+
+	// All the files modified, then all of them staged: each file moves from Working to Staged
+	FGitSourceControlChangelistState StagedChangelist(FGitSourceControlChangelist::StagedChangelist);
+	FGitSourceControlChangelistState WorkingChangelist(FGitSourceControlChangelist::WorkingChangelist);
+	Report.Measure(TEXT("Changelists.Add"), NumFiles, Iterations, [&]()
+	{
+		for (const FSourceControlStateRef& State : States)
+		{
+			StagedChangelist.RemoveFile(State);
+			WorkingChangelist.RemoveFile(State);
+		}
+	}, [&]()
+	{
+		bool bAdded = true;
+		for (const FSourceControlStateRef& State : States)
+		{
+			bAdded &= WorkingChangelist.AddFile(State);
+		}
+		return bAdded && WorkingChangelist.GetFilesStates().Num() == NumFiles;
+	});
+	Report.Measure(TEXT("Changelists.Move"), NumFiles, Iterations, [&]()
+	{
+		for (const FSourceControlStateRef& State : States)
+		{
+			StagedChangelist.RemoveFile(State);
+			WorkingChangelist.AddFile(State);
+		}
+	}, [&]()
+	{
+		bool bMoved = true;
+		for (const FSourceControlStateRef& State : States)
+		{
+			bMoved &= WorkingChangelist.RemoveFile(State) && StagedChangelist.AddFile(State);
+		}
+		return bMoved && WorkingChangelist.GetFilesStates().Num() == 0 && StagedChangelist.GetFilesStates().Num() == NumFiles;
+	});
+
+	TArray<FSourceControlStateRef> StagedFiles;
+	TArray<FSourceControlStateRef> WorkingFiles;
+	Report.Measure(TEXT("Rescan.Add"), NumFiles, Iterations, [&]()
+	{
+		WorkingFiles.Reset();
+	}, [&]()
+	{
+		for (const FSourceControlStateRef& State : States)
+		{
+			WorkingFiles.AddUnique(State);
+		}
+		return WorkingFiles.Num() == NumFiles;
+	});
+	Report.Measure(TEXT("Rescan.Move"), NumFiles, Iterations, [&]()
+	{
+		StagedFiles.Reset();
+		WorkingFiles = States;
+	}, [&]()
+	{
+		for (const FSourceControlStateRef& State : States)
+		{
+			WorkingFiles.Remove(State);
+			StagedFiles.AddUnique(State);
+		}
+		return WorkingFiles.Num() == 0 && StagedFiles.Num() == NumFiles;
+	});
+
+	for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+	{
+		TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+	}
+	FString Filename;
+	TestTrue(TEXT("Benchmark report written"), Report.Save(Filename));
+	return true;
+}
+#endif
+
+/**
+ * Time and memory of the file states of a 100k-file project, kept in the path and state tables of the provider,
+ * compared to the memory of the map of combined states by path that they replaced
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkStateTableTest, "GitSourceControl.Benchmark.StateTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkStateTableTest::RunTest(const FString& Parameters)
+{
+	const int32 NumFiles = FMath::Max(1, CVarGitBenchmarkStates.GetValueOnAnyThread());
+	const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+	const FString Root = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	TArray<FString> RelativePaths;
+	TArray<FString> Paths;
+	RelativePaths.Reserve(NumFiles);
+	Paths.Reserve(NumFiles);
+	for (int32 Index = 0; Index < NumFiles; Index++)
+	{
+		RelativePaths.Add(FString::Printf(TEXT("Content/Dir%04d/File%06d.uasset"), Index / 100, Index));
+		Paths.Add(Root / RelativePaths.Last());
+	}
+	FGitBenchmarkReport Report(TEXT("StateTable"));
+
+	// Paths are interned once for the session: a new table for each iteration
+	TUniquePtr<FGitPathTable> PathTable;
+	TArray<FGitPathId> Ids;
+	Report.Measure(TEXT("PathTable.InternRelative"), NumFiles, Iterations, [&]()
+	{
+		PathTable = MakeUnique<FGitPathTable>();
+		Ids.Reset(NumFiles);
+	}, [&]()
+	{
+		for (const FString& RelativePath : RelativePaths)
+		{
+			Ids.Add(PathTable->InternRelative(Root, RelativePath));
+		}
+		return PathTable->Num() == NumFiles + 1;
+	});
+
+	Report.Measure(TEXT("PathTable.Find"), NumFiles, Iterations, [&]()
+	{
+		bool bFound = true;
+		for (const FString& Path : Paths)
+		{
+			bFound &= PathTable->Find(Path) != FGitPathTable::EmptyId;
+		}
+		return bFound;
+	});
+
+	// A refresh of all the files, as written by UpdateCachedStates
+	FGitFileStateTable StateTable;
+	int32 Iteration = 0;
+	Report.Measure(TEXT("StateTable.Update"), NumFiles, Iterations, [&]()
+	{
+		const EFileState::Type FileState = Iteration++ % 2 == 0 ? EFileState::Modified : EFileState::Unknown;
+		for (const FGitPathId Id : Ids)
+		{
+			StateTable.SetFileState(Id, FileState);
+			StateTable.SetTreeState(Id, ETreeState::Working);
+			StateTable.SetLockState(Id, ELockState::NotLocked, FString());
+			StateTable.SetRemoteState(Id, ERemoteState::UpToDate, FString());
+		}
+		return true;
+	});
+
+	TMap<FString, FGitState> StateMap;
+	StateMap.Reserve(NumFiles);
+	for (const FString& Path : Paths)
+	{
+		StateMap.Add(Path, FGitState());
+	}
+	SIZE_T StateMapBytes = StateMap.GetAllocatedSize();
+	for (const TPair<FString, FGitState>& State : StateMap)
+	{
+		StateMapBytes += State.Key.GetAllocatedSize() + State.Value.LockUser.GetAllocatedSize() + State.Value.HeadBranch.GetAllocatedSize();
+	}
+	const SIZE_T TablesBytes = PathTable->GetAllocatedSize() + StateTable.GetAllocatedSize();
+	Report.AddValue(TEXT("PathTable.Bytes"), PathTable->GetAllocatedSize());
+	Report.AddValue(TEXT("StateTable.Bytes"), StateTable.GetAllocatedSize());
+	Report.AddValue(TEXT("StateMap.Bytes"), StateMapBytes);
+	TestTrue(TEXT("Tables smaller than a map of states by path"), TablesBytes < StateMapBytes);
+
+	for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+	{
+		TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+	}
+	FString Filename;
+	TestTrue(TEXT("Benchmark report written"), Report.Save(Filename));
+	return true;
+}
+
+/** A 'git log -z --name-status' of a file with the format of RunGetHistory, renamed every ten commits, from the most recent commit */
+static TArray<uint8> MakeLogOutput(int32 InNumCommits)
+{
+	TArray<uint8> Output;
+	const auto Append = [&Output](const FString& InText)
+	{
+		const FTCHARToUTF8 Converted(*InText);
+		Output.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+	};
+	for (int32 Index = InNumCommits; Index > 0; Index--)
+	{
+		const FString Filename = FString::Printf(TEXT("Content/Dir%03d/File%05d.uasset"), Index / 10, 0);
+		Output.Add(0x01);
+		Append(FString::Printf(TEXT("%08x%s"), Index, *FString::ChrN(32, TEXT('0'))));
+		Output.Add(0);
+		Append(TEXT("S\u00e9bastien Rombauts"));
+		Output.Add(0);
+		Append(FString::Printf(TEXT("%d"), 1431718347 + Index));
+		Output.Add(0);
+		Append(FString::Printf(TEXT("Commit %d\n\n - with many lines\n"), Index));
+		Output.Add(0);
+		if (Index % 10 == 0)
+		{
+			Append(TEXT("\nR100"));
+			Output.Add(0);
+			Append(FString::Printf(TEXT("Content/Dir%03d/File%05d.uasset"), Index / 10 - 1, 0));
+			Output.Add(0);
+		}
+		else
+		{
+			Append(TEXT("\nM"));
+			Output.Add(0);
+		}
+		Append(Filename);
+		Output.Add(0);
+	}
+	return Output;
+}
+
+/** The history of a file parsed from the output of its log, at the 250 revisions shown by the editor and at 10k */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkLogParserTest, "GitSourceControl.Benchmark.LogParser", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkLogParserTest::RunTest(const FString& Parameters)
+{
+	const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+	FGitBenchmarkReport Report(TEXT("LogParser"));
+	for (const int32 NumCommits : {250, 10000})
+	{
+		const TArray<uint8> Output = MakeLogOutput(NumCommits);
+		TGitSourceControlHistory History;
+		Report.Measure(FString::Printf(TEXT("ParseLog.%d"), NumCommits), NumCommits, Iterations, [&History]()
+		{
+			History.Reset();
+		}, [&]()
+		{
+			GitSourceControlUtils::ParseLog(Output.GetData(), Output.Num(), History);
+			return History.Num() == NumCommits;
+		});
+		Report.AddValue(FString::Printf(TEXT("ParseLog.%d.Bytes"), NumCommits), Output.Num());
+
+		if (!TestEqual(TEXT("Revisions parsed"), History.Num(), NumCommits))
+		{
+			continue;
+		}
+		const FGitSourceControlRevision& Latest = *History[0];
+		TestEqual(TEXT("Commit id"), Latest.CommitId, FString::Printf(TEXT("%08x%s"), NumCommits, *FString::ChrN(32, TEXT('0'))));
+		TestEqual(TEXT("Commit id number"), Latest.CommitIdNumber, NumCommits);
+		TestEqual(TEXT("User name"), Latest.UserName, FString(TEXT("S\u00e9bastien Rombauts")));
+		TestEqual(TEXT("Date"), Latest.Date, FDateTime::FromUnixTimestamp(1431718347 + NumCommits));
+		TestEqual(TEXT("Description"), Latest.Description, FString::Printf(TEXT("Commit %d\n\n - with many lines"), NumCommits));
+		TestEqual(TEXT("Revision number"), Latest.RevisionNumber, NumCommits);
+		// The most recent commit of both sizes is a rename: it points to the revision before it
+		TestEqual(TEXT("Renamed action"), Latest.Action, FString(TEXT("branch")));
+		TestEqual(TEXT("Renamed filename"), Latest.Filename, FString::Printf(TEXT("Content/Dir%03d/File%05d.uasset"), NumCommits / 10, 0));
+		TestTrue(TEXT("Rename source"), Latest.BranchSource.Get() == &History[1].Get());
+		TestEqual(TEXT("Modified action"), History[1]->Action, FString(TEXT("modified")));
+	}
+
+	for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+	{
+		TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+	}
+	FString Filename;
+	TestTrue(TEXT("Benchmark report written"), Report.Save(Filename));
+	return true;
+}
+
+/**
+ * The lockable attribute of 100k paths looked up in the compiled attributes of a repository with nested .gitattributes,
+ * against the scan of the lockable suffixes it replaced, and checked against git check-attr on a sample of the paths
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkAttributesTest, "GitSourceControl.Benchmark.Attributes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkAttributesTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 1000;
+		Spec.NumCommits = 1;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("BenchmarkAttributes"), Spec)))
+		{
+			return;
+		}
+		// The root .gitattributes makes *.uasset and *.umap lockable: a nested file overrides it for a directory and its subdirectories
+		const bool bNested = FFileHelper::SaveStringToFile(TEXT("*.uasset -lockable\nMaps/*.umap -lockable\n*.png lockable\n"), *(Repository.GetRoot() / TEXT("Content/Dir001/.gitattributes")))
+			&& Repository.RunGit(TEXT("add"), {TEXT("Content/Dir001/.gitattributes")})
+			&& Repository.RunGit(TEXT("commit"), {TEXT("-m"), TEXT("\"Nested attributes\"")});
+		if (!Context.TestTrue(TEXT("Nested attributes committed"), bNested))
+		{
+			return;
+		}
+		FGitAttributeCache AttributeCache;
+		Context.TestTrue(TEXT("Attributes loaded"), AttributeCache.Load(Repository.GetPathToGitBinary(), Repository.GetRoot()));
+		FGitBenchmarkReport Report(TEXT("Attributes"));
+		Report.SetRepository(Repository);
+
+		const int32 NumPaths = FMath::Max(1, CVarGitBenchmarkStates.GetValueOnAnyThread());
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const TCHAR* Extensions[] = {TEXT("uasset"), TEXT("umap"), TEXT("png"), TEXT("ini")};
+		TArray<FString> Paths;
+		Paths.Reserve(NumPaths);
+		for (int32 Index = 0; Index < NumPaths; Index++)
+		{
+			const TCHAR* Directory = Index % 8 == 1 ? TEXT("Maps/") : TEXT("");
+			Paths.Add(FString::Printf(TEXT("Content/Dir%03d/%sFile%06d.%s"), (Index / 10) % 100, Directory, Index, Extensions[Index % UE_ARRAY_COUNT(Extensions)]));
+		}
+
+		TArray<bool> Lockable;
+		Report.Measure(TEXT("AttributeCache.IsLockable"), NumPaths, Iterations, [&]()
+		{
+			Lockable.Reset(NumPaths);
+		}, [&]()
+		{
+			for (const FString& Path : Paths)
+			{
+				Lockable.Add(AttributeCache.IsLockable(Path));
+			}
+			return true;
+		});
+
+		const TArray<FString> LockableExtensions = AttributeCache.GetLockableExtensions();
+		Report.Measure(TEXT("Suffixes"), NumPaths, Iterations, [&]()
+		{
+			int32 NumLockable = 0;
+			for (const FString& Path : Paths)
+			{
+				NumLockable += LockableExtensions.ContainsByPredicate([&Path](const FString& Extension) { return Path.EndsWith(Extension); }) ? 1 : 0;
+			}
+			return NumLockable > 0;
+		});
+
+		// Eight consecutive paths in 2000, one of each kind, through git itself: a short enough command line
+		const int32 SampleStep = 2000;
+		TArray<FString> SampleParameters{TEXT("lockable"), TEXT("--")};
+		for (int32 Index = 0; Index < NumPaths; Index += SampleStep)
+		{
+			// In a different directory each time, Dir001 and its nested attributes included
+			const int32 First = Index + ((Index / SampleStep) % 10) * 10;
+			for (int32 Offset = 0; Offset < 8 && First + Offset < NumPaths; Offset++)
+			{
+				SampleParameters.Add(Paths[First + Offset]);
+			}
+		}
+		TArray<FString> Results;
+		Context.TestTrue(TEXT("git check-attr"), Repository.RunGit(TEXT("check-attr"), SampleParameters, &Results));
+		int32 NumMismatches = 0;
+		for (const FString& Result : Results)
+		{
+			// "path: lockable: set|unset|unspecified"
+			FString Path;
+			FString Value;
+			if (Result.Split(TEXT(": lockable: "), &Path, &Value))
+			{
+				const int32 Index = FCString::Atoi(*FPaths::GetBaseFilename(Path).RightChop(4));
+				if (Lockable.IsValidIndex(Index) && Lockable[Index] != (Value == TEXT("set")))
+				{
+					Context.AddError(FString::Printf(TEXT("Lockable attribute of %s: git check-attr says %s"), *Path, *Value));
+					NumMismatches++;
+				}
+			}
+		}
+		Context.TestEqual(TEXT("Paths checked by git check-attr"), Results.Num(), SampleParameters.Num() - 2);
+		Context.TestEqual(TEXT("Lockable attributes different from git check-attr"), NumMismatches, 0);
+
+		for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+		{
+			Context.TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+		}
+		SaveReport(Context, Report);
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/**
+ * A scripted browsing session of the Content Browser in the project of the editor: a selection of assets sliding over its Content directory,
+ * each one force updated by GetState() then again on a change of filter, with the status commands issued and skipped
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkBrowsingTest, "GitSourceControl.Benchmark.Browsing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkBrowsingTest::RunTest(const FString& Parameters)
+{
+	FGitSourceControlProvider& Provider = FGitSourceControlModule::Get().GetProvider();
+	if (!Provider.IsAvailable())
+	{
+		AddInfo(TEXT("Git revision control is not enabled on this project: skipped"));
+		return true;
+	}
+
+	const int32 MaxAssets = 200;
+	const int32 SelectionSize = 20;
+	const int32 SelectionStep = 10;
+	TArray<FString> Assets;
+	IFileManager::Get().FindFilesRecursive(Assets, *FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()), TEXT("*.uasset"), true, false);
+	Assets.Sort();
+	Assets.SetNum(FMath::Min(Assets.Num(), MaxAssets));
+	if (Assets.Num() < SelectionSize)
+	{
+		AddInfo(FString::Printf(TEXT("Only %d asset(s) in the project: skipped"), Assets.Num()));
+		return true;
+	}
+
+	FGitBenchmarkReport Report(TEXT("Browsing"));
+	const FGitForceUpdateStats StatsBefore = Provider.GetForceUpdateStats();
+	const int64 NumStatusBefore = CountProcesses(TEXT("status"));
+	int32 NumSelections = 0;
+	int64 NumRepeatCommands = 0;
+	Report.Measure(TEXT("Session"), Assets.Num(), 1, [&]()
+	{
+		bool bUpdated = true;
+		for (int32 First = 0; First + SelectionSize <= Assets.Num(); First += SelectionStep)
+		{
+			const TArray<FString> Selection(Assets.GetData() + First, SelectionSize);
+			TArray<FSourceControlStateRef> States;
+			bUpdated &= Provider.GetState(Selection, States, EStateCacheUsage::ForceUpdate) == ECommandResult::Succeeded;
+
+			// The same assets again, as just updated: no other status command
+			const int64 NumCommandsBefore = Provider.GetForceUpdateStats().NumCommands;
+			States.Reset();
+			bUpdated &= Provider.GetState(Selection, States, EStateCacheUsage::ForceUpdate) == ECommandResult::Succeeded;
+			NumRepeatCommands += Provider.GetForceUpdateStats().NumCommands - NumCommandsBefore;
+			NumSelections++;
+		}
+		return bUpdated;
+	});
+
+	const FGitForceUpdateStats& StatsAfter = Provider.GetForceUpdateStats();
+	const int64 NumRequests = StatsAfter.NumRequests - StatsBefore.NumRequests;
+	const int64 NumCommands = StatsAfter.NumCommands - StatsBefore.NumCommands;
+	Report.AddValue(TEXT("ForceUpdate.Requests"), NumRequests);
+	Report.AddValue(TEXT("ForceUpdate.PathsRequested"), StatsAfter.NumPathsRequested - StatsBefore.NumPathsRequested);
+	Report.AddValue(TEXT("ForceUpdate.PathsSkipped"), StatsAfter.NumPathsSkipped - StatsBefore.NumPathsSkipped);
+	Report.AddValue(TEXT("ForceUpdate.Commands"), NumCommands);
+	Report.AddValue(TEXT("Commands.status.Count"), CountProcesses(TEXT("status")) - NumStatusBefore);
+
+	TestEqual(TEXT("Force update requests"), NumRequests, (int64)NumSelections * 2);
+	TestTrue(TEXT("At most one status command per selection"), NumCommands <= NumSelections);
+	TestEqual(TEXT("Status commands of the selections updated again"), NumRepeatCommands, (int64)0);
+	for (const FGitBenchmarkTiming& Timing : Report.GetTimings())
+	{
+		TestEqual(FString::Printf(TEXT("Failed iterations of %s"), *Timing.Name), Timing.NumFailures, 0);
+	}
+	FString Filename;
+	TestTrue(TEXT("Benchmark report written"), Report.Save(Filename));
+	return true;
+}
+
+/**
+ * The read-only utilities bound to the project (CheckRemote diffs its Content, Config and Plugins directories) on the repository of the
+ * editor, with the startup and force update statistics of the provider and the totals of the traced git processes.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitBenchmarkProjectTest, "GitSourceControl.Benchmark.Project", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FGitBenchmarkProjectTest::RunTest(const FString& Parameters)
+{
+	const FGitSourceControlProvider& Provider = FGitSourceControlModule::Get().GetProvider();
+	if (!Provider.IsAvailable())
+	{
+		AddInfo(TEXT("Git revision control is not enabled on this project: skipped"));
+		return true;
+	}
+
+	FGitBenchmarkReport Report(TEXT("Project"));
+	const FGitStartupStats& StartupStats = Provider.GetStartupStats();
+	Report.AddValue(TEXT("Startup.TimeToAvailable"), StartupStats.TimeToAvailable);
+	Report.AddValue(TEXT("Startup.TimeToStatus"), StartupStats.TimeToStatus);
+	Report.AddValue(TEXT("Startup.TimeToRemoteStatus"), StartupStats.TimeToRemoteStatus);
+	Report.AddValue(TEXT("Startup.FromSnapshot"), StartupStats.bFromSnapshot ? 1.0 : 0.0);
+	const FGitForceUpdateStats& ForceUpdateStats = Provider.GetForceUpdateStats();
+	Report.AddValue(TEXT("ForceUpdate.Requests"), ForceUpdateStats.NumRequests);
+	Report.AddValue(TEXT("ForceUpdate.PathsRequested"), ForceUpdateStats.NumPathsRequested);
+	Report.AddValue(TEXT("ForceUpdate.PathsSkipped"), ForceUpdateStats.NumPathsSkipped);
+	for (const TPair<FString, FGitCommandTraceTotals>& Totals : FGitCommandTracer::Get().GetTotals())
+	{
+		Report.AddValue(FString::Printf(TEXT("Commands.%s.Count"), *Totals.Key), Totals.Value.Count);
+		Report.AddValue(FString::Printf(TEXT("Commands.%s.TotalSeconds"), *Totals.Key), Totals.Value.TotalSeconds);
+	}
+
+	const FString PathToGitBinary = Provider.GetGitBinaryPath();
+	const FString Root = Provider.GetPathToRepositoryRoot();
+	RunOffGameThread(*this, [Report = MoveTemp(Report), PathToGitBinary, Root](FGitTestContext& Context) mutable
+	{
+		const int32 Iterations = FMath::Max(1, CVarGitBenchmarkIterations.GetValueOnAnyThread());
+		const TArray<FString> ProjectDirs = GitSourceControlUtils::GetSourceControlledAssetPaths();
+
+		TMap<FString, FGitSourceControlState> States;
+		Report.Measure(TEXT("RunUpdateStatus"), 0, Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			States.Reset();
+			return GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, Root, false, ProjectDirs, ErrorMessages, States, false);
+		});
+
+		Report.Measure(TEXT("CheckRemote"), States.Num(), Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TMap<FString, FGitSourceControlState> RemoteStates = States;
+			GitSourceControlUtils::CheckRemote(PathToGitBinary, Root, ProjectDirs, ErrorMessages, RemoteStates);
+			return ErrorMessages.Num() == 0;
+		});
+
+		Report.Measure(TEXT("GetAllLocks.Index"), 0, Iterations, [&]()
+		{
+			TArray<FString> ErrorMessages;
+			TMap<FString, FString> Locks;
+			GitSourceControlUtils::GetAllLocks(Root, PathToGitBinary, ErrorMessages, Locks, false);
+			return true;
+		});
+
+		SaveReport(Context, Report);
+	});
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
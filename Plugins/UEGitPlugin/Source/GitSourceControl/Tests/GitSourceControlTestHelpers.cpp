@@ -0,0 +1,138 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GitSourceControlCommand.h"
+#include "GitSourceControlModule.h"
+#include "GitSourceControlTestRepository.h"
+#include "IGitSourceControlWorker.h"
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeLock.h"
+
+void FGitTestContext::AddError(const FString& InError)
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Errors.Add(InError);
+}
+
+bool FGitTestContext::TestTrue(const FString& InWhat, bool bInValue)
+{
+	if (!bInValue)
+	{
+		AddError(FString::Printf(TEXT("Expected '%s' to be true."), *InWhat));
+	}
+	return bInValue;
+}
+
+bool FGitTestContext::TestEqual(const FString& InWhat, int64 InActual, int64 InExpected)
+{
+	if (InActual != InExpected)
+	{
+		AddError(FString::Printf(TEXT("Expected '%s' to be %lld, but it was %lld."), *InWhat, InExpected, InActual));
+		return false;
+	}
+	return true;
+}
+
+bool FGitTestContext::TestSuccess(const FString& InWhat, bool bInSuccess, const TArray<FString>& InErrorMessages)
+{
+	if (!bInSuccess)
+	{
+		AddError(FString::Printf(TEXT("%s failed: %s"), *InWhat, *FString::Join(InErrorMessages, TEXT("\n"))));
+	}
+	return bInSuccess;
+}
+
+TArray<FString> FGitTestContext::GetErrors() const
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	return Errors;
+}
+
+namespace GitSourceControlTestHelpers
+{
+void RunOffGameThread(FAutomationTestBase& InTest, TFunction<void(FGitTestContext&)> InBody)
+{
+	TSharedRef<FGitTestContext> Context = MakeShared<FGitTestContext>();
+	TSharedRef<TFuture<void>> Future = MakeShared<TFuture<void>>(Async(EAsyncExecution::Thread, [Context, Body = MoveTemp(InBody)]()
+	{
+		Body(*Context);
+	}));
+
+	FAutomationTestBase* Test = &InTest;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Test, Context, Future]()
+	{
+		if (!Future->IsReady())
+		{
+			return false;
+		}
+		for (const FString& Error : Context->GetErrors())
+		{
+			Test->AddError(Error);
+		}
+		return true;
+	}));
+}
+
+bool ExecuteWorker(const FGitTestRepository& InRepository, const TSharedRef<ISourceControlOperation, ESPMode::ThreadSafe>& InOperation,
+	const TSharedRef<IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const TArray<FString>& InFiles, bool bInUsingGitLfsLocking,
+	TArray<FString>* OutErrorMessages)
+{
+	check(!IsInGameThread());
+
+	FGitSourceControlCommand Command(InOperation, InWorker);
+	Command.PathToGitBinary = InRepository.GetPathToGitBinary();
+	Command.PathToRepositoryRoot = InRepository.GetRoot();
+	Command.PathToGitRoot = InRepository.GetRoot();
+	Command.bUsingGitLfsLocking = bInUsingGitLfsLocking;
+	Command.Concurrency = EConcurrency::Asynchronous;
+	Command.bAutoDelete = false;
+	Command.Files = InFiles;
+	const bool bSuccess = Command.DoWork();
+	if (OutErrorMessages)
+	{
+		*OutErrorMessages = MoveTemp(Command.ResultInfo.ErrorMessages);
+	}
+	return bSuccess;
+}
+
+void RunOnGameThread(TFunction<void()> InFunction)
+{
+	if (IsInGameThread())
+	{
+		InFunction();
+	}
+	else
+	{
+		Async(EAsyncExecution::TaskGraphMainThread, MoveTemp(InFunction)).Wait();
+	}
+}
+
+void UpdateProviderStates(const TSharedRef<IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker)
+{
+	RunOnGameThread([InWorker]()
+	{
+		InWorker->UpdateStates();
+	});
+}
+
+void RemoveProviderStates(const TArray<FString>& InFiles)
+{
+	RunOnGameThread([Files = InFiles]()
+	{
+		FGitSourceControlProvider& Provider = FGitSourceControlModule::Get().GetProvider();
+		for (const FString& File : Files)
+		{
+			Provider.RemoveFileFromCache(File);
+		}
+	});
+}
+} // namespace GitSourceControlTestHelpers
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,68 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+class FAutomationTestBase;
+class FGitTestRepository;
+class IGitSourceControlWorker;
+class ISourceControlOperation;
+
+/** Errors of a test body run on a worker thread, reported to the test once it is done */
+class FGitTestContext
+{
+public:
+	void AddError(const FString& InError);
+
+	/** Add an error if the condition is false, returning the condition */
+	bool TestTrue(const FString& InWhat, bool bInValue);
+	bool TestEqual(const FString& InWhat, int64 InActual, int64 InExpected);
+
+	/** Add the errors of a failed command to the error of its step */
+	bool TestSuccess(const FString& InWhat, bool bInSuccess, const TArray<FString>& InErrorMessages);
+
+	TArray<FString> GetErrors() const;
+
+private:
+	mutable FCriticalSection CriticalSection;
+	TArray<FString> Errors;
+};
+
+namespace GitSourceControlTestHelpers
+{
+/**
+ * Run the body of a test on its own thread, and report its errors to the test once it is done.
+ *
+ * The workers wait on the game thread (to unlink the packages before a pull for instance), so running them from
+ * the test itself would deadlock: the test only queues a latent command that lets the game thread tick meanwhile.
+ */
+void RunOffGameThread(FAutomationTestBase& InTest, TFunction<void(FGitTestContext&)> InBody);
+
+/**
+ * Run a worker on files of a test repository, as the provider would on its thread, without updating the states of the provider
+ * @returns the success of the command
+ */
+bool ExecuteWorker(const FGitTestRepository& InRepository, const TSharedRef<ISourceControlOperation, ESPMode::ThreadSafe>& InOperation,
+	const TSharedRef<IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker, const TArray<FString>& InFiles, bool bInUsingGitLfsLocking = false,
+	TArray<FString>* OutErrorMessages = nullptr);
+
+/** Update the states of the provider with those found by a worker, on the game thread, as done once a command is complete */
+void UpdateProviderStates(const TSharedRef<IGitSourceControlWorker, ESPMode::ThreadSafe>& InWorker);
+
+/** Remove the states of files of a test repository from the provider, on the game thread */
+void RemoveProviderStates(const TArray<FString>& InFiles);
+
+/** Run a function on the game thread and wait for it */
+void RunOnGameThread(TFunction<void()> InFunction);
+} // namespace GitSourceControlTestHelpers
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,428 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "GitSourceControlTestRepository.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GitSourceControlModule.h"
+#include "GitSourceControlUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "ISourceControlModule.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace GitTestRepositoryConstants
+{
+/** Files per directory of the first commit */
+const int32 FilesPerDirectory = 100;
+/** Time of the first commit, so that the generated history is the same at each run */
+const int64 FirstCommitTime = 1700000000;
+const TCHAR* HistoryFile = TEXT("Content/History.uasset");
+} // namespace GitTestRepositoryConstants
+
+/** A "git fast-import" stream, with the content of the files inlined */
+struct FGitFastImportStream
+{
+	TArray<uint8> Bytes;
+
+	void Append(const FString& InText)
+	{
+		const FTCHARToUTF8 Utf8(*InText);
+		Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	void AppendData(const FString& InContent)
+	{
+		const FTCHARToUTF8 Utf8(*InContent);
+		Append(FString::Printf(TEXT("data %d\n"), Utf8.Length()));
+		Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		Bytes.Add('\n');
+	}
+
+	void AppendCommit(const FString& InRef, int32 InMark, int32 InParentMark, int64 InTime, const FString& InMessage)
+	{
+		Append(FString::Printf(TEXT("commit %s\nmark :%d\n"), *InRef, InMark));
+		Append(FString::Printf(TEXT("author Benchmark <benchmark@example.com> %lld +0000\ncommitter Benchmark <benchmark@example.com> %lld +0000\n"), InTime, InTime));
+		AppendData(InMessage);
+		if (InParentMark > 0)
+		{
+			Append(FString::Printf(TEXT("from :%d\n"), InParentMark));
+		}
+	}
+
+	void AppendFile(const FString& InPath, const FString& InContent)
+	{
+		Append(FString::Printf(TEXT("M 100644 inline %s\n"), *InPath));
+		AppendData(InContent);
+	}
+
+	void AppendBranch(const FString& InRef, int32 InMark)
+	{
+		Append(FString::Printf(TEXT("reset %s\nfrom :%d\n\n"), *InRef, InMark));
+	}
+};
+
+/** URL of a local directory, for git-lfs and partial clones that need a "file://" URL */
+static FString MakeFileUrl(const FString& InDirectory)
+{
+	return InDirectory.StartsWith(TEXT("/")) ? TEXT("file://") + InDirectory : TEXT("file:///") + InDirectory;
+}
+
+static FString Quote(const FString& InPath)
+{
+	return FString::Printf(TEXT("\"%s\""), *InPath);
+}
+
+FGitTestRepository::~FGitTestRepository()
+{
+	// Put the remote back in place, for the next run to delete it
+	if (!RemoteDirectory.IsEmpty() && !IFileManager::Get().DirectoryExists(*RemoteDirectory))
+	{
+		SetRemoteAvailable(true);
+	}
+}
+
+bool FGitTestRepository::Create(const FString& InName, const FGitTestRepositorySpec& InSpec)
+{
+	Spec = InSpec;
+	Spec.NumConflicts = FMath::Min(Spec.NumConflicts, Spec.NumFiles);
+
+	PathToGitBinary = FGitSourceControlModule::Get().GetProvider().GetGitBinaryPath();
+	if (PathToGitBinary.IsEmpty())
+	{
+		PathToGitBinary = GitSourceControlUtils::FindGitBinaryPath();
+	}
+	BaseDirectory = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("GitSourceControl") / InName);
+	Root = BaseDirectory / TEXT("Work");
+	RemoteDirectory = BaseDirectory / TEXT("Remote.git");
+	RemoteUrl = MakeFileUrl(RemoteDirectory);
+	OtherRoot.Reset();
+
+	IFileManager::Get().DeleteDirectory(*BaseDirectory, false, true);
+	if (!IFileManager::Get().MakeDirectory(*Root, true))
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to create '%s'"), *Root);
+		return false;
+	}
+
+	// The remote, that also serves partial clones
+	if (!RunGitIn(FString(), TEXT("init"), {TEXT("--bare"), Quote(RemoteDirectory)})
+		|| !RunGitIn(RemoteDirectory, TEXT("symbolic-ref"), {TEXT("HEAD"), TEXT("refs/heads/main")})
+		|| !RunGitIn(RemoteDirectory, TEXT("config"), {TEXT("uploadpack.allowFilter"), TEXT("true")}))
+	{
+		return false;
+	}
+
+	if (!RunGit(TEXT("init"), {})
+		|| !RunGit(TEXT("symbolic-ref"), {TEXT("HEAD"), TEXT("refs/heads/main")})
+		|| !ConfigureClone(Root)
+		|| !RunGit(TEXT("remote"), {TEXT("add"), TEXT("origin"), Quote(RemoteUrl)}))
+	{
+		return false;
+	}
+	bHasLfs = Spec.NumLfsFiles > 0 && RunGit(TEXT("lfs"), {TEXT("version")}) && RunGit(TEXT("lfs"), {TEXT("install"), TEXT("--local")});
+	if (Spec.NumLfsFiles > 0 && !bHasLfs)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("git-lfs is not installed: '%s' is generated without its binary assets"), *InName);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	if (!ImportHistory()
+		|| !RunGit(TEXT("reset"), {TEXT("--hard"), TEXT("main")})
+		|| !RunGit(TEXT("push"), {TEXT("-u"), TEXT("origin"), TEXT("--all")}))
+	{
+		return false;
+	}
+	if ((bHasLfs && !CommitLfsFiles()) || (Spec.NumConflicts > 0 && !MakeConflicts()))
+	{
+		return false;
+	}
+	UE_LOG(LogSourceControl, Log, TEXT("Generated '%s': %d files, %d commits, %d branches, %d LFS assets, %d conflicts in %.3fs"), *InName, Spec.NumFiles, Spec.NumCommits + 1,
+		Spec.NumBranches, bHasLfs ? Spec.NumLfsFiles : 0, Spec.NumConflicts, FPlatformTime::Seconds() - StartTime);
+	return true;
+}
+
+void FGitTestRepository::Destroy()
+{
+	SetRemoteAvailable(true);
+	if (!BaseDirectory.IsEmpty())
+	{
+		IFileManager::Get().DeleteDirectory(*BaseDirectory, false, true);
+	}
+	RemoteDirectory.Reset();
+}
+
+bool FGitTestRepository::ConfigureClone(const FString& InDirectory) const
+{
+	return RunGitIn(InDirectory, TEXT("config"), {TEXT("user.name"), TEXT("Benchmark")})
+		&& RunGitIn(InDirectory, TEXT("config"), {TEXT("user.email"), TEXT("benchmark@example.com")})
+		&& RunGitIn(InDirectory, TEXT("config"), {TEXT("core.autocrlf"), TEXT("false")})
+		&& RunGitIn(InDirectory, TEXT("config"), {TEXT("commit.gpgsign"), TEXT("false")})
+		&& RunGitIn(InDirectory, TEXT("config"), {TEXT("gc.auto"), TEXT("0")});
+}
+
+FString FGitTestRepository::GetRelativeFilePath(int32 InIndex)
+{
+	return FString::Printf(TEXT("Content/Dir%03d/File%05d.uasset"), InIndex / GitTestRepositoryConstants::FilesPerDirectory, InIndex);
+}
+
+FString FGitTestRepository::GetRelativeLfsFilePath(int32 InIndex)
+{
+	return FString::Printf(TEXT("Content/Lfs/Asset%05d.uasset"), InIndex);
+}
+
+FString FGitTestRepository::GetFilePath(int32 InIndex) const
+{
+	return Root / GetRelativeFilePath(InIndex);
+}
+
+TArray<FString> FGitTestRepository::GetFilePaths(int32 InFirst, int32 InNum) const
+{
+	TArray<FString> Paths;
+	Paths.Reserve(InNum);
+	for (int32 Index = InFirst; Index < InFirst + InNum; Index++)
+	{
+		Paths.Add(GetFilePath(Index % Spec.NumFiles));
+	}
+	return Paths;
+}
+
+FString FGitTestRepository::GetHistoryFilePath() const
+{
+	return Root / GitTestRepositoryConstants::HistoryFile;
+}
+
+FString FGitTestRepository::GetLfsFilePath(int32 InIndex) const
+{
+	return Root / GetRelativeLfsFilePath(InIndex);
+}
+
+FString FGitTestRepository::MakeContent(const FString& InRelativePath, const FString& InTag) const
+{
+	FString Content = FString::Printf(TEXT("%s %s\n"), *InRelativePath, *InTag);
+	if (Content.Len() < Spec.FileSize)
+	{
+		Content = Content.LeftChop(1) + FString::ChrN(Spec.FileSize - Content.Len(), TEXT('.')) + TEXT("\n");
+	}
+	return Content;
+}
+
+bool FGitTestRepository::ImportHistory()
+{
+	// Only the binary assets go through git-lfs: the text files are imported as they are
+	FString Attributes = TEXT("*.uasset lockable\n*.umap lockable\n");
+	if (bHasLfs)
+	{
+		Attributes += TEXT("Content/Lfs/** filter=lfs diff=lfs merge=lfs -text lockable\n");
+	}
+
+	FGitFastImportStream Stream;
+	const FString MainRef(TEXT("refs/heads/main"));
+	int32 Mark = 1;
+	Stream.AppendCommit(MainRef, Mark, 0, GitTestRepositoryConstants::FirstCommitTime, TEXT("Initial commit"));
+	Stream.AppendFile(TEXT(".gitattributes"), Attributes);
+	for (int32 Index = 0; Index < Spec.NumFiles; Index++)
+	{
+		const FString Path = GetRelativeFilePath(Index);
+		Stream.AppendFile(Path, MakeContent(Path, TEXT("initial")));
+	}
+	Stream.AppendFile(GitTestRepositoryConstants::HistoryFile, MakeContent(GitTestRepositoryConstants::HistoryFile, TEXT("initial")));
+
+	// Branches spread over the history, the last ones on the tip if there are fewer commits than branches
+	const int32 BranchInterval = FMath::Max(1, Spec.NumCommits / (Spec.NumBranches + 1));
+	int32 NumBranches = 0;
+	for (int32 Commit = 1; Commit <= Spec.NumCommits; Commit++)
+	{
+		const FString Tag = FString::Printf(TEXT("commit %d"), Commit);
+		Stream.AppendCommit(MainRef, Mark + 1, Mark, GitTestRepositoryConstants::FirstCommitTime + 60 * Commit, FString::Printf(TEXT("Commit %d"), Commit));
+		Mark++;
+		for (int32 File = 0; File < FMath::Min(Spec.FilesPerCommit, Spec.NumFiles); File++)
+		{
+			const FString Path = GetRelativeFilePath((Commit * Spec.FilesPerCommit + File) % Spec.NumFiles);
+			Stream.AppendFile(Path, MakeContent(Path, Tag));
+		}
+		Stream.AppendFile(GitTestRepositoryConstants::HistoryFile, MakeContent(GitTestRepositoryConstants::HistoryFile, Tag));
+		if (Commit % BranchInterval == 0 && NumBranches < Spec.NumBranches)
+		{
+			Stream.AppendBranch(FString::Printf(TEXT("refs/heads/branch%02d"), NumBranches++), Mark);
+		}
+	}
+	while (NumBranches < Spec.NumBranches)
+	{
+		Stream.AppendBranch(FString::Printf(TEXT("refs/heads/branch%02d"), NumBranches++), Mark);
+	}
+
+	// The changes of the remote, that the local commit of MakeConflicts() conflicts with
+	if (Spec.NumConflicts > 0)
+	{
+		Stream.AppendCommit(TEXT("refs/heads/conflicts"), Mark + 1, Mark, GitTestRepositoryConstants::FirstCommitTime + 60 * (Spec.NumCommits + 1), TEXT("Their changes"));
+		for (int32 Index = 0; Index < Spec.NumConflicts; Index++)
+		{
+			const FString Path = GetRelativeFilePath(Index);
+			Stream.AppendFile(Path, MakeContent(Path, TEXT("theirs")));
+		}
+	}
+
+	const FString StreamFilename = BaseDirectory / TEXT("history.fast-import");
+	if (!FFileHelper::SaveArrayToFile(Stream.Bytes, *StreamFilename))
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("Failed to write '%s'"), *StreamFilename);
+		return false;
+	}
+
+	// fast-import only reads its standard input: go through the shell to redirect it from the file
+	int32 ReturnCode = -1;
+	FString StdOut;
+	FString StdErr;
+#if PLATFORM_WINDOWS
+	const FString Shell(TEXT("cmd.exe"));
+	const FString Command = FString::Printf(TEXT("/c \"\"%s\" -C \"%s\" fast-import --quiet < \"%s\"\""), *PathToGitBinary, *Root, *StreamFilename);
+#else
+	const FString Shell(TEXT("/bin/sh"));
+	const FString Command = FString::Printf(TEXT("-c \"'%s' -C '%s' fast-import --quiet < '%s'\""), *PathToGitBinary, *Root, *StreamFilename);
+#endif
+	FPlatformProcess::ExecProcess(*Shell, *Command, &ReturnCode, &StdOut, &StdErr);
+	IFileManager::Get().Delete(*StreamFilename);
+	if (ReturnCode != 0)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("git fast-import failed (%d): %s"), ReturnCode, *StdErr);
+		return false;
+	}
+	return true;
+}
+
+bool FGitTestRepository::CommitLfsFiles()
+{
+	// Incompressible content, the same at each run
+	FRandomStream Random(Spec.NumLfsFiles);
+	TArray<uint8> Content;
+	Content.SetNumUninitialized(Spec.LfsFileSize);
+	for (int32 Index = 0; Index < Spec.NumLfsFiles; Index++)
+	{
+		for (uint8& Byte : Content)
+		{
+			Byte = static_cast<uint8>(Random.RandHelper(256));
+		}
+		if (!FFileHelper::SaveArrayToFile(Content, *GetLfsFilePath(Index)))
+		{
+			return false;
+		}
+	}
+	return RunGit(TEXT("add"), {TEXT("Content/Lfs")})
+		&& RunGit(TEXT("commit"), {TEXT("-m"), TEXT("\"Binary assets\"")})
+		&& RunGit(TEXT("push"), {TEXT("origin"), TEXT("main")});
+}
+
+bool FGitTestRepository::MakeConflicts()
+{
+	// The remote gets their changes, and the working copy commits its own before pulling them
+	if (!RunGit(TEXT("push"), {TEXT("origin"), TEXT("conflicts:main")}))
+	{
+		return false;
+	}
+	ModifyFiles(0, Spec.NumConflicts, TEXT("ours"));
+	if (!RunGit(TEXT("commit"), {TEXT("-a"), TEXT("-m"), TEXT("\"Our changes\"")}))
+	{
+		return false;
+	}
+	// Fails, as expected
+	RunGit(TEXT("pull"), {TEXT("--no-rebase"), TEXT("--no-edit")});
+
+	TArray<FString> Unmerged;
+	RunGit(TEXT("ls-files"), {TEXT("--unmerged")}, &Unmerged);
+	if (Unmerged.Num() == 0)
+	{
+		UE_LOG(LogSourceControl, Warning, TEXT("The pull did not leave any conflict in '%s'"), *Root);
+		return false;
+	}
+	return true;
+}
+
+TArray<FString> FGitTestRepository::ModifyFiles(int32 InFirst, int32 InNum, const FString& InTag) const
+{
+	TArray<FString> Paths;
+	Paths.Reserve(InNum);
+	for (int32 Index = InFirst; Index < InFirst + InNum; Index++)
+	{
+		const FString RelativePath = GetRelativeFilePath(Index % Spec.NumFiles);
+		const FString Path = Root / RelativePath;
+		FFileHelper::SaveStringToFile(MakeContent(RelativePath, InTag), *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		Paths.Add(Path);
+	}
+	return Paths;
+}
+
+bool FGitTestRepository::PushRemoteChanges(int32 InFirst, int32 InNum, const FString& InTag)
+{
+	if (OtherRoot.IsEmpty())
+	{
+		const FString Directory = BaseDirectory / TEXT("Other");
+		if (!RunGitIn(FString(), TEXT("clone"), {Quote(RemoteUrl), Quote(Directory)}) || !ConfigureClone(Directory))
+		{
+			return false;
+		}
+		OtherRoot = Directory;
+	}
+
+	if (!RunGitIn(OtherRoot, TEXT("fetch"), {TEXT("origin")}) || !RunGitIn(OtherRoot, TEXT("reset"), {TEXT("--hard"), TEXT("origin/main")}))
+	{
+		return false;
+	}
+	for (int32 Index = InFirst; Index < InFirst + InNum; Index++)
+	{
+		const FString RelativePath = GetRelativeFilePath(Index % Spec.NumFiles);
+		FFileHelper::SaveStringToFile(MakeContent(RelativePath, InTag), *(OtherRoot / RelativePath), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+	return RunGitIn(OtherRoot, TEXT("commit"), {TEXT("-a"), TEXT("-m"), Quote(InTag)})
+		&& RunGitIn(OtherRoot, TEXT("push"), {TEXT("origin"), TEXT("HEAD:main")});
+}
+
+bool FGitTestRepository::SetRemoteAvailable(bool bInAvailable)
+{
+	const FString OfflineDirectory = RemoteDirectory + TEXT(".offline");
+	const FString& From = bInAvailable ? OfflineDirectory : RemoteDirectory;
+	const FString& To = bInAvailable ? RemoteDirectory : OfflineDirectory;
+	if (RemoteDirectory.IsEmpty() || !IFileManager::Get().DirectoryExists(*From))
+	{
+		return IFileManager::Get().DirectoryExists(*To);
+	}
+	return IFileManager::Get().Move(*To, *From, false);
+}
+
+bool FGitTestRepository::CloneSparse(FString& OutRoot)
+{
+	OutRoot = BaseDirectory / TEXT("Sparse");
+	IFileManager::Get().DeleteDirectory(*OutRoot, false, true);
+	// Cone mode is only the default of "clone --sparse" since Git 2.37
+	return RunGitIn(FString(), TEXT("clone"), {TEXT("--filter=blob:none"), TEXT("--sparse"), Quote(RemoteUrl), Quote(OutRoot)})
+		&& RunGitIn(OutRoot, TEXT("sparse-checkout"), {TEXT("init"), TEXT("--cone")})
+		&& ConfigureClone(OutRoot);
+}
+
+bool FGitTestRepository::RunGit(const FString& InCommand, const TArray<FString>& InParameters, TArray<FString>* OutResults) const
+{
+	return RunGitIn(Root, InCommand, InParameters, OutResults);
+}
+
+bool FGitTestRepository::RunGitIn(const FString& InDirectory, const FString& InCommand, const TArray<FString>& InParameters, TArray<FString>* OutResults) const
+{
+	TArray<FString> Results;
+	TArray<FString> ErrorMessages;
+	const bool bResult = GitSourceControlUtils::RunCommand(InCommand, PathToGitBinary, InDirectory, InParameters, FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+	if (!bResult)
+	{
+		UE_LOG(LogSourceControl, Log, TEXT("git %s %s failed: %s"), *InCommand, *FString::Join(InParameters, TEXT(" ")), *FString::Join(ErrorMessages, TEXT("\n")));
+	}
+	if (OutResults)
+	{
+		*OutResults = MoveTemp(Results);
+	}
+	return bResult;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,111 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Size and shape of a generated repository */
+struct FGitTestRepositorySpec
+{
+	/** Files of the first commit, in directories of 100 files */
+	int32 NumFiles = 1000;
+	/** Size of each generated file, in bytes */
+	int32 FileSize = 256;
+	/** Commits after the first one, each modifying FilesPerCommit files and the history file */
+	int32 NumCommits = 100;
+	int32 FilesPerCommit = 10;
+	/** Branches created on commits spread over the history, pushed to the remote */
+	int32 NumBranches = 4;
+	/** Binary assets tracked by git-lfs, committed only if git-lfs is installed */
+	int32 NumLfsFiles = 0;
+	int32 LfsFileSize = 64 * 1024;
+	/** Files modified by a local commit and by the remote, left unmerged by a pull */
+	int32 NumConflicts = 0;
+};
+
+/**
+ * A repository generated under the automation transient directory, with a bare repository as its "origin" remote.
+ *
+ * The history is written by a single "git fast-import", so that large repositories take seconds to generate.
+ * The remote is a local directory: it can be made unavailable by renaming it, to test the offline mode.
+ */
+class FGitTestRepository
+{
+public:
+	~FGitTestRepository();
+
+	/** Generate the repository and its remote, replacing those of a previous run with the same name */
+	bool Create(const FString& InName, const FGitTestRepositorySpec& InSpec);
+
+	/** Delete the directories of the repository */
+	void Destroy();
+
+	const FGitTestRepositorySpec& GetSpec() const { return Spec; }
+	const FString& GetPathToGitBinary() const { return PathToGitBinary; }
+	/** Root of the working copy, the repository under test */
+	const FString& GetRoot() const { return Root; }
+	/** URL of the bare remote */
+	const FString& GetRemoteUrl() const { return RemoteUrl; }
+	/** Whether git-lfs is installed, and the assets are tracked by it */
+	bool HasLfs() const { return bHasLfs; }
+
+	/** Absolute path of a file of the first commit */
+	FString GetFilePath(int32 InIndex) const;
+	/** Absolute paths of a range of files of the first commit */
+	TArray<FString> GetFilePaths(int32 InFirst, int32 InNum) const;
+	/** Absolute path of the file modified by every commit */
+	FString GetHistoryFilePath() const;
+	/** Absolute path of a binary asset tracked by git-lfs */
+	FString GetLfsFilePath(int32 InIndex) const;
+
+	/** Write new content to a range of files of the working copy, returning their absolute paths */
+	TArray<FString> ModifyFiles(int32 InFirst, int32 InNum, const FString& InTag) const;
+
+	/** Commit changes to a range of files from another clone and push them, for the working copy to fetch */
+	bool PushRemoteChanges(int32 InFirst, int32 InNum, const FString& InTag);
+
+	/** Rename the remote away, or back, so that it cannot be reached */
+	bool SetRemoteAvailable(bool bInAvailable);
+
+	/** Clone the remote again as a partial clone (--filter=blob:none), with a sparse-checkout in cone mode of the root files only */
+	bool CloneSparse(FString& OutRoot);
+
+	/** Run a git command in the working copy, or in another directory */
+	bool RunGit(const FString& InCommand, const TArray<FString>& InParameters, TArray<FString>* OutResults = nullptr) const;
+	bool RunGitIn(const FString& InDirectory, const FString& InCommand, const TArray<FString>& InParameters, TArray<FString>* OutResults = nullptr) const;
+
+private:
+	/** Relative path of a file of the first commit */
+	static FString GetRelativeFilePath(int32 InIndex);
+	static FString GetRelativeLfsFilePath(int32 InIndex);
+
+	/** Content of a text file, padded to the size of the spec */
+	FString MakeContent(const FString& InRelativePath, const FString& InTag) const;
+
+	/** Set the user and the options needed by the tests in a new clone */
+	bool ConfigureClone(const FString& InDirectory) const;
+
+	/** Import the history of the spec into the working copy */
+	bool ImportHistory();
+
+	/** Commit the git-lfs assets, and the conflicting changes */
+	bool CommitLfsFiles();
+	bool MakeConflicts();
+
+	FGitTestRepositorySpec Spec;
+	FString PathToGitBinary;
+	FString BaseDirectory;
+	FString Root;
+	FString RemoteDirectory;
+	FString RemoteUrl;
+	/** Clone used to push changes to the remote, created on demand */
+	FString OtherRoot;
+	bool bHasLfs = false;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,515 @@
+// Copyright (c) 2014-2023 Sebastien Rombauts (sebastien.rombauts@gmail.com)
+//
+// Distributed under the MIT License (MIT) (See accompanying file LICENSE.txt
+// or copy at http://opensource.org/licenses/MIT)
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GitSourceControlAttributeCache.h"
+#include "GitSourceControlBenchmarkReport.h"
+#include "GitSourceControlCommand.h"
+#include "GitSourceControlModule.h"
+#include "GitSourceControlOfflineQueue.h"
+#include "GitSourceControlOperations.h"
+#include "GitSourceControlReadBackend.h"
+#include "GitSourceControlSparseCheckout.h"
+#include "GitSourceControlState.h"
+#include "GitSourceControlTestHelpers.h"
+#include "GitSourceControlTestRepository.h"
+#include "GitSourceControlUtils.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+using namespace GitSourceControlTestHelpers;
+
+/** The generated history, as read by the plugin */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryHistoryTest, "GitSourceControl.Repository.History", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryHistoryTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 200;
+		Spec.NumCommits = 50;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("History"), Spec)))
+		{
+			return;
+		}
+
+		TArray<FString> ErrorMessages;
+		TGitSourceControlHistory History;
+		if (Context.TestSuccess(TEXT("RunGetHistory"), GitSourceControlUtils::RunGetHistory(Repository.GetPathToGitBinary(), Repository.GetRoot(),
+			Repository.GetHistoryFilePath(), false, ErrorMessages, History), ErrorMessages))
+		{
+			Context.TestEqual(TEXT("Revisions of the history file"), History.Num(), Spec.NumCommits + 1);
+		}
+
+		TArray<FString> Branches;
+		Repository.RunGit(TEXT("branch"), {TEXT("--remotes"), TEXT("--format=%(refname:short)")}, &Branches);
+		Context.TestEqual(TEXT("Remote branches"), Branches.FilterByPredicate([](const FString& Branch) { return Branch.StartsWith(TEXT("origin/branch")); }).Num(), Spec.NumBranches);
+
+		// The files are unchanged, then modified
+		TMap<FString, FGitSourceControlState> States;
+		const TArray<FString> Files = Repository.GetFilePaths(0, 10);
+		Context.TestSuccess(TEXT("RunUpdateStatus"), GitSourceControlUtils::RunUpdateStatus(Repository.GetPathToGitBinary(), Repository.GetRoot(), false, Files,
+			ErrorMessages, States, false), ErrorMessages);
+		Context.TestEqual(TEXT("Modified files"), States.FilterByPredicate([](const TPair<FString, FGitSourceControlState>& State) { return State.Value.IsModified(); }).Num(), 0);
+
+		Repository.ModifyFiles(0, 5, TEXT("modified"));
+		States.Reset();
+		Context.TestSuccess(TEXT("RunUpdateStatus"), GitSourceControlUtils::RunUpdateStatus(Repository.GetPathToGitBinary(), Repository.GetRoot(), false, Files,
+			ErrorMessages, States, false), ErrorMessages);
+		Context.TestEqual(TEXT("Modified files"), States.FilterByPredicate([](const TPair<FString, FGitSourceControlState>& State) { return State.Value.IsModified(); }).Num(), 5);
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** Files left unmerged by a pull are all reported as conflicted */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryConflictsTest, "GitSourceControl.Repository.Conflicts", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryConflictsTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 1000;
+		Spec.NumCommits = 10;
+		Spec.NumConflicts = 1000;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Conflicts"), Spec)))
+		{
+			return;
+		}
+
+		TArray<FString> ErrorMessages;
+		TMap<FString, FGitSourceControlState> States;
+		Context.TestSuccess(TEXT("RunUpdateStatus"), GitSourceControlUtils::RunUpdateStatus(Repository.GetPathToGitBinary(), Repository.GetRoot(), false,
+			{Repository.GetRoot() / TEXT("Content")}, ErrorMessages, States, false), ErrorMessages);
+		Context.TestEqual(TEXT("Conflicted files"), States.FilterByPredicate([](const TPair<FString, FGitSourceControlState>& State) { return State.Value.IsConflicted(); }).Num(), Spec.NumConflicts);
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** A blob larger than the pipe buffer is streamed whole, up to the bytes written by git just before it exits */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryStreamTest, "GitSourceControl.Repository.Stream", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryStreamTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 4;
+		Spec.FileSize = 4 * 1024 * 1024;
+		Spec.NumCommits = 1;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Stream"), Spec)))
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < Spec.NumFiles; Index++)
+		{
+			const FString RelativePath = Repository.GetFilePath(Index).RightChop(Repository.GetRoot().Len() + 1);
+			const FString Command = FString::Printf(TEXT("cat-file -p \"HEAD:%s\""), *RelativePath);
+			int64 Size = 0;
+			uint8 LastByte = 0;
+			int32 ReturnCode = -1;
+			Context.TestTrue(TEXT("RunCommandStreamed"), GitSourceControlUtils::RunCommandStreamed(Repository.GetPathToGitBinary(), Repository.GetRoot(), Command, [&](const uint8* Data, int32 InSize)
+			{
+				Size += InSize;
+				LastByte = Data[InSize - 1];
+				return true;
+			}, ReturnCode));
+			Context.TestEqual(TEXT("Streamed size"), Size, Spec.FileSize);
+			Context.TestTrue(TEXT("Streamed up to the last byte"), LastByte == '\n');
+		}
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** The patterns with a "**" between directories match none of them too, as in git */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryAttributesTest, "GitSourceControl.Repository.Attributes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryAttributesTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 10;
+		Spec.NumCommits = 1;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Attributes"), Spec)))
+		{
+			return;
+		}
+		const FString Patterns = TEXT("Content/**/*.png lockable\n**/Maps/*.ini lockable\nContent/Dir000/**/Sub/*.txt lockable\n");
+		if (!Context.TestTrue(TEXT("Patterns added"), FFileHelper::SaveStringToFile(Patterns, *(Repository.GetRoot() / TEXT(".gitattributes")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM,
+			&IFileManager::Get(), FILEWRITE_Append)))
+		{
+			return;
+		}
+		FGitAttributeCache AttributeCache;
+		Context.TestTrue(TEXT("Attributes loaded"), AttributeCache.Load(Repository.GetPathToGitBinary(), Repository.GetRoot()));
+
+		// The path, and whether it is lockable
+		const TPair<const TCHAR*, bool> Expected[] = {
+			{TEXT("Content/Foo.png"), true},
+			{TEXT("Content/Dir000/Foo.png"), true},
+			{TEXT("Other/Foo.png"), false},
+			{TEXT("Maps/Level.ini"), true},
+			{TEXT("Content/Maps/Level.ini"), true},
+			{TEXT("Content/Maps/Sub/Level.ini"), false},
+			{TEXT("Content/Dir000/Sub/Notes.txt"), true},
+			{TEXT("Content/Dir000/A/B/Sub/Notes.txt"), true},
+			{TEXT("Content/Dir000/Notes.txt"), false},
+		};
+		const int32 NumExpected = UE_ARRAY_COUNT(Expected);
+		TArray<FString> CheckParameters{TEXT("lockable"), TEXT("--")};
+		for (const TPair<const TCHAR*, bool>& Path : Expected)
+		{
+			Context.TestTrue(FString::Printf(TEXT("Lockable attribute of %s"), Path.Key), AttributeCache.IsLockable(Path.Key) == Path.Value);
+			CheckParameters.Add(Path.Key);
+		}
+
+		// And git agrees
+		TArray<FString> Results;
+		Context.TestTrue(TEXT("git check-attr"), Repository.RunGit(TEXT("check-attr"), CheckParameters, &Results));
+		Context.TestEqual(TEXT("Paths checked by git check-attr"), Results.Num(), NumExpected);
+		for (int32 Index = 0; Index < Results.Num() && Index < NumExpected; Index++)
+		{
+			Context.TestTrue(FString::Printf(TEXT("git check-attr: %s"), *Results[Index]), Results[Index].EndsWith(TEXT(": lockable: set")) == Expected[Index].Value);
+		}
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** The native backend gives the same answers as git, for the queries it does not decline, and how much faster */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitReadBackendsTest, "GitSourceControl.Repository.ReadBackends", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitReadBackendsTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 300;
+		Spec.NumCommits = 5;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("ReadBackends"), Spec)))
+		{
+			return;
+		}
+
+		const FString& Root = Repository.GetRoot();
+		FGitCliReadBackend Cli(Repository.GetPathToGitBinary());
+		FGitNativeReadBackend Native;
+		const auto TestSame = [&Context](const FString& InWhat, bool bInNativeAnswered, const FString& InNative, const FString& InCli)
+		{
+			if (bInNativeAnswered && InNative != InCli)
+			{
+				Context.AddError(FString::Printf(TEXT("%s: '%s' (native) != '%s' (cli)"), *InWhat, *InNative, *InCli));
+			}
+		};
+
+		FString NativeValue, CliValue, NativeSummary, CliSummary;
+		Context.TestTrue(TEXT("cli GetBranchName"), Cli.GetBranchName(Root, CliValue));
+		TestSame(TEXT("GetBranchName"), Native.GetBranchName(Root, NativeValue), NativeValue, CliValue);
+		Context.TestTrue(TEXT("cli GetRemoteBranchName"), Cli.GetRemoteBranchName(Root, CliValue));
+		TestSame(TEXT("GetRemoteBranchName"), Native.GetRemoteBranchName(Root, NativeValue), NativeValue, CliValue);
+		Context.TestTrue(TEXT("cli GetRemoteUrl"), Cli.GetRemoteUrl(Root, CliValue));
+		TestSame(TEXT("GetRemoteUrl"), Native.GetRemoteUrl(Root, NativeValue), NativeValue, CliValue);
+		Context.TestTrue(TEXT("cli GetCommitInfo"), Cli.GetCommitInfo(Root, CliValue, CliSummary));
+		const bool bNativeCommit = Native.GetCommitInfo(Root, NativeValue, NativeSummary);
+		// The generated history is written in a pack
+		Context.TestTrue(TEXT("native GetCommitInfo from a pack"), bNativeCommit);
+		TestSame(TEXT("GetCommitInfo id"), bNativeCommit, NativeValue, CliValue);
+		TestSame(TEXT("GetCommitInfo summary"), bNativeCommit, NativeSummary, CliSummary);
+
+		TArray<FString> NativeFiles, CliFiles;
+		Context.TestTrue(TEXT("cli ListFiles"), Cli.ListFiles(Root, Root / TEXT("Content/Dir001"), CliFiles));
+		if (Native.ListFiles(Root, Root / TEXT("Content/Dir001"), NativeFiles))
+		{
+			NativeFiles.Sort();
+			CliFiles.Sort();
+			TestSame(TEXT("ListFiles"), true, FString::Join(NativeFiles, TEXT(",")), FString::Join(CliFiles, TEXT(",")));
+		}
+
+		const TArray<FString> Wildcards {TEXT("*.uasset"), TEXT("*.umap"), TEXT("*.ini")};
+		TArray<FString> NativeResults, CliResults, ErrorMessages;
+		Context.TestTrue(TEXT("cli CheckLockable"), Cli.CheckLockable(Root, Wildcards, CliResults, ErrorMessages));
+		TestSame(TEXT("CheckLockable"), Native.CheckLockable(Root, Wildcards, NativeResults, ErrorMessages), FString::Join(NativeResults, TEXT("\n")), FString::Join(CliResults, TEXT("\n")));
+
+		const auto HistoryToString = [](const TGitSourceControlHistory& InHistory)
+		{
+			FString String;
+			for (const TSharedRef<FGitSourceControlRevision, ESPMode::ThreadSafe>& Revision : InHistory)
+			{
+				String += FString::Printf(TEXT("%d %s %s %s %s %d %s %lld %s\n"), Revision->RevisionNumber, *Revision->CommitId, *Revision->Action, *Revision->Filename,
+					*Revision->FileHash, Revision->FileSize, *Revision->UserName, Revision->Date.ToUnixTimestamp(), *Revision->Description);
+			}
+			return String;
+		};
+		TGitSourceControlHistory NativeHistory, CliHistory;
+		Context.TestTrue(TEXT("cli GetHistory"), Cli.GetHistory(Root, Repository.GetHistoryFilePath(), false, CliHistory, ErrorMessages));
+		const bool bNativeHistory = Native.GetHistory(Root, Repository.GetHistoryFilePath(), false, NativeHistory, ErrorMessages);
+		// The generated history is linear, without any rename
+		Context.TestTrue(TEXT("native GetHistory of a linear history"), bNativeHistory);
+		TestSame(TEXT("GetHistory"), bNativeHistory, HistoryToString(NativeHistory), HistoryToString(CliHistory));
+
+		// The same queries timed on both backends: a failure of the native one is a query it declines
+		const int32 Iterations = 20;
+		FGitBenchmarkReport Report(TEXT("ReadBackends"));
+		Report.SetRepository(Repository);
+		for (IGitReadBackend* Backend : TArray<IGitReadBackend*>{&Native, &Cli})
+		{
+			const FString Name = Backend->GetName();
+			FString Value, Summary;
+			TArray<FString> Values, Errors;
+			TGitSourceControlHistory History;
+			Report.Measure(Name + TEXT(" GetBranchName"), 1, Iterations, [&]() { return Backend->GetBranchName(Root, Value); });
+			Report.Measure(Name + TEXT(" GetRemoteBranchName"), 1, Iterations, [&]() { return Backend->GetRemoteBranchName(Root, Value); });
+			Report.Measure(Name + TEXT(" GetRemoteUrl"), 1, Iterations, [&]() { return Backend->GetRemoteUrl(Root, Value); });
+			Report.Measure(Name + TEXT(" GetCommitInfo"), 1, Iterations, [&]() { return Backend->GetCommitInfo(Root, Value, Summary); });
+			Report.Measure(Name + TEXT(" ListFiles"), Spec.NumFiles, Iterations, [&]() { Values.Reset(); return Backend->ListFiles(Root, Root / TEXT("Content"), Values); });
+			Report.Measure(Name + TEXT(" CheckLockable"), Wildcards.Num(), Iterations, [&]() { Values.Reset(); return Backend->CheckLockable(Root, Wildcards, Values, Errors); });
+			Report.Measure(Name + TEXT(" GetHistory"), Spec.NumCommits + 1, Iterations, [&]() { History.Reset(); return Backend->GetHistory(Root, Repository.GetHistoryFilePath(), false, History, Errors); });
+		}
+		FString ReportFilename;
+		Context.TestTrue(TEXT("Benchmark report written"), Report.Save(ReportFilename));
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** A fetch reports its progress and stops as soon as it is canceled, leaving the repository for the next fetch to complete */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryCancelTest, "GitSourceControl.Repository.Cancel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryCancelTest::RunTest(const FString& Parameters)
+{
+#if GIT_USE_CANCELLABLE_PROCESS
+	// The fetch worker shares the offline journal of the editor: a pending journal would be replayed onto the generated repository
+	const FGitOfflineQueue& OfflineQueue = FGitOfflineQueue::Get();
+	if (!OfflineQueue.IsRemoteReachable() || OfflineQueue.Num() > 0)
+	{
+		AddWarning(TEXT("The editor is working offline: skipped until its journal is replayed"));
+		return true;
+	}
+
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 20000;
+		Spec.NumCommits = 1;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Cancel"), Spec))
+			|| !Context.TestTrue(TEXT("Remote changes pushed"), Repository.PushRemoteChanges(0, Spec.NumFiles, TEXT("cancel"))))
+		{
+			return;
+		}
+
+		// A large pack to fetch: all the files were changed by another clone
+		const auto MakeFetchCommand = [&Repository]()
+		{
+			TUniquePtr<FGitSourceControlCommand> Command = MakeUnique<FGitSourceControlCommand>(ISourceControlOperation::Create<FGitFetch>(), MakeShared<FGitFetchWorker>());
+			Command->PathToGitBinary = Repository.GetPathToGitBinary();
+			Command->PathToRepositoryRoot = Repository.GetRoot();
+			Command->PathToGitRoot = Repository.GetRoot();
+			Command->bUsingGitLfsLocking = false;
+			Command->Concurrency = EConcurrency::Asynchronous;
+			Command->bAutoDelete = false;
+			return Command;
+		};
+
+		TUniquePtr<FGitSourceControlCommand> Command = MakeFetchCommand();
+		FGitSourceControlCommand* FetchCommand = Command.Get();
+		TFuture<bool> Fetch = Async(EAsyncExecution::Thread, [FetchCommand]() { return FetchCommand->DoWork(); });
+		FString Phase;
+		int32 Percent = 0;
+		bool bProgress = false;
+		while (!bProgress && !FetchCommand->WaitForCompletion(1))
+		{
+			bProgress = FetchCommand->ConsumeProgress(Phase, Percent);
+		}
+		Context.TestTrue(TEXT("Progress reported by the fetch"), bProgress && !Phase.IsEmpty());
+
+		// Canceled at its first progress, long before the end of the transfer
+		const double CancelTime = FPlatformTime::Seconds();
+		FetchCommand->Cancel();
+		const bool bFetched = Fetch.Get();
+		const double CancelSeconds = FPlatformTime::Seconds() - CancelTime;
+		Context.TestTrue(TEXT("Fetch canceled"), !bFetched && FetchCommand->IsCanceled());
+		Context.TestTrue(FString::Printf(TEXT("Fetch stopped within a second of its cancellation (%.3fs)"), CancelSeconds), CancelSeconds < 1.0);
+
+		TArray<FString> ErrorMessages;
+		TUniquePtr<FGitSourceControlCommand> NextCommand = MakeFetchCommand();
+		Context.TestSuccess(TEXT("Next fetch"), NextCommand->DoWork(), NextCommand->ResultInfo.ErrorMessages);
+		TArray<FString> LocalMain;
+		TArray<FString> RemoteMain;
+		Repository.RunGit(TEXT("rev-parse"), {TEXT("refs/remotes/origin/main")}, &LocalMain);
+		Repository.RunGit(TEXT("ls-remote"), {TEXT("origin"), TEXT("refs/heads/main")}, &RemoteMain);
+		Context.TestTrue(TEXT("Remote branch fetched"), LocalMain.Num() == 1 && RemoteMain.Num() == 1 && RemoteMain[0].StartsWith(LocalMain[0]));
+
+		FGitBenchmarkReport Report(TEXT("Cancel"));
+		Report.SetRepository(Repository);
+		Report.AddValue(TEXT("Fetch.CancelSeconds"), CancelSeconds);
+		FString ReportFilename;
+		Context.TestTrue(TEXT("Benchmark report written"), Report.Save(ReportFilename));
+
+		Repository.Destroy();
+	});
+#else
+	AddInfo(TEXT("Git commands can only be canceled from Unreal Engine 5.1: skipped"));
+#endif
+	return true;
+}
+
+/** A push queued while the remote is unreachable survives a restart, and is replayed to the branch it was committed on */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositoryOfflineTest, "GitSourceControl.Repository.Offline", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositoryOfflineTest::RunTest(const FString& Parameters)
+{
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 100;
+		Spec.NumCommits = 2;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Offline"), Spec)))
+		{
+			return;
+		}
+
+		const FString& PathToGitBinary = Repository.GetPathToGitBinary();
+		const FString& Root = Repository.GetRoot();
+		// A journal of its own, next to the repository, so that the one of the editor is left alone
+		const FString JournalFilename = FPaths::GetPath(Root) / TEXT("OfflineJournal.bin");
+		TArray<FString> Results;
+		TArray<FString> ErrorMessages;
+
+		Context.TestTrue(TEXT("Remote moved away"), Repository.SetRemoteAvailable(false));
+		{
+			FGitOfflineQueue OfflineQueue(JournalFilename);
+			OfflineQueue.Load(Root);
+			Context.TestTrue(TEXT("Remote unreachable"), !OfflineQueue.ProbeRemote(PathToGitBinary, Root));
+
+			// A check in while offline: the commit stays local and its push is queued, once
+			Repository.ModifyFiles(0, 5, TEXT("offline"));
+			Context.TestTrue(TEXT("Offline commit"), Repository.RunGit(TEXT("commit"), {TEXT("-a"), TEXT("-m"), TEXT("\"offline\"")}));
+			const bool bPushed = GitSourceControlUtils::RunCommand(TEXT("push"), PathToGitBinary, Root, {TEXT("origin"), TEXT("main")},
+				FGitSourceControlModule::GetEmptyStringArray(), Results, ErrorMessages);
+			Context.TestTrue(TEXT("Push failed with a network error"), !bPushed && FGitOfflineQueue::IsNetworkError(ErrorMessages));
+			OfflineQueue.Enqueue(EGitOfflineOperation::Push, FGitSourceControlModule::GetEmptyStringArray(), TEXT("refs/heads/main"));
+			OfflineQueue.Enqueue(EGitOfflineOperation::Push, FGitSourceControlModule::GetEmptyStringArray(), TEXT("refs/heads/main"));
+			Context.TestEqual(TEXT("Queued pushes"), OfflineQueue.Num(), 1);
+		}
+
+		// Another branch is checked out by the time the remote is back
+		Repository.RunGit(TEXT("checkout"), {TEXT("-b"), TEXT("feature")});
+		Repository.ModifyFiles(5, 5, TEXT("feature"));
+		Context.TestTrue(TEXT("Commit on another branch"), Repository.RunGit(TEXT("commit"), {TEXT("-a"), TEXT("-m"), TEXT("\"feature\"")}));
+		Context.TestTrue(TEXT("Remote moved back"), Repository.SetRemoteAvailable(true));
+
+		// As after a restart of the editor
+		FGitOfflineQueue OfflineQueue(JournalFilename);
+		OfflineQueue.Load(Root);
+		Context.TestEqual(TEXT("Operations read back from the journal"), OfflineQueue.Num(), 1);
+		Context.TestTrue(TEXT("Remote reachable"), OfflineQueue.ProbeRemote(PathToGitBinary, Root));
+		Results.Reset();
+		ErrorMessages.Reset();
+		Context.TestSuccess(TEXT("Replay"), OfflineQueue.Replay(PathToGitBinary, Root, Results, ErrorMessages), ErrorMessages);
+
+		TArray<FString> LocalMain;
+		TArray<FString> RemoteMain;
+		TArray<FString> RemoteFeature;
+		Repository.RunGit(TEXT("rev-parse"), {TEXT("refs/heads/main")}, &LocalMain);
+		Repository.RunGit(TEXT("ls-remote"), {TEXT("origin"), TEXT("refs/heads/main")}, &RemoteMain);
+		Repository.RunGit(TEXT("ls-remote"), {TEXT("origin"), TEXT("refs/heads/feature")}, &RemoteFeature);
+		Context.TestTrue(TEXT("Offline commit pushed to main"), LocalMain.Num() == 1 && RemoteMain.Num() == 1 && RemoteMain[0].StartsWith(LocalMain[0]));
+		Context.TestEqual(TEXT("Branches pushed from HEAD"), RemoteFeature.Num(), 0);
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+/** A sparse partial clone only fetches the blobs of the directories added to its cones, and the status of its cones fetches none */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGitRepositorySparseTest, "GitSourceControl.Repository.Sparse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FGitRepositorySparseTest::RunTest(const FString& Parameters)
+{
+	// The sparse-checkout is read according to the version of git found by the provider
+	if (!FGitSourceControlModule::Get().GetProvider().GetGitVersion().IsGreaterOrEqualThan(2, 26))
+	{
+		AddInfo(TEXT("Requires Git 2.26 or later as the revision control provider: skipped"));
+		return true;
+	}
+
+	RunOffGameThread(*this, [](FGitTestContext& Context)
+	{
+		FGitTestRepositorySpec Spec;
+		Spec.NumFiles = 300;
+		Spec.NumCommits = 5;
+		Spec.NumBranches = 0;
+		FGitTestRepository Repository;
+		FString SparseRoot;
+		if (!Context.TestTrue(TEXT("Repository generated"), Repository.Create(TEXT("Sparse"), Spec))
+			|| !Context.TestTrue(TEXT("Sparse clone over file://"), Repository.CloneSparse(SparseRoot)))
+		{
+			return;
+		}
+
+		const FString& PathToGitBinary = Repository.GetPathToGitBinary();
+		const auto GetSparseFilePath = [&Repository, &SparseRoot](int32 InIndex)
+		{
+			return SparseRoot / Repository.GetFilePath(InIndex).RightChop(Repository.GetRoot().Len() + 1);
+		};
+		const auto CountMissingBlobs = [&Repository, &SparseRoot]()
+		{
+			TArray<FString> Objects;
+			Repository.RunGitIn(SparseRoot, TEXT("rev-list"), {TEXT("--objects"), TEXT("--all"), TEXT("--missing=print")}, &Objects);
+			return Objects.FilterByPredicate([](const FString& Object) { return Object.StartsWith(TEXT("?")); }).Num();
+		};
+
+		// A layout of its own, for the clone, so that the one of the editor is left alone
+		FGitSparseCheckout SparseCheckout;
+		Context.TestTrue(TEXT("Refresh"), SparseCheckout.Refresh(PathToGitBinary, SparseRoot));
+		Context.TestTrue(TEXT("Sparse"), SparseCheckout.IsSparse());
+		Context.TestTrue(TEXT("Partial clone"), SparseCheckout.IsPartialClone());
+		const FString ContentDirectory = SparseRoot / TEXT("Content/");
+		Context.TestEqual(TEXT("Cones in Content/ before the hydration"), SparseCheckout.FilterToCone({ContentDirectory}).Num(), 0);
+
+		// Content/Dir001 holds the files 100 to 199, all different
+		const int32 NumConeFiles = 100;
+		const int32 MissingBlobs = CountMissingBlobs();
+		TArray<FString> ErrorMessages;
+		Context.TestSuccess(TEXT("Hydrate"), SparseCheckout.Hydrate(PathToGitBinary, SparseRoot, {TEXT("Content/Dir001")}, ErrorMessages), ErrorMessages);
+		const TArray<FString> Cones = SparseCheckout.FilterToCone({ContentDirectory});
+		Context.TestTrue(TEXT("Content/ restricted to the new cone"), Cones.Num() == 1 && Cones[0] == SparseRoot / TEXT("Content/Dir001/"));
+		Context.TestTrue(TEXT("File of the cone checked out"), FPaths::FileExists(GetSparseFilePath(100)));
+		Context.TestTrue(TEXT("File out of the cones not checked out"), !FPaths::FileExists(GetSparseFilePath(0)));
+		Context.TestEqual(TEXT("Blobs fetched by the hydration"), MissingBlobs - CountMissingBlobs(), NumConeFiles);
+
+		const int32 HydratedMissingBlobs = CountMissingBlobs();
+		FFileHelper::SaveStringToFile(TEXT("modified"), *GetSparseFilePath(100));
+		TMap<FString, FGitSourceControlState> States;
+		Context.TestSuccess(TEXT("RunUpdateStatus"), GitSourceControlUtils::RunUpdateStatus(PathToGitBinary, SparseRoot, false, Cones, ErrorMessages, States, false), ErrorMessages);
+		Context.TestEqual(TEXT("Modified files"), States.FilterByPredicate([](const TPair<FString, FGitSourceControlState>& State) { return State.Value.IsModified(); }).Num(), 1);
+		Context.TestEqual(TEXT("Blobs fetched by the status"), HydratedMissingBlobs - CountMissingBlobs(), 0);
+
+		Repository.Destroy();
+	});
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS